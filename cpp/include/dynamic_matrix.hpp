@@ -0,0 +1,893 @@
+/**
+ * @file dynamic_matrix.hpp
+ * @author ashwinn76
+ * @brief Implementation of a matrix class with sizes chosen at runtime
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * The elements live on the heap, row after row, each row starting on a 64-byte boundary: the stride is the column
+ * count rounded up to a whole number of cache lines, and the padding is kept at zero. Products go through the same
+ * blocked kernel as the fixed matrix. A fixed matrix converts to a dynamic one implicitly, so the two mix in
+ * arithmetic, and a dynamic matrix converts back with fixed<_Rows, _Columns>() once its size is known. Elements are
+ * the same as the fixed matrix takes, and the determinant and inverse eliminate as ring_traits says, as they do there.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "matrix.hpp"
+#include "parallel.hpp"
+#include "strassen.hpp"
+
+template<typename _T>
+struct dynamic_lu_decomposition;
+
+
+/**
+ * @brief Matrix class with runtime sizes and aligned heap storage
+ *
+ * @tparam _T Type of matrix element
+ */
+template<typename _T = double>
+class dynamic_matrix
+{
+public:
+    using value_type = _T;
+
+    static constexpr auto alignment = 64_sz;  // bytes; every row starts on a cache line
+
+private:
+    /**
+     * @brief Release memory taken with the matrix alignment
+     *
+     */
+    struct aligned_delete
+    {
+        void operator()( value_type* i_data ) const noexcept
+        {
+            ::operator delete[]( i_data, std::align_val_t{ alignment } );
+        }
+    };
+
+    uint64_t m_rows{ 0_ui64 };
+
+    uint64_t m_columns{ 0_ui64 };
+
+    uint64_t m_stride{ 0_ui64 };  // elements from the start of one row to the start of the next
+
+    std::unique_ptr<value_type[], aligned_delete> m_data{};
+
+
+    static_assert( alignof( value_type ) <= alignment, "Elements cannot be aligned beyond a cache line!" );
+
+
+    /**
+     * @brief Columns rounded up so that a row takes a whole number of cache lines, whatever the element size
+     *
+     */
+    static uint64_t padded_stride( uint64_t i_columns ) noexcept
+    {
+        // the fewest elements filling whole cache lines: one line for elements that divide it, several otherwise
+        constexpr auto line = static_cast<uint64_t>( alignment / std::gcd( alignment, sizeof( value_type ) ) );
+
+        return ( i_columns + line - 1 ) / line * line;
+    }
+
+
+    /**
+     * @brief Allocate zeroed storage for a size
+     *
+     */
+    void allocate( uint64_t i_rows, uint64_t i_columns )
+    {
+        if( i_rows == 0 || i_columns == 0 )
+        {
+            throw std::invalid_argument{ "Rows and columns have to be non-zero!" };
+        }
+
+        m_rows = i_rows;
+        m_columns = i_columns;
+        m_stride = padded_stride( i_columns );
+
+        auto count{ m_rows * m_stride };
+        auto data{ static_cast<value_type*>( ::operator new[]( count * sizeof( value_type ),
+                                                                std::align_val_t{ alignment } ) ) };
+
+        std::uninitialized_fill_n( data, count, static_cast<value_type>( 0 ) );
+        m_data.reset( data );
+    }
+
+
+    void check_same_size( const dynamic_matrix& i_other ) const
+    {
+        if( m_rows != i_other.m_rows )
+        {
+            throw std::invalid_argument{ "Both matrices should have same number of rows!" };
+        }
+
+        if( m_columns != i_other.m_columns )
+        {
+            throw std::invalid_argument{ "Both matrices should have same number of columns!" };
+        }
+    }
+
+
+    void check_square() const
+    {
+        if( !IsSquare() )
+        {
+            throw std::invalid_argument{ "matrix has to be a square matrix!" };
+        }
+    }
+
+
+    /**
+     * @brief Combine every element with the same element of another matrix, in one pass
+     *
+     */
+    template<typename _Combine>
+    void combine( const dynamic_matrix& i_other, _Combine&& i_combine )
+    {
+        check_same_size( i_other );
+
+        parallel::for_row_bands( m_rows, m_columns, [&]( uint64_t i_first, uint64_t i_last ) {
+            for( auto i{ i_first }; i < i_last; ++i )
+            {
+                auto row{ ( *this )[i] };
+                auto other{ i_other[i] };
+
+                for( auto j{ 0_ui64 }; j < m_columns; ++j )
+                {
+                    i_combine( row[j], other[j] );
+                }
+            }
+        } );
+    }
+
+public:
+    /**
+     * @brief Constructor for dynamic_matrix class
+     *
+     * @param i_rows Number of rows
+     * @param i_columns Number of columns
+     * @param i_identity whether to set the main diagonal to 1
+     * @throw std::invalid_argument if either size is zero
+     */
+    explicit dynamic_matrix( uint64_t i_rows, uint64_t i_columns, bool i_identity = true )
+    {
+        allocate( i_rows, i_columns );
+
+        if( i_identity )
+        {
+            for( auto k{ 0_ui64 }; k < std::min( m_rows, m_columns ); ++k )
+            {
+                ( *this )[k][k] = static_cast<value_type>( 1 );
+            }
+        }
+    }
+
+
+    /**
+     * @brief Constructor for dynamic_matrix class
+     *
+     * @param i_rows Number of rows
+     * @param i_columns Number of columns
+     * @param i_list Elements row by row; missing ones are zero
+     */
+    dynamic_matrix( uint64_t i_rows, uint64_t i_columns, std::initializer_list<value_type> i_list ) :
+        dynamic_matrix{ i_rows, i_columns, false }
+    {
+        auto idx{ 0_ui64 };
+
+        for( auto iter{ i_list.begin() }; iter != i_list.end() && idx < m_rows * m_columns; ++iter, ++idx )
+        {
+            ( *this )[idx / m_columns][idx % m_columns] = *iter;
+        }
+    }
+
+
+    /**
+     * @brief Copy a fixed-size matrix
+     *
+     * @param i_matrix fixed-size matrix
+     */
+    template<uint64_t _Rows, uint64_t _Columns>
+    dynamic_matrix( const matrix<_Rows, _Columns, value_type>& i_matrix ) : dynamic_matrix{ _Rows, _Columns, false }
+    {
+        for( auto i{ 0_ui64 }; i < _Rows; ++i )
+        {
+            std::copy( i_matrix[i].begin(), i_matrix[i].end(), ( *this )[i] );
+        }
+    }
+
+
+    /**
+     * @brief Evaluate a lazy element-wise expression over fixed-size matrices, or copy a view of one
+     *
+     * @tparam _Operand Type of the expression or view
+     * @param i_operand expression or view
+     */
+    template<typename _Operand,
+             typename = std::enable_if_t<is_matrix_expression_v<_Operand> || is_matrix_view_v<_Operand>>>
+    dynamic_matrix( const _Operand& i_operand ) : dynamic_matrix{ _Operand::Rows(), _Operand::Columns(), false }
+    {
+        for( auto i{ 0_ui64 }; i < m_rows; ++i )
+        {
+            for( auto j{ 0_ui64 }; j < m_columns; ++j )
+            {
+                ( *this )[i][j] = i_operand( i, j );
+            }
+        }
+    }
+
+
+    /**
+     * @brief Copy constructor; a copy of a moved-from matrix is empty too
+     *
+     */
+    dynamic_matrix( const dynamic_matrix& i_other )
+    {
+        if( i_other.m_data )
+        {
+            allocate( i_other.m_rows, i_other.m_columns );
+            std::copy( i_other.m_data.get(), i_other.m_data.get() + m_rows * m_stride, m_data.get() );
+        }
+    }
+
+
+    /**
+     * @brief Move constructor, leaving the other matrix empty: 0 x 0, and still fit to copy, assign and compare
+     *
+     */
+
+    dynamic_matrix( dynamic_matrix&& i_other ) noexcept :
+        m_rows{ std::exchange( i_other.m_rows, 0 ) },
+        m_columns{ std::exchange( i_other.m_columns, 0 ) },
+        m_stride{ std::exchange( i_other.m_stride, 0 ) },
+        m_data{ std::move( i_other.m_data ) }
+    {
+    }
+
+
+    dynamic_matrix& operator=( const dynamic_matrix& i_other )
+    {
+        if( this != &i_other )
+        {
+            *this = dynamic_matrix{ i_other };
+        }
+
+        return *this;
+    }
+
+
+    dynamic_matrix& operator=( dynamic_matrix&& i_other ) noexcept
+    {
+        m_rows = std::exchange( i_other.m_rows, 0 );
+        m_columns = std::exchange( i_other.m_columns, 0 );
+        m_stride = std::exchange( i_other.m_stride, 0 );
+        m_data = std::move( i_other.m_data );
+
+        return *this;
+    }
+
+
+    /**
+     * @brief Copy into a fixed-size matrix
+     *
+     * @tparam _Rows Number of rows
+     * @tparam _Columns Number of columns
+     * @return fixed-size matrix
+     * @throw std::invalid_argument if the sizes differ
+     */
+    template<uint64_t _Rows, uint64_t _Columns>
+    matrix<_Rows, _Columns, value_type> fixed() const
+    {
+        if( m_rows != _Rows || m_columns != _Columns )
+        {
+            throw std::invalid_argument{ "Matrix sizes do not match!" };
+        }
+
+        auto mat{ matrix<_Rows, _Columns, value_type>{ false } };
+
+        for( auto i{ 0_ui64 }; i < _Rows; ++i )
+        {
+            std::copy( ( *this )[i], ( *this )[i] + _Columns, mat[i].begin() );
+        }
+
+        return mat;
+    }
+
+
+    /**
+     * @brief Multiply two matrices
+     *
+     * @param i_lhs First matrix
+     * @param i_rhs Second matrix
+     * @return Product of multiplication
+     * @throw std::invalid_argument if the columns of the first matrix are not the rows of the second
+     */
+    friend dynamic_matrix operator*( const dynamic_matrix& i_lhs, const dynamic_matrix& i_rhs )
+    {
+        if( i_lhs.m_columns != i_rhs.m_rows )
+        {
+            throw std::invalid_argument{
+                "Number of columns of first matrix should be equal to number of rows of second matrix!" };
+        }
+
+        auto mat{ dynamic_matrix{ i_lhs.m_rows, i_rhs.m_columns, false } };
+
+        if constexpr( gemm::is_supported_v<value_type> )
+        {
+            parallel::multiply<value_type>( i_lhs.m_rows,
+                                            i_rhs.m_columns,
+                                            i_lhs.m_columns,
+                                            i_lhs.data(),
+                                            i_lhs.m_stride,
+                                            i_rhs.data(),
+                                            i_rhs.m_stride,
+                                            mat.data(),
+                                            mat.m_stride );
+        }
+        else
+        {
+            for( auto i{ 0_ui64 }; i < i_lhs.m_rows; ++i )
+            {
+                for( auto k{ 0_ui64 }; k < i_lhs.m_columns; ++k )
+                {
+                    auto element{ i_lhs[i][k] };
+
+                    for( auto j{ 0_ui64 }; j < i_rhs.m_columns; ++j )
+                    {
+                        mat[i][j] += element * i_rhs[k][j];
+                    }
+                }
+            }
+        }
+
+        return mat;
+    }
+
+
+    /**
+     * @brief Adds two matrices and return the sum
+     *
+     * @param i_lhs First matrix, reused for the result when it is a temporary
+     * @param i_rhs Second matrix
+     * @return Sum of input matrices
+     */
+    friend dynamic_matrix operator+( dynamic_matrix i_lhs, const dynamic_matrix& i_rhs )
+    {
+        i_lhs += i_rhs;
+        return i_lhs;
+    }
+
+
+    /**
+     * @brief Subtracts two matrices and return the result
+     *
+     * @param i_lhs First matrix, reused for the result when it is a temporary
+     * @param i_rhs Second matrix
+     * @return Difference of input matrices
+     */
+    friend dynamic_matrix operator-( dynamic_matrix i_lhs, const dynamic_matrix& i_rhs )
+    {
+        i_lhs -= i_rhs;
+        return i_lhs;
+    }
+
+
+    /**
+     * @brief Adds new matrix to original matrix in place
+     *
+     * @param i_matrix new matrix
+     * @return matrix after addition
+     */
+    dynamic_matrix& operator+=( const dynamic_matrix& i_matrix )
+    {
+        combine( i_matrix, []( auto& i_element, auto i_value ) { i_element += i_value; } );
+        return *this;
+    }
+
+
+    /**
+     * @brief Subtracts new matrix from original matrix in place
+     *
+     * @param i_matrix new matrix
+     * @return resultant matrix
+     */
+    dynamic_matrix& operator-=( const dynamic_matrix& i_matrix )
+    {
+        combine( i_matrix, []( auto& i_element, auto i_value ) { i_element -= i_value; } );
+        return *this;
+    }
+
+
+    /**
+     * @brief Multiply matrix with current matrix
+     *
+     * @param i_matrix new matrix
+     * @return resultant matrix
+     */
+    dynamic_matrix& operator*=( const dynamic_matrix& i_matrix )
+    {
+        check_square();
+        i_matrix.check_square();
+
+        *this = ( *this * i_matrix );
+
+        return *this;
+    }
+
+
+    /**
+     * @brief Check if matrices are equal
+     *
+     * @param i_lhs First matrix
+     * @param i_rhs Second matrix
+     * @return true if matrices have the same size and elements
+     */
+    friend bool operator==( const dynamic_matrix& i_lhs, const dynamic_matrix& i_rhs ) noexcept
+    {
+        if( i_lhs.m_rows != i_rhs.m_rows || i_lhs.m_columns != i_rhs.m_columns )
+        {
+            return false;
+        }
+
+        for( auto i{ 0_ui64 }; i < i_lhs.m_rows; ++i )
+        {
+            if( !std::equal( i_lhs[i], i_lhs[i] + i_lhs.m_columns, i_rhs[i] ) )
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+
+    friend bool operator!=( const dynamic_matrix& i_lhs, const dynamic_matrix& i_rhs ) noexcept
+    {
+        return !( i_lhs == i_rhs );
+    }
+
+
+    /**
+     * @brief Get the row by index
+     *
+     * @param i_row input row index
+     * @return first element of the row
+     */
+    value_type* operator[]( const uint64_t i_row ) noexcept
+    {
+        return m_data.get() + i_row * m_stride;
+    }
+
+
+    const value_type* operator[]( const uint64_t i_row ) const noexcept
+    {
+        return m_data.get() + i_row * m_stride;
+    }
+
+
+    /**
+     * @brief Get element by row and column
+     *
+     * @param i_row input row index
+     * @param i_col input column index
+     * @return element
+     */
+    const value_type& operator()( const uint64_t i_row, const uint64_t i_col ) const noexcept
+    {
+        return m_data.get()[i_row * m_stride + i_col];
+    }
+
+
+    /**
+     * @brief transpose operator
+     *
+     * @return transpose of the matrix
+     */
+    dynamic_matrix operator~() const
+    {
+        auto transpose{ dynamic_matrix{ m_columns, m_rows, false } };
+
+        for( auto i{ 0_ui64 }; i < m_rows; ++i )
+        {
+            for( auto j{ 0_ui64 }; j < m_columns; ++j )
+            {
+                transpose[j][i] = ( *this )[i][j];
+            }
+        }
+
+        return transpose;
+    }
+
+
+    /**
+     * @brief Number of rows in the matrix
+     *
+     * @return number of rows
+     */
+    uint64_t Rows() const noexcept
+    {
+        return m_rows;
+    }
+
+
+    /**
+     * @brief Number of columns in the matrix
+     *
+     * @return number of columns
+     */
+    uint64_t Columns() const noexcept
+    {
+        return m_columns;
+    }
+
+
+    /**
+     * @brief Check if matrix is square
+     *
+     * @return true if matrix is square
+     */
+    bool IsSquare() const noexcept
+    {
+        return m_rows == m_columns;
+    }
+
+
+    /**
+     * @brief Elements from the start of one row to the start of the next
+     *
+     * @return row stride
+     */
+    uint64_t stride() const noexcept
+    {
+        return m_stride;
+    }
+
+
+    value_type* data() noexcept
+    {
+        return m_data.get();
+    }
+
+
+    const value_type* data() const noexcept
+    {
+        return m_data.get();
+    }
+
+
+    /**
+     * @brief Calculate determinant of square matrix
+     *
+     * An LU decomposition over floating point types and fields, Bareiss' fraction-free elimination over the integers
+     * and Euclid's algorithm on the rows over other rings.
+     *
+     * @return Value of determinant
+     * @throw std::invalid_argument if the matrix is not square
+     */
+    value_type determinant() const
+    {
+        if constexpr( ring_traits<value_type>::elimination != elimination_kind::euclidean )
+        {
+            return lu().determinant();
+        }
+        else if constexpr( std::is_integral_v<value_type> )
+        {
+            check_square();
+
+            auto rows{ *this };
+            return elimination::fraction_free_determinant<value_type>( rows, m_rows );
+        }
+        else
+        {
+            check_square();
+
+            auto rows{ *this };
+            return elimination::euclidean_determinant<value_type>( rows, m_rows );
+        }
+    }
+
+
+    /**
+     * @brief LU decomposition with partial pivoting
+     *
+     * @return factors such that the rows of the matrix, permuted, equal L * U
+     * @throw std::invalid_argument if the matrix is not square
+     */
+    dynamic_lu_decomposition<value_type> lu() const
+    {
+        static_assert( ring_traits<value_type>::elimination != elimination_kind::euclidean,
+                       "LU decomposition needs elements that can be divided!" );
+
+        check_square();
+
+        return dynamic_lu_decomposition<value_type>{ *this };
+    }
+
+
+    /**
+     * @brief Solve the system A * X = B, for one right-hand side per column of B
+     *
+     * @param i_rhs right-hand sides
+     * @return solutions, one per column
+     */
+    dynamic_matrix solve( const dynamic_matrix& i_rhs ) const
+    {
+        return lu().solve( i_rhs );
+    }
+
+
+    /**
+     * @brief Calculate the inverse of the matrix by solving A * X = I, or over a ring by Gauss-Jordan elimination with
+     * Euclid's algorithm on the rows
+     *
+     * @return inverse of the matrix
+     * @throw std::domain_error if the matrix is singular, or has no inverse over its ring
+     * @throw std::invalid_argument if the matrix is not square
+     */
+    dynamic_matrix inverse() const
+    {
+        if constexpr( ring_traits<value_type>::elimination == elimination_kind::euclidean )
+        {
+            check_square();
+
+            auto rows{ *this };
+            auto inverse{ dynamic_matrix{ m_rows, m_columns } };
+
+            elimination::euclidean_inverse<value_type>( rows, inverse, m_rows );
+
+            return inverse;
+        }
+        else
+        {
+            auto decomposition{ lu() };
+
+            if( decomposition.singular )
+            {
+                throw std::domain_error{ "Cannot invert a singular matrix!" };
+            }
+
+            return decomposition.solve( dynamic_matrix{ m_rows, m_columns } );
+        }
+    }
+
+    static_assert( ring_traits<value_type>::is_ring, "Contained element needs to be a valid matrix type!" );
+};
+
+
+/**
+ * @brief LU decomposition with partial pivoting of a square dynamic matrix: P * A = L * U
+ *
+ * The same factorisation as lu_decomposition, with the order known at runtime: pivoting on the largest element for
+ * floating point types, on the first non-zero one over exact fields.
+ *
+ * @tparam _T Type of matrix element
+ */
+template<typename _T>
+struct dynamic_lu_decomposition
+{
+    using value_type = _T;
+
+    dynamic_matrix<value_type> factors;
+
+    std::vector<uint64_t> permutation{};  // row of A that ended up in each row of P * A
+
+    bool odd_permutation{ false };
+
+    bool singular{ false };
+
+
+    /**
+     * @brief Decompose a matrix
+     *
+     * @param i_matrix square matrix
+     */
+    explicit dynamic_lu_decomposition( const dynamic_matrix<value_type>& i_matrix ) :
+        factors{ i_matrix }, permutation( i_matrix.Rows() )
+    {
+        auto order{ factors.Rows() };
+
+        for( auto row{ 0_ui64 }; row < order; ++row )
+        {
+            permutation[row] = row;
+        }
+
+        for( auto k{ 0_ui64 }; k < order; ++k )
+        {
+            auto pivot{ k };
+
+            if constexpr( ring_traits<value_type>::elimination == elimination_kind::partial_pivoting )
+            {
+                for( auto row{ k + 1 }; row < order; ++row )
+                {
+                    if( std::abs( factors[row][k] ) > std::abs( factors[pivot][k] ) )
+                    {
+                        pivot = row;
+                    }
+                }
+            }
+            else
+            {
+                while( pivot + 1 < order && factors[pivot][k] == static_cast<value_type>( 0 ) )
+                {
+                    ++pivot;
+                }
+            }
+
+            if( factors[pivot][k] == static_cast<value_type>( 0 ) )
+            {
+                // nothing left to eliminate in this column
+                singular = true;
+                continue;
+            }
+
+            if( pivot != k )
+            {
+                std::swap_ranges( factors[pivot], factors[pivot] + order, factors[k] );
+                std::swap( permutation[pivot], permutation[k] );
+                odd_permutation = !odd_permutation;
+            }
+
+            for( auto row{ k + 1 }; row < order; ++row )
+            {
+                auto multiplier{ factors[row][k] / factors[k][k] };
+                factors[row][k] = multiplier;
+
+                for( auto col{ k + 1 }; col < order; ++col )
+                {
+                    factors[row][col] -= multiplier * factors[k][col];
+                }
+            }
+        }
+    }
+
+
+    /**
+     * @brief Determinant of the decomposed matrix: the product of the pivots, signed by the permutation
+     *
+     * @return Value of determinant
+     */
+    value_type determinant() const noexcept
+    {
+        if( singular )
+        {
+            return static_cast<value_type>( 0 );
+        }
+
+        auto det{ static_cast<value_type>( odd_permutation ? -1 : 1 ) };
+
+        for( auto k{ 0_ui64 }; k < factors.Rows(); ++k )
+        {
+            det *= factors[k][k];
+        }
+
+        return det;
+    }
+
+
+    /**
+     * @brief Solve A * X = B by forward and back substitution, all columns of B together
+     *
+     * @param i_rhs right-hand sides
+     * @return solutions, one per column
+     * @throw std::domain_error if the matrix is singular
+     */
+    dynamic_matrix<value_type> solve( const dynamic_matrix<value_type>& i_rhs ) const
+    {
+        auto order{ factors.Rows() };
+        auto columns{ i_rhs.Columns() };
+
+        if( i_rhs.Rows() != order )
+        {
+            throw std::invalid_argument{ "Right-hand sides should have as many rows as the matrix!" };
+        }
+
+        if( singular )
+        {
+            throw std::domain_error{ "Cannot solve a system with a singular matrix!" };
+        }
+
+        auto solution{ dynamic_matrix<value_type>{ order, columns, false } };
+
+        for( auto row{ 0_ui64 }; row < order; ++row )
+        {
+            std::copy( i_rhs[permutation[row]], i_rhs[permutation[row]] + columns, solution[row] );
+        }
+
+        // row operations over whole rows, so the inner loops run along contiguous memory
+        for( auto row{ 1_ui64 }; row < order; ++row )
+        {
+            for( auto k{ 0_ui64 }; k < row; ++k )
+            {
+                auto multiplier{ factors[row][k] };
+
+                for( auto col{ 0_ui64 }; col < columns; ++col )
+                {
+                    solution[row][col] -= multiplier * solution[k][col];
+                }
+            }
+        }
+
+        for( auto row{ order }; row-- > 0; )
+        {
+            for( auto k{ row + 1 }; k < order; ++k )
+            {
+                auto multiplier{ factors[row][k] };
+
+                for( auto col{ 0_ui64 }; col < columns; ++col )
+                {
+                    solution[row][col] -= multiplier * solution[k][col];
+                }
+            }
+
+            for( auto col{ 0_ui64 }; col < columns; ++col )
+            {
+                solution[row][col] /= factors[row][row];
+            }
+        }
+
+        return solution;
+    }
+};
+
+
+/**
+ * @brief Multiply two dynamic matrices with the classical algorithm, as operator* does
+ *
+ */
+template<typename _T>
+dynamic_matrix<_T> multiply( const dynamic_matrix<_T>& i_lhs, const dynamic_matrix<_T>& i_rhs, classical_policy = {} )
+{
+    return i_lhs * i_rhs;
+}
+
+
+/**
+ * @brief Multiply two dynamic matrices with the Strassen-Winograd recursion when they are square
+ *
+ * @param i_lhs First matrix
+ * @param i_rhs Second matrix
+ * @param io_workspace scratch memory, kept by the caller between products
+ * @param i_policy where the recursion hands over to the blocked kernel
+ * @return Product of multiplication
+ */
+template<typename _T>
+dynamic_matrix<_T> multiply( const dynamic_matrix<_T>& i_lhs,
+                             const dynamic_matrix<_T>& i_rhs,
+                             const strassen_policy& i_policy,
+                             strassen::workspace<_T>& io_workspace = strassen::workspace<_T>::local() )
+{
+    if( !i_lhs.IsSquare() || !i_rhs.IsSquare() || i_lhs.Rows() != i_rhs.Rows() )
+    {
+        return i_lhs * i_rhs;
+    }
+
+    auto mat{ dynamic_matrix<_T>{ i_lhs.Rows(), i_lhs.Rows(), false } };
+
+    strassen::multiply<_T>( i_lhs.Rows(),
+                            i_lhs.data(),
+                            i_lhs.stride(),
+                            i_rhs.data(),
+                            i_rhs.stride(),
+                            mat.data(),
+                            mat.stride(),
+                            i_policy,
+                            io_workspace );
+
+    return mat;
+}
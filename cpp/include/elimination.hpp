@@ -0,0 +1,217 @@
+/**
+ * @file elimination.hpp
+ * @author ashwinn76
+ * @brief Exact elimination over rings, shared by the fixed and the dynamic matrix
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * The routines work on a square block of rows reached as io_rows[row][col], which both a fixed matrix and a dynamic
+ * one provide, and take the order of the block separately. They reduce the block in place, so a caller passes a copy.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <stdexcept>
+
+#include "ring.hpp"
+
+namespace elimination
+{
+/**
+ * @brief Exchange two rows of a block
+ *
+ */
+template<typename _Rows>
+constexpr void swap_rows( _Rows& io_rows, uint64_t i_order, uint64_t i_first, uint64_t i_second ) noexcept
+{
+    for( auto col{ 0_ui64 }; col < i_order; ++col )
+    {
+        auto value{ io_rows[i_first][col] };
+        io_rows[i_first][col] = io_rows[i_second][col];
+        io_rows[i_second][col] = value;
+    }
+}
+
+
+/**
+ * @brief Determinant by Bareiss' elimination, in which every division is exact
+ *
+ * Each step divides by the previous pivot, so the elements stay minors of the matrix and never outgrow the
+ * determinant.
+ *
+ * @tparam _T Type of matrix element
+ * @param io_rows block to reduce
+ * @param i_order rows and columns of the block
+ */
+template<typename _T, typename _Rows>
+constexpr _T fraction_free_determinant( _Rows& io_rows, uint64_t i_order ) noexcept
+{
+    auto previous{ static_cast<_T>( 1 ) };
+    auto negate{ false };
+
+    for( auto k{ 0_ui64 }; k < i_order; ++k )
+    {
+        if( io_rows[k][k] == static_cast<_T>( 0 ) )
+        {
+            auto pivot{ k + 1 };
+
+            while( pivot < i_order && io_rows[pivot][k] == static_cast<_T>( 0 ) )
+            {
+                ++pivot;
+            }
+
+            if( pivot == i_order )
+            {
+                return static_cast<_T>( 0 );
+            }
+
+            swap_rows( io_rows, i_order, pivot, k );
+            negate = !negate;
+        }
+
+        for( auto row{ k + 1 }; row < i_order; ++row )
+        {
+            for( auto col{ k + 1 }; col < i_order; ++col )
+            {
+                io_rows[row][col] =
+                    ( io_rows[row][col] * io_rows[k][k] - io_rows[row][k] * io_rows[k][col] ) / previous;
+            }
+        }
+
+        previous = io_rows[k][k];
+    }
+
+    return negate ? -previous : previous;
+}
+
+
+/**
+ * @brief Clear a column below the diagonal with Euclid's algorithm on whole rows
+ *
+ * The diagonal row ends with a greatest common divisor of the column. Only swaps and adding a multiple of one row to
+ * another are used, so the determinant at most changes sign.
+ *
+ * @tparam _T Type of matrix element
+ * @param io_rows block to reduce
+ * @param io_mirror block that undergoes the same operations, if any
+ * @param i_order rows and columns of the block
+ * @param i_k row and column of the diagonal
+ * @return true if an odd number of swaps was made
+ */
+template<typename _T, typename _Rows>
+constexpr bool euclidean_column( _Rows& io_rows, _Rows* io_mirror, uint64_t i_order, uint64_t i_k )
+{
+    auto odd{ false };
+
+    for( auto row{ i_k + 1 }; row < i_order; ++row )
+    {
+        while( io_rows[row][i_k] != static_cast<_T>( 0 ) )
+        {
+            auto quotient{ ring_traits<_T>::quotient( io_rows[i_k][i_k], io_rows[row][i_k] ) };
+
+            for( auto col{ i_k }; col < i_order; ++col )
+            {
+                io_rows[i_k][col] -= quotient * io_rows[row][col];
+            }
+
+            swap_rows( io_rows, i_order, i_k, row );
+
+            if( io_mirror )
+            {
+                for( auto col{ 0_ui64 }; col < i_order; ++col )
+                {
+                    ( *io_mirror )[i_k][col] -= quotient * ( *io_mirror )[row][col];
+                }
+
+                swap_rows( *io_mirror, i_order, i_k, row );
+            }
+
+            odd = !odd;
+        }
+    }
+
+    return odd;
+}
+
+
+/**
+ * @brief Determinant over a ring: the product of the diagonal Euclid's algorithm leaves, signed by the swaps
+ *
+ * @tparam _T Type of matrix element
+ * @param io_rows block to reduce
+ * @param i_order rows and columns of the block
+ */
+template<typename _T, typename _Rows>
+constexpr _T euclidean_determinant( _Rows& io_rows, uint64_t i_order )
+{
+    auto det{ static_cast<_T>( 1 ) };
+
+    for( auto k{ 0_ui64 }; k < i_order; ++k )
+    {
+        if( euclidean_column<_T>( io_rows, static_cast<_Rows*>( nullptr ), i_order, k ) )
+        {
+            det = -det;
+        }
+
+        det *= io_rows[k][k];
+    }
+
+    return det;
+}
+
+
+/**
+ * @brief Inverse over a ring by Gauss-Jordan elimination, Euclid's algorithm finding each pivot
+ *
+ * The pivots multiply to the determinant up to sign, so they are all units exactly when the inverse exists.
+ *
+ * @tparam _T Type of matrix element
+ * @param io_rows block to reduce to the identity
+ * @param io_inverse identity on entry, the inverse on return
+ * @param i_order rows and columns of the block
+ * @throw std::domain_error if the block has no inverse over its ring
+ */
+template<typename _T, typename _Rows>
+constexpr void euclidean_inverse( _Rows& io_rows, _Rows& io_inverse, uint64_t i_order )
+{
+    using traits = ring_traits<_T>;
+
+    for( auto k{ 0_ui64 }; k < i_order; ++k )
+    {
+        euclidean_column<_T>( io_rows, &io_inverse, i_order, k );
+
+        if( !traits::is_unit( io_rows[k][k] ) )
+        {
+            throw std::domain_error{ "Cannot invert a singular matrix!" };
+        }
+
+        auto scale{ traits::unit_inverse( io_rows[k][k] ) };
+
+        for( auto col{ 0_ui64 }; col < i_order; ++col )
+        {
+            io_rows[k][col] *= scale;
+            io_inverse[k][col] *= scale;
+        }
+
+        for( auto row{ 0_ui64 }; row < i_order; ++row )
+        {
+            auto factor{ io_rows[row][k] };
+
+            if( row == k || factor == static_cast<_T>( 0 ) )
+            {
+                continue;
+            }
+
+            for( auto col{ 0_ui64 }; col < i_order; ++col )
+            {
+                io_rows[row][col] -= factor * io_rows[k][col];
+                io_inverse[row][col] -= factor * io_inverse[k][col];
+            }
+        }
+    }
+}
+
+}
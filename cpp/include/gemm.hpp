@@ -0,0 +1,415 @@
+/**
+ * @file gemm.hpp
+ * @author ashwinn76
+ * @brief Cache-blocked, register-tiled matrix multiplication kernels for float and double
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * The product is computed the way optimised BLAS libraries do it. Blocks of the right operand of kc x nc elements
+ * are packed into panels nr columns wide, and blocks of the left operand of mc x kc elements into panels mr rows tall,
+ * so that the micro-kernel reads both from contiguous memory: a packed left block sits in L2, a panel of the right
+ * block in L1. The micro-kernel keeps an mr x nr tile of the result in vector registers for the whole kc loop and does
+ * one broadcast and nr / lanes fused multiply-adds per left element. Panels are zero padded, so the kernel always runs
+ * a full tile and only the write-back looks at the edges.
+ *
+ * On x86-64 the AVX-512 and AVX2 + FMA kernels are compiled alongside the baseline one and picked at run time, so the
+ * build does not need -march flags. Elsewhere, and with compilers without GNU vector extensions, the 16-byte kernel or
+ * a plain loop is used.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+#include "macro_utils.hpp"
+
+#if( defined __GNUC__ || defined __clang__ )
+#    define __GEMM_VECTOR_EXTENSIONS
+#    define __GEMM_INLINE __attribute__( ( always_inline ) ) inline
+#    define __GEMM_UNROLL _Pragma( "GCC unroll 16" )
+#endif
+
+namespace gemm
+{
+/**
+ * @brief Element types the blocked kernels handle
+ *
+ */
+template<typename _T>
+constexpr auto is_supported_v = std::is_same_v<_T, float> || std::is_same_v<_T, double>;
+
+constexpr auto small_product_size = 512_ui64;  // multiply-adds up to which a plain loop beats packing the operands
+
+
+#ifdef __GEMM_VECTOR_EXTENSIONS
+/**
+ * @brief Register tile and cache block sizes for an element type and a vector width in bytes
+ *
+ */
+template<typename _T, std::size_t _Bytes>
+struct shape
+{
+    typedef _T vector_t __attribute__( ( vector_size( _Bytes ) ) );
+
+    static constexpr auto lanes = _Bytes / sizeof( _T );
+
+    static constexpr auto vectors = 2_sz;  // vectors per tile row
+
+    static constexpr auto nr = lanes * vectors;
+
+    static constexpr auto mr = _Bytes == 64 ? 8_sz : _Bytes == 32 ? 6_sz : 4_sz;  // 16, 12 or 8 of 32 or 16 registers
+
+    static constexpr auto kc = 16 * 1024 / ( nr * sizeof( _T ) );  // a right panel takes half of a 32 KiB L1
+
+    static constexpr auto mc = mr * ( 128 * 1024 / ( mr * kc * sizeof( _T ) ) );  // a left block takes ~128 KiB of L2
+
+    static constexpr auto nc = nr * 256;
+};
+
+
+/**
+ * @brief Multiply a packed mr x kc left panel by a packed kc x nr right panel and add the tile to the result
+ *
+ * @param i_rows rows of the tile inside the result
+ * @param i_columns columns of the tile inside the result
+ */
+template<typename _T, std::size_t _Bytes>
+__GEMM_INLINE void micro_kernel( std::size_t i_kc,
+                                 const _T* i_a,
+                                 const _T* i_b,
+                                 _T* io_c,
+                                 std::size_t i_ldc,
+                                 std::size_t i_rows,
+                                 std::size_t i_columns ) noexcept
+{
+    using shape_t = shape<_T, _Bytes>;
+    using vector_t = typename shape_t::vector_t;
+
+    constexpr auto mr = shape_t::mr;
+    constexpr auto nr = shape_t::nr;
+    constexpr auto lanes = shape_t::lanes;
+    constexpr auto vectors = shape_t::vectors;
+
+    vector_t accumulators[mr][vectors]{};
+
+    for( auto p{ 0_sz }; p < i_kc; ++p, i_a += mr, i_b += nr )
+    {
+        vector_t b[vectors];
+
+        __GEMM_UNROLL
+        for( auto v{ 0_sz }; v < vectors; ++v )
+        {
+            std::memcpy( &b[v], i_b + v * lanes, _Bytes );
+        }
+
+        __GEMM_UNROLL
+        for( auto i{ 0_sz }; i < mr; ++i )
+        {
+            auto a{ i_a[i] };
+
+            __GEMM_UNROLL
+            for( auto v{ 0_sz }; v < vectors; ++v )
+            {
+                accumulators[i][v] += b[v] * a;
+            }
+        }
+    }
+
+    if( i_rows == mr && i_columns == nr )
+    {
+        __GEMM_UNROLL
+        for( auto i{ 0_sz }; i < mr; ++i )
+        {
+            __GEMM_UNROLL
+            for( auto v{ 0_sz }; v < vectors; ++v )
+            {
+                vector_t c;
+                std::memcpy( &c, io_c + i * i_ldc + v * lanes, _Bytes );
+                c += accumulators[i][v];
+                std::memcpy( io_c + i * i_ldc + v * lanes, &c, _Bytes );
+            }
+        }
+    }
+    else
+    {
+        _T tile[mr][nr];
+        std::memcpy( tile, accumulators, sizeof( tile ) );
+
+        for( auto i{ 0_sz }; i < i_rows; ++i )
+        {
+            for( auto j{ 0_sz }; j < i_columns; ++j )
+            {
+                io_c[i * i_ldc + j] += tile[i][j];
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief Copy a kc x nc block of the right operand into panels of nr columns, row after row within a panel
+ *
+ */
+template<typename _T, std::size_t _Nr>
+__GEMM_INLINE void pack_right( std::size_t i_kc, std::size_t i_nc, const _T* i_b, std::size_t i_ldb, _T* o_packed )
+{
+    for( auto jr{ 0_sz }; jr < i_nc; jr += _Nr )
+    {
+        auto columns{ std::min( _Nr, i_nc - jr ) };
+
+        for( auto p{ 0_sz }; p < i_kc; ++p, o_packed += _Nr )
+        {
+            auto row{ i_b + p * i_ldb + jr };
+
+            for( auto j{ 0_sz }; j < _Nr; ++j )
+            {
+                o_packed[j] = j < columns ? row[j] : _T{};
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief Copy an mc x kc block of the left operand into panels of mr rows, column after column within a panel
+ *
+ */
+template<typename _T, std::size_t _Mr>
+__GEMM_INLINE void pack_left( std::size_t i_mc, std::size_t i_kc, const _T* i_a, std::size_t i_lda, _T* o_packed )
+{
+    for( auto ir{ 0_sz }; ir < i_mc; ir += _Mr )
+    {
+        auto rows{ std::min( _Mr, i_mc - ir ) };
+
+        for( auto p{ 0_sz }; p < i_kc; ++p, o_packed += _Mr )
+        {
+            for( auto i{ 0_sz }; i < _Mr; ++i )
+            {
+                o_packed[i] = i < rows ? i_a[( ir + i ) * i_lda + p] : _T{};
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief Per-thread packing buffers, kept between products and only grown, never cleared: packing writes every element
+ * the kernel reads
+ *
+ */
+template<typename _T>
+struct buffers
+{
+    std::unique_ptr<_T[]> left{};
+    std::unique_ptr<_T[]> right{};
+
+    std::size_t left_size{ 0_sz };
+    std::size_t right_size{ 0_sz };
+
+
+    static _T* reserve( std::unique_ptr<_T[]>& io_buffer, std::size_t& io_size, std::size_t i_size )
+    {
+        if( io_size < i_size )
+        {
+            io_buffer.reset( new _T[i_size] );
+            io_size = i_size;
+        }
+
+        return io_buffer.get();
+    }
+
+
+    static buffers& local()
+    {
+        thread_local auto instance{ buffers{} };
+        return instance;
+    }
+};
+
+
+/**
+ * @brief The five loops around the micro-kernel, for one vector width
+ *
+ */
+template<typename _T, std::size_t _Bytes>
+__GEMM_INLINE void blocked_multiply( std::size_t i_m,
+                                     std::size_t i_n,
+                                     std::size_t i_k,
+                                     const _T* i_a,
+                                     std::size_t i_lda,
+                                     const _T* i_b,
+                                     std::size_t i_ldb,
+                                     _T* o_c,
+                                     std::size_t i_ldc )
+{
+    using shape_t = shape<_T, _Bytes>;
+
+    // blocks as large as this product needs, with the panels rounded up to whole register tiles
+    auto panel_depth{ std::min( shape_t::kc, i_k ) };
+    auto left_rows{ ( std::min( shape_t::mc, i_m ) + shape_t::mr - 1 ) / shape_t::mr * shape_t::mr };
+    auto right_columns{ ( std::min( shape_t::nc, i_n ) + shape_t::nr - 1 ) / shape_t::nr * shape_t::nr };
+
+    auto& packed{ buffers<_T>::local() };
+    auto left{ buffers<_T>::reserve( packed.left, packed.left_size, left_rows * panel_depth ) };
+    auto right{ buffers<_T>::reserve( packed.right, packed.right_size, panel_depth * right_columns ) };
+
+    for( auto i{ 0_sz }; i < i_m; ++i )
+    {
+        std::fill_n( o_c + i * i_ldc, i_n, _T{} );
+    }
+
+    for( auto jc{ 0_sz }; jc < i_n; jc += shape_t::nc )
+    {
+        auto nc{ std::min( shape_t::nc, i_n - jc ) };
+
+        for( auto pc{ 0_sz }; pc < i_k; pc += shape_t::kc )
+        {
+            auto kc{ std::min( shape_t::kc, i_k - pc ) };
+
+            pack_right<_T, shape_t::nr>( kc, nc, i_b + pc * i_ldb + jc, i_ldb, right );
+
+            for( auto ic{ 0_sz }; ic < i_m; ic += shape_t::mc )
+            {
+                auto mc{ std::min( shape_t::mc, i_m - ic ) };
+
+                pack_left<_T, shape_t::mr>( mc, kc, i_a + ic * i_lda + pc, i_lda, left );
+
+                for( auto jr{ 0_sz }; jr < nc; jr += shape_t::nr )
+                {
+                    for( auto ir{ 0_sz }; ir < mc; ir += shape_t::mr )
+                    {
+                        micro_kernel<_T, _Bytes>( kc,
+                                                  left + ir * kc,
+                                                  right + jr * kc,
+                                                  o_c + ( ic + ir ) * i_ldc + jc + jr,
+                                                  i_ldc,
+                                                  std::min( shape_t::mr, mc - ir ),
+                                                  std::min( shape_t::nr, nc - jr ) );
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+template<typename _T>
+void multiply_128( std::size_t i_m,
+                   std::size_t i_n,
+                   std::size_t i_k,
+                   const _T* i_a,
+                   std::size_t i_lda,
+                   const _T* i_b,
+                   std::size_t i_ldb,
+                   _T* o_c,
+                   std::size_t i_ldc )
+{
+    blocked_multiply<_T, 16>( i_m, i_n, i_k, i_a, i_lda, i_b, i_ldb, o_c, i_ldc );
+}
+
+
+#    if defined __x86_64__
+template<typename _T>
+__attribute__( ( target( "avx2,fma" ) ) ) void multiply_256( std::size_t i_m,
+                                                            std::size_t i_n,
+                                                            std::size_t i_k,
+                                                            const _T* i_a,
+                                                            std::size_t i_lda,
+                                                            const _T* i_b,
+                                                            std::size_t i_ldb,
+                                                            _T* o_c,
+                                                            std::size_t i_ldc )
+{
+    blocked_multiply<_T, 32>( i_m, i_n, i_k, i_a, i_lda, i_b, i_ldb, o_c, i_ldc );
+}
+
+
+template<typename _T>
+__attribute__( ( target( "avx512f" ) ) ) void multiply_512( std::size_t i_m,
+                                                           std::size_t i_n,
+                                                           std::size_t i_k,
+                                                           const _T* i_a,
+                                                           std::size_t i_lda,
+                                                           const _T* i_b,
+                                                           std::size_t i_ldb,
+                                                           _T* o_c,
+                                                           std::size_t i_ldc )
+{
+    blocked_multiply<_T, 64>( i_m, i_n, i_k, i_a, i_lda, i_b, i_ldb, o_c, i_ldc );
+}
+#    endif
+
+
+/**
+ * @brief Widest kernel the processor runs
+ *
+ */
+template<typename _T>
+auto select_kernel() noexcept
+{
+#    if defined __x86_64__
+    __builtin_cpu_init();
+
+    if( __builtin_cpu_supports( "avx512f" ) )
+    {
+        return &multiply_512<_T>;
+    }
+
+    if( __builtin_cpu_supports( "avx2" ) && __builtin_cpu_supports( "fma" ) )
+    {
+        return &multiply_256<_T>;
+    }
+#    endif
+
+    return &multiply_128<_T>;
+}
+#endif
+
+
+/**
+ * @brief Row-major product C = A * B of an m x k and a k x n matrix, each row i_ld* elements after the previous one
+ *
+ */
+template<typename _T>
+void multiply( std::size_t i_m,
+               std::size_t i_n,
+               std::size_t i_k,
+               const _T* i_a,
+               std::size_t i_lda,
+               const _T* i_b,
+               std::size_t i_ldb,
+               _T* o_c,
+               std::size_t i_ldc )
+{
+    static_assert( is_supported_v<_T>, "Blocked products are only implemented for float and double!" );
+
+#ifdef __GEMM_VECTOR_EXTENSIONS
+    static const auto kernel{ select_kernel<_T>() };
+
+    kernel( i_m, i_n, i_k, i_a, i_lda, i_b, i_ldb, o_c, i_ldc );
+#else
+    for( auto i{ 0_sz }; i < i_m; ++i )
+    {
+        auto row{ o_c + i * i_ldc };
+        std::fill_n( row, i_n, _T{} );
+
+        for( auto p{ 0_sz }; p < i_k; ++p )
+        {
+            auto a{ i_a[i * i_lda + p] };
+
+            for( auto j{ 0_sz }; j < i_n; ++j )
+            {
+                row[j] += a * i_b[p * i_ldb + j];
+            }
+        }
+    }
+#endif
+}
+
+}
@@ -23,6 +23,15 @@
 #    define __CONCEPTS
 #endif
 
+// true while a constexpr function is being evaluated by the compiler; without a way to tell, always true
+#if defined __cpp_lib_is_constant_evaluated
+#    define __IS_CONSTANT_EVALUATED() std::is_constant_evaluated()
+#elif( defined __GNUC__ && __GNUC__ >= 9 ) || ( defined __clang__ && __clang_major__ >= 9 )
+#    define __IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#else
+#    define __IS_CONSTANT_EVALUATED() true
+#endif
+
 #define UNSIGNED_CONVERTER( x ) \
     __CONSTEVAL auto operator"" _ui##x( unsigned long long __n ) noexcept \
     { \
@@ -46,4 +55,4 @@ __CONSTEVAL std::size_t operator"" _sz( unsigned long long __n ) noexcept
     return static_cast<std::size_t>( __n );
 }
 
-#define RAW( X ) std::remove_reference_t<std::remove_cv_t<X>>
+#define RAW( X ) std::remove_cv_t<std::remove_reference_t<X>>
@@ -12,9 +12,164 @@
 #pragma once
 
 #include <array>
+#include <functional>
+#include <stdexcept>
 
+#include "elimination.hpp"
+#include "ring.hpp"
+#include "strassen.hpp"
 #include "type_trait_utils.hpp"
 
+template<uint64_t _Order, typename _T>
+struct lu_decomposition;
+
+template<typename _Lhs, typename _Rhs, typename _Operation>
+class matrix_expression;
+
+
+template<uint64_t _Rows, uint64_t _Columns, typename _T>
+class matrix;
+
+template<uint64_t _Rows, uint64_t _Columns, typename _Matrix, bool _Transposed>
+class matrix_view;
+
+template<uint64_t _Rows, uint64_t _Columns, typename _Matrix>
+class indexed_view;
+
+template<typename _Operand>
+constexpr bool views_storage( const _Operand& i_operand, const void* i_storage ) noexcept;
+
+template<typename _Lhs, typename _Rhs>
+constexpr auto multiply_in_place( const _Lhs& i_lhs, const _Rhs& i_rhs );
+
+
+/**
+ * @brief Type trait to check if a type can be an operand of an element-wise expression: a matrix or an expression
+ *
+ * @tparam _T Type to check
+ */
+template<typename _T>
+struct is_matrix_operand : std::false_type
+{
+};
+
+template<uint64_t _Rows, uint64_t _Columns, typename _T>
+struct is_matrix_operand<matrix<_Rows, _Columns, _T>> : std::true_type
+{
+};
+
+template<typename _Lhs, typename _Rhs, typename _Operation>
+struct is_matrix_operand<matrix_expression<_Lhs, _Rhs, _Operation>> : std::true_type
+{
+};
+
+template<uint64_t _Rows, uint64_t _Columns, typename _Matrix, bool _Transposed>
+struct is_matrix_operand<matrix_view<_Rows, _Columns, _Matrix, _Transposed>> : std::true_type
+{
+};
+
+template<uint64_t _Rows, uint64_t _Columns, typename _Matrix>
+struct is_matrix_operand<indexed_view<_Rows, _Columns, _Matrix>> : std::true_type
+{
+};
+
+template<typename _T>
+constexpr auto inline is_matrix_operand_v = is_matrix_operand<RAW( _T )>::value;
+
+
+/**
+ * @brief Type trait to check if a type is a lazy element-wise expression
+ *
+ * @tparam _T Type to check
+ */
+template<typename _T>
+struct is_matrix_expression : std::false_type
+{
+};
+
+template<typename _Lhs, typename _Rhs, typename _Operation>
+struct is_matrix_expression<matrix_expression<_Lhs, _Rhs, _Operation>> : std::true_type
+{
+};
+
+template<typename _T>
+constexpr auto inline is_matrix_expression_v = is_matrix_expression<RAW( _T )>::value;
+
+
+/**
+ * @brief Type trait to check if a type is a non-owning view of a matrix
+ *
+ * @tparam _T Type to check
+ */
+template<typename _T>
+struct is_matrix_view : std::false_type
+{
+};
+
+template<uint64_t _Rows, uint64_t _Columns, typename _Matrix, bool _Transposed>
+struct is_matrix_view<matrix_view<_Rows, _Columns, _Matrix, _Transposed>> : std::true_type
+{
+};
+
+template<uint64_t _Rows, uint64_t _Columns, typename _Matrix>
+struct is_matrix_view<indexed_view<_Rows, _Columns, _Matrix>> : std::true_type
+{
+};
+
+template<typename _T>
+constexpr auto inline is_matrix_view_v = is_matrix_view<RAW( _T )>::value;
+
+
+/**
+ * @brief Type trait to check if a type is an operand that is not a matrix: an expression or a view
+ *
+ * @tparam _T Type to check
+ */
+template<typename _T>
+constexpr auto inline is_lazy_operand_v = is_matrix_expression_v<_T> || is_matrix_view_v<_T>;
+
+
+/**
+ * @brief Type trait to check if a type keeps its rows in place, one after another at a fixed distance
+ *
+ * @tparam _T Type to check
+ */
+template<typename _T>
+struct has_row_storage : std::false_type
+{
+};
+
+template<uint64_t _Rows, uint64_t _Columns, typename _T>
+struct has_row_storage<matrix<_Rows, _Columns, _T>> : std::true_type
+{
+};
+
+template<uint64_t _Rows, uint64_t _Columns, typename _Matrix>
+struct has_row_storage<matrix_view<_Rows, _Columns, _Matrix, false>> : std::true_type
+{
+};
+
+template<typename _T>
+constexpr auto inline has_row_storage_v = has_row_storage<RAW( _T )>::value;
+
+
+/**
+ * @brief Check that a view starting at an offset, of a size, lies inside a matrix or view of a size, along one axis
+ *
+ * @param i_offset first row or column of the view
+ * @param i_size rows or columns of the view
+ * @param i_limit rows or columns of what is viewed
+ * @throw std::out_of_range if the view reaches past the end
+ */
+constexpr void check_extent( uint64_t i_offset, uint64_t i_size, uint64_t i_limit )
+{
+    if( i_offset > i_limit || i_size > i_limit - i_offset )
+    {
+        throw std::out_of_range{ "View has to lie inside the matrix!" };
+    }
+}
+
+
 /**
  * @brief Generic matrix class
  *
@@ -28,6 +183,8 @@ class matrix
 private:
     std::array<std::array<_T, _Columns>, _Rows> m_array{};
 
+    static constexpr auto small_parallel_size = 1_ui64 << 14;  // elements below which element-wise work stays inline
+
 public:
     using value_type = _T;
 
@@ -143,35 +300,42 @@ public:
 
 
     /**
-     * @brief Generic binary operator
+     * @brief Evaluate a lazy element-wise expression, or copy a view, into a new matrix
      *
-     * @tparam _Nr Number of rows in the second matrix
-     * @tparam _Nc Number of columns in the second matrix
-     * @tparam _Predicate Binary Predicate Type
-     * @param i_lhs First matrix
-     * @param i_rhs Second matrix
-     * @param binary_p Binary predicate
-     * @return Binary operation result
+     * @tparam _Operand Type of the expression or view
+     * @param i_operand expression or view of the same shape
      */
-    template<uint64_t _Nr, uint64_t _Nc, typename _Predicate>
-    friend constexpr auto basic_binary_operator( const matrix& i_lhs,
-                                                 const matrix<_Nr, _Nc, value_type>& i_rhs,
-                                                 _Predicate&& binary_p ) noexcept
+    template<typename _Operand,
+             typename = std::enable_if_t<is_matrix_expression_v<_Operand> || is_matrix_view_v<_Operand>>>
+    constexpr matrix( const _Operand& i_operand ) noexcept
     {
-        static_assert( Rows() == _Nr, "Both matrices should have same number of rows!" );
-        static_assert( Columns() == _Nc, "Both matrices should have same number of columns!" );
+        assign( i_operand, []( auto&& i_element, auto&& i_value ) { i_element = i_value; } );
+    }
 
-        auto newMat{ matrix{} };
 
-        for( auto i{ 0_ui64 }; i < Rows(); i++ )
+    /**
+     * @brief Evaluate a lazy element-wise expression, or copy a view, straight into the matrix
+     *
+     * The matrix itself may appear in the expression, since every element of the result only reads the same element
+     * of it. A view of the matrix may read other elements, as a transpose does, so an operand holding one is
+     * evaluated into a temporary first.
+     *
+     * @tparam _Operand Type of the expression or view
+     * @param i_operand expression or view of the same shape
+     * @return this matrix
+     */
+    template<typename _Operand,
+             typename = std::enable_if_t<is_matrix_expression_v<_Operand> || is_matrix_view_v<_Operand>>>
+    constexpr matrix& operator=( const _Operand& i_operand ) noexcept
+    {
+        if( views_storage( i_operand, this ) )
         {
-            for( auto j{ 0_ui64 }; j < Columns(); j++ )
-            {
-                newMat[i][j] = binary_p( i_lhs[i][j], i_rhs[i][j] );
-            }
+            return *this = matrix( i_operand );
         }
 
-        return newMat;
+        assign( i_operand, []( auto&& i_element, auto&& i_value ) { i_element = i_value; } );
+
+        return *this;
     }
 
 
@@ -183,22 +347,37 @@ public:
      * @param i_lhs First matrix
      * @param i_rhs Second matrix
      * @return Product of multiplication
+     * @throw std::bad_alloc if a large product cannot allocate its packing buffers
      */
     template<uint64_t _Nr, uint64_t _Nc>
-    friend constexpr auto operator*( const matrix& i_lhs, const matrix<_Nr, _Nc, value_type>& i_rhs ) noexcept
+    friend constexpr auto operator*( const matrix& i_lhs, const matrix<_Nr, _Nc, value_type>& i_rhs )
     {
         static_assert( Columns() == _Nr,
                        "Number of columns of first matrix should be equal to number of rows of second matrix!" );
 
         auto mat{ matrix<Rows(), _Nc, value_type>{ 0 } };
 
+        if constexpr( gemm::is_supported_v<value_type> && Rows() * Columns() * _Nc > gemm::small_product_size )
+        {
+            if( !__IS_CONSTANT_EVALUATED() )
+            {
+                parallel::multiply<value_type>(
+                    Rows(), _Nc, Columns(), i_lhs[0].data(), Columns(), i_rhs[0].data(), _Nc, mat[0].data(), _Nc );
+
+                return mat;
+            }
+        }
+
+        // i-k-j order walks both matrices along rows; with every bound a constant, small products unroll completely
         for( auto i{ 0_ui64 }; i < Rows(); ++i )
         {
-            for( auto j{ 0_ui64 }; j < _Nc; ++j )
+            for( auto k{ 0_ui64 }; k < Columns(); ++k )
             {
-                for( auto k{ 0_ui64 }; k < Columns(); ++k )
+                auto element{ i_lhs[i][k] };
+
+                for( auto j{ 0_ui64 }; j < _Nc; ++j )
                 {
-                    mat[i][j] += ( i_lhs[i][k] * i_rhs[k][j] );
+                    mat[i][j] += ( element * i_rhs[k][j] );
                 }
             }
         }
@@ -208,78 +387,46 @@ public:
 
 
     /**
-     * @brief Adds two matrices and return the sum
-     *
-     * @tparam _Nr Number of rows in the second matrix
-     * @tparam _Nc Number of columns in the second matrix
-     * @param i_lhs First matrix
-     * @param i_rhs Second matrix
-     * @return Sum of input matrices
-     */
-    template<uint64_t _Nr, uint64_t _Nc>
-    friend constexpr auto operator+( const matrix& i_lhs, const matrix<_Nr, _Nc, value_type>& i_rhs ) noexcept
-    {
-        static_assert( Rows() == _Nr, "Both matrices should have same number of rows!" );
-        static_assert( Columns() == _Nc, "Both matrices should have same number of columns!" );
-
-        return basic_binary_operator( i_lhs, i_rhs, []( auto&& l_ele, auto&& r_ele ) { return l_ele + r_ele; } );
-    }
-
-
-    /**
-     * @brief Subtracts two matrices and return the result
+     * @brief Adds new matrix, element-wise expression or view to original matrix in place
      *
-     * @tparam _Nr Number of rows in the second matrix
-     * @tparam _Nc Number of columns in the second matrix
-     * @param i_lhs First matrix
-     * @param i_rhs Second matrix
-     * @return Difference of input matrices
-     */
-    template<uint64_t _Nr, uint64_t _Nc>
-    friend constexpr auto operator-( const matrix& i_lhs, const matrix<_Nr, _Nc, value_type>& i_rhs ) noexcept
-    {
-        static_assert( Rows() == _Nr, "Both matrices should have same number of rows!" );
-        static_assert( Columns() == _Nc, "Both matrices should have same number of columns!" );
-
-        return basic_binary_operator( i_lhs, i_rhs, []( auto&& l_ele, auto&& r_ele ) { return l_ele - r_ele; } );
-    }
-
-
-    /**
-     * @brief Adds new matrix to original matrix
+     * An operand holding a view of this matrix is evaluated into a temporary first.
      *
-     * @tparam _Nr Number of rows in the second matrix
-     * @tparam _Nc Number of columns in the second matrix
-     * @param i_matrix new matrix
+     * @tparam _Operand Type of the matrix, expression or view
+     * @param i_operand new matrix, expression or view
      * @return matrix after addition
      */
-    template<uint64_t _Nr, uint64_t _Nc>
-    constexpr auto operator+=( const matrix<_Nr, _Nc, value_type>& i_matrix ) noexcept
+    template<typename _Operand, typename = std::enable_if_t<is_matrix_operand_v<_Operand>>>
+    constexpr matrix& operator+=( const _Operand& i_operand ) noexcept
     {
-        static_assert( Rows() == _Nr, "Both matrices should have same number of rows!" );
-        static_assert( Columns() == _Nc, "Both matrices should have same number of columns!" );
+        if( views_storage( i_operand, this ) )
+        {
+            return *this += matrix( i_operand );
+        }
 
-        *this = ( *this + i_matrix );
+        assign( i_operand, []( auto&& i_element, auto&& i_value ) { i_element += i_value; } );
 
         return *this;
     }
 
 
     /**
-     * @brief Subtracts new matrix from original matrix
+     * @brief Subtracts new matrix, element-wise expression or view from original matrix in place
      *
-     * @tparam _Nr Number of rows in the second matrix
-     * @tparam _Nc Number of columns in the second matrix
-     * @param i_matrix new matrix
+     * An operand holding a view of this matrix is evaluated into a temporary first.
+     *
+     * @tparam _Operand Type of the matrix, expression or view
+     * @param i_operand new matrix, expression or view
      * @return resultant matrix
      */
-    template<uint64_t _Nr, uint64_t _Nc>
-    constexpr auto operator-=( const matrix<_Nr, _Nc, value_type>& i_matrix ) noexcept
+    template<typename _Operand, typename = std::enable_if_t<is_matrix_operand_v<_Operand>>>
+    constexpr matrix& operator-=( const _Operand& i_operand ) noexcept
     {
-        static_assert( Rows() == _Nr, "Both matrices should have same number of rows!" );
-        static_assert( Columns() == _Nc, "Both matrices should have same number of columns!" );
+        if( views_storage( i_operand, this ) )
+        {
+            return *this -= matrix( i_operand );
+        }
 
-        *this = ( *this - i_matrix );
+        assign( i_operand, []( auto&& i_element, auto&& i_value ) { i_element -= i_value; } );
 
         return *this;
     }
@@ -292,9 +439,10 @@ public:
      * @tparam _Nc Number of columns in the second matrix
      * @param i_matrix new matrix
      * @return resultant matrix
+     * @throw std::bad_alloc if a large product cannot allocate its packing buffers
      */
     template<uint64_t _Nr, uint64_t _Nc>
-    constexpr auto operator*=( const matrix<_Nr, _Nc, value_type>& i_matrix ) noexcept
+    constexpr auto operator*=( const matrix<_Nr, _Nc, value_type>& i_matrix )
     {
         static_assert( matrix::IsSquare(), "Original matrix needs to be a square matrix!" );
         static_assert( RAW( decltype( i_matrix ) )::IsSquare(), "Input matrix needs to be a square matrix!" );
@@ -383,6 +531,52 @@ public:
     }
 
 
+    /**
+     * @brief Get element by row and column, the way expressions read their operands
+     *
+     * @param i_row input row index
+     * @param i_col input column index
+     * @return element
+     */
+    constexpr const value_type& operator()( const uint64_t i_row, const uint64_t i_col ) const noexcept
+    {
+        return m_array[i_row][i_col];
+    }
+
+
+    /**
+     * @brief First element, the rows following one after another
+     *
+     * @return pointer to the first element
+     */
+    constexpr value_type* data() noexcept
+    {
+        return m_array[0].data();
+    }
+
+
+    /**
+     * @brief First element of a constant matrix
+     *
+     * @return pointer to the first element
+     */
+    constexpr const value_type* data() const noexcept
+    {
+        return m_array[0].data();
+    }
+
+
+    /**
+     * @brief Distance in elements between the starts of two rows
+     *
+     * @return distance between rows
+     */
+    __CONSTEVAL static auto stride() noexcept
+    {
+        return Columns();
+    }
+
+
     /**
      * @brief transpose operator
      *
@@ -438,157 +632,1675 @@ public:
 
 
     /**
-     * @brief Elements leftover after excluding a row and column
+     * @brief View of one row, without copying
      *
-     * @param i_row Row to exclude
-     * @param i_col Column to exclude
-     * @return matrix form of leftover elements
+     * @param i_row input row index
+     * @return view of the row
+     * @throw std::out_of_range if the row is not in the matrix
      */
-    constexpr auto leftover_elements( uint64_t i_row, uint64_t i_col ) const noexcept
+    constexpr auto row( uint64_t i_row )
     {
-        static_assert( IsSquare() && Rows() > 2_ui64, "matrix has to be a square matrix of minimum order 3" );
+        return matrix_view<1, Columns(), matrix, false>{ *this, i_row, 0 };
+    }
 
-        constexpr auto new_rows = Rows() - 1_ui64;
-        constexpr auto new_cols = Columns() - 1_ui64;
 
-        auto leftover_eles{ std::array<value_type, new_rows * new_cols>{} };
+    /**
+     * @brief View of one row of a constant matrix, without copying
+     *
+     * @param i_row input row index
+     * @return view of the row
+     * @throw std::out_of_range if the row is not in the matrix
+     */
+    constexpr auto row( uint64_t i_row ) const
+    {
+        return matrix_view<1, Columns(), const matrix, false>{ *this, i_row, 0 };
+    }
 
-        auto iter{ leftover_eles.begin() };
 
-        for( auto r{ 0_ui64 }; r < Rows(); ++r )
-        {
-            for( auto c{ 0_ui64 }; c < Columns(); ++c )
-            {
-                if( r != i_row && c != i_col )
-                {
-                    *iter = m_array[r][c];
-                    ++iter;
-                }
-            }
-        }
+    /**
+     * @brief View of one column, without copying
+     *
+     * @param i_col input column index
+     * @return view of the column
+     * @throw std::out_of_range if the column is not in the matrix
+     */
+    constexpr auto column( uint64_t i_col )
+    {
+        return matrix_view<Rows(), 1, matrix, false>{ *this, 0, i_col };
+    }
 
-        return matrix<new_rows, new_cols, value_type>{ leftover_eles.begin(), leftover_eles.end() };
+
+    /**
+     * @brief View of one column of a constant matrix, without copying
+     *
+     * @param i_col input column index
+     * @return view of the column
+     * @throw std::out_of_range if the column is not in the matrix
+     */
+    constexpr auto column( uint64_t i_col ) const
+    {
+        return matrix_view<Rows(), 1, const matrix, false>{ *this, 0, i_col };
     }
 
 
     /**
-     * @brief Calculate determinant of square matrix
+     * @brief View of a block of adjacent rows and columns, without copying
      *
-     * @return Value of determinant
+     * @tparam _Nr Number of rows in the block
+     * @tparam _Nc Number of columns in the block
+     * @param i_row row of the top left element
+     * @param i_col column of the top left element
+     * @return view of the block
+     * @throw std::out_of_range if the block reaches past the matrix
      */
-    constexpr auto determinant() const noexcept
+    template<uint64_t _Nr, uint64_t _Nc>
+    constexpr auto block( uint64_t i_row, uint64_t i_col )
     {
-        static_assert( matrix::IsSquare(), "matrix has to be a square matrix!" );
+        static_assert( _Nr <= Rows() && _Nc <= Columns(), "Block has to fit in the matrix!" );
 
-        if constexpr( Columns() == 1_ui64 )
-        {
-            return m_array[0][0];
-        }
-        else if constexpr( Columns() == 2_ui64 )
-        {
-            return ( ( m_array[0][0] * m_array[1][1] ) - ( m_array[0][1] * m_array[1][0] ) );
-        }
-        else
-        {
-            auto det{ 0.0l };
+        return matrix_view<_Nr, _Nc, matrix, false>{ *this, i_row, i_col };
+    }
 
-            constexpr auto row_num = 0_ui64;
 
-            for( auto col{ 0_ui64 }; col < Columns(); ++col )
-            {
-                auto multiplier{ col % 2 == 0 ? 1 : -1 };
+    /**
+     * @brief View of a block of a constant matrix, without copying
+     *
+     * @tparam _Nr Number of rows in the block
+     * @tparam _Nc Number of columns in the block
+     * @param i_row row of the top left element
+     * @param i_col column of the top left element
+     * @return view of the block
+     * @throw std::out_of_range if the block reaches past the matrix
+     */
+    template<uint64_t _Nr, uint64_t _Nc>
+    constexpr auto block( uint64_t i_row, uint64_t i_col ) const
+    {
+        static_assert( _Nr <= Rows() && _Nc <= Columns(), "Block has to fit in the matrix!" );
 
-                auto leftover{ leftover_elements( row_num, col ) };
+        return matrix_view<_Nr, _Nc, const matrix, false>{ *this, i_row, i_col };
+    }
 
-                det += ( m_array[row_num][col] * multiplier * leftover.determinant() );
-            }
 
-            return det;
-        }
+    /**
+     * @brief View of the transpose, without copying as operator~ does
+     *
+     * @return transposed view
+     */
+    constexpr auto transpose() noexcept
+    {
+        return matrix_view<Columns(), Rows(), matrix, true>{ *this, 0, 0 };
     }
 
 
     /**
-     * @brief Calculate adjoint of the matrix
+     * @brief View of the transpose of a constant matrix
      *
-     * @return adjoint of the matrix
+     * @return transposed view
      */
-    constexpr auto adjoint() const noexcept
+    constexpr auto transpose() const noexcept
     {
-        static_assert( matrix::IsSquare(), "matrix has to be a square matrix!" );
+        return matrix_view<Columns(), Rows(), const matrix, true>{ *this, 0, 0 };
+    }
 
-        auto cofactor_matrix{ matrix{} };
 
-        for( auto row{ 0_ui64 }; row < Rows(); ++row )
-        {
-            for( auto col{ 0_ui64 }; col < Columns(); ++col )
-            {
-                auto multiplier{ ( row + col ) % 2 == 0 ? 1 : -1 };
+    /**
+     * @brief View of the elements in chosen rows and columns, in the order given
+     *
+     * @tparam _Nr Number of rows chosen
+     * @tparam _Nc Number of columns chosen
+     * @param i_rows row indices
+     * @param i_cols column indices
+     * @return view of the chosen elements
+     * @throw std::out_of_range if an index is not in the matrix
+     */
+    template<uint64_t _Nr, uint64_t _Nc>
+    constexpr auto select( const std::array<uint64_t, _Nr>& i_rows, const std::array<uint64_t, _Nc>& i_cols )
+    {
+        return indexed_view<_Nr, _Nc, matrix>{ *this, i_rows, i_cols };
+    }
 
-                cofactor_matrix[row][col] = multiplier * leftover_elements( row, col ).determinant();
-            }
-        }
 
-        return ~cofactor_matrix;
+    /**
+     * @brief View of chosen elements of a constant matrix
+     *
+     * @tparam _Nr Number of rows chosen
+     * @tparam _Nc Number of columns chosen
+     * @param i_rows row indices
+     * @param i_cols column indices
+     * @return view of the chosen elements
+     * @throw std::out_of_range if an index is not in the matrix
+     */
+    template<uint64_t _Nr, uint64_t _Nc>
+    constexpr auto select( const std::array<uint64_t, _Nr>& i_rows,
+                           const std::array<uint64_t, _Nc>& i_cols ) const
+    {
+        return indexed_view<_Nr, _Nc, const matrix>{ *this, i_rows, i_cols };
     }
 
 
     /**
-     * @brief Calculate the inverse of the matrix
+     * @brief View of the elements left after excluding a row and column, the minor without copying
      *
-     * @return inverse of the matrix
+     * @param i_row Row to exclude
+     * @param i_col Column to exclude
+     * @return view of leftover elements
+     * @throw std::out_of_range if the row or column is not in the matrix
      */
-    constexpr auto inverse() const noexcept
+    constexpr auto leftover( uint64_t i_row, uint64_t i_col ) const
     {
-        static_assert( matrix::IsSquare(), "matrix has to be a square matrix!" );
+        static_assert( Rows() > 1_ui64 && Columns() > 1_ui64, "matrix has to have at least 2 rows and columns" );
 
-        auto det{ determinant() };
+        check_extent( i_row, 1, Rows() );
+        check_extent( i_col, 1, Columns() );
 
-        assert( det != static_cast<decltype( det )>( 0.0 ) );
+        auto rows{ std::array<uint64_t, Rows() - 1>{} };
+        auto cols{ std::array<uint64_t, Columns() - 1>{} };
 
-        if( det == static_cast<decltype( det )>( 0.0 ) )
+        for( auto r{ 0_ui64 }; r < rows.size(); ++r )
         {
-            return matrix{};
+            rows[r] = r < i_row ? r : r + 1;
         }
 
+        for( auto c{ 0_ui64 }; c < cols.size(); ++c )
+        {
+            cols[c] = c < i_col ? c : c + 1;
+        }
+
+        return select( rows, cols );
+    }
+
+
+    /**
+     * @brief Elements leftover after excluding a row and column
+     *
+     * @param i_row Row to exclude
+     * @param i_col Column to exclude
+     * @return matrix form of leftover elements
+     */
+    constexpr auto leftover_elements( uint64_t i_row, uint64_t i_col ) const
+    {
+        static_assert( IsSquare() && Rows() > 2_ui64, "matrix has to be a square matrix of minimum order 3" );
+
+        return matrix<Rows() - 1_ui64, Columns() - 1_ui64, value_type>( leftover( i_row, i_col ) );
+    }
+
+
+    /**
+     * @brief Calculate determinant of square matrix
+     *
+     * Orders up to 3 use the closed forms. Larger ones use an LU decomposition in O(n^3) over floating point types and
+     * fields, Bareiss' fraction-free elimination over the integers and Euclid's algorithm on the rows over other rings.
+     *
+     * @return Value of determinant
+     */
+    constexpr auto determinant() const noexcept
+    {
+        return determinant_of( *this );
+    }
+
+
+    /**
+     * @brief Determinant of a square matrix or view of this order, read in place
+     *
+     * Views of a matrix, minors among them, take the same way as a matrix would without being copied first; only the
+     * eliminations copy, into the matrix they work on.
+     *
+     * @tparam _Operand Type of the matrix or view
+     * @param i_operand matrix or view
+     * @return Value of determinant
+     */
+    template<typename _Operand>
+    static constexpr value_type determinant_of( const _Operand& i_operand ) noexcept
+    {
+        static_assert( matrix::IsSquare(), "matrix has to be a square matrix!" );
+        static_assert( _Operand::Rows() == Rows() && _Operand::Columns() == Columns(), "Orders have to match!" );
+
+        const auto& a{ i_operand };
+
         if constexpr( Columns() == 1_ui64 )
         {
-            return matrix{ 1.0 / det };
+            return a( 0, 0 );
         }
         else if constexpr( Columns() == 2_ui64 )
         {
-            auto a{ ( *this )[0][0] };
-            auto b{ ( *this )[0][1] };
-            auto c{ ( *this )[1][0] };
-            auto d{ ( *this )[1][1] };
+            return ( ( a( 0, 0 ) * a( 1, 1 ) ) - ( a( 0, 1 ) * a( 1, 0 ) ) );
+        }
+        else if constexpr( Columns() == 3_ui64 )
+        {
+            return ( a( 0, 0 ) * ( ( a( 1, 1 ) * a( 2, 2 ) ) - ( a( 1, 2 ) * a( 2, 1 ) ) ) ) -
+                   ( a( 0, 1 ) * ( ( a( 1, 0 ) * a( 2, 2 ) ) - ( a( 1, 2 ) * a( 2, 0 ) ) ) ) +
+                   ( a( 0, 2 ) * ( ( a( 1, 0 ) * a( 2, 1 ) ) - ( a( 1, 1 ) * a( 2, 0 ) ) ) );
+        }
+        else if constexpr( ring_traits<value_type>::elimination != elimination_kind::euclidean )
+        {
+            return lu_decomposition<Rows(), value_type>{ i_operand }.determinant();
+        }
+        else if constexpr( std::is_integral_v<value_type> )
+        {
+            auto rows{ matrix( i_operand ) };
+            return elimination::fraction_free_determinant<value_type>( rows, Rows() );
+        }
+        else
+        {
+            auto rows{ matrix( i_operand ) };
+            return elimination::euclidean_determinant<value_type>( rows, Rows() );
+        }
+    }
+
+
+    /**
+     * @brief LU decomposition with partial pivoting
+     *
+     * @return factors such that the rows of the matrix, permuted, equal L * U
+     */
+    constexpr auto lu() const noexcept
+    {
+        static_assert( matrix::IsSquare(), "matrix has to be a square matrix!" );
+        static_assert( ring_traits<value_type>::elimination != elimination_kind::euclidean,
+                       "LU decomposition needs elements that can be divided!" );
+
+        return lu_decomposition<Rows(), value_type>{ *this };
+    }
+
+
+    /**
+     * @brief Solve the system A * X = B, for one right-hand side per column of B
+     *
+     * @tparam _Operand Type of the matrix, expression or view of right-hand sides
+     * @param i_rhs right-hand sides
+     * @return solutions, one per column
+     */
+    template<typename _Operand, typename = std::enable_if_t<is_matrix_operand_v<_Operand>>>
+    constexpr auto solve( const _Operand& i_rhs ) const
+    {
+        return lu().solve( i_rhs );
+    }
+
+
+    /**
+     * @brief Solve the system A * x = b
+     *
+     * @param i_rhs right-hand side
+     * @return solution
+     */
+    constexpr auto solve( const std::array<value_type, _Rows>& i_rhs ) const
+    {
+        return lu().solve( i_rhs );
+    }
+
+
+    /**
+     * @brief Calculate adjoint of the matrix
+     *
+     * Each cofactor is the determinant of a minor read in place through leftover().
+     *
+     * @return adjoint of the matrix
+     */
+    constexpr auto adjoint() const noexcept
+    {
+        static_assert( matrix::IsSquare(), "matrix has to be a square matrix!" );
+
+        auto cofactor_matrix{ matrix{} };
+
+        for( auto row{ 0_ui64 }; row < Rows(); ++row )
+        {
+            for( auto col{ 0_ui64 }; col < Columns(); ++col )
+            {
+                auto cofactor{ matrix<Rows() - 1_ui64, Columns() - 1_ui64, value_type>::determinant_of(
+                    leftover( row, col ) ) };
+
+                cofactor_matrix[row][col] = ( row + col ) % 2 == 0 ? cofactor : -cofactor;
+            }
+        }
+
+        return ~cofactor_matrix;
+    }
+
+
+    /**
+     * @brief Calculate the inverse of the matrix
+     *
+     * Orders 1 and 2 use the closed forms, larger ones solve A * X = I on an LU decomposition in O(n^3). Over a ring,
+     * Gauss-Jordan elimination with Euclid's algorithm on the rows finds the inverse whenever the determinant is a
+     * unit.
+     *
+     * @return inverse of the matrix
+     * @throw std::domain_error if the matrix is singular, or has no inverse over its ring
+     */
+    constexpr auto inverse() const
+    {
+        return inverse_of( *this );
+    }
+
+
+    /**
+     * @brief Inverse of a square matrix or view of this order, read in place
+     *
+     * @tparam _Operand Type of the matrix or view
+     * @param i_operand matrix or view
+     * @return inverse of the matrix or view
+     * @throw std::domain_error if it is singular, or has no inverse over its ring
+     */
+    template<typename _Operand>
+    static constexpr matrix inverse_of( const _Operand& i_operand )
+    {
+        static_assert( matrix::IsSquare(), "matrix has to be a square matrix!" );
+        static_assert( _Operand::Rows() == Rows() && _Operand::Columns() == Columns(), "Orders have to match!" );
+
+        if constexpr( ring_traits<value_type>::elimination == elimination_kind::euclidean )
+        {
+            auto rows{ matrix( i_operand ) };
+            auto inverse{ matrix{} };
+
+            elimination::euclidean_inverse<value_type>( rows, inverse, Rows() );
+
+            return inverse;
+        }
+        else if constexpr( Columns() <= 2_ui64 )
+        {
+            auto det{ determinant_of( i_operand ) };
 
-            return matrix{ d / det, -b / det, -c / det, a / det };
+            if( det == static_cast<value_type>( 0 ) )
+            {
+                throw std::domain_error{ "Cannot invert a singular matrix!" };
+            }
+
+            if constexpr( Columns() == 1_ui64 )
+            {
+                return matrix{ static_cast<value_type>( 1 ) / det };
+            }
+            else
+            {
+                auto a{ i_operand( 0, 0 ) };
+                auto b{ i_operand( 0, 1 ) };
+                auto c{ i_operand( 1, 0 ) };
+                auto d{ i_operand( 1, 1 ) };
+
+                return matrix{ d / det, -b / det, -c / det, a / det };
+            }
         }
         else
         {
-            auto adj{ adjoint() };
+            auto decomposition{ lu_decomposition<Rows(), value_type>{ i_operand } };
 
-            auto inv{ matrix{} };
+            if( decomposition.singular )
+            {
+                throw std::domain_error{ "Cannot invert a singular matrix!" };
+            }
+
+            return decomposition.solve( matrix{} );
+        }
+    }
+
+private:
+    /**
+     * @brief Combine every element with the same element of a matrix or expression, in one pass
+     *
+     */
+    template<typename _Operand, typename _Combine>
+    constexpr void assign( const _Operand& i_operand, _Combine&& i_combine ) noexcept
+    {
+        static_assert( Rows() == _Operand::Rows(), "Both matrices should have same number of rows!" );
+        static_assert( Columns() == _Operand::Columns(), "Both matrices should have same number of columns!" );
+        static_assert( std::is_same_v<value_type, typename _Operand::value_type>,
+                       "Both matrices should have the same element type!" );
 
-            for( auto row{ 0_ui64 }; row < Rows(); ++row )
+        auto combine_rows{ [&]( uint64_t i_first, uint64_t i_last ) {
+            for( auto i{ i_first }; i < i_last; ++i )
             {
-                for( auto col{ 0_ui64 }; col < Columns(); ++col )
+                for( auto j{ 0_ui64 }; j < Columns(); ++j )
                 {
-                    inv[row][col] = adj[row][col] / det;
+                    i_combine( m_array[i][j], i_operand( i, j ) );
                 }
             }
+        } };
 
-            return inv;
+        if constexpr( Rows() * Columns() >= small_parallel_size )
+        {
+            if( !__IS_CONSTANT_EVALUATED() )
+            {
+                parallel::for_row_bands( Rows(), Columns(), combine_rows );
+                return;
+            }
         }
+
+        combine_rows( 0_ui64, Rows() );
     }
 
-    static_assert( std::is_floating_point_v<value_type>, "Contained element needs to be a valid matrix type!" );
+    static_assert( ring_traits<value_type>::is_ring, "Contained element needs to be a valid matrix type!" );
     static_assert( Rows() != 0 && Columns() != 0, "Rows and columns have to be non-zero!" );
 };
 
 
-template<std::uint64_t _Order, typename _T = double>
-constexpr static auto IdentityMatrix = matrix<_Order, _Order, _T>{};
+/**
+ * @brief Size up to which an expression copies a matrix it is given, rather than referring to it
+ *
+ */
+constexpr auto expression_copy_bytes = 64_sz;
+
+
+/**
+ * @brief How an expression holds an operand passed as _Operand&&: a reference to a matrix that outlives the full
+ *        expression, and a copy of anything else
+ *
+ * A temporary matrix, such as a product, is gone by the time a stored expression is evaluated, so it is moved in.
+ * Views and sub-expressions only refer to matrices themselves and are copied. A matrix small enough to copy for the
+ * price of a few loads is copied too, which also keeps a constexpr expression over local matrices a constant.
+ *
+ * @tparam _Operand Type of the operand as forwarded
+ */
+template<typename _Operand>
+using expression_operand_t = std::conditional_t<std::is_lvalue_reference_v<_Operand> && !is_lazy_operand_v<_Operand> &&
+                                                    ( sizeof( RAW( _Operand ) ) > expression_copy_bytes ),
+                                                const RAW( _Operand )&,
+                                                RAW( _Operand )>;
+
+
+/**
+ * @brief Lazy element-wise combination of two matrices or expressions
+ *
+ * Nothing is computed until the expression is assigned to a matrix, which then runs a single loop over its elements,
+ * so a chain like a + b - c costs no temporary matrix. Operands are held as expression_operand_t says: temporaries
+ * and small matrices by value, so an expression can be stored and evaluated later, and larger matrices passed by name
+ * by reference, so those must outlive the expression.
+ *
+ * @tparam _Lhs Type of the first operand as held, a matrix type or a const reference to one
+ * @tparam _Rhs Type of the second operand as held
+ * @tparam _Operation Binary operation on elements
+ */
+template<typename _Lhs, typename _Rhs, typename _Operation>
+class matrix_expression
+{
+    using lhs_t = RAW( _Lhs );
+    using rhs_t = RAW( _Rhs );
+
+public:
+    using value_type = typename lhs_t::value_type;
+
+private:
+    _Lhs m_lhs;
+
+    _Rhs m_rhs;
+
+    _Operation m_operation;
+
+public:
+    /**
+     * @brief Constructor for matrix_expression class
+     *
+     * @param i_lhs First operand
+     * @param i_rhs Second operand
+     * @param i_operation Binary operation on elements
+     */
+    template<typename _LhsArg, typename _RhsArg>
+    constexpr matrix_expression( _LhsArg&& i_lhs, _RhsArg&& i_rhs, _Operation i_operation ) noexcept :
+        m_lhs{ std::forward<_LhsArg>( i_lhs ) },
+        m_rhs{ std::forward<_RhsArg>( i_rhs ) },
+        m_operation{ std::move( i_operation ) }
+    {
+    }
+
+
+    /**
+     * @brief Compute one element of the result
+     *
+     * @param i_row input row index
+     * @param i_col input column index
+     * @return element
+     */
+    constexpr value_type operator()( const uint64_t i_row, const uint64_t i_col ) const noexcept
+    {
+        return m_operation( m_lhs( i_row, i_col ), m_rhs( i_row, i_col ) );
+    }
+
+
+    constexpr const lhs_t& lhs() const noexcept
+    {
+        return m_lhs;
+    }
+
+
+    constexpr const rhs_t& rhs() const noexcept
+    {
+        return m_rhs;
+    }
+
+
+    /**
+     * @brief Number of rows in the result
+     *
+     * @return number of rows
+     */
+    __CONSTEVAL static auto Rows() noexcept
+    {
+        return lhs_t::Rows();
+    }
+
+
+    /**
+     * @brief Number of columns in the result
+     *
+     * @return number of columns
+     */
+    __CONSTEVAL static auto Columns() noexcept
+    {
+        return lhs_t::Columns();
+    }
+
+    static_assert( Rows() == rhs_t::Rows(), "Both matrices should have same number of rows!" );
+    static_assert( Columns() == rhs_t::Columns(), "Both matrices should have same number of columns!" );
+    static_assert( std::is_same_v<value_type, typename rhs_t::value_type>,
+                   "Both matrices should have the same element type!" );
+};
+
+
+/**
+ * @brief Generic binary operator
+ *
+ * @tparam _Lhs Type of the first matrix or expression
+ * @tparam _Rhs Type of the second matrix or expression
+ * @tparam _Predicate Binary Predicate Type
+ * @param i_lhs First matrix
+ * @param i_rhs Second matrix
+ * @param binary_p Binary predicate
+ * @return Lazy binary operation result, evaluated when assigned to a matrix
+ */
+template<typename _Lhs,
+         typename _Rhs,
+         typename _Predicate,
+         typename = std::enable_if_t<is_matrix_operand_v<_Lhs> && is_matrix_operand_v<_Rhs>>>
+constexpr auto basic_binary_operator( _Lhs&& i_lhs, _Rhs&& i_rhs, _Predicate&& binary_p ) noexcept
+{
+    return matrix_expression<expression_operand_t<_Lhs>, expression_operand_t<_Rhs>, RAW( _Predicate )>{
+        std::forward<_Lhs>( i_lhs ), std::forward<_Rhs>( i_rhs ), std::forward<_Predicate>( binary_p ) };
+}
+
+
+/**
+ * @brief Adds two matrices
+ *
+ * @tparam _Lhs Type of the first matrix or expression
+ * @tparam _Rhs Type of the second matrix or expression
+ * @param i_lhs First matrix
+ * @param i_rhs Second matrix
+ * @return Lazy sum of input matrices
+ */
+template<typename _Lhs,
+         typename _Rhs,
+         typename = std::enable_if_t<is_matrix_operand_v<_Lhs> && is_matrix_operand_v<_Rhs>>>
+constexpr auto operator+( _Lhs&& i_lhs, _Rhs&& i_rhs ) noexcept
+{
+    return basic_binary_operator( std::forward<_Lhs>( i_lhs ), std::forward<_Rhs>( i_rhs ), std::plus<>{} );
+}
+
+
+/**
+ * @brief Subtracts two matrices
+ *
+ * @tparam _Lhs Type of the first matrix or expression
+ * @tparam _Rhs Type of the second matrix or expression
+ * @param i_lhs First matrix
+ * @param i_rhs Second matrix
+ * @return Lazy difference of input matrices
+ */
+template<typename _Lhs,
+         typename _Rhs,
+         typename = std::enable_if_t<is_matrix_operand_v<_Lhs> && is_matrix_operand_v<_Rhs>>>
+constexpr auto operator-( _Lhs&& i_lhs, _Rhs&& i_rhs ) noexcept
+{
+    return basic_binary_operator( std::forward<_Lhs>( i_lhs ), std::forward<_Rhs>( i_rhs ), std::minus<>{} );
+}
+
+
+/**
+ * @brief Transpose of an expression, evaluated into a matrix first
+ *
+ * @param i_expression expression
+ * @return transpose of the expression
+ */
+template<typename _Lhs, typename _Rhs, typename _Operation>
+constexpr auto operator~( const matrix_expression<_Lhs, _Rhs, _Operation>& i_expression ) noexcept
+{
+    using expression_t = matrix_expression<_Lhs, _Rhs, _Operation>;
+
+    return ~matrix<expression_t::Rows(), expression_t::Columns(), typename expression_t::value_type>( i_expression );
+}
+
+
+/**
+ * @brief Combine every element of a view with the same element of a matrix, expression or view
+ *
+ */
+template<typename _View, typename _Operand, typename _Combine>
+constexpr void combine_elements( const _View& i_view, const _Operand& i_operand, _Combine&& i_combine ) noexcept
+{
+    static_assert( _View::Rows() == _Operand::Rows(), "Both matrices should have same number of rows!" );
+    static_assert( _View::Columns() == _Operand::Columns(), "Both matrices should have same number of columns!" );
+    static_assert( std::is_same_v<typename _View::value_type, typename _Operand::value_type>,
+                   "Both matrices should have the same element type!" );
+
+    const void* storage{ &i_view.viewed() };
+    auto aliased{ views_storage( i_operand, storage ) };
+
+    if constexpr( !is_matrix_expression_v<_Operand> && !is_matrix_view_v<_Operand> )
+    {
+        aliased = &i_operand == storage;
+    }
+
+    // the operand may read the viewed elements in another order, or at an offset, so it is evaluated first
+    if( aliased )
+    {
+        combine_elements(
+            i_view, matrix<_View::Rows(), _View::Columns(), typename _View::value_type>( i_operand ), i_combine );
+        return;
+    }
+
+    for( auto i{ 0_ui64 }; i < _View::Rows(); ++i )
+    {
+        for( auto j{ 0_ui64 }; j < _View::Columns(); ++j )
+        {
+            i_combine( i_view( i, j ), i_operand( i, j ) );
+        }
+    }
+}
+
+
+/**
+ * @brief Non-owning view of a block of a matrix, possibly transposed
+ *
+ * Rows, columns, blocks and transposes read and write the matrix in place: element (i, j) of the view is element
+ * (row + i, column + j) of the matrix, or (row + j, column + i) when transposed. Assigning to a view writes through to
+ * the matrix element by element, so the operand must not read the viewed elements in another order, as a transpose
+ * of the same block would. A view must not outlive its matrix.
+ *
+ * @tparam _Rows Number of rows
+ * @tparam _Columns Number of columns
+ * @tparam _Matrix Type of the viewed matrix, const for a read-only view
+ * @tparam _Transposed true if the rows of the view are columns of the matrix
+ */
+template<uint64_t _Rows, uint64_t _Columns, typename _Matrix, bool _Transposed>
+class matrix_view
+{
+public:
+    using value_type = typename std::remove_const_t<_Matrix>::value_type;
+
+private:
+    _Matrix* m_matrix;
+
+    uint64_t m_row;
+
+    uint64_t m_column;
+
+public:
+    /**
+     * @brief Constructor for matrix_view class
+     *
+     * @param i_matrix viewed matrix
+     * @param i_row row of the matrix where the view starts
+     * @param i_col column of the matrix where the view starts
+     * @throw std::out_of_range if the view reaches past the matrix
+     */
+    constexpr matrix_view( _Matrix& i_matrix, uint64_t i_row, uint64_t i_col ) :
+        m_matrix{ &i_matrix }, m_row{ i_row }, m_column{ i_col }
+    {
+        check_extent( i_row, _Transposed ? _Columns : _Rows, std::remove_const_t<_Matrix>::Rows() );
+        check_extent( i_col, _Transposed ? _Rows : _Columns, std::remove_const_t<_Matrix>::Columns() );
+    }
+
+
+    constexpr matrix_view( const matrix_view& ) noexcept = default;
+
+
+    /**
+     * @brief Copy the elements of another view of the same type, rather than rebinding
+     *
+     * @param i_view view to copy from
+     * @return this view
+     */
+    constexpr matrix_view& operator=( const matrix_view& i_view ) noexcept
+    {
+        combine_elements( *this, i_view, []( auto&& i_element, auto&& i_value ) { i_element = i_value; } );
+
+        return *this;
+    }
+
+
+    /**
+     * @brief Copy a matrix, expression or view into the viewed elements
+     *
+     * @tparam _Operand Type of the matrix, expression or view
+     * @param i_operand operand of the same shape
+     * @return this view
+     */
+    template<typename _Operand, typename = std::enable_if_t<is_matrix_operand_v<_Operand>>>
+    constexpr matrix_view& operator=( const _Operand& i_operand ) noexcept
+    {
+        combine_elements( *this, i_operand, []( auto&& i_element, auto&& i_value ) { i_element = i_value; } );
+
+        return *this;
+    }
+
+
+    /**
+     * @brief Add a matrix, expression or view to the viewed elements
+     *
+     * @tparam _Operand Type of the matrix, expression or view
+     * @param i_operand operand of the same shape
+     * @return this view
+     */
+    template<typename _Operand, typename = std::enable_if_t<is_matrix_operand_v<_Operand>>>
+    constexpr matrix_view& operator+=( const _Operand& i_operand ) noexcept
+    {
+        combine_elements( *this, i_operand, []( auto&& i_element, auto&& i_value ) { i_element += i_value; } );
+
+        return *this;
+    }
+
+
+    /**
+     * @brief Subtract a matrix, expression or view from the viewed elements
+     *
+     * @tparam _Operand Type of the matrix, expression or view
+     * @param i_operand operand of the same shape
+     * @return this view
+     */
+    template<typename _Operand, typename = std::enable_if_t<is_matrix_operand_v<_Operand>>>
+    constexpr matrix_view& operator-=( const _Operand& i_operand ) noexcept
+    {
+        combine_elements( *this, i_operand, []( auto&& i_element, auto&& i_value ) { i_element -= i_value; } );
+
+        return *this;
+    }
+
+
+    /**
+     * @brief Matrix the view reads and writes
+     *
+     * @return viewed matrix
+     */
+    constexpr _Matrix& viewed() const noexcept
+    {
+        return *m_matrix;
+    }
+
+
+    /**
+     * @brief Get element by row and column
+     *
+     * @param i_row input row index
+     * @param i_col input column index
+     * @return element of the matrix, writable unless the matrix is constant
+     */
+    constexpr decltype( auto ) operator()( const uint64_t i_row, const uint64_t i_col ) const noexcept
+    {
+        if constexpr( _Transposed )
+        {
+            return ( *m_matrix )[m_row + i_col][m_column + i_row];
+        }
+        else
+        {
+            return ( *m_matrix )[m_row + i_row][m_column + i_col];
+        }
+    }
+
+
+    /**
+     * @brief First element, the rows following at stride() elements apart
+     *
+     * @return pointer to the first element
+     */
+    constexpr auto data() const noexcept
+    {
+        static_assert( !_Transposed, "Rows of a transposed view are not stored in place!" );
+
+        return &( *m_matrix )[m_row][m_column];
+    }
+
+
+    /**
+     * @brief Distance in elements between the starts of two rows
+     *
+     * @return distance between rows
+     */
+    __CONSTEVAL static auto stride() noexcept
+    {
+        return std::remove_const_t<_Matrix>::Columns();
+    }
+
+
+    /**
+     * @brief View of a block of this view
+     *
+     * @tparam _Nr Number of rows in the block
+     * @tparam _Nc Number of columns in the block
+     * @param i_row row of the top left element, in this view
+     * @param i_col column of the top left element, in this view
+     * @return view of the block
+     * @throw std::out_of_range if the block reaches past the view
+     */
+    template<uint64_t _Nr, uint64_t _Nc>
+    constexpr auto block( uint64_t i_row, uint64_t i_col ) const
+    {
+        static_assert( _Nr <= Rows() && _Nc <= Columns(), "Block has to fit in the view!" );
+
+        check_extent( i_row, _Nr, Rows() );
+        check_extent( i_col, _Nc, Columns() );
+
+        if constexpr( _Transposed )
+        {
+            return matrix_view<_Nr, _Nc, _Matrix, true>{ *m_matrix, m_row + i_col, m_column + i_row };
+        }
+        else
+        {
+            return matrix_view<_Nr, _Nc, _Matrix, false>{ *m_matrix, m_row + i_row, m_column + i_col };
+        }
+    }
+
+
+    /**
+     * @brief View of one row of this view
+     *
+     * @param i_row input row index
+     * @return view of the row
+     * @throw std::out_of_range if the row is not in the matrix
+     */
+    constexpr auto row( uint64_t i_row ) const
+    {
+        return block<1, _Columns>( i_row, 0 );
+    }
+
+
+    /**
+     * @brief View of one column of this view
+     *
+     * @param i_col input column index
+     * @return view of the column
+     * @throw std::out_of_range if the column is not in the matrix
+     */
+    constexpr auto column( uint64_t i_col ) const
+    {
+        return block<_Rows, 1>( 0, i_col );
+    }
+
+
+    /**
+     * @brief View of the transpose of this view
+     *
+     * @return transposed view
+     */
+    constexpr auto transpose() const noexcept
+    {
+        return matrix_view<_Columns, _Rows, _Matrix, !_Transposed>{ *m_matrix, m_row, m_column };
+    }
+
+
+    /**
+     * @brief Determinant of the viewed elements, read in place
+     *
+     * @return Value of determinant
+     */
+    constexpr auto determinant() const noexcept
+    {
+        return matrix<_Rows, _Columns, value_type>::determinant_of( *this );
+    }
+
+
+    /**
+     * @brief LU decomposition of the viewed elements, copied only into its factors
+     *
+     * @return factors such that the rows of the view, permuted, equal L * U
+     */
+    constexpr auto lu() const noexcept
+    {
+        static_assert( IsSquare(), "view has to be square!" );
+        static_assert( ring_traits<value_type>::elimination != elimination_kind::euclidean,
+                       "LU decomposition needs elements that can be divided!" );
+
+        return lu_decomposition<_Rows, value_type>{ *this };
+    }
+
+
+    /**
+     * @brief Solve the system A * X = B for the viewed elements A, one right-hand side per column of B
+     *
+     * @tparam _Operand Type of the matrix, expression or view of right-hand sides
+     * @param i_rhs right-hand sides
+     * @return solutions, one per column
+     */
+    template<typename _Operand, typename = std::enable_if_t<is_matrix_operand_v<_Operand>>>
+    constexpr auto solve( const _Operand& i_rhs ) const
+    {
+        return lu().solve( i_rhs );
+    }
+
+
+    /**
+     * @brief Inverse of the viewed elements
+     *
+     * @return inverse, as a matrix
+     * @throw std::domain_error if the viewed elements are singular, or have no inverse over their ring
+     */
+    constexpr auto inverse() const
+    {
+        return matrix<_Rows, _Columns, value_type>::inverse_of( *this );
+    }
+
+
+    /**
+     * @brief Number of rows in the view
+     *
+     * @return number of rows
+     */
+    __CONSTEVAL static auto Rows() noexcept
+    {
+        return _Rows;
+    }
+
+
+    /**
+     * @brief Number of columns in the view
+     *
+     * @return number of columns
+     */
+    __CONSTEVAL static auto Columns() noexcept
+    {
+        return _Columns;
+    }
+
+
+    /**
+     * @brief Check if view is square
+     *
+     * @return true if view is square
+     */
+    __CONSTEVAL static auto IsSquare() noexcept
+    {
+        return Rows() == Columns();
+    }
+
+    static_assert( Rows() != 0 && Columns() != 0, "Rows and columns have to be non-zero!" );
+};
+
+
+/**
+ * @brief Non-owning view of the elements of a matrix in chosen rows and columns
+ *
+ * Element (i, j) of the view is element (rows[i], columns[j]) of the matrix, so a minor is the view that skips one row
+ * and one column. The indices are copied into the view; the elements are not. A view must not outlive its matrix.
+ *
+ * @tparam _Rows Number of rows
+ * @tparam _Columns Number of columns
+ * @tparam _Matrix Type of the viewed matrix, const for a read-only view
+ */
+template<uint64_t _Rows, uint64_t _Columns, typename _Matrix>
+class indexed_view
+{
+public:
+    using value_type = typename std::remove_const_t<_Matrix>::value_type;
+
+private:
+    _Matrix* m_matrix;
+
+    std::array<uint64_t, _Rows> m_rows;
+
+    std::array<uint64_t, _Columns> m_columns;
+
+public:
+    /**
+     * @brief Constructor for indexed_view class
+     *
+     * @param i_matrix viewed matrix
+     * @param i_rows rows of the matrix, in the order of the view
+     * @param i_cols columns of the matrix, in the order of the view
+     * @throw std::out_of_range if an index is not in the matrix
+     */
+    constexpr indexed_view( _Matrix& i_matrix,
+                            const std::array<uint64_t, _Rows>& i_rows,
+                            const std::array<uint64_t, _Columns>& i_cols ) :
+        m_matrix{ &i_matrix }, m_rows{ i_rows }, m_columns{ i_cols }
+    {
+        for( auto row : m_rows )
+        {
+            check_extent( row, 1, std::remove_const_t<_Matrix>::Rows() );
+        }
+
+        for( auto col : m_columns )
+        {
+            check_extent( col, 1, std::remove_const_t<_Matrix>::Columns() );
+        }
+    }
+
+
+    constexpr indexed_view( const indexed_view& ) noexcept = default;
+
+
+    /**
+     * @brief Copy the elements of another view of the same type, rather than rebinding
+     *
+     * @param i_view view to copy from
+     * @return this view
+     */
+    constexpr indexed_view& operator=( const indexed_view& i_view ) noexcept
+    {
+        combine_elements( *this, i_view, []( auto&& i_element, auto&& i_value ) { i_element = i_value; } );
+
+        return *this;
+    }
+
+
+    /**
+     * @brief Copy a matrix, expression or view into the viewed elements
+     *
+     * @tparam _Operand Type of the matrix, expression or view
+     * @param i_operand operand of the same shape
+     * @return this view
+     */
+    template<typename _Operand, typename = std::enable_if_t<is_matrix_operand_v<_Operand>>>
+    constexpr indexed_view& operator=( const _Operand& i_operand ) noexcept
+    {
+        combine_elements( *this, i_operand, []( auto&& i_element, auto&& i_value ) { i_element = i_value; } );
+
+        return *this;
+    }
+
+
+    /**
+     * @brief Add a matrix, expression or view to the viewed elements
+     *
+     * @tparam _Operand Type of the matrix, expression or view
+     * @param i_operand operand of the same shape
+     * @return this view
+     */
+    template<typename _Operand, typename = std::enable_if_t<is_matrix_operand_v<_Operand>>>
+    constexpr indexed_view& operator+=( const _Operand& i_operand ) noexcept
+    {
+        combine_elements( *this, i_operand, []( auto&& i_element, auto&& i_value ) { i_element += i_value; } );
+
+        return *this;
+    }
+
+
+    /**
+     * @brief Subtract a matrix, expression or view from the viewed elements
+     *
+     * @tparam _Operand Type of the matrix, expression or view
+     * @param i_operand operand of the same shape
+     * @return this view
+     */
+    template<typename _Operand, typename = std::enable_if_t<is_matrix_operand_v<_Operand>>>
+    constexpr indexed_view& operator-=( const _Operand& i_operand ) noexcept
+    {
+        combine_elements( *this, i_operand, []( auto&& i_element, auto&& i_value ) { i_element -= i_value; } );
+
+        return *this;
+    }
+
+
+    /**
+     * @brief Matrix the view reads and writes
+     *
+     * @return viewed matrix
+     */
+    constexpr _Matrix& viewed() const noexcept
+    {
+        return *m_matrix;
+    }
+
+
+    /**
+     * @brief Get element by row and column
+     *
+     * @param i_row input row index
+     * @param i_col input column index
+     * @return element of the matrix, writable unless the matrix is constant
+     */
+    constexpr decltype( auto ) operator()( const uint64_t i_row, const uint64_t i_col ) const noexcept
+    {
+        return ( *m_matrix )[m_rows[i_row]][m_columns[i_col]];
+    }
+
+
+    /**
+     * @brief Determinant of the viewed elements, read in place
+     *
+     * @return Value of determinant
+     */
+    constexpr auto determinant() const noexcept
+    {
+        return matrix<_Rows, _Columns, value_type>::determinant_of( *this );
+    }
+
+
+    /**
+     * @brief LU decomposition of the viewed elements, copied only into its factors
+     *
+     * @return factors such that the rows of the view, permuted, equal L * U
+     */
+    constexpr auto lu() const noexcept
+    {
+        static_assert( IsSquare(), "view has to be square!" );
+        static_assert( ring_traits<value_type>::elimination != elimination_kind::euclidean,
+                       "LU decomposition needs elements that can be divided!" );
+
+        return lu_decomposition<_Rows, value_type>{ *this };
+    }
+
+
+    /**
+     * @brief Solve the system A * X = B for the viewed elements A, one right-hand side per column of B
+     *
+     * @tparam _Operand Type of the matrix, expression or view of right-hand sides
+     * @param i_rhs right-hand sides
+     * @return solutions, one per column
+     */
+    template<typename _Operand, typename = std::enable_if_t<is_matrix_operand_v<_Operand>>>
+    constexpr auto solve( const _Operand& i_rhs ) const
+    {
+        return lu().solve( i_rhs );
+    }
+
+
+    /**
+     * @brief Inverse of the viewed elements
+     *
+     * @return inverse, as a matrix
+     * @throw std::domain_error if the viewed elements are singular, or have no inverse over their ring
+     */
+    constexpr auto inverse() const
+    {
+        return matrix<_Rows, _Columns, value_type>::inverse_of( *this );
+    }
+
+
+    /**
+     * @brief Number of rows in the view
+     *
+     * @return number of rows
+     */
+    __CONSTEVAL static auto Rows() noexcept
+    {
+        return _Rows;
+    }
+
+
+    /**
+     * @brief Number of columns in the view
+     *
+     * @return number of columns
+     */
+    __CONSTEVAL static auto Columns() noexcept
+    {
+        return _Columns;
+    }
+
+
+    /**
+     * @brief Check if view is square
+     *
+     * @return true if view is square
+     */
+    __CONSTEVAL static auto IsSquare() noexcept
+    {
+        return Rows() == Columns();
+    }
+
+    static_assert( Rows() != 0 && Columns() != 0, "Rows and columns have to be non-zero!" );
+};
+
+
+/**
+ * @brief Multiply two matrices, expressions or views, at least one not a matrix, without copying the views
+ *
+ * Views whose rows are stored in place, which is all but transposed and indexed ones, go to the blocked kernel with
+ * the stride of their matrix, as matrices do. An expression is evaluated once into a matrix first, rather than once
+ * for every product it takes part in.
+ *
+ * @tparam _Lhs Type of the first matrix, expression or view
+ * @tparam _Rhs Type of the second matrix, expression or view
+ * @param i_lhs First matrix
+ * @param i_rhs Second matrix
+ * @return Product of multiplication
+ * @throw std::bad_alloc if a large product cannot allocate its packing buffers
+ */
+template<typename _Lhs,
+         typename _Rhs,
+         typename = std::enable_if_t<is_matrix_operand_v<_Lhs> && is_matrix_operand_v<_Rhs> &&
+                                     ( is_lazy_operand_v<_Lhs> || is_lazy_operand_v<_Rhs> )>>
+constexpr auto operator*( const _Lhs& i_lhs, const _Rhs& i_rhs )
+{
+    static_assert( _Lhs::Columns() == _Rhs::Rows(),
+                   "Number of columns of first matrix should be equal to number of rows of second matrix!" );
+    static_assert( std::is_same_v<typename _Lhs::value_type, typename _Rhs::value_type>,
+                   "Both matrices should have the same element type!" );
+
+    using value_type = typename _Lhs::value_type;
+
+    constexpr auto rows = _Lhs::Rows();
+    constexpr auto inner = _Lhs::Columns();
+    constexpr auto columns = _Rhs::Columns();
+
+    if constexpr( is_matrix_expression_v<_Lhs> )
+    {
+        return matrix<rows, inner, value_type>( i_lhs ) * i_rhs;
+    }
+    else if constexpr( is_matrix_expression_v<_Rhs> )
+    {
+        return i_lhs * matrix<inner, columns, value_type>( i_rhs );
+    }
+    else
+    {
+        return multiply_in_place( i_lhs, i_rhs );
+    }
+}
+
+
+/**
+ * @brief Product of two matrices or views, reading both where they are stored
+ *
+ */
+template<typename _Lhs, typename _Rhs>
+constexpr auto multiply_in_place( const _Lhs& i_lhs, const _Rhs& i_rhs )
+{
+    using value_type = typename _Lhs::value_type;
+
+    constexpr auto rows = _Lhs::Rows();
+    constexpr auto inner = _Lhs::Columns();
+    constexpr auto columns = _Rhs::Columns();
+
+    auto mat{ matrix<rows, columns, value_type>{ false } };
+
+    if constexpr( gemm::is_supported_v<value_type> && has_row_storage_v<_Lhs> && has_row_storage_v<_Rhs> &&
+                  rows * inner * columns > gemm::small_product_size )
+    {
+        if( !__IS_CONSTANT_EVALUATED() )
+        {
+            parallel::multiply<value_type>( rows,
+                                            columns,
+                                            inner,
+                                            i_lhs.data(),
+                                            _Lhs::stride(),
+                                            i_rhs.data(),
+                                            _Rhs::stride(),
+                                            mat.data(),
+                                            columns );
+
+            return mat;
+        }
+    }
+
+    for( auto i{ 0_ui64 }; i < rows; ++i )
+    {
+        for( auto k{ 0_ui64 }; k < inner; ++k )
+        {
+            auto element{ i_lhs( i, k ) };
+
+            for( auto j{ 0_ui64 }; j < columns; ++j )
+            {
+                mat[i][j] += ( element * i_rhs( k, j ) );
+            }
+        }
+    }
+
+    return mat;
+}
+
+
+/**
+ * @brief Check if matrices, expressions or views, at least one not a matrix, are equal element by element
+ *
+ * @tparam _Lhs Type of the first matrix, expression or view
+ * @tparam _Rhs Type of the second matrix, expression or view
+ * @param i_lhs First matrix
+ * @param i_rhs Second matrix
+ * @return true if matrices are equal
+ * @return false if matrices are not equal
+ */
+template<typename _Lhs,
+         typename _Rhs,
+         typename = std::enable_if_t<is_matrix_operand_v<_Lhs> && is_matrix_operand_v<_Rhs> &&
+                                     ( is_lazy_operand_v<_Lhs> || is_lazy_operand_v<_Rhs> )>>
+constexpr bool operator==( const _Lhs& i_lhs, const _Rhs& i_rhs ) noexcept
+{
+    if constexpr( _Lhs::Rows() == _Rhs::Rows() && _Lhs::Columns() == _Rhs::Columns() )
+    {
+        for( auto row{ 0_ui64 }; row < _Lhs::Rows(); ++row )
+        {
+            for( auto col{ 0_ui64 }; col < _Lhs::Columns(); ++col )
+            {
+                if( !( i_lhs( row, col ) == i_rhs( row, col ) ) )
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+
+/**
+ * @brief Check if matrices, expressions or views, at least one not a matrix, are not equal
+ *
+ * @tparam _Lhs Type of the first matrix, expression or view
+ * @tparam _Rhs Type of the second matrix, expression or view
+ * @param i_lhs First matrix
+ * @param i_rhs Second matrix
+ * @return true if matrices are not equal
+ * @return false if matrices are equal
+ */
+template<typename _Lhs,
+         typename _Rhs,
+         typename = std::enable_if_t<is_matrix_operand_v<_Lhs> && is_matrix_operand_v<_Rhs> &&
+                                     ( is_lazy_operand_v<_Lhs> || is_lazy_operand_v<_Rhs> )>>
+constexpr bool operator!=( const _Lhs& i_lhs, const _Rhs& i_rhs ) noexcept
+{
+    return !( i_lhs == i_rhs );
+}
+
+
+/**
+ * @brief Check if a matrix, expression or view holds a view of some matrix
+ *
+ * A matrix operand itself reads each element where it is written, so only views count.
+ *
+ * @param i_operand matrix, expression or view
+ * @param i_storage address of the matrix
+ * @return true if a view in the operand reads that matrix
+ */
+template<typename _Operand>
+constexpr bool views_storage( const _Operand& i_operand, const void* i_storage ) noexcept
+{
+    if constexpr( is_matrix_view_v<_Operand> )
+    {
+        return &i_operand.viewed() == i_storage;
+    }
+    else if constexpr( is_matrix_expression_v<_Operand> )
+    {
+        return views_storage( i_operand.lhs(), i_storage ) || views_storage( i_operand.rhs(), i_storage );
+    }
+    else
+    {
+        return false;
+    }
+}
+
+
+/**
+ * @brief Multiply two matrices with the classical algorithm, as operator* does
+ *
+ * @param i_lhs First matrix
+ * @param i_rhs Second matrix
+ * @return Product of multiplication
+ */
+template<uint64_t _Rows, uint64_t _Inner, uint64_t _Columns, typename _T>
+constexpr auto multiply( const matrix<_Rows, _Inner, _T>& i_lhs,
+                         const matrix<_Inner, _Columns, _T>& i_rhs,
+                         classical_policy = {} ) noexcept
+{
+    return i_lhs * i_rhs;
+}
+
+
+/**
+ * @brief Multiply two square matrices with the Strassen-Winograd recursion
+ *
+ * Trades some accuracy for fewer operations on large orders; element types other than float and double, and orders
+ * at or below the cutoff, use the classical product.
+ *
+ * @param i_lhs First matrix
+ * @param i_rhs Second matrix
+ * @param i_policy where the recursion hands over to the blocked kernel
+ * @return Product of multiplication
+ */
+template<uint64_t _Order, typename _T>
+auto multiply( const matrix<_Order, _Order, _T>& i_lhs,
+               const matrix<_Order, _Order, _T>& i_rhs,
+               const strassen_policy& i_policy )
+{
+    if constexpr( gemm::is_supported_v<_T> )
+    {
+        auto mat{ matrix<_Order, _Order, _T>{ false } };
+
+        strassen::multiply<_T>( _Order,
+                                i_lhs[0].data(),
+                                _Order,
+                                i_rhs[0].data(),
+                                _Order,
+                                mat[0].data(),
+                                _Order,
+                                i_policy,
+                                strassen::workspace<_T>::local() );
+
+        return mat;
+    }
+    else
+    {
+        return i_lhs * i_rhs;
+    }
+}
+
+
+template<std::uint64_t _Order, typename _T = double>
+constexpr static auto IdentityMatrix = matrix<_Order, _Order, _T>{};
+
+
+/**
+ * @brief LU decomposition with partial pivoting of a square matrix: P * A = L * U
+ *
+ * L has a unit diagonal and is stored below the diagonal of the factors, U on and above it. Over floating point types
+ * each step pivots on the largest remaining element of its column, so the multipliers stay within [-1, 1]. Over an
+ * exact field any non-zero element will do, and the first one is taken.
+ *
+ * @tparam _Order Order of the matrix
+ * @tparam _T Type of matrix element
+ */
+template<uint64_t _Order, typename _T>
+struct lu_decomposition
+{
+    using value_type = _T;
+
+    matrix<_Order, _Order, value_type> factors{ false };
+
+    std::array<uint64_t, _Order> permutation{};  // row of A that ended up in each row of P * A
+
+    bool odd_permutation{ false };
+
+    bool singular{ false };
+
+
+    /**
+     * @brief Decompose a matrix
+     *
+     * @tparam _Operand Type of the matrix or view
+     * @param i_matrix square matrix or view, copied into the factors
+     */
+    template<typename _Operand, typename = std::enable_if_t<is_matrix_operand_v<_Operand>>>
+    constexpr explicit lu_decomposition( const _Operand& i_matrix ) noexcept : factors( i_matrix )
+    {
+        static_assert( _Operand::Rows() == _Order && _Operand::Columns() == _Order, "Orders have to match!" );
+
+        for( auto row{ 0_ui64 }; row < _Order; ++row )
+        {
+            permutation[row] = row;
+        }
+
+        for( auto k{ 0_ui64 }; k < _Order; ++k )
+        {
+            auto pivot{ k };
+
+            if constexpr( ring_traits<value_type>::elimination == elimination_kind::partial_pivoting )
+            {
+                for( auto row{ k + 1 }; row < _Order; ++row )
+                {
+                    if( magnitude( factors[row][k] ) > magnitude( factors[pivot][k] ) )
+                    {
+                        pivot = row;
+                    }
+                }
+            }
+            else
+            {
+                while( pivot + 1 < _Order && factors[pivot][k] == static_cast<value_type>( 0 ) )
+                {
+                    ++pivot;
+                }
+            }
+
+            if( factors[pivot][k] == static_cast<value_type>( 0 ) )
+            {
+                // nothing left to eliminate in this column
+                singular = true;
+                continue;
+            }
+
+            if( pivot != k )
+            {
+                swap_rows( pivot, k );
+            }
+
+            for( auto row{ k + 1 }; row < _Order; ++row )
+            {
+                auto multiplier{ factors[row][k] / factors[k][k] };
+                factors[row][k] = multiplier;
+
+                for( auto col{ k + 1 }; col < _Order; ++col )
+                {
+                    factors[row][col] -= multiplier * factors[k][col];
+                }
+            }
+        }
+    }
+
+
+    /**
+     * @brief Determinant of the decomposed matrix: the product of the pivots, signed by the permutation
+     *
+     * @return Value of determinant
+     */
+    constexpr value_type determinant() const noexcept
+    {
+        if( singular )
+        {
+            return static_cast<value_type>( 0 );
+        }
+
+        auto det{ static_cast<value_type>( 1 ) };
+
+        for( auto k{ 0_ui64 }; k < _Order; ++k )
+        {
+            det *= factors[k][k];
+        }
+
+        return odd_permutation ? -det : det;
+    }
+
+
+    /**
+     * @brief Solve A * X = B by forward and back substitution, one column of B at a time
+     *
+     * @tparam _Operand Type of the matrix, expression or view of right-hand sides
+     * @param i_rhs right-hand sides
+     * @return solutions, one per column
+     */
+    template<typename _Operand, typename = std::enable_if_t<is_matrix_operand_v<_Operand>>>
+    constexpr auto solve( const _Operand& i_rhs ) const
+    {
+        static_assert( _Operand::Rows() == _Order, "Right-hand sides should have as many rows as the matrix!" );
+
+        constexpr auto columns = _Operand::Columns();
+
+        if( singular )
+        {
+            throw std::domain_error{ "Cannot solve a system with a singular matrix!" };
+        }
+
+        auto solution{ matrix<_Order, columns, value_type>{ false } };
+
+        for( auto row{ 0_ui64 }; row < _Order; ++row )
+        {
+            for( auto col{ 0_ui64 }; col < columns; ++col )
+            {
+                solution[row][col] = i_rhs( permutation[row], col );
+            }
+        }
+
+        for( auto col{ 0_ui64 }; col < columns; ++col )
+        {
+            for( auto row{ 1_ui64 }; row < _Order; ++row )
+            {
+                for( auto k{ 0_ui64 }; k < row; ++k )
+                {
+                    solution[row][col] -= factors[row][k] * solution[k][col];
+                }
+            }
+
+            for( auto row{ _Order }; row-- > 0; )
+            {
+                for( auto k{ row + 1 }; k < _Order; ++k )
+                {
+                    solution[row][col] -= factors[row][k] * solution[k][col];
+                }
+
+                solution[row][col] /= factors[row][row];
+            }
+        }
+
+        return solution;
+    }
+
+
+    /**
+     * @brief Solve A * x = b
+     *
+     * @param i_rhs right-hand side
+     * @return solution
+     */
+    constexpr auto solve( const std::array<value_type, _Order>& i_rhs ) const
+    {
+        auto column{ matrix<_Order, 1, value_type>{ false } };
+
+        for( auto row{ 0_ui64 }; row < _Order; ++row )
+        {
+            column[row][0] = i_rhs[row];
+        }
+
+        auto solved{ solve( column ) };
+        auto solution{ std::array<value_type, _Order>{} };
+
+        for( auto row{ 0_ui64 }; row < _Order; ++row )
+        {
+            solution[row] = solved[row][0];
+        }
+
+        return solution;
+    }
+
+private:
+    static constexpr value_type magnitude( value_type i_value ) noexcept
+    {
+        return i_value < static_cast<value_type>( 0 ) ? -i_value : i_value;
+    }
+
+
+    constexpr void swap_rows( uint64_t i_first, uint64_t i_second ) noexcept
+    {
+        for( auto col{ 0_ui64 }; col < _Order; ++col )
+        {
+            auto value{ factors[i_first][col] };
+            factors[i_first][col] = factors[i_second][col];
+            factors[i_second][col] = value;
+        }
+
+        auto row{ permutation[i_first] };
+        permutation[i_first] = permutation[i_second];
+        permutation[i_second] = row;
+
+        odd_permutation = !odd_permutation;
+    }
+};
 
 
 /**
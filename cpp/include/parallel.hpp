@@ -0,0 +1,467 @@
+/**
+ * @file parallel.hpp
+ * @author ashwinn76
+ * @brief Splitting large matrix operations across threads by output tiles
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * The output is cut into tiles and each thread starts with an equal, contiguous range of them, so a regular shape
+ * needs no coordination beyond one atomic per tile taken. A thread that finishes its range steals single tiles from
+ * the back of the fullest remaining range, which evens out the smaller tiles at the ragged edges and threads that
+ * were scheduled late. Below a size threshold everything runs on the calling thread.
+ *
+ * The threads come from a pool that is started on first use and grown to the largest count asked for, so a product
+ * does not pay for creating threads, nor for their per-thread packing buffers, every time it runs. A thread of the
+ * pool, and a thread already waiting on the pool, runs any operation nested inside its work alone; the stealing makes
+ * that correct, since the calling thread alone takes every tile no other thread joined in for. For the same reason a
+ * pool that cannot start another thread goes on with the ones it has. An exception thrown by the work on any thread
+ * is rethrown to the caller once every thread has left the operation.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "gemm.hpp"
+
+namespace parallel
+{
+/**
+ * @brief How far large matrix operations are spread
+ *
+ */
+struct parallel_options_s
+{
+    std::size_t threads{ std::max( 1u, std::thread::hardware_concurrency() ) };
+
+    uint64_t product_threshold{ 128_ui64 * 128 * 128 };  // multiply-adds below which a product stays on one thread
+
+    uint64_t element_threshold{ 1_ui64 << 18 };  // elements below which an element-wise operation stays on one thread
+
+    std::size_t product_tile{ 128_sz };  // rows and columns of the product computed as one unit of work
+
+    std::size_t element_tile{ 1_sz << 14 };  // elements per unit of element-wise work, rounded to whole rows
+};
+
+
+/**
+ * @brief Process-wide options; change them before matrices are used from several threads
+ *
+ */
+inline parallel_options_s& options() noexcept
+{
+    static auto instance{ parallel_options_s{} };
+    return instance;
+}
+
+
+/**
+ * @brief Tiles not yet taken from one thread's range, begin in the high half and end in the low half
+ *
+ */
+struct alignas( 64 ) tile_range
+{
+    std::atomic<uint64_t> bounds{ 0_ui64 };
+
+    static constexpr uint64_t pack( uint64_t i_begin, uint64_t i_end ) noexcept
+    {
+        return ( i_begin << 32 ) | i_end;
+    }
+
+
+    /**
+     * @brief Take the first tile, as the owner does
+     *
+     */
+    std::optional<std::size_t> take_front() noexcept
+    {
+        auto current{ bounds.load( std::memory_order_relaxed ) };
+
+        while( ( current >> 32 ) < ( current & 0xFFFFFFFF ) )
+        {
+            if( bounds.compare_exchange_weak( current, current + ( 1_ui64 << 32 ), std::memory_order_relaxed ) )
+            {
+                return static_cast<std::size_t>( current >> 32 );
+            }
+        }
+
+        return std::nullopt;
+    }
+
+
+    /**
+     * @brief Take the last tile, as a thief does
+     *
+     */
+    std::optional<std::size_t> take_back() noexcept
+    {
+        auto current{ bounds.load( std::memory_order_relaxed ) };
+
+        while( ( current >> 32 ) < ( current & 0xFFFFFFFF ) )
+        {
+            if( bounds.compare_exchange_weak( current, current - 1, std::memory_order_relaxed ) )
+            {
+                return static_cast<std::size_t>( ( current & 0xFFFFFFFF ) - 1 );
+            }
+        }
+
+        return std::nullopt;
+    }
+
+
+    uint64_t remaining() const noexcept
+    {
+        auto current{ bounds.load( std::memory_order_relaxed ) };
+        auto begin{ current >> 32 };
+        auto end{ current & 0xFFFFFFFF };
+
+        return begin < end ? end - begin : 0;
+    }
+};
+
+
+/**
+ * @brief Threads kept waiting between operations, so that each operation only has to wake them
+ *
+ * One operation at a time uses the pool; another thread that asks meanwhile does its work alone.
+ */
+class worker_pool
+{
+    std::mutex m_mutex{};
+    std::condition_variable m_wake{};
+    std::condition_variable m_done{};
+    std::vector<std::thread> m_workers{};
+
+    void ( *m_call )( void*, std::size_t ){ nullptr };  // work of the current operation, with its state
+    void* m_context{ nullptr };
+
+    std::size_t m_open{ 0_sz };  // slots of the current operation no worker has taken yet
+    std::size_t m_next{ 0_sz };  // index the next worker joins as
+    std::size_t m_running{ 0_sz };  // workers inside the current operation
+
+    std::exception_ptr m_error{};  // first exception a worker's call of the current operation threw
+
+    bool m_busy{ false };
+    bool m_stopping{ false };
+
+
+    static bool& inside() noexcept
+    {
+        thread_local auto flag{ false };
+        return flag;
+    }
+
+
+    void serve()
+    {
+        inside() = true;
+
+        auto lock{ std::unique_lock{ m_mutex } };
+
+        for( ;; )
+        {
+            m_wake.wait( lock, [this] { return m_stopping || m_open > 0; } );
+
+            if( m_stopping )
+            {
+                return;
+            }
+
+            --m_open;
+            ++m_running;
+
+            auto self{ m_next++ };
+            auto call{ m_call };
+            auto context{ m_context };
+
+            auto error{ std::exception_ptr{} };
+
+            lock.unlock();
+
+            try
+            {
+                call( context, self );
+            }
+            catch( ... )
+            {
+                error = std::current_exception();
+            }
+
+            lock.lock();
+
+            if( error && !m_error )
+            {
+                m_error = error;
+            }
+
+            if( --m_running == 0 )
+            {
+                m_done.notify_all();
+            }
+        }
+    }
+
+public:
+    worker_pool() = default;
+
+    worker_pool( const worker_pool& ) = delete;
+    worker_pool& operator=( const worker_pool& ) = delete;
+
+
+    ~worker_pool()
+    {
+        {
+            auto lock{ std::lock_guard{ m_mutex } };
+            m_stopping = true;
+        }
+
+        m_wake.notify_all();
+
+        for( auto&& worker : m_workers )
+        {
+            worker.join();
+        }
+    }
+
+
+    /**
+     * @brief Process-wide pool, started on first use
+     *
+     */
+    static worker_pool& instance()
+    {
+        static auto pool{ worker_pool{} };
+        return pool;
+    }
+
+
+    /**
+     * @brief Call a function with 0 on the calling thread and with 1 to i_threads - 1 on up to as many workers
+     *
+     * Returns once every call has returned. Workers that are late, or missing because the pool is in use or could
+     * not start another thread, are not waited for, so the function has to finish the work even if only the call
+     * with 0 is made.
+     *
+     * @param i_threads threads to use, the calling one included
+     * @param i_work called with a thread index
+     * @throw the first exception a call threw, once every call has returned
+     */
+    template<typename _Work>
+    void run( std::size_t i_threads, _Work& i_work )
+    {
+        {
+            auto lock{ std::lock_guard{ m_mutex } };
+
+            if( inside() || m_busy )
+            {
+                i_work( 0_sz );
+                return;
+            }
+
+            m_busy = true;
+
+            try
+            {
+                while( m_workers.size() + 1 < i_threads )
+                {
+                    m_workers.emplace_back( [this] { serve(); } );
+                }
+            }
+            catch( ... )
+            {
+                // the calling thread takes whatever the missing workers would have
+            }
+
+            m_call = []( void* i_context, std::size_t i_self ) { ( *static_cast<_Work*>( i_context ) )( i_self ); };
+            m_context = &i_work;
+            m_open = std::min( i_threads - 1, m_workers.size() );
+            m_next = 1_sz;
+            m_error = nullptr;
+        }
+
+        m_wake.notify_all();
+
+        auto error{ std::exception_ptr{} };
+
+        inside() = true;
+
+        try
+        {
+            i_work( 0_sz );
+        }
+        catch( ... )
+        {
+            error = std::current_exception();
+        }
+
+        inside() = false;
+
+        auto lock{ std::unique_lock{ m_mutex } };
+
+        // the workers use the caller's state, so even a failed call waits for them
+        m_open = 0_sz;
+        m_done.wait( lock, [this] { return m_running == 0; } );
+        m_busy = false;
+
+        if( !error )
+        {
+            error = std::exchange( m_error, nullptr );
+        }
+
+        m_error = nullptr;
+
+        if( error )
+        {
+            std::rethrow_exception( error );
+        }
+    }
+};
+
+
+/**
+ * @brief Run a function once for every tile, on up to a number of threads including the calling one
+ *
+ * @param i_tiles number of tiles
+ * @param i_threads threads to use
+ * @param i_work called with a tile index, concurrently for different tiles
+ * @throw the first exception a tile threw, once every thread is done
+ */
+template<typename _Work>
+void for_each_tile( std::size_t i_tiles, std::size_t i_threads, _Work&& i_work )
+{
+    auto threads{ std::min( i_threads, i_tiles ) };
+
+    if( threads <= 1 )
+    {
+        for( auto tile{ 0_sz }; tile < i_tiles; ++tile )
+        {
+            i_work( tile );
+        }
+
+        return;
+    }
+
+    auto ranges{ std::unique_ptr<tile_range[]>{ new tile_range[threads] } };
+
+    for( auto i{ 0_sz }; i < threads; ++i )
+    {
+        ranges[i].bounds.store( tile_range::pack( i_tiles * i / threads, i_tiles * ( i + 1 ) / threads ) );
+    }
+
+    auto run{ [&]( std::size_t i_self ) {
+        for( ;; )
+        {
+            auto tile{ ranges[i_self].take_front() };
+
+            while( !tile )
+            {
+                auto victim{ i_self };
+
+                for( auto i{ 0_sz }; i < threads; ++i )
+                {
+                    if( ranges[i].remaining() > ranges[victim].remaining() )
+                    {
+                        victim = i;
+                    }
+                }
+
+                if( victim == i_self )
+                {
+                    return;
+                }
+
+                tile = ranges[victim].take_back();
+            }
+
+            i_work( *tile );
+        }
+    } };
+
+    worker_pool::instance().run( threads, run );
+}
+
+
+/**
+ * @brief Row-major product C = A * B, split by tiles of C across threads once it is large enough
+ *
+ */
+template<typename _T>
+void multiply( std::size_t i_m,
+               std::size_t i_n,
+               std::size_t i_k,
+               const _T* i_a,
+               std::size_t i_lda,
+               const _T* i_b,
+               std::size_t i_ldb,
+               _T* o_c,
+               std::size_t i_ldc )
+{
+    auto& settings{ options() };
+
+    if( static_cast<uint64_t>( i_m ) * i_n * i_k < settings.product_threshold || settings.threads <= 1 )
+    {
+        gemm::multiply( i_m, i_n, i_k, i_a, i_lda, i_b, i_ldb, o_c, i_ldc );
+        return;
+    }
+
+    auto edge{ std::max( settings.product_tile, 1_sz ) };
+    auto row_tiles{ ( i_m + edge - 1 ) / edge };
+    auto column_tiles{ ( i_n + edge - 1 ) / edge };
+
+    // tiles of a row band are adjacent, so a thread's range mostly shares the rows of A it packs
+    for_each_tile( row_tiles * column_tiles, settings.threads, [&]( std::size_t i_tile ) {
+        auto row{ i_tile / column_tiles * edge };
+        auto column{ i_tile % column_tiles * edge };
+
+        gemm::multiply( std::min( edge, i_m - row ),
+                        std::min( edge, i_n - column ),
+                        i_k,
+                        i_a + row * i_lda,
+                        i_lda,
+                        i_b + column,
+                        i_ldb,
+                        o_c + row * i_ldc + column,
+                        i_ldc );
+    } );
+}
+
+
+/**
+ * @brief Run a function over bands of whole rows, across threads once there are enough elements
+ *
+ * @param i_rows number of rows
+ * @param i_columns number of columns
+ * @param i_work called with the first row of a band and the row after it
+ * @throw the first exception a band threw, once every thread is done
+ */
+template<typename _Work>
+void for_row_bands( std::size_t i_rows, std::size_t i_columns, _Work&& i_work )
+{
+    auto& settings{ options() };
+
+    if( static_cast<uint64_t>( i_rows ) * i_columns < settings.element_threshold || settings.threads <= 1 )
+    {
+        i_work( 0_sz, i_rows );
+        return;
+    }
+
+    auto band{ std::max( settings.element_tile / std::max( i_columns, 1_sz ), 1_sz ) };
+
+    for_each_tile( ( i_rows + band - 1 ) / band, settings.threads, [&]( std::size_t i_tile ) {
+        i_work( i_tile * band, std::min( i_rows, ( i_tile + 1 ) * band ) );
+    } );
+}
+
+}
@@ -0,0 +1,422 @@
+/**
+ * @file ring.hpp
+ * @author ashwinn76
+ * @brief Exact element types for matrices, and the traits that pick their elimination
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * A matrix element type tells the determinant and the inverse how to eliminate through ring_traits, which other types
+ * can specialise. Floating point types pivot on the largest element. Fields such as GF(2^8) pivot on any non-zero
+ * element and divide exactly. Integers and the residues modulo n are only a ring: their elimination uses Euclid's
+ * algorithm on the rows, which never divides, and integer determinants use Bareiss' fraction-free elimination.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <stdexcept>
+#include <type_traits>
+
+#include "macro_utils.hpp"
+
+/**
+ * @brief How a matrix of an element type is reduced for its determinant and inverse
+ *
+ */
+enum class elimination_kind
+{
+    partial_pivoting,  // inexact division, pivoting on magnitude for stability
+    field,  // exact division by every non-zero element
+    euclidean,  // a ring: row operations from Euclid's algorithm, inverting only units
+};
+
+
+/**
+ * @brief Ring or field policy of a matrix element type
+ *
+ * The primary template covers floating point and signed integer types; a new element type specialises it.
+ *
+ * @tparam _T Type of matrix element
+ */
+template<typename _T>
+struct ring_traits
+{
+    static constexpr auto is_ring = std::is_floating_point_v<_T> || ( std::is_integral_v<_T> && std::is_signed_v<_T> );
+
+    static constexpr auto elimination =
+        std::is_floating_point_v<_T> ? elimination_kind::partial_pivoting : elimination_kind::euclidean;
+
+
+    /**
+     * @brief Quotient of Euclid's algorithm: i_lhs - quotient * i_rhs is smaller than i_rhs
+     *
+     */
+    static constexpr _T quotient( _T i_lhs, _T i_rhs ) noexcept
+    {
+        return i_lhs / i_rhs;
+    }
+
+
+    static constexpr bool is_unit( _T i_value ) noexcept
+    {
+        return i_value == 1 || i_value == -1;
+    }
+
+
+    /**
+     * @brief Inverse of a unit, which for the integers is the unit itself
+     *
+     */
+    static constexpr _T unit_inverse( _T i_value ) noexcept
+    {
+        return i_value;
+    }
+};
+
+
+/**
+ * @brief Residue modulo a number: the ring Z_n, a field when the modulus is prime
+ *
+ * @tparam _Modulus modulus, at most 2^32 so that products fit in 64 bits
+ */
+template<uint64_t _Modulus>
+class modular
+{
+    static_assert( _Modulus >= 2 && _Modulus <= ( 1_ui64 << 32 ), "Modulus has to be within [2, 2^32]!" );
+
+    uint64_t m_value{ 0_ui64 };  // in [0, modulus)
+
+public:
+    constexpr modular() noexcept = default;
+
+
+    /**
+     * @brief Residue of an integer, negative ones included
+     *
+     */
+    constexpr modular( int64_t i_value ) noexcept
+    {
+        auto residue{ i_value % static_cast<int64_t>( _Modulus ) };
+        m_value = static_cast<uint64_t>( residue < 0 ? residue + static_cast<int64_t>( _Modulus ) : residue );
+    }
+
+
+    /**
+     * @brief Representative in [0, modulus)
+     *
+     */
+    constexpr uint64_t value() const noexcept
+    {
+        return m_value;
+    }
+
+
+    __CONSTEVAL static auto modulus() noexcept
+    {
+        return _Modulus;
+    }
+
+
+    /**
+     * @brief Multiplicative inverse, by the extended Euclidean algorithm
+     *
+     * @throw std::domain_error if the residue shares a factor with the modulus
+     */
+    constexpr modular inverse() const
+    {
+        auto r0{ static_cast<int64_t>( _Modulus ) };
+        auto r1{ static_cast<int64_t>( m_value ) };
+        auto t0{ 0_i64 };
+        auto t1{ 1_i64 };
+
+        while( r1 != 0 )
+        {
+            auto q{ r0 / r1 };
+
+            auto r{ r0 - q * r1 };
+            r0 = r1;
+            r1 = r;
+
+            auto t{ t0 - q * t1 };
+            t0 = t1;
+            t1 = t;
+        }
+
+        if( r0 != 1 )
+        {
+            throw std::domain_error{ "Residue has no inverse modulo the modulus!" };
+        }
+
+        return modular{ t0 };
+    }
+
+
+    constexpr modular& operator+=( modular i_other ) noexcept
+    {
+        m_value += i_other.m_value;
+        m_value -= m_value >= _Modulus ? _Modulus : 0;
+        return *this;
+    }
+
+
+    constexpr modular& operator-=( modular i_other ) noexcept
+    {
+        m_value += m_value < i_other.m_value ? _Modulus - i_other.m_value : -i_other.m_value;
+        return *this;
+    }
+
+
+    constexpr modular& operator*=( modular i_other ) noexcept
+    {
+        m_value = m_value * i_other.m_value % _Modulus;
+        return *this;
+    }
+
+
+    constexpr modular& operator/=( modular i_other )
+    {
+        return *this *= i_other.inverse();
+    }
+
+
+    constexpr modular operator-() const noexcept
+    {
+        return modular{} -= *this;
+    }
+
+
+    friend constexpr modular operator+( modular i_lhs, modular i_rhs ) noexcept
+    {
+        return i_lhs += i_rhs;
+    }
+
+
+    friend constexpr modular operator-( modular i_lhs, modular i_rhs ) noexcept
+    {
+        return i_lhs -= i_rhs;
+    }
+
+
+    friend constexpr modular operator*( modular i_lhs, modular i_rhs ) noexcept
+    {
+        return i_lhs *= i_rhs;
+    }
+
+
+    friend constexpr modular operator/( modular i_lhs, modular i_rhs )
+    {
+        return i_lhs /= i_rhs;
+    }
+
+
+    friend constexpr bool operator==( modular i_lhs, modular i_rhs ) noexcept
+    {
+        return i_lhs.m_value == i_rhs.m_value;
+    }
+
+
+    friend constexpr bool operator!=( modular i_lhs, modular i_rhs ) noexcept
+    {
+        return !( i_lhs == i_rhs );
+    }
+};
+
+
+template<uint64_t _Modulus>
+struct ring_traits<modular<_Modulus>>
+{
+    using value_type = modular<_Modulus>;
+
+    static constexpr auto is_ring = true;
+
+    static constexpr auto elimination = elimination_kind::euclidean;
+
+
+    static constexpr value_type quotient( value_type i_lhs, value_type i_rhs ) noexcept
+    {
+        return value_type{ static_cast<int64_t>( i_lhs.value() / i_rhs.value() ) };
+    }
+
+
+    static constexpr bool is_unit( value_type i_value ) noexcept
+    {
+        auto a{ i_value.value() };
+        auto b{ _Modulus };
+
+        while( b != 0 )
+        {
+            auto r{ a % b };
+            a = b;
+            b = r;
+        }
+
+        return a == 1;
+    }
+
+
+    static constexpr value_type unit_inverse( value_type i_value )
+    {
+        return i_value.inverse();
+    }
+};
+
+
+namespace galois
+{
+/**
+ * @brief Powers of the generator x + 1 of GF(2^8), twice over so that two logarithms can be added without reduction
+ *
+ */
+struct tables_s
+{
+    std::array<uint8_t, 510> exp{};
+    std::array<uint8_t, 256> log{};
+};
+
+
+constexpr tables_s make_tables() noexcept
+{
+    auto tables{ tables_s{} };
+    auto power{ 1_ui32 };
+
+    for( auto i{ 0_sz }; i < 255; ++i )
+    {
+        tables.exp[i] = static_cast<uint8_t>( power );
+        tables.exp[i + 255] = static_cast<uint8_t>( power );
+        tables.log[power] = static_cast<uint8_t>( i );
+
+        // multiply by x + 1: x * power ^ power, reduced by the polynomial
+        auto doubled{ power << 1 };
+        power ^= doubled ^ ( doubled & 0x100 ? 0x11B : 0 );
+    }
+
+    return tables;
+}
+
+
+inline constexpr auto tables = make_tables();
+
+}
+
+
+/**
+ * @brief Element of GF(2^8) with the AES reduction polynomial x^8 + x^4 + x^3 + x + 1
+ *
+ * Addition is XOR; multiplication goes through logarithm tables to the generator x + 1.
+ */
+class gf256
+{
+    uint8_t m_value{ 0 };
+
+public:
+    constexpr gf256() noexcept = default;
+
+
+    constexpr gf256( uint8_t i_value ) noexcept : m_value{ i_value }
+    {
+    }
+
+
+    constexpr uint8_t value() const noexcept
+    {
+        return m_value;
+    }
+
+
+    /**
+     * @brief Multiplicative inverse
+     *
+     * @throw std::domain_error for zero
+     */
+    constexpr gf256 inverse() const
+    {
+        if( m_value == 0 )
+        {
+            throw std::domain_error{ "Zero has no inverse in GF(2^8)!" };
+        }
+
+        return gf256{ galois::tables.exp[255 - galois::tables.log[m_value]] };
+    }
+
+
+    constexpr gf256& operator+=( gf256 i_other ) noexcept
+    {
+        m_value ^= i_other.m_value;
+        return *this;
+    }
+
+
+    constexpr gf256& operator-=( gf256 i_other ) noexcept
+    {
+        return *this += i_other;
+    }
+
+
+    constexpr gf256& operator*=( gf256 i_other ) noexcept
+    {
+        m_value = m_value == 0 || i_other.m_value == 0
+                      ? 0
+                      : galois::tables.exp[galois::tables.log[m_value] + galois::tables.log[i_other.m_value]];
+        return *this;
+    }
+
+
+    constexpr gf256& operator/=( gf256 i_other )
+    {
+        return *this *= i_other.inverse();
+    }
+
+
+    constexpr gf256 operator-() const noexcept
+    {
+        return *this;
+    }
+
+
+    friend constexpr gf256 operator+( gf256 i_lhs, gf256 i_rhs ) noexcept
+    {
+        return i_lhs += i_rhs;
+    }
+
+
+    friend constexpr gf256 operator-( gf256 i_lhs, gf256 i_rhs ) noexcept
+    {
+        return i_lhs -= i_rhs;
+    }
+
+
+    friend constexpr gf256 operator*( gf256 i_lhs, gf256 i_rhs ) noexcept
+    {
+        return i_lhs *= i_rhs;
+    }
+
+
+    friend constexpr gf256 operator/( gf256 i_lhs, gf256 i_rhs )
+    {
+        return i_lhs /= i_rhs;
+    }
+
+
+    friend constexpr bool operator==( gf256 i_lhs, gf256 i_rhs ) noexcept
+    {
+        return i_lhs.m_value == i_rhs.m_value;
+    }
+
+
+    friend constexpr bool operator!=( gf256 i_lhs, gf256 i_rhs ) noexcept
+    {
+        return !( i_lhs == i_rhs );
+    }
+};
+
+
+template<>
+struct ring_traits<gf256>
+{
+    static constexpr auto is_ring = true;
+
+    static constexpr auto elimination = elimination_kind::field;
+};
@@ -0,0 +1,235 @@
+/**
+ * @file strassen.hpp
+ * @author ashwinn76
+ * @brief Strassen-Winograd multiplication of large square matrices, over the blocked kernel
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Each level splits the operands into quadrants and forms the product from 7 half-size products and 15 quadrant
+ * additions instead of 8 products, so the work drops by about 1/8 per level. The recursion stops at an odd order or
+ * at the cutoff, where the blocked kernel takes over. The products and sums are scheduled as by Boyer, Dumas, Pernet
+ * and Zhou (2009): besides the quadrants of the result, a level needs only two temporaries of a quadrant each. All
+ * levels take them from one workspace sized up front, so nothing is allocated during the recursion.
+ *
+ * The additions cost accuracy: the error bound grows with the depth of the recursion, where the classical product's
+ * does not. The policy is therefore opt-in.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "parallel.hpp"
+
+/**
+ * @brief Product policy of the classical O(n^3) algorithm, the default
+ *
+ */
+struct classical_policy
+{
+};
+
+
+/**
+ * @brief Product policy of the Strassen-Winograd recursion, for square float and double matrices
+ *
+ */
+struct strassen_policy
+{
+    std::size_t cutoff{ 512_sz };  // order at and below which the blocked kernel multiplies
+};
+
+
+namespace strassen
+{
+/**
+ * @brief Scratch memory for every level of the recursion, reused between products
+ *
+ * @tparam _T Type of matrix element
+ */
+template<typename _T>
+class workspace
+{
+public:
+    /**
+     * @brief Elements a product of an order needs
+     *
+     */
+    static std::size_t required( std::size_t i_order, std::size_t i_cutoff ) noexcept
+    {
+        auto total{ 0_sz };
+
+        for( auto order{ i_order }; order % 2 == 0 && order > i_cutoff; order /= 2 )
+        {
+            total += 2 * ( order / 2 ) * ( order / 2 );
+        }
+
+        return total;
+    }
+
+
+    /**
+     * @brief Make room for a product of an order
+     *
+     * @return scratch memory, valid until the next reserve
+     */
+    _T* reserve( std::size_t i_order, std::size_t i_cutoff )
+    {
+        auto size{ required( i_order, i_cutoff ) };
+
+        if( m_buffer.size() < size )
+        {
+            m_buffer.resize( size );
+        }
+
+        return m_buffer.data();
+    }
+
+
+    std::size_t capacity() const noexcept
+    {
+        return m_buffer.size();
+    }
+
+
+    /**
+     * @brief Workspace of the calling thread
+     *
+     */
+    static workspace& local()
+    {
+        thread_local auto instance{ workspace{} };
+        return instance;
+    }
+
+private:
+    std::vector<_T> m_buffer{};
+};
+
+
+/**
+ * @brief o = l + r or o = l - r over an order x order block
+ *
+ */
+template<bool _Subtract, typename _T>
+void combine( std::size_t i_order,
+              _T* o_out,
+              std::size_t i_ldo,
+              const _T* i_lhs,
+              std::size_t i_ldl,
+              const _T* i_rhs,
+              std::size_t i_ldr ) noexcept
+{
+    for( auto i{ 0_sz }; i < i_order; ++i, o_out += i_ldo, i_lhs += i_ldl, i_rhs += i_ldr )
+    {
+        for( auto j{ 0_sz }; j < i_order; ++j )
+        {
+            o_out[j] = _Subtract ? i_lhs[j] - i_rhs[j] : i_lhs[j] + i_rhs[j];
+        }
+    }
+}
+
+
+/**
+ * @brief One level of the recursion: C = A * B for square row-major blocks
+ *
+ * @param io_scratch two quadrants of memory for this level, followed by what the deeper levels need
+ */
+template<typename _T>
+void winograd( std::size_t i_order,
+               const _T* i_a,
+               std::size_t i_lda,
+               const _T* i_b,
+               std::size_t i_ldb,
+               _T* o_c,
+               std::size_t i_ldc,
+               std::size_t i_cutoff,
+               _T* io_scratch )
+{
+    if( i_order % 2 != 0 || i_order <= i_cutoff )
+    {
+        parallel::multiply( i_order, i_order, i_order, i_a, i_lda, i_b, i_ldb, o_c, i_ldc );
+        return;
+    }
+
+    auto h{ i_order / 2 };
+
+    auto a11{ i_a };
+    auto a12{ i_a + h };
+    auto a21{ i_a + h * i_lda };
+    auto a22{ a21 + h };
+
+    auto b11{ i_b };
+    auto b12{ i_b + h };
+    auto b21{ i_b + h * i_ldb };
+    auto b22{ b21 + h };
+
+    auto c11{ o_c };
+    auto c12{ o_c + h };
+    auto c21{ o_c + h * i_ldc };
+    auto c22{ c21 + h };
+
+    auto x{ io_scratch };
+    auto y{ io_scratch + h * h };
+    auto deeper{ io_scratch + 2 * h * h };
+
+    auto product{ [&]( const _T* i_left, std::size_t i_ldl, const _T* i_right, std::size_t i_ldr, _T* o_out ) {
+        winograd( h, i_left, i_ldl, i_right, i_ldr, o_out, i_ldc, i_cutoff, deeper );
+    } };
+
+    combine<true>( h, x, h, a11, i_lda, a21, i_lda );  // S3 = A11 - A21
+    combine<true>( h, y, h, b22, i_ldb, b12, i_ldb );  // T3 = B22 - B12
+    product( x, h, y, h, c21 );  // P7 = S3 * T3
+    combine<false>( h, x, h, a21, i_lda, a22, i_lda );  // S1 = A21 + A22
+    combine<true>( h, y, h, b12, i_ldb, b11, i_ldb );  // T1 = B12 - B11
+    product( x, h, y, h, c22 );  // P5 = S1 * T1
+    combine<true>( h, x, h, x, h, a11, i_lda );  // S2 = S1 - A11
+    combine<true>( h, y, h, b22, i_ldb, y, h );  // T2 = B22 - T1
+    product( x, h, y, h, c12 );  // P6 = S2 * T2
+    combine<true>( h, x, h, a12, i_lda, x, h );  // S4 = A12 - S2
+    product( x, h, b22, i_ldb, c11 );  // P3 = S4 * B22
+
+    // P1 = A11 * B11 takes the temporary S4 no longer needs
+    winograd( h, a11, i_lda, b11, i_ldb, x, h, i_cutoff, deeper );
+
+    combine<false>( h, c12, i_ldc, x, h, c12, i_ldc );  // U2 = P1 + P6
+    combine<false>( h, c21, i_ldc, c12, i_ldc, c21, i_ldc );  // U3 = U2 + P7
+    combine<false>( h, c12, i_ldc, c12, i_ldc, c22, i_ldc );  // U4 = U2 + P5
+    combine<false>( h, c22, i_ldc, c21, i_ldc, c22, i_ldc );  // U7 = U3 + P5, C22
+    combine<false>( h, c12, i_ldc, c12, i_ldc, c11, i_ldc );  // U5 = U4 + P3, C12
+    combine<true>( h, y, h, y, h, b21, i_ldb );  // T4 = T2 - B21
+    product( a22, i_lda, y, h, c11 );  // P4 = A22 * T4
+    combine<true>( h, c21, i_ldc, c21, i_ldc, c11, i_ldc );  // U6 = U3 - P4, C21
+    product( a12, i_lda, b21, i_ldb, c11 );  // P2 = A12 * B21
+    combine<false>( h, c11, i_ldc, x, h, c11, i_ldc );  // U1 = P1 + P2, C11
+}
+
+
+/**
+ * @brief Row-major product C = A * B of two square matrices of an order
+ *
+ * @param io_workspace scratch memory, grown to what the order needs
+ */
+template<typename _T>
+void multiply( std::size_t i_order,
+               const _T* i_a,
+               std::size_t i_lda,
+               const _T* i_b,
+               std::size_t i_ldb,
+               _T* o_c,
+               std::size_t i_ldc,
+               const strassen_policy& i_policy,
+               workspace<_T>& io_workspace )
+{
+    static_assert( gemm::is_supported_v<_T>, "Strassen products are only implemented for float and double!" );
+
+    auto cutoff{ std::max( i_policy.cutoff, 1_sz ) };
+    auto scratch{ io_workspace.reserve( i_order, cutoff ) };
+
+    winograd( i_order, i_a, i_lda, i_b, i_ldb, o_c, i_ldc, cutoff, scratch );
+}
+
+}
@@ -0,0 +1,918 @@
+/**
+ * @file btree_vault.hpp
+ * @author ashwinn76
+ * @brief Page-oriented, memory-mapped B+tree vault format for very large stores
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Layout: the file is a sequence of 4 KB pages. Page 0 holds two plain, MAC-protected header slots, each naming a
+ * root page and the generation it belongs to. Every other page is sealed on its own (nonce || ciphertext || tag) with
+ * its page id and the generation that wrote it as associated data, and parents record both for each child, so a lookup
+ * decrypts only the pages on one root-to-leaf path and an old copy of a page cannot be passed off as the current one.
+ *
+ * Writes are copy-on-write: a page reachable from the published root is never rewritten, its changed copy goes to a
+ * new page. flush() syncs those pages and only then publishes the new root into the older header slot, so a crash at
+ * any point leaves the tree of the last flush intact. A handle takes the writer file lock at its first change and keeps
+ * it until the flush, so writers in other processes wait for each other rather than building on a stale root.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sys/mman.h>
+
+#include "vault_crypto.hpp"
+#include "vault_io.hpp"
+
+namespace vault
+{
+/**
+ * @brief Options for opening or creating a B+tree vault
+ *
+ */
+struct btree_options_s
+{
+    uint32_t kdf_iterations{ 200000_ui32 };  // PBKDF2 iterations used when creating a vault
+    bool read_only{ false };  // open without write access
+};
+
+
+namespace
+{
+constexpr auto btree_magic = std::string_view{ "PWBTREE1" };
+
+constexpr auto btree_format_version = 2_ui32;
+
+constexpr auto page_size = 4096_ui64;
+
+constexpr auto header_slot_size = page_size / 2;
+
+constexpr auto page_payload_size = page_size - encryption::aead_overhead;
+
+constexpr auto node_header_size = 3_sz;  // type, count
+
+constexpr auto page_ref_size = 12_sz;  // page id, generation
+
+constexpr auto max_btree_name = 255_sz;
+
+constexpr auto max_btree_entry = 2000_sz;  // name plus secret, keeps two entries in every leaf
+
+constexpr auto no_page = 0_ui32;
+
+}
+
+
+/**
+ * @brief Check whether an existing file is a B+tree vault
+ *
+ * @param i_path file to probe
+ * @return true if the file starts with the B+tree vault magic
+ */
+inline bool is_btree_vault( const std::string& i_path )
+{
+    auto fd{ unique_fd{ ::open( i_path.c_str(), O_RDONLY | O_CLOEXEC ) } };
+    auto magic{ std::string( btree_magic.size(), '\0' ) };
+
+    return fd && ::pread( fd.get(), magic.data(), magic.size(), 0 ) == static_cast<ssize_t>( magic.size() ) &&
+           magic == btree_magic;
+}
+
+
+/**
+ * @brief B+tree vault with independently encrypted pages
+ *
+ */
+class btree_vault
+{
+public:
+    /**
+     * @brief Open a B+tree vault, creating it when it does not exist yet
+     *
+     * @param i_path vault file
+     * @param i_key master key
+     * @param i_options open options
+     */
+    btree_vault( std::string i_path, const encryption::encryption_key& i_key, btree_options_s i_options = {} ) :
+        m_path{ std::move( i_path ) },
+        m_options{ i_options }
+    {
+        m_fd = unique_fd::open( m_path, m_options.read_only ? O_RDONLY : O_RDWR | O_CREAT );
+
+        if( file_size( m_fd.get() ) == 0_ui64 )
+        {
+            if( m_options.read_only )
+            {
+                throw vault_error{ "Vault " + m_path + " does not exist" };
+            }
+
+            // another process may be creating it too
+            m_writer_lock.emplace( m_fd.get() );
+        }
+
+        if( file_size( m_fd.get() ) == 0_ui64 )
+        {
+            create( i_key );
+        }
+        else
+        {
+            read_header( i_key );
+        }
+
+        m_writer_lock.reset();
+
+        remap();
+    }
+
+
+    btree_vault( const btree_vault& ) = delete;
+    btree_vault& operator=( const btree_vault& ) = delete;
+
+
+    ~btree_vault()
+    {
+        try
+        {
+            flush();
+        }
+        catch( ... )
+        {
+        }
+
+        unmap();
+    }
+
+
+    /**
+     * @brief Look up a secret, decrypting one page per tree level
+     *
+     * @param i_name entry name
+     * @return secret, nothing if the entry does not exist
+     */
+    std::optional<std::string> get( std::string_view i_name ) const
+    {
+        auto node{ read_node( m_root ) };
+
+        while( node.type == node_type::internal )
+        {
+            node = read_node( node.children[child_index( node, i_name )] );
+        }
+
+        auto iter{ std::lower_bound( node.keys.begin(), node.keys.end(), i_name ) };
+
+        if( iter == node.keys.end() || *iter != i_name )
+        {
+            return std::nullopt;
+        }
+
+        return node.values[static_cast<std::size_t>( iter - node.keys.begin() )];
+    }
+
+
+    /**
+     * @brief Add a new entry
+     *
+     */
+    void put( std::string_view i_name, std::string_view i_secret )
+    {
+        store( i_name, i_secret, false );
+    }
+
+
+    /**
+     * @brief Replace the secret of an existing entry
+     *
+     */
+    void update( std::string_view i_name, std::string_view i_secret )
+    {
+        store( i_name, i_secret, true );
+    }
+
+
+    /**
+     * @brief Check whether an entry exists
+     *
+     */
+    bool contains( std::string_view i_name ) const
+    {
+        return get( i_name ).has_value();
+    }
+
+
+    /**
+     * @brief Visit all entries whose name starts with a prefix, in name order
+     *
+     * Copy-on-write pages cannot keep a chain of sibling links, so the scan walks down from the root and visits the
+     * children to the right of the first match in order.
+     *
+     * @param i_prefix name prefix, empty for every entry
+     * @param i_visitor called with (name, secret); return false to stop
+     */
+    template<typename _Visitor>
+    void scan( std::string_view i_prefix, _Visitor&& i_visitor ) const
+    {
+        scan_below( m_root, i_prefix, i_visitor );
+    }
+
+
+    /**
+     * @brief Number of entries
+     *
+     */
+    uint64_t size() const noexcept
+    {
+        return m_entries;
+    }
+
+
+    /**
+     * @brief Height of the tree, 1 for a single leaf
+     *
+     */
+    uint32_t height() const noexcept
+    {
+        return m_height;
+    }
+
+
+    /**
+     * @brief Make all page writes durable, publish the new root and release the writer lock
+     *
+     */
+    void flush()
+    {
+        if( !m_dirty || m_options.read_only )
+        {
+            return;
+        }
+
+        sync_data( m_fd.get() );
+        write_header( m_generation + 1 );
+        sync_data( m_fd.get() );
+
+        ++m_generation;
+        m_committed_pages = m_page_count;
+        m_dirty = false;
+
+        m_writer_lock.reset();
+    }
+
+
+    /**
+     * @brief Move to the newest root another handle published; a handle with changes not flushed yet keeps its own
+     *
+     * @return true if a newer root was found
+     */
+    bool refresh()
+    {
+        if( m_writer_lock )
+        {
+            return false;
+        }
+
+        // both header slots are authenticated and pages are durable before a root names them, so no lock is needed
+        auto page{ std::string( page_size, '\0' ) };
+        read_exact( m_fd.get(), page.data(), page.size(), 0_ui64 );
+
+        auto previous{ m_generation };
+        load_header( page );
+
+        if( m_page_count * page_size > m_mapped_size )
+        {
+            remap();
+        }
+
+        return m_generation != previous;
+    }
+
+private:
+    enum class node_type : uint8_t
+    {
+        leaf = 1,
+        internal = 2,
+    };
+
+
+    /**
+     * @brief Location of a page and the generation that wrote it
+     *
+     */
+    struct page_ref_s
+    {
+        uint32_t page{ no_page };
+        uint64_t generation{ 0_ui64 };
+    };
+
+
+    /**
+     * @brief Decoded tree node
+     *
+     */
+    struct node_s
+    {
+        node_type type{ node_type::leaf };
+        std::vector<std::string> keys{};
+        std::vector<std::string> values{};  // leaves only
+        std::vector<page_ref_s> children{};  // internal nodes only, keys.size() + 1 entries
+
+        std::size_t encoded_size() const noexcept
+        {
+            auto size{ node_header_size };
+
+            for( auto i{ 0_sz }; i < keys.size(); ++i )
+            {
+                size += 2 + keys[i].size() + ( type == node_type::leaf ? 2 + values[i].size() : page_ref_size );
+            }
+
+            return size + ( type == node_type::internal ? page_ref_size : 0 );
+        }
+    };
+
+    std::string m_path{};
+
+    btree_options_s m_options{};
+
+    unique_fd m_fd{};
+
+    std::optional<file_lock> m_writer_lock{};  // held from the first change until the flush
+
+    encryption::aead_key_t m_key{};
+
+    encryption::aead_key_t m_header_key{};
+
+    uint32_t m_iterations{ 0_ui32 };
+
+    std::vector<uint8_t> m_salt{};
+
+    std::vector<uint8_t> m_check{};
+
+    uint64_t m_generation{ 0_ui64 };  // generation of the published root
+
+    page_ref_s m_root{};
+
+    uint32_t m_page_count{ 1_ui32 };  // page 0 holds the header
+
+    uint32_t m_committed_pages{ 1_ui32 };  // pages at or past this one are unpublished and may be rewritten in place
+
+    uint32_t m_height{ 1_ui32 };
+
+    uint64_t m_entries{ 0_ui64 };
+
+    void* m_map{ nullptr };
+
+    std::size_t m_mapped_size{ 0_sz };
+
+    bool m_dirty{ false };
+
+
+    void create( const encryption::encryption_key& i_key )
+    {
+        m_iterations = m_options.kdf_iterations;
+        m_salt.resize( salt_size );
+        encryption::random_bytes( m_salt.data(), m_salt.size() );
+
+        set_keys( derive_master_key( i_key, m_salt, m_iterations ) );
+
+        m_root = write_node( {}, node_s{} );
+
+        // both slots start out valid, so the magic is at the start of the file from here on
+        write_header( 0_ui64 );
+        write_header( 1_ui64 );
+        sync_data( m_fd.get() );
+
+        m_generation = 1_ui64;
+        m_committed_pages = m_page_count;
+        m_dirty = false;
+    }
+
+
+    void set_keys( const encryption::aead_key_t& i_key )
+    {
+        m_key = derive_subkey( i_key, "btree pages" );
+        m_header_key = derive_subkey( i_key, "btree header" );
+
+        auto check{ master_key_check( i_key ) };
+        m_check.assign( check.begin(), check.begin() + key_check_size );
+    }
+
+
+    std::string header_fields( uint64_t i_generation ) const
+    {
+        auto writer{ byte_writer{} };
+        writer.put_bytes( btree_magic.data(), btree_magic.size() )
+            .put( btree_format_version )
+            .put( m_iterations )
+            .put_bytes( m_salt.data(), m_salt.size() )
+            .put_bytes( m_check.data(), m_check.size() )
+            .put( i_generation )
+            .put( m_root.page )
+            .put( m_root.generation )
+            .put( m_page_count )
+            .put( m_height )
+            .put( m_entries );
+
+        return writer.bytes();
+    }
+
+
+    /**
+     * @brief Write the header of a generation into its slot, the one not holding the generation before it
+     *
+     */
+    void write_header( uint64_t i_generation )
+    {
+        auto slot{ header_fields( i_generation ) };
+        auto mac{ encryption::hmac_sha256::mac( m_header_key.data(), m_header_key.size(), slot.data(), slot.size() ) };
+
+        slot.append( reinterpret_cast<const char*>( mac.data() ), mac.size() );
+        slot.resize( header_slot_size, '\0' );
+
+        write_exact( m_fd.get(), slot.data(), slot.size(), ( i_generation % 2 ) * header_slot_size );
+    }
+
+
+    void read_header( const encryption::encryption_key& i_key )
+    {
+        auto page{ std::string( page_size, '\0' ) };
+        read_exact( m_fd.get(), page.data(), page.size(), 0_ui64 );
+
+        // the fixed fields are the same in both slots, so even a torn slot 0 still holds them
+        auto reader{ byte_reader{ page } };
+
+        if( reader.get_bytes( btree_magic.size() ) != btree_magic )
+        {
+            throw vault_error{ m_path + " is not a B+tree vault" };
+        }
+
+        if( reader.get<uint32_t>() != btree_format_version )
+        {
+            throw vault_error{ "Unsupported vault format version" };
+        }
+
+        m_iterations = reader.get<uint32_t>();
+
+        auto salt{ reader.get_bytes( salt_size ) };
+        m_salt.assign( salt.begin(), salt.end() );
+
+        auto stored_check{ reader.get_bytes( key_check_size ) };
+
+        set_keys( derive_master_key( i_key, m_salt, m_iterations ) );
+
+        if( std::string_view{ reinterpret_cast<const char*>( m_check.data() ), m_check.size() } != stored_check )
+        {
+            throw vault_error{ "Wrong key for vault " + m_path };
+        }
+
+        load_header( page );
+    }
+
+
+    /**
+     * @brief Take the root from the newest header slot that passes authentication
+     *
+     */
+    void load_header( std::string_view i_page )
+    {
+        auto fields_size{ header_fields( 0_ui64 ).size() };
+        auto found{ false };
+
+        for( auto offset : { 0_ui64, header_slot_size } )
+        {
+            auto slot{ i_page.substr( offset, header_slot_size ) };
+            auto mac{
+                encryption::hmac_sha256::mac( m_header_key.data(), m_header_key.size(), slot.data(), fields_size ) };
+
+            if( slot.substr( fields_size, mac.size() ) !=
+                std::string_view{ reinterpret_cast<const char*>( mac.data() ), mac.size() } )
+            {
+                continue;
+            }
+
+            // the fixed fields were checked at open
+            auto reader{ byte_reader{ slot } };
+            reader.get_bytes( btree_magic.size() + sizeof( btree_format_version ) + sizeof( m_iterations ) + salt_size +
+                              key_check_size );
+
+            auto generation{ reader.get<uint64_t>() };
+
+            if( found && generation <= m_generation )
+            {
+                continue;
+            }
+
+            found = true;
+            m_generation = generation;
+            m_root.page = reader.get<uint32_t>();
+            m_root.generation = reader.get<uint64_t>();
+            m_page_count = reader.get<uint32_t>();
+            m_height = reader.get<uint32_t>();
+            m_entries = reader.get<uint64_t>();
+        }
+
+        if( !found )
+        {
+            throw vault_error{ "Vault header failed authentication" };
+        }
+
+        m_committed_pages = m_page_count;
+    }
+
+
+    /**
+     * @brief Take the writer lock before the first change since the last flush, picking up what other writers
+     *        published in the meantime
+     *
+     */
+    void begin_write()
+    {
+        if( m_writer_lock )
+        {
+            return;
+        }
+
+        m_writer_lock.emplace( m_fd.get() );
+
+        try
+        {
+            auto page{ std::string( page_size, '\0' ) };
+            read_exact( m_fd.get(), page.data(), page.size(), 0_ui64 );
+
+            load_header( page );
+
+            if( m_page_count * page_size > m_mapped_size )
+            {
+                remap();
+            }
+        }
+        catch( ... )
+        {
+            m_writer_lock.reset();
+            throw;
+        }
+    }
+
+
+    void unmap() noexcept
+    {
+        if( m_map )
+        {
+            ::munmap( m_map, m_mapped_size );
+            m_map = nullptr;
+            m_mapped_size = 0;
+        }
+    }
+
+
+    void remap()
+    {
+        unmap();
+
+        auto size{ file_size( m_fd.get() ) };
+
+        if( size == 0 )
+        {
+            return;
+        }
+
+        auto addr{ ::mmap( nullptr, size, PROT_READ, MAP_SHARED, m_fd.get(), 0 ) };
+
+        if( addr == MAP_FAILED )
+        {
+            throw vault_error{ "Unable to map vault " + m_path };
+        }
+
+        m_map = addr;
+        m_mapped_size = size;
+    }
+
+
+    std::string page_ad( page_ref_s i_page ) const
+    {
+        auto writer{ byte_writer{} };
+        writer.put_bytes( btree_magic.data(), btree_magic.size() ).put( i_page.page ).put( i_page.generation );
+
+        return writer.bytes();
+    }
+
+
+    node_s read_node( page_ref_s i_page ) const
+    {
+        if( i_page.page == no_page || i_page.page >= m_page_count ||
+            ( i_page.page + 1_ui64 ) * page_size > m_mapped_size )
+        {
+            throw vault_error{ "Vault page out of range" };
+        }
+
+        auto sealed{ static_cast<const uint8_t*>( m_map ) + i_page.page * page_size };
+
+        auto plain{ std::string{} };
+
+        if( !encryption::aead_open( m_key, page_ad( i_page ), sealed, page_size, plain ) )
+        {
+            throw vault_error{ "Vault page failed authentication" };
+        }
+
+        auto reader{ byte_reader{ plain } };
+
+        auto node{ node_s{} };
+        node.type = static_cast<node_type>( reader.get<uint8_t>() );
+
+        auto count{ reader.get<uint16_t>() };
+
+        auto get_ref{ [&reader]() {
+            auto page{ reader.get<uint32_t>() };
+            return page_ref_s{ page, reader.get<uint64_t>() };
+        } };
+
+        if( node.type == node_type::internal )
+        {
+            node.children.push_back( get_ref() );
+        }
+
+        for( auto i{ 0_ui16 }; i < count; ++i )
+        {
+            node.keys.emplace_back( reader.get_string() );
+
+            if( node.type == node_type::leaf )
+            {
+                node.values.emplace_back( reader.get_string() );
+            }
+            else
+            {
+                node.children.push_back( get_ref() );
+            }
+        }
+
+        return node;
+    }
+
+
+    /**
+     * @brief Write a node, in place when its page is not yet published and to a new page otherwise
+     *
+     * @param i_page page the node was read from, an empty reference for a new node
+     * @return where the node now lives
+     */
+    page_ref_s write_node( page_ref_s i_page, const node_s& i_node )
+    {
+        auto writer{ byte_writer{} };
+        writer.put( static_cast<uint8_t>( i_node.type ) ).put( static_cast<uint16_t>( i_node.keys.size() ) );
+
+        if( i_node.type == node_type::internal )
+        {
+            writer.put( i_node.children.front().page ).put( i_node.children.front().generation );
+        }
+
+        for( auto i{ 0_sz }; i < i_node.keys.size(); ++i )
+        {
+            writer.put_string( i_node.keys[i] );
+
+            if( i_node.type == node_type::leaf )
+            {
+                writer.put_string( i_node.values[i] );
+            }
+            else
+            {
+                writer.put( i_node.children[i + 1].page ).put( i_node.children[i + 1].generation );
+            }
+        }
+
+        auto plain{ writer.bytes() };
+        plain.resize( page_payload_size, '\0' );
+
+        auto page{ page_ref_s{ i_page.page >= m_committed_pages ? i_page.page : allocate_page(), m_generation + 1 } };
+        auto sealed{ encryption::aead_seal( m_key, page_ad( page ), plain ) };
+
+        write_exact( m_fd.get(), sealed.data(), sealed.size(), page.page * page_size );
+
+        m_dirty = true;
+
+        return page;
+    }
+
+
+    static std::size_t child_index( const node_s& i_node, std::string_view i_name )
+    {
+        return static_cast<std::size_t>( std::upper_bound( i_node.keys.begin(), i_node.keys.end(), i_name ) -
+                                         i_node.keys.begin() );
+    }
+
+
+    uint32_t allocate_page()
+    {
+        return m_page_count++;
+    }
+
+
+    /**
+     * @brief Visit the entries below a page that start with a prefix
+     *
+     * @return false once the visitor stopped or the entries moved past the prefix
+     */
+    template<typename _Visitor>
+    bool scan_below( page_ref_s i_page, std::string_view i_prefix, _Visitor& i_visitor ) const
+    {
+        auto node{ read_node( i_page ) };
+
+        if( node.type == node_type::internal )
+        {
+            for( auto i{ child_index( node, i_prefix ) }; i < node.children.size(); ++i )
+            {
+                if( !scan_below( node.children[i], i_prefix, i_visitor ) )
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        auto start{ static_cast<std::size_t>( std::lower_bound( node.keys.begin(), node.keys.end(), i_prefix ) -
+                                              node.keys.begin() ) };
+
+        for( auto i{ start }; i < node.keys.size(); ++i )
+        {
+            if( node.keys[i].compare( 0, i_prefix.size(), i_prefix ) != 0 ||
+                !i_visitor( std::string_view{ node.keys[i] }, std::string_view{ node.values[i] } ) )
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+
+    void store( std::string_view i_name, std::string_view i_secret, bool i_replace )
+    {
+        if( m_options.read_only )
+        {
+            throw vault_error{ "Vault " + m_path + " is open read-only" };
+        }
+
+        if( i_name.empty() || i_name.size() > max_btree_name || i_name.size() + i_secret.size() > max_btree_entry )
+        {
+            throw vault_error{ "Entry too large for a B+tree vault page" };
+        }
+
+        begin_write();
+
+        auto split{ std::optional<std::pair<std::string, page_ref_s>>{} };
+
+        try
+        {
+            split = insert( m_root, i_name, i_secret, i_replace );
+        }
+        catch( ... )
+        {
+            // nothing to publish, so other writers need not wait for a flush
+            if( !m_dirty )
+            {
+                m_writer_lock.reset();
+            }
+
+            throw;
+        }
+
+        if( split )
+        {
+            auto root{ node_s{ node_type::internal } };
+            root.keys.push_back( std::move( split->first ) );
+            root.children = { m_root, split->second };
+
+            m_root = write_node( {}, root );
+            ++m_height;
+        }
+
+        if( !i_replace )
+        {
+            ++m_entries;
+        }
+
+        if( m_page_count * page_size > m_mapped_size )
+        {
+            remap();
+        }
+    }
+
+
+    /**
+     * @brief Insert below a page
+     *
+     * @param io_page page to insert below, moved to wherever its changed copy was written
+     * @return separator and new right sibling when the page had to split
+     */
+    std::optional<std::pair<std::string, page_ref_s>> insert( page_ref_s& io_page,
+                                                              std::string_view i_name,
+                                                              std::string_view i_secret,
+                                                              bool i_replace )
+    {
+        auto node{ read_node( io_page ) };
+
+        if( node.type == node_type::leaf )
+        {
+            auto iter{ std::lower_bound( node.keys.begin(), node.keys.end(), i_name ) };
+            auto pos{ static_cast<std::size_t>( iter - node.keys.begin() ) };
+            auto exists{ iter != node.keys.end() && *iter == i_name };
+
+            if( exists != i_replace )
+            {
+                throw vault_error{ "Entry " + std::string{ i_name } +
+                                   ( exists ? " already exists" : " does not exist" ) };
+            }
+
+            if( exists )
+            {
+                node.values[pos] = std::string{ i_secret };
+            }
+            else
+            {
+                node.keys.insert( iter, std::string{ i_name } );
+                node.values.insert( node.values.begin() + static_cast<std::ptrdiff_t>( pos ), std::string{ i_secret } );
+            }
+        }
+        else
+        {
+            auto pos{ child_index( node, i_name ) };
+            auto child{ node.children[pos] };
+            auto split{ insert( node.children[pos], i_name, i_secret, i_replace ) };
+
+            // the child was rewritten in place, this node still points at it
+            if( !split && child.page == node.children[pos].page && child.generation == node.children[pos].generation )
+            {
+                return std::nullopt;
+            }
+
+            if( split )
+            {
+                node.keys.insert( node.keys.begin() + static_cast<std::ptrdiff_t>( pos ), std::move( split->first ) );
+                node.children.insert( node.children.begin() + static_cast<std::ptrdiff_t>( pos + 1 ), split->second );
+            }
+        }
+
+        if( node.encoded_size() <= page_payload_size )
+        {
+            io_page = write_node( io_page, node );
+            return std::nullopt;
+        }
+
+        return split_node( io_page, node );
+    }
+
+
+    std::pair<std::string, page_ref_s> split_node( page_ref_s& io_page, node_s& io_node )
+    {
+        auto total{ io_node.encoded_size() };
+
+        // smallest prefix holding at least half of the bytes, but leave at least one key on each side
+        auto size{ node_header_size };
+        auto mid{ 0_sz };
+
+        while( mid + 1 < io_node.keys.size() && size < total / 2 )
+        {
+            size += 2 + io_node.keys[mid].size() +
+                    ( io_node.type == node_type::leaf ? 2 + io_node.values[mid].size() : page_ref_size );
+            ++mid;
+        }
+
+        mid = std::max<std::size_t>( mid, 1 );
+
+        auto right{ node_s{ io_node.type } };
+        auto separator{ std::string{} };
+
+        if( io_node.type == node_type::leaf )
+        {
+            right.keys.assign( io_node.keys.begin() + static_cast<std::ptrdiff_t>( mid ), io_node.keys.end() );
+            right.values.assign( io_node.values.begin() + static_cast<std::ptrdiff_t>( mid ), io_node.values.end() );
+            io_node.keys.resize( mid );
+            io_node.values.resize( mid );
+
+            separator = right.keys.front();
+        }
+        else
+        {
+            // the middle key moves up, its right child becomes the first child of the new node
+            separator = io_node.keys[mid];
+
+            right.keys.assign( io_node.keys.begin() + static_cast<std::ptrdiff_t>( mid + 1 ), io_node.keys.end() );
+            right.children.assign( io_node.children.begin() + static_cast<std::ptrdiff_t>( mid + 1 ),
+                                   io_node.children.end() );
+            io_node.keys.resize( mid );
+            io_node.children.resize( mid + 1 );
+        }
+
+        auto right_page{ write_node( {}, right ) };
+        io_page = write_node( io_page, io_node );
+
+        return { std::move( separator ), right_page };
+    }
+};
+
+}
@@ -0,0 +1,960 @@
+/**
+ * @file bulk_transfer.hpp
+ * @author ashwinn76
+ * @brief Parallel CSV / JSON-lines import and export pipelines for the vault
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Both directions run as reader -> worker pool -> ordered writer. Stages talk through bounded queues and a bounded
+ * reorder window, so memory stays flat however many records pass through.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include "vault.hpp"
+
+namespace vault
+{
+/**
+ * @brief Text format of a bulk transfer
+ *
+ */
+enum class bulk_format : uint8_t
+{
+    csv,  // name,secret with RFC 4180 quoting and an optional unquoted header row
+    json_lines,  // one {"name": ..., "secret": ...} object per line
+};
+
+
+/**
+ * @brief Tuning for a bulk transfer
+ *
+ */
+struct bulk_options_s
+{
+    bulk_format format{ bulk_format::json_lines };
+    std::size_t workers{ std::max( 1u, std::thread::hardware_concurrency() ) };  // encrypt / decrypt threads
+    std::size_t queue_capacity{ 1024_sz };  // records in flight between the stages
+    std::size_t batch_size{ 256_sz };  // imported records per write and commit
+};
+
+
+/**
+ * @brief Name and secret of one transferred record
+ *
+ */
+struct bulk_record_s
+{
+    std::string name{};
+    std::string secret{};
+};
+
+
+/**
+ * @brief Blocking queue with a fixed capacity
+ *
+ */
+template<typename _T>
+class bounded_queue
+{
+public:
+    explicit bounded_queue( std::size_t i_capacity ) : m_capacity{ std::max<std::size_t>( i_capacity, 1 ) }
+    {
+    }
+
+
+    /**
+     * @brief Wait for room and add an item
+     *
+     * @return false if the queue was closed
+     */
+    bool push( _T i_item )
+    {
+        auto lock{ std::unique_lock{ m_mutex } };
+        m_not_full.wait( lock, [this] { return m_closed || m_items.size() < m_capacity; } );
+
+        if( m_closed )
+        {
+            return false;
+        }
+
+        m_items.push_back( std::move( i_item ) );
+        m_not_empty.notify_one();
+
+        return true;
+    }
+
+
+    /**
+     * @brief Wait for an item
+     *
+     * @return item, nothing once the queue is closed and drained
+     */
+    std::optional<_T> pop()
+    {
+        auto lock{ std::unique_lock{ m_mutex } };
+        m_not_empty.wait( lock, [this] { return m_closed || !m_items.empty(); } );
+
+        if( m_items.empty() )
+        {
+            return std::nullopt;
+        }
+
+        auto item{ std::move( m_items.front() ) };
+        m_items.pop_front();
+        m_not_full.notify_one();
+
+        return item;
+    }
+
+
+    /**
+     * @brief Refuse further pushes and wake every waiter
+     *
+     */
+    void close()
+    {
+        auto lock{ std::lock_guard{ m_mutex } };
+
+        m_closed = true;
+        m_not_empty.notify_all();
+        m_not_full.notify_all();
+    }
+
+private:
+    std::size_t m_capacity{};
+
+    std::deque<_T> m_items{};
+
+    std::mutex m_mutex{};
+
+    std::condition_variable m_not_empty{};
+
+    std::condition_variable m_not_full{};
+
+    bool m_closed{ false };
+};
+
+
+/**
+ * @brief Run source -> parallel transform -> sink, delivering results to the sink in source order
+ *
+ * The source and the sink each run on a single thread. At most i_capacity items are between the source and the sink
+ * at any time. The first exception from any stage stops the pipeline and is rethrown here.
+ *
+ * @param i_source returns the next item, nothing at the end
+ * @param i_transform maps an item, called concurrently from i_workers threads
+ * @param i_sink consumes results in order
+ */
+template<typename _In, typename _Out, typename _Source, typename _Transform, typename _Sink>
+void ordered_pipeline(
+    _Source&& i_source, _Transform&& i_transform, _Sink&& i_sink, std::size_t i_workers, std::size_t i_capacity )
+{
+    auto mutex{ std::mutex{} };
+    auto changed{ std::condition_variable{} };
+    auto done{ std::map<uint64_t, _Out>{} };
+    auto written{ 0_ui64 };
+    auto total{ std::optional<uint64_t>{} };
+    auto error{ std::exception_ptr{} };
+
+    auto input{ bounded_queue<std::pair<uint64_t, _In>>{ i_capacity } };
+
+    auto fail = [&]( std::exception_ptr i_error ) {
+        {
+            auto lock{ std::lock_guard{ mutex } };
+
+            if( !error )
+            {
+                error = i_error;
+            }
+
+            changed.notify_all();
+        }
+
+        input.close();
+    };
+
+    auto reader{ std::thread{ [&] {
+        try
+        {
+            auto sequence{ 0_ui64 };
+
+            while( auto item{ i_source() } )
+            {
+                {
+                    // the reorder window keeps a slow item from letting finished ones pile up behind it
+                    auto lock{ std::unique_lock{ mutex } };
+                    changed.wait( lock, [&] { return error || sequence < written + i_capacity; } );
+
+                    if( error )
+                    {
+                        return;
+                    }
+                }
+
+                if( !input.push( { sequence, std::move( *item ) } ) )
+                {
+                    return;
+                }
+
+                ++sequence;
+            }
+
+            auto lock{ std::lock_guard{ mutex } };
+            total = sequence;
+            changed.notify_all();
+        }
+        catch( ... )
+        {
+            fail( std::current_exception() );
+        }
+
+        input.close();
+    } } };
+
+    auto workers{ std::vector<std::thread>{} };
+
+    for( auto i{ 0_sz }; i < std::max<std::size_t>( i_workers, 1 ); ++i )
+    {
+        workers.emplace_back( [&] {
+            while( auto item{ input.pop() } )
+            {
+                try
+                {
+                    auto result{ i_transform( std::move( item->second ) ) };
+
+                    auto lock{ std::lock_guard{ mutex } };
+                    done.emplace( item->first, std::move( result ) );
+                    changed.notify_all();
+                }
+                catch( ... )
+                {
+                    fail( std::current_exception() );
+                }
+            }
+        } );
+    }
+
+    try
+    {
+        auto lock{ std::unique_lock{ mutex } };
+
+        while( true )
+        {
+            changed.wait( lock, [&] { return error || done.count( written ) != 0 || total == written; } );
+
+            if( error || total == written )
+            {
+                break;
+            }
+
+            auto result{ std::move( done.extract( written ).mapped() ) };
+
+            lock.unlock();
+            i_sink( std::move( result ) );
+            lock.lock();
+
+            ++written;
+            changed.notify_all();
+        }
+    }
+    catch( ... )
+    {
+        fail( std::current_exception() );
+    }
+
+    reader.join();
+
+    for( auto&& worker : workers )
+    {
+        worker.join();
+    }
+
+    if( error )
+    {
+        std::rethrow_exception( error );
+    }
+}
+
+
+namespace
+{
+/**
+ * @brief Read one CSV record, which may span lines inside a quoted field
+ *
+ * @param io_in input
+ * @param o_quoted set when any field of the record was quoted
+ * @return fields, nothing at the end of the input
+ */
+inline std::optional<std::vector<std::string>> read_csv_record( std::istream& io_in, bool& o_quoted )
+{
+    auto line{ std::string{} };
+
+    if( !std::getline( io_in, line ) )
+    {
+        return std::nullopt;
+    }
+
+    auto fields{ std::vector<std::string>{ std::string{} } };
+    auto quoted{ false };
+
+    o_quoted = false;
+
+    for( auto i{ 0_sz };; ++i )
+    {
+        if( i == line.size() )
+        {
+            if( !quoted )
+            {
+                break;
+            }
+
+            // a newline inside quotes belongs to the field
+            fields.back() += '\n';
+
+            if( !std::getline( io_in, line ) )
+            {
+                throw vault_error{ "Unterminated quoted CSV field" };
+            }
+
+            i = static_cast<std::size_t>( -1 );
+            continue;
+        }
+
+        auto c{ line[i] };
+
+        if( quoted )
+        {
+            if( c == '"' && i + 1 < line.size() && line[i + 1] == '"' )
+            {
+                fields.back() += '"';
+                ++i;
+            }
+            else if( c == '"' )
+            {
+                quoted = false;
+            }
+            else
+            {
+                fields.back() += c;
+            }
+        }
+        else if( c == '"' )
+        {
+            quoted = true;
+            o_quoted = true;
+        }
+        else if( c == ',' )
+        {
+            fields.emplace_back();
+        }
+        else if( c != '\r' || i + 1 != line.size() )
+        {
+            fields.back() += c;
+        }
+    }
+
+    return fields;
+}
+
+
+inline std::string csv_field( std::string_view i_value, bool i_always_quote = false )
+{
+    if( !i_always_quote && i_value.find_first_of( ",\"\r\n" ) == std::string_view::npos )
+    {
+        return std::string{ i_value };
+    }
+
+    auto field{ std::string{ "\"" } };
+
+    for( auto c : i_value )
+    {
+        field += c;
+
+        if( c == '"' )
+        {
+            field += '"';
+        }
+    }
+
+    return field + '"';
+}
+
+
+inline void append_utf8( std::string& io_out, uint32_t i_code_point )
+{
+    if( i_code_point < 0x80 )
+    {
+        io_out += static_cast<char>( i_code_point );
+    }
+    else if( i_code_point < 0x800 )
+    {
+        io_out += static_cast<char>( 0xC0 | ( i_code_point >> 6 ) );
+        io_out += static_cast<char>( 0x80 | ( i_code_point & 0x3F ) );
+    }
+    else if( i_code_point < 0x10000 )
+    {
+        io_out += static_cast<char>( 0xE0 | ( i_code_point >> 12 ) );
+        io_out += static_cast<char>( 0x80 | ( ( i_code_point >> 6 ) & 0x3F ) );
+        io_out += static_cast<char>( 0x80 | ( i_code_point & 0x3F ) );
+    }
+    else
+    {
+        io_out += static_cast<char>( 0xF0 | ( i_code_point >> 18 ) );
+        io_out += static_cast<char>( 0x80 | ( ( i_code_point >> 12 ) & 0x3F ) );
+        io_out += static_cast<char>( 0x80 | ( ( i_code_point >> 6 ) & 0x3F ) );
+        io_out += static_cast<char>( 0x80 | ( i_code_point & 0x3F ) );
+    }
+}
+
+
+/**
+ * @brief Minimal reader for the flat string-valued JSON objects written by export
+ *
+ */
+class json_object_reader
+{
+public:
+    explicit json_object_reader( std::string_view i_text ) noexcept : m_text{ i_text }
+    {
+    }
+
+
+    /**
+     * @brief Parse the object into name and secret, ignoring other string members
+     *
+     */
+    bulk_record_s read()
+    {
+        auto record{ bulk_record_s{} };
+        auto seen_name{ false };
+        auto seen_secret{ false };
+
+        expect( '{' );
+
+        if( !consume( '}' ) )
+        {
+            do
+            {
+                auto key{ read_string() };
+                expect( ':' );
+                auto value{ read_string() };
+
+                if( key == "name" )
+                {
+                    record.name = std::move( value );
+                    seen_name = true;
+                }
+                else if( key == "secret" )
+                {
+                    record.secret = std::move( value );
+                    seen_secret = true;
+                }
+            } while( consume( ',' ) );
+
+            expect( '}' );
+        }
+
+        skip_space();
+
+        if( m_position != m_text.size() || !seen_name || !seen_secret )
+        {
+            throw vault_error{ "Expected a JSON object with name and secret strings" };
+        }
+
+        return record;
+    }
+
+private:
+    std::string_view m_text{};
+
+    std::size_t m_position{ 0_sz };
+
+
+    void skip_space() noexcept
+    {
+        constexpr auto space = std::string_view{ " \t\r\n" };
+
+        while( m_position < m_text.size() && space.find( m_text[m_position] ) != std::string_view::npos )
+        {
+            ++m_position;
+        }
+    }
+
+
+    bool consume( char i_c ) noexcept
+    {
+        skip_space();
+
+        if( m_position < m_text.size() && m_text[m_position] == i_c )
+        {
+            ++m_position;
+            return true;
+        }
+
+        return false;
+    }
+
+
+    void expect( char i_c )
+    {
+        if( !consume( i_c ) )
+        {
+            throw vault_error{ std::string{ "Malformed JSON line: expected '" } + i_c + "'" };
+        }
+    }
+
+
+    uint32_t read_hex4()
+    {
+        if( m_position + 4 > m_text.size() )
+        {
+            throw vault_error{ "Malformed JSON escape" };
+        }
+
+        auto value{ 0_ui32 };
+
+        for( auto i{ 0 }; i < 4; ++i )
+        {
+            auto c{ m_text[m_position++] };
+            value <<= 4;
+
+            if( c >= '0' && c <= '9' )
+            {
+                value |= static_cast<uint32_t>( c - '0' );
+            }
+            else if( c >= 'a' && c <= 'f' )
+            {
+                value |= static_cast<uint32_t>( c - 'a' + 10 );
+            }
+            else if( c >= 'A' && c <= 'F' )
+            {
+                value |= static_cast<uint32_t>( c - 'A' + 10 );
+            }
+            else
+            {
+                throw vault_error{ "Malformed JSON escape" };
+            }
+        }
+
+        return value;
+    }
+
+
+    std::string read_string()
+    {
+        expect( '"' );
+
+        auto value{ std::string{} };
+
+        while( m_position < m_text.size() )
+        {
+            auto c{ m_text[m_position++] };
+
+            if( c == '"' )
+            {
+                return value;
+            }
+
+            if( c != '\\' )
+            {
+                value += c;
+                continue;
+            }
+
+            if( m_position == m_text.size() )
+            {
+                break;
+            }
+
+            switch( auto escape{ m_text[m_position++] } )
+            {
+            case 'b':
+                value += '\b';
+                break;
+            case 'f':
+                value += '\f';
+                break;
+            case 'n':
+                value += '\n';
+                break;
+            case 'r':
+                value += '\r';
+                break;
+            case 't':
+                value += '\t';
+                break;
+            case 'u':
+            {
+                auto code_point{ read_hex4() };
+
+                if( code_point >= 0xD800 && code_point < 0xDC00 && m_text.substr( m_position, 2 ) == "\\u" )
+                {
+                    m_position += 2;
+                    code_point = 0x10000 + ( ( code_point - 0xD800 ) << 10 ) + ( read_hex4() - 0xDC00 );
+                }
+
+                append_utf8( value, code_point );
+                break;
+            }
+            default:
+                value += escape;
+                break;
+            }
+        }
+
+        throw vault_error{ "Unterminated JSON string" };
+    }
+};
+
+
+inline std::string json_string( std::string_view i_value )
+{
+    constexpr auto hex = std::string_view{ "0123456789abcdef" };
+
+    auto out{ std::string{ "\"" } };
+
+    for( auto c : i_value )
+    {
+        switch( c )
+        {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\r':
+            out += "\\r";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        default:
+            if( static_cast<unsigned char>( c ) < 0x20 )
+            {
+                out += "\\u00";
+                out += hex[static_cast<unsigned char>( c ) >> 4];
+                out += hex[static_cast<unsigned char>( c ) & 0xF];
+            }
+            else
+            {
+                out += c;
+            }
+            break;
+        }
+    }
+
+    return out + '"';
+}
+
+}
+
+
+/**
+ * @brief Reads records one at a time from CSV or JSON-lines text
+ *
+ */
+class bulk_reader
+{
+public:
+    bulk_reader( std::istream& io_in, bulk_format i_format ) noexcept : m_in{ io_in }, m_format{ i_format }
+    {
+    }
+
+
+    /**
+     * @brief Next record, nothing at the end of the input
+     *
+     */
+    std::optional<bulk_record_s> next()
+    {
+        if( m_format == bulk_format::csv )
+        {
+            auto quoted{ false };
+
+            while( auto fields{ read_csv_record( m_in, quoted ) } )
+            {
+                // a quoted "name","secret" is an entry of that name
+                auto header{ m_first && !quoted && fields->size() >= 2 && ( *fields )[0] == "name" &&
+                             ( *fields )[1] == "secret" };
+                m_first = false;
+
+                if( header || ( fields->size() == 1 && fields->front().empty() ) )
+                {
+                    continue;
+                }
+
+                if( fields->size() < 2 )
+                {
+                    throw vault_error{ "CSV record needs name and secret columns" };
+                }
+
+                return bulk_record_s{ std::move( ( *fields )[0] ), std::move( ( *fields )[1] ) };
+            }
+
+            return std::nullopt;
+        }
+
+        auto line{ std::string{} };
+
+        while( std::getline( m_in, line ) )
+        {
+            if( line.find_first_not_of( " \t\r" ) != std::string::npos )
+            {
+                return json_object_reader{ line }.read();
+            }
+        }
+
+        return std::nullopt;
+    }
+
+private:
+    std::istream& m_in;
+
+    bulk_format m_format{};
+
+    bool m_first{ true };
+};
+
+
+/**
+ * @brief Format one record as a CSV or JSON-lines line, newline included
+ *
+ * A CSV record that would read back as the header row is quoted.
+ */
+inline std::string format_record( std::string_view i_name, std::string_view i_secret, bulk_format i_format )
+{
+    if( i_format == bulk_format::csv )
+    {
+        auto quote{ i_name == "name" && i_secret == "secret" };
+
+        return csv_field( i_name, quote ) + ',' + csv_field( i_secret, quote ) + '\n';
+    }
+
+    return "{\"name\":" + json_string( i_name ) + ",\"secret\":" + json_string( i_secret ) + "}\n";
+}
+
+
+/**
+ * @brief Import records, sealing them on the worker pool and appending them in input order
+ *
+ * Records whose name already exists replace the stored secret. Each batch is committed once it is full, so an import
+ * that fails partway, on a malformed record or a full disk, keeps the batches before the failure; importing the same
+ * input again after fixing it replaces them with the same secrets.
+ *
+ * @return number of records imported
+ * @throw vault_error on malformed input, with the batches before it committed
+ */
+inline uint64_t import_records( vault& io_store, std::istream& io_in, const bulk_options_s& i_options = {} )
+{
+    auto reader{ bulk_reader{ io_in, i_options.format } };
+
+    auto batch{ std::vector<sealed_entry_s>{} };
+    auto count{ 0_ui64 };
+
+    ordered_pipeline<bulk_record_s, sealed_entry_s>(
+        [&reader] { return reader.next(); },
+        [&io_store]( bulk_record_s i_record ) {
+            auto sealed{ io_store.seal_entry( i_record.name, i_record.secret ) };
+            wipe_bytes( i_record.secret.data(), i_record.secret.size() );
+
+            return sealed;
+        },
+        [&]( sealed_entry_s i_sealed ) {
+            batch.push_back( std::move( i_sealed ) );
+            ++count;
+
+            if( batch.size() >= i_options.batch_size )
+            {
+                io_store.append_sealed( batch );
+                batch.clear();
+            }
+        },
+        i_options.workers,
+        i_options.queue_capacity );
+
+    if( !batch.empty() )
+    {
+        io_store.append_sealed( batch );
+    }
+
+    return count;
+}
+
+
+/**
+ * @brief Export every entry, reading in file order and decrypting on the worker pool
+ *
+ * @return number of records exported
+ */
+inline uint64_t export_records( const vault& i_store, std::ostream& o_out, const bulk_options_s& i_options = {} )
+{
+    auto locations{ i_store.entry_locations() };
+    auto next{ 0_sz };
+
+    if( i_options.format == bulk_format::csv )
+    {
+        o_out << "name,secret\n";
+    }
+
+    ordered_pipeline<record_location_s, std::string>(
+        [&]() -> std::optional<record_location_s> {
+            if( next == locations.size() )
+            {
+                return std::nullopt;
+            }
+
+            return locations[next++];
+        },
+        [&]( const record_location_s& i_location ) {
+            auto entry{ i_store.open_entry( i_location ) };
+            auto line{ format_record( entry.name, entry.secret, i_options.format ) };
+            wipe_bytes( entry.secret.data(), entry.secret.size() );
+
+            return line;
+        },
+        [&o_out]( std::string i_line ) {
+            o_out << i_line;
+            wipe_bytes( i_line.data(), i_line.size() );
+        },
+        i_options.workers,
+        i_options.queue_capacity );
+
+    if( !o_out )
+    {
+        throw vault_error{ "Unable to write export" };
+    }
+
+    return locations.size();
+}
+
+
+namespace
+{
+/**
+ * @brief Stream buffer writing to a file descriptor, wiping the plaintext it held after every write
+ *
+ */
+class fd_output_buffer : public std::streambuf
+{
+public:
+    explicit fd_output_buffer( int i_fd ) noexcept : m_fd{ i_fd }
+    {
+        setp( m_buffer.data(), m_buffer.data() + m_buffer.size() );
+    }
+
+
+    fd_output_buffer( const fd_output_buffer& ) = delete;
+    fd_output_buffer& operator=( const fd_output_buffer& ) = delete;
+
+
+    ~fd_output_buffer() override
+    {
+        wipe_bytes( m_buffer.data(), m_buffer.size() );
+    }
+
+protected:
+    int_type overflow( int_type i_char ) override
+    {
+        if( sync() != 0 )
+        {
+            return traits_type::eof();
+        }
+
+        if( !traits_type::eq_int_type( i_char, traits_type::eof() ) )
+        {
+            *pptr() = traits_type::to_char_type( i_char );
+            pbump( 1 );
+        }
+
+        return traits_type::not_eof( i_char );
+    }
+
+
+    int sync() override
+    {
+        auto size{ static_cast<std::size_t>( pptr() - pbase() ) };
+
+        try
+        {
+            write_exact( m_fd, pbase(), size, m_offset );
+        }
+        catch( const vault_error& )
+        {
+            return -1;
+        }
+
+        m_offset += size;
+        wipe_bytes( pbase(), size );
+        setp( m_buffer.data(), m_buffer.data() + m_buffer.size() );
+
+        return 0;
+    }
+
+private:
+    int m_fd{ -1 };
+
+    uint64_t m_offset{ 0_ui64 };
+
+    std::array<char, 1_sz << 16> m_buffer{};
+};
+
+}
+
+
+/**
+ * @brief Export every entry into a file only its owner can read, as the secrets are in plaintext
+ *
+ * The file is created with mode 0600, and an existing file is truncated and narrowed to it before anything is written.
+ *
+ * @param i_path file to create or replace
+ * @return number of records exported
+ */
+inline uint64_t export_file( const vault& i_store, const std::string& i_path, const bulk_options_s& i_options = {} )
+{
+    auto fd{ unique_fd::open( i_path, O_WRONLY | O_CREAT | O_TRUNC, 0600 ) };
+
+    if( ::fchmod( fd.get(), 0600 ) != 0 )
+    {
+        throw vault_error{ "Unable to restrict access to " + i_path };
+    }
+
+    auto buffer{ std::make_unique<fd_output_buffer>( fd.get() ) };
+    auto out{ std::ostream{ buffer.get() } };
+
+    auto count{ export_records( i_store, out, i_options ) };
+
+    if( !out.flush() )
+    {
+        throw vault_error{ "Unable to write export" };
+    }
+
+    return count;
+}
+
+}
@@ -0,0 +1,514 @@
+/**
+ * @file chacha20_poly1305.hpp
+ * @author ashwinn76
+ * @brief ChaCha20-Poly1305 authenticated encryption (RFC 8439)
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include <sys/random.h>
+
+#include "macro_utils.hpp"
+
+namespace encryption
+{
+using aead_key_t = std::array<uint8_t, 32>;
+
+using aead_nonce_t = std::array<uint8_t, 12>;
+
+using aead_tag_t = std::array<uint8_t, 16>;
+
+constexpr auto aead_overhead = std::tuple_size_v<aead_nonce_t> + std::tuple_size_v<aead_tag_t>;
+
+constexpr auto aead_max_plaintext = ( ( 1_ui64 << 32 ) - 1 ) * 64;  // bytes the 32-bit block counter reaches from 1
+
+namespace
+{
+constexpr uint32_t rotl( uint32_t x, int n ) noexcept
+{
+    return ( x << n ) | ( x >> ( 32 - n ) );
+}
+
+constexpr uint32_t load32_le( const uint8_t* p ) noexcept
+{
+    return uint32_t{ p[0] } | ( uint32_t{ p[1] } << 8 ) | ( uint32_t{ p[2] } << 16 ) | ( uint32_t{ p[3] } << 24 );
+}
+
+constexpr uint64_t load64_le( const uint8_t* p ) noexcept
+{
+    return uint64_t{ load32_le( p ) } | ( uint64_t{ load32_le( p + 4 ) } << 32 );
+}
+
+constexpr void store32_le( uint8_t* p, uint32_t v ) noexcept
+{
+    for( auto i{ 0 }; i < 4; ++i )
+    {
+        p[i] = static_cast<uint8_t>( v >> ( 8 * i ) );
+    }
+}
+
+constexpr void store64_le( uint8_t* p, uint64_t v ) noexcept
+{
+    store32_le( p, static_cast<uint32_t>( v ) );
+    store32_le( p + 4, static_cast<uint32_t>( v >> 32 ) );
+}
+
+constexpr void quarter_round( std::array<uint32_t, 16>& s, int a, int b, int c, int d ) noexcept
+{
+    s[a] += s[b];
+    s[d] = rotl( s[d] ^ s[a], 16 );
+    s[c] += s[d];
+    s[b] = rotl( s[b] ^ s[c], 12 );
+    s[a] += s[b];
+    s[d] = rotl( s[d] ^ s[a], 8 );
+    s[c] += s[d];
+    s[b] = rotl( s[b] ^ s[c], 7 );
+}
+
+}
+
+
+/**
+ * @brief Fill a buffer from the kernel CSPRNG
+ *
+ * @param o_data buffer to fill
+ * @param i_size number of bytes
+ */
+inline void random_bytes( void* o_data, std::size_t i_size )
+{
+    auto bytes{ static_cast<uint8_t*>( o_data ) };
+
+    while( i_size > 0 )
+    {
+        auto got{ ::getrandom( bytes, i_size, 0 ) };
+
+        if( got < 0 )
+        {
+            throw std::runtime_error{ "Unable to read random bytes!" };
+        }
+
+        bytes += got;
+        i_size -= static_cast<std::size_t>( got );
+    }
+}
+
+
+/**
+ * @brief ChaCha20 block function
+ *
+ * @param i_key 256 bit key
+ * @param i_counter block counter
+ * @param i_nonce 96 bit nonce
+ * @return 64 bytes of key stream
+ */
+inline std::array<uint8_t, 64> chacha20_block( const aead_key_t& i_key,
+                                               uint32_t i_counter,
+                                               const aead_nonce_t& i_nonce ) noexcept
+{
+    auto state{ std::array<uint32_t, 16>{ 0x61707865, 0x3320646e, 0x79622d32, 0x6b206574 } };
+
+    for( auto i{ 0 }; i < 8; ++i )
+    {
+        state[4 + i] = load32_le( i_key.data() + 4 * i );
+    }
+
+    state[12] = i_counter;
+
+    for( auto i{ 0 }; i < 3; ++i )
+    {
+        state[13 + i] = load32_le( i_nonce.data() + 4 * i );
+    }
+
+    auto working{ state };
+
+    for( auto round{ 0 }; round < 10; ++round )
+    {
+        quarter_round( working, 0, 4, 8, 12 );
+        quarter_round( working, 1, 5, 9, 13 );
+        quarter_round( working, 2, 6, 10, 14 );
+        quarter_round( working, 3, 7, 11, 15 );
+        quarter_round( working, 0, 5, 10, 15 );
+        quarter_round( working, 1, 6, 11, 12 );
+        quarter_round( working, 2, 7, 8, 13 );
+        quarter_round( working, 3, 4, 9, 14 );
+    }
+
+    auto stream{ std::array<uint8_t, 64>{} };
+
+    for( auto i{ 0 }; i < 16; ++i )
+    {
+        store32_le( stream.data() + 4 * i, working[i] + state[i] );
+    }
+
+    return stream;
+}
+
+
+/**
+ * @brief XOR data with the ChaCha20 key stream
+ *
+ */
+inline void chacha20_xor( const aead_key_t& i_key,
+                          uint32_t i_counter,
+                          const aead_nonce_t& i_nonce,
+                          uint8_t* io_data,
+                          std::size_t i_size ) noexcept
+{
+    for( auto offset{ 0_sz }; offset < i_size; offset += 64, ++i_counter )
+    {
+        auto stream{ chacha20_block( i_key, i_counter, i_nonce ) };
+
+        for( auto i{ 0_sz }; i < 64 && offset + i < i_size; ++i )
+        {
+            io_data[offset + i] ^= stream[i];
+        }
+    }
+}
+
+
+/**
+ * @brief Poly1305 one-time authenticator
+ *
+ */
+class poly1305
+{
+public:
+    explicit poly1305( const uint8_t* i_key ) noexcept
+    {
+        auto t0{ load64_le( i_key ) };
+        auto t1{ load64_le( i_key + 8 ) };
+
+        m_r[0] = t0 & 0xffc0fffffff;
+        m_r[1] = ( ( t0 >> 44 ) | ( t1 << 20 ) ) & 0xfffffc0ffff;
+        m_r[2] = ( t1 >> 24 ) & 0x00ffffffc0f;
+
+        m_pad[0] = load64_le( i_key + 16 );
+        m_pad[1] = load64_le( i_key + 24 );
+    }
+
+
+    poly1305& update( const uint8_t* i_data, std::size_t i_size ) noexcept
+    {
+        while( i_size > 0 )
+        {
+            auto take{ std::min<std::size_t>( i_size, 16 - m_filled ) };
+            std::memcpy( m_buffer.data() + m_filled, i_data, take );
+
+            m_filled += take;
+            i_data += take;
+            i_size -= take;
+
+            if( m_filled == 16 )
+            {
+                block( m_buffer.data(), 1_ui64 << 40 );
+                m_filled = 0;
+            }
+        }
+
+        return *this;
+    }
+
+
+    /**
+     * @brief Pad buffered data with zeros up to the next 16 byte boundary
+     *
+     */
+    poly1305& pad16() noexcept
+    {
+        if( m_filled != 0 )
+        {
+            auto zeros{ std::array<uint8_t, 16>{} };
+            update( zeros.data(), 16 - m_filled );
+        }
+
+        return *this;
+    }
+
+
+    aead_tag_t finish() noexcept
+    {
+        if( m_filled != 0 )
+        {
+            m_buffer[m_filled] = 1;
+            std::memset( m_buffer.data() + m_filled + 1, 0, 16 - m_filled - 1 );
+            block( m_buffer.data(), 0_ui64 );
+        }
+
+        auto [h0, h1, h2] = m_h;
+
+        // full carry, then compute h + -p and select
+        auto c{ h1 >> 44 };
+        h1 &= 0xfffffffffff;
+        h2 += c;
+        c = h2 >> 42;
+        h2 &= 0x3ffffffffff;
+        h0 += c * 5;
+        c = h0 >> 44;
+        h0 &= 0xfffffffffff;
+        h1 += c;
+        c = h1 >> 44;
+        h1 &= 0xfffffffffff;
+        h2 += c;
+        c = h2 >> 42;
+        h2 &= 0x3ffffffffff;
+        h0 += c * 5;
+        c = h0 >> 44;
+        h0 &= 0xfffffffffff;
+        h1 += c;
+
+        auto g0{ h0 + 5 };
+        c = g0 >> 44;
+        g0 &= 0xfffffffffff;
+        auto g1{ h1 + c };
+        c = g1 >> 44;
+        g1 &= 0xfffffffffff;
+        auto g2{ h2 + c - ( 1_ui64 << 42 ) };
+
+        auto mask{ ( g2 >> 63 ) - 1 };
+        g0 &= mask;
+        g1 &= mask;
+        g2 &= mask;
+        mask = ~mask;
+        h0 = ( h0 & mask ) | g0;
+        h1 = ( h1 & mask ) | g1;
+        h2 = ( h2 & mask ) | g2;
+
+        // h = (h + pad) mod 2^128
+        auto t0{ m_pad[0] };
+        auto t1{ m_pad[1] };
+
+        h0 += t0 & 0xfffffffffff;
+        c = h0 >> 44;
+        h0 &= 0xfffffffffff;
+        h1 += ( ( ( t0 >> 44 ) | ( t1 << 20 ) ) & 0xfffffffffff ) + c;
+        c = h1 >> 44;
+        h1 &= 0xfffffffffff;
+        h2 += ( ( t1 >> 24 ) & 0x3ffffffffff ) + c;
+        h2 &= 0x3ffffffffff;
+
+        auto tag{ aead_tag_t{} };
+        store64_le( tag.data(), h0 | ( h1 << 44 ) );
+        store64_le( tag.data() + 8, ( h1 >> 20 ) | ( h2 << 24 ) );
+
+        return tag;
+    }
+
+private:
+    std::array<uint64_t, 3> m_r{};
+
+    std::array<uint64_t, 3> m_h{};
+
+    std::array<uint64_t, 2> m_pad{};
+
+    std::array<uint8_t, 16> m_buffer{};
+
+    std::size_t m_filled{ 0_sz };
+
+
+    void block( const uint8_t* i_block, uint64_t i_hibit ) noexcept
+    {
+        using u128 = unsigned __int128;
+
+        auto [r0, r1, r2] = m_r;
+        auto s1{ r1 * ( 5 << 2 ) };
+        auto s2{ r2 * ( 5 << 2 ) };
+
+        auto [h0, h1, h2] = m_h;
+
+        auto t0{ load64_le( i_block ) };
+        auto t1{ load64_le( i_block + 8 ) };
+
+        h0 += t0 & 0xfffffffffff;
+        h1 += ( ( t0 >> 44 ) | ( t1 << 20 ) ) & 0xfffffffffff;
+        h2 += ( ( ( t1 >> 24 ) ) & 0x3ffffffffff ) | i_hibit;
+
+        auto d0{ u128{ h0 } * r0 + u128{ h1 } * s2 + u128{ h2 } * s1 };
+        auto d1{ u128{ h0 } * r1 + u128{ h1 } * r0 + u128{ h2 } * s2 };
+        auto d2{ u128{ h0 } * r2 + u128{ h1 } * r1 + u128{ h2 } * r0 };
+
+        auto c{ static_cast<uint64_t>( d0 >> 44 ) };
+        h0 = static_cast<uint64_t>( d0 ) & 0xfffffffffff;
+        d1 += c;
+        c = static_cast<uint64_t>( d1 >> 44 );
+        h1 = static_cast<uint64_t>( d1 ) & 0xfffffffffff;
+        d2 += c;
+        c = static_cast<uint64_t>( d2 >> 42 );
+        h2 = static_cast<uint64_t>( d2 ) & 0x3ffffffffff;
+        h0 += c * 5;
+        c = h0 >> 44;
+        h0 &= 0xfffffffffff;
+        h1 += c;
+
+        m_h = { h0, h1, h2 };
+    }
+};
+
+
+namespace
+{
+inline aead_tag_t aead_tag( const aead_key_t& i_key,
+                            const aead_nonce_t& i_nonce,
+                            const uint8_t* i_ad,
+                            std::size_t i_ad_size,
+                            const uint8_t* i_cipher,
+                            std::size_t i_cipher_size ) noexcept
+{
+    auto otk{ chacha20_block( i_key, 0, i_nonce ) };
+
+    auto lengths{ std::array<uint8_t, 16>{} };
+    store64_le( lengths.data(), i_ad_size );
+    store64_le( lengths.data() + 8, i_cipher_size );
+
+    return poly1305{ otk.data() }
+        .update( i_ad, i_ad_size )
+        .pad16()
+        .update( i_cipher, i_cipher_size )
+        .pad16()
+        .update( lengths.data(), lengths.size() )
+        .finish();
+}
+
+}
+
+
+/**
+ * @brief Encrypt and authenticate in place
+ *
+ * @param i_key key
+ * @param i_nonce nonce, never reused with the same key
+ * @param i_ad associated data, authenticated but not encrypted
+ * @param io_data plaintext in, ciphertext out
+ * @return authentication tag
+ */
+inline aead_tag_t aead_encrypt( const aead_key_t& i_key,
+                                const aead_nonce_t& i_nonce,
+                                std::string_view i_ad,
+                                uint8_t* io_data,
+                                std::size_t i_size ) noexcept
+{
+    chacha20_xor( i_key, 1, i_nonce, io_data, i_size );
+
+    return aead_tag( i_key, i_nonce, reinterpret_cast<const uint8_t*>( i_ad.data() ), i_ad.size(), io_data, i_size );
+}
+
+
+/**
+ * @brief Verify and decrypt in place
+ *
+ * @return false if the tag does not match; the data is left untouched in that case
+ */
+inline bool aead_decrypt( const aead_key_t& i_key,
+                          const aead_nonce_t& i_nonce,
+                          std::string_view i_ad,
+                          uint8_t* io_data,
+                          std::size_t i_size,
+                          const aead_tag_t& i_tag ) noexcept
+{
+    auto expected{ aead_tag(
+        i_key, i_nonce, reinterpret_cast<const uint8_t*>( i_ad.data() ), i_ad.size(), io_data, i_size ) };
+
+    auto diff{ 0 };
+
+    for( auto i{ 0_sz }; i < expected.size(); ++i )
+    {
+        diff |= expected[i] ^ i_tag[i];
+    }
+
+    if( diff != 0 )
+    {
+        return false;
+    }
+
+    chacha20_xor( i_key, 1, i_nonce, io_data, i_size );
+
+    return true;
+}
+
+
+/**
+ * @brief Seal a message as nonce || ciphertext || tag with a fresh random nonce
+ *
+ * @param i_key key
+ * @param i_ad associated data
+ * @param i_plain plaintext
+ * @return sealed box
+ * @throw std::length_error if the plaintext is longer than aead_max_plaintext
+ */
+inline std::vector<uint8_t> aead_seal( const aead_key_t& i_key, std::string_view i_ad, std::string_view i_plain )
+{
+    if( i_plain.size() > aead_max_plaintext )
+    {
+        throw std::length_error{ "Plaintext is too long to seal!" };
+    }
+
+    auto nonce{ aead_nonce_t{} };
+    random_bytes( nonce.data(), nonce.size() );
+
+    auto sealed{ std::vector<uint8_t>( nonce.size() + i_plain.size() + std::tuple_size_v<aead_tag_t> ) };
+
+    std::memcpy( sealed.data(), nonce.data(), nonce.size() );
+    std::memcpy( sealed.data() + nonce.size(), i_plain.data(), i_plain.size() );
+
+    auto tag{ aead_encrypt( i_key, nonce, i_ad, sealed.data() + nonce.size(), i_plain.size() ) };
+
+    std::memcpy( sealed.data() + nonce.size() + i_plain.size(), tag.data(), tag.size() );
+
+    return sealed;
+}
+
+
+/**
+ * @brief Open a box produced by aead_seal
+ *
+ * @param i_key key
+ * @param i_ad associated data given when sealing
+ * @param i_sealed sealed bytes
+ * @param i_size number of sealed bytes
+ * @param o_plain decrypted plaintext
+ * @return false if the box is truncated or fails authentication
+ */
+inline bool aead_open( const aead_key_t& i_key,
+                       std::string_view i_ad,
+                       const uint8_t* i_sealed,
+                       std::size_t i_size,
+                       std::string& o_plain )
+{
+    if( i_size < aead_overhead )
+    {
+        return false;
+    }
+
+    auto nonce{ aead_nonce_t{} };
+    auto tag{ aead_tag_t{} };
+
+    auto plain_size{ i_size - aead_overhead };
+
+    std::memcpy( nonce.data(), i_sealed, nonce.size() );
+    std::memcpy( tag.data(), i_sealed + nonce.size() + plain_size, tag.size() );
+
+    o_plain.assign( reinterpret_cast<const char*>( i_sealed + nonce.size() ), plain_size );
+
+    if( !aead_decrypt( i_key, nonce, i_ad, reinterpret_cast<uint8_t*>( o_plain.data() ), plain_size, tag ) )
+    {
+        o_plain.clear();
+        return false;
+    }
+
+    return true;
+}
+
+}
@@ -0,0 +1,544 @@
+/**
+ * @file dawg.hpp
+ * @author ashwinn76
+ * @brief Compact, minimized directed acyclic word graph used for dictionary lookups
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "macro_utils.hpp"
+
+namespace password_strength
+{
+/**
+ * @brief Single serialized edge of the graph.
+ *
+ * Layout of packed: bits 0-7 label, bit 8 end-of-word, bit 9 last edge of the list, bits 10-31 first edge of child.
+ * count holds the number of words reachable through this edge, which makes the graph a minimal perfect hash.
+ */
+struct dawg_edge_s
+{
+    uint32_t packed{ 0_ui32 };
+    uint32_t count{ 0_ui32 };
+
+    constexpr auto label() const noexcept
+    {
+        return static_cast<char>( packed & 0xFF_ui32 );
+    }
+
+    constexpr auto end_of_word() const noexcept
+    {
+        return ( packed & ( 1_ui32 << 8 ) ) != 0;
+    }
+
+    constexpr auto last() const noexcept
+    {
+        return ( packed & ( 1_ui32 << 9 ) ) != 0;
+    }
+
+    constexpr auto child() const noexcept
+    {
+        return packed >> 10;
+    }
+};
+
+
+/**
+ * @brief Result of following one edge from a node
+ *
+ */
+struct dawg_step_s
+{
+    uint32_t child{ 0_ui32 };  // first edge of the child list, 0 when the child has no edges
+    uint32_t index_offset{ 0_ui32 };  // words skipped by preceding siblings
+    bool end_of_word{ false };  // whether the path so far spells a word
+};
+
+
+/**
+ * @brief Read-only DAWG, either owning its edges or mapped from a file built offline
+ *
+ */
+class dawg
+{
+public:
+    constexpr static auto root = 0_ui32;
+
+    constexpr static auto magic = 0x47574144_ui32;  // "DAWG"
+
+    constexpr static auto max_edges = ( 1_ui32 << 22 ) - 1_ui32;
+
+    dawg() = default;
+
+
+    /**
+     * @brief Build a minimized graph from words ordered by descending frequency
+     *
+     * @param i_words words, most common first; position decides the rank
+     * @return graph over the lowercase dictionary
+     */
+    static dawg build( const std::vector<std::string>& i_words )
+    {
+        auto ranked{ std::vector<std::pair<std::string, uint32_t>>{} };
+        ranked.reserve( i_words.size() );
+
+        for( auto i{ 0_sz }; i < i_words.size(); ++i )
+        {
+            if( !i_words[i].empty() )
+            {
+                ranked.emplace_back( i_words[i], static_cast<uint32_t>( i + 1 ) );
+            }
+        }
+
+        std::stable_sort( ranked.begin(), ranked.end(), []( auto&& l, auto&& r ) { return l.first < r.first; } );
+        ranked.erase( std::unique( ranked.begin(), ranked.end(), []( auto&& l, auto&& r ) { return l.first == r.first; } ),
+                      ranked.end() );
+
+        auto builder{ graph_builder{} };
+
+        auto result{ dawg{} };
+        result.m_own_ranks.reserve( ranked.size() );
+
+        for( auto&& [word, rank] : ranked )
+        {
+            builder.add( word );
+            result.m_own_ranks.push_back( rank );
+        }
+
+        result.m_own_edges = builder.finish();
+
+        if( result.m_own_edges.size() > max_edges )
+        {
+            throw std::length_error{ "Dictionary too large for DAWG encoding!" };
+        }
+
+        result.m_edges = result.m_own_edges.data();
+        result.m_edge_count = static_cast<uint32_t>( result.m_own_edges.size() );
+        result.m_ranks = result.m_own_ranks.data();
+        result.m_word_count = static_cast<uint32_t>( result.m_own_ranks.size() );
+
+        return result;
+    }
+
+
+    /**
+     * @brief Map a graph written by save() without copying it
+     *
+     * @param i_path path of the serialized graph
+     * @return graph backed by the mapping
+     */
+    static dawg map_file( const std::string& i_path )
+    {
+        auto fd{ ::open( i_path.c_str(), O_RDONLY | O_CLOEXEC ) };
+
+        if( fd < 0 )
+        {
+            throw std::runtime_error{ "Unable to open dictionary " + i_path };
+        }
+
+        struct stat st
+        {
+        };
+
+        if( ::fstat( fd, &st ) != 0 || st.st_size < static_cast<off_t>( sizeof( header_s ) ) )
+        {
+            ::close( fd );
+            throw std::runtime_error{ "Invalid dictionary " + i_path };
+        }
+
+        auto size{ static_cast<std::size_t>( st.st_size ) };
+        auto addr{ ::mmap( nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0 ) };
+        ::close( fd );
+
+        if( addr == MAP_FAILED )
+        {
+            throw std::runtime_error{ "Unable to map dictionary " + i_path };
+        }
+
+        auto result{ dawg{} };
+        result.m_mapping = std::shared_ptr<void>{ addr, [size]( void* p ) { ::munmap( p, size ); } };
+
+        auto header{ header_s{} };
+        std::memcpy( &header, addr, sizeof( header ) );
+
+        auto expected{ sizeof( header ) + header.edge_count * sizeof( dawg_edge_s ) +
+                       header.word_count * sizeof( uint32_t ) };
+
+        if( header.magic != magic || expected != size )
+        {
+            throw std::runtime_error{ "Corrupt dictionary " + i_path };
+        }
+
+        auto bytes{ static_cast<const char*>( addr ) + sizeof( header ) };
+
+        result.m_edges = reinterpret_cast<const dawg_edge_s*>( bytes );
+        result.m_edge_count = header.edge_count;
+        result.m_ranks = reinterpret_cast<const uint32_t*>( bytes + header.edge_count * sizeof( dawg_edge_s ) );
+        result.m_word_count = header.word_count;
+
+        return result;
+    }
+
+
+    /**
+     * @brief Serialize the graph so it can be mapped later
+     *
+     * @param i_path output path
+     */
+    void save( const std::string& i_path ) const
+    {
+        auto stream{ std::ofstream{ i_path, std::ios::binary | std::ios::trunc } };
+
+        auto header{ header_s{ magic, m_edge_count, m_word_count } };
+
+        stream.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+        stream.write( reinterpret_cast<const char*>( m_edges ), m_edge_count * sizeof( dawg_edge_s ) );
+        stream.write( reinterpret_cast<const char*>( m_ranks ), m_word_count * sizeof( uint32_t ) );
+
+        if( !stream )
+        {
+            throw std::runtime_error{ "Unable to write dictionary " + i_path };
+        }
+    }
+
+
+    /**
+     * @brief Follow the edge labelled i_char out of a node
+     *
+     * @param i_node first edge of the node's list
+     * @param i_char label to follow
+     * @return step information, nothing when no such edge exists
+     */
+    std::optional<dawg_step_s> step( uint32_t i_node, char i_char ) const noexcept
+    {
+        if( i_node >= m_edge_count )
+        {
+            return std::nullopt;
+        }
+
+        auto offset{ 0_ui32 };
+
+        for( auto idx{ i_node }; idx < m_edge_count; ++idx )
+        {
+            auto&& edge{ m_edges[idx] };
+
+            if( edge.label() == i_char )
+            {
+                return dawg_step_s{ edge.child(), offset, edge.end_of_word() };
+            }
+
+            offset += edge.count;
+
+            if( edge.last() )
+            {
+                break;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+
+    /**
+     * @brief Frequency rank of a word
+     *
+     * @param i_word word to look up
+     * @return 1-based rank, nothing when the word is not in the dictionary
+     */
+    std::optional<uint32_t> rank( std::string_view i_word ) const noexcept
+    {
+        auto node{ root };
+        auto index{ 0_ui32 };
+
+        for( auto i{ 0_sz }; i < i_word.size(); ++i )
+        {
+            auto next{ step( node, i_word[i] ) };
+
+            if( !next )
+            {
+                return std::nullopt;
+            }
+
+            index += next->index_offset;
+
+            if( i + 1 == i_word.size() )
+            {
+                return next->end_of_word ? std::optional{ rank_at( index ) } : std::nullopt;
+            }
+
+            index += next->end_of_word ? 1_ui32 : 0_ui32;
+
+            if( next->child == 0_ui32 )
+            {
+                return std::nullopt;
+            }
+
+            node = next->child;
+        }
+
+        return std::nullopt;
+    }
+
+
+    /**
+     * @brief Rank of the word with the given perfect-hash index
+     *
+     * @param i_index index accumulated while walking the graph
+     * @return 1-based rank
+     */
+    uint32_t rank_at( uint32_t i_index ) const noexcept
+    {
+        return i_index < m_word_count ? m_ranks[i_index] : m_word_count;
+    }
+
+
+    /**
+     * @brief Number of words in the graph
+     *
+     */
+    auto size() const noexcept
+    {
+        return m_word_count;
+    }
+
+
+    /**
+     * @brief Number of serialized edges
+     *
+     */
+    auto edge_count() const noexcept
+    {
+        return m_edge_count;
+    }
+
+private:
+    struct header_s
+    {
+        uint32_t magic{ 0_ui32 };
+        uint32_t edge_count{ 0_ui32 };
+        uint32_t word_count{ 0_ui32 };
+        uint32_t reserved{ 0_ui32 };
+    };
+
+
+    /**
+     * @brief Incremental construction of a minimal graph from sorted input (Daciuk et al.)
+     *
+     */
+    class graph_builder
+    {
+        struct edge_s
+        {
+            char label{};
+            bool end_of_word{ false };
+            uint32_t child{ 0_ui32 };
+
+            friend bool operator<( const edge_s& l, const edge_s& r )
+            {
+                return std::tie( l.label, l.end_of_word, l.child ) < std::tie( r.label, r.end_of_word, r.child );
+            }
+        };
+
+        using node_t = std::vector<edge_s>;
+
+        std::vector<node_t> m_nodes{ node_t{} };
+
+        std::map<node_t, uint32_t> m_register{};
+
+        std::vector<uint32_t> m_path{};  // unchecked nodes along the previous word, m_path[i] is reached by i+1 chars
+
+        std::string m_previous{};
+
+
+        void minimize( std::size_t i_down_to )
+        {
+            while( m_path.size() > i_down_to )
+            {
+                auto child{ m_path.back() };
+                m_path.pop_back();
+
+                auto parent{ m_path.empty() ? 0_ui32 : m_path.back() };
+
+                auto [iter, inserted] = m_register.emplace( m_nodes[child], child );
+
+                if( !inserted )
+                {
+                    m_nodes[parent].back().child = iter->second;
+                }
+            }
+        }
+
+    public:
+        void add( const std::string& i_word )
+        {
+            auto common{ 0_sz };
+
+            while( common < i_word.size() && common < m_previous.size() && i_word[common] == m_previous[common] )
+            {
+                ++common;
+            }
+
+            minimize( common );
+
+            auto node{ m_path.empty() ? 0_ui32 : m_path.back() };
+
+            for( auto i{ common }; i < i_word.size(); ++i )
+            {
+                m_nodes.emplace_back();
+                auto child{ static_cast<uint32_t>( m_nodes.size() - 1 ) };
+
+                m_nodes[node].push_back( edge_s{ i_word[i], i + 1 == i_word.size(), child } );
+                m_path.push_back( child );
+                node = child;
+            }
+
+            m_previous = i_word;
+        }
+
+
+        std::vector<dawg_edge_s> finish()
+        {
+            minimize( 0 );
+
+            auto offsets{ std::vector<uint32_t>( m_nodes.size(), 0_ui32 ) };
+            auto words{ std::vector<uint32_t>( m_nodes.size(), 0_ui32 ) };
+            auto visited{ std::vector<bool>( m_nodes.size(), false ) };
+            auto order{ std::vector<uint32_t>{} };
+
+            // post-order so that child word counts are known before their parents
+            auto stack{ std::vector<std::pair<uint32_t, bool>>{ { 0_ui32, false } } };
+
+            while( !stack.empty() )
+            {
+                auto [node, expanded] = stack.back();
+                stack.pop_back();
+
+                if( expanded )
+                {
+                    for( auto&& edge : m_nodes[node] )
+                    {
+                        words[node] += ( edge.end_of_word ? 1_ui32 : 0_ui32 ) + words[edge.child];
+                    }
+
+                    order.push_back( node );
+                    continue;
+                }
+
+                if( visited[node] )
+                {
+                    continue;
+                }
+
+                visited[node] = true;
+                stack.emplace_back( node, true );
+
+                for( auto&& edge : m_nodes[node] )
+                {
+                    if( !visited[edge.child] )
+                    {
+                        stack.emplace_back( edge.child, false );
+                    }
+                }
+            }
+
+            // root first, then remaining nodes with edges in reverse post-order
+            auto total{ 0_ui32 };
+
+            for( auto iter{ order.rbegin() }; iter != order.rend(); ++iter )
+            {
+                if( !m_nodes[*iter].empty() )
+                {
+                    offsets[*iter] = total;
+                    total += static_cast<uint32_t>( m_nodes[*iter].size() );
+                }
+            }
+
+            auto edges{ std::vector<dawg_edge_s>( total ) };
+
+            for( auto&& node : order )
+            {
+                auto&& list{ m_nodes[node] };
+
+                for( auto i{ 0_sz }; i < list.size(); ++i )
+                {
+                    auto&& edge{ list[i] };
+                    auto child{ m_nodes[edge.child].empty() ? 0_ui32 : offsets[edge.child] };
+
+                    auto packed{ static_cast<uint32_t>( static_cast<unsigned char>( edge.label ) ) |
+                                 ( edge.end_of_word ? 1_ui32 << 8 : 0_ui32 ) |
+                                 ( i + 1 == list.size() ? 1_ui32 << 9 : 0_ui32 ) | ( child << 10 ) };
+
+                    edges[offsets[node] + i] =
+                        dawg_edge_s{ packed, ( edge.end_of_word ? 1_ui32 : 0_ui32 ) + words[edge.child] };
+                }
+            }
+
+            return edges;
+        }
+    };
+
+    std::vector<dawg_edge_s> m_own_edges{};
+
+    std::vector<uint32_t> m_own_ranks{};
+
+    std::shared_ptr<void> m_mapping{};
+
+    const dawg_edge_s* m_edges{ nullptr };
+
+    uint32_t m_edge_count{ 0_ui32 };
+
+    const uint32_t* m_ranks{ nullptr };
+
+    uint32_t m_word_count{ 0_ui32 };
+
+public:
+    dawg( const dawg& i_other ) :
+        m_own_edges{ i_other.m_own_edges },
+        m_own_ranks{ i_other.m_own_ranks },
+        m_mapping{ i_other.m_mapping },
+        m_edges{ i_other.m_mapping ? i_other.m_edges : m_own_edges.data() },
+        m_edge_count{ i_other.m_edge_count },
+        m_ranks{ i_other.m_mapping ? i_other.m_ranks : m_own_ranks.data() },
+        m_word_count{ i_other.m_word_count }
+    {
+    }
+
+    dawg( dawg&& ) noexcept = default;
+
+    dawg& operator=( dawg i_other ) noexcept
+    {
+        std::swap( m_own_edges, i_other.m_own_edges );
+        std::swap( m_own_ranks, i_other.m_own_ranks );
+        std::swap( m_mapping, i_other.m_mapping );
+        std::swap( m_edges, i_other.m_edges );
+        std::swap( m_edge_count, i_other.m_edge_count );
+        std::swap( m_ranks, i_other.m_ranks );
+        std::swap( m_word_count, i_other.m_word_count );
+
+        return *this;
+    }
+};
+
+}
@@ -0,0 +1,437 @@
+/**
+ * @file entry_store.hpp
+ * @author ashwinn76
+ * @brief Compact, arena-backed in-memory store of decrypted entry fields
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * An entry is four 32-bit field references, 16 bytes, instead of four std::string objects and their heap blocks.
+ * Fields live length-prefixed in large slabs; a reference is the slab number and the position within it. Every
+ * distinct field value is stored once, so the user names and sites that repeat across thousands of entries cost a
+ * reference each, and two fields are equal exactly when their references are. Lookups use open addressing over
+ * 32-bit values, so neither the index nor the tables hold a single pointer.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <cstring>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include <sys/mman.h>
+
+#include "plaintext_cache.hpp"
+#include "vault_io.hpp"
+
+namespace vault
+{
+/**
+ * @brief Fields of one entry, viewing into the store that holds them
+ *
+ */
+struct entry_view_s
+{
+    std::string_view name{};
+    std::string_view user{};
+    std::string_view url{};
+    std::string_view notes{};
+};
+
+
+/**
+ * @brief Interned entry fields in locked, non-dumpable slabs, with a 16-byte index record per entry
+ *
+ * Views stay valid until the store is cleared or destroyed: slabs never move, and replacing an entry leaves its old
+ * fields in place. The slabs are wiped before they are released. Not thread-safe; readers may share a store that is
+ * no longer written.
+ */
+class entry_store
+{
+public:
+    static constexpr auto slab_bits = 20_ui32;
+
+    static constexpr auto slab_size = 1_sz << slab_bits;
+
+    static constexpr auto max_slabs = 1_sz << ( 32 - slab_bits );  // 4 GiB of fields behind 32-bit references
+
+    static constexpr auto max_field_size = 0xFFFF_sz;
+
+
+    entry_store() = default;
+
+    entry_store( const entry_store& ) = delete;
+    entry_store& operator=( const entry_store& ) = delete;
+
+
+    ~entry_store()
+    {
+        release_slabs();
+    }
+
+
+    /**
+     * @brief Insert an entry, or replace the fields of the entry with the same name
+     *
+     * @return id of the entry, stable for the life of the store
+     */
+    uint32_t put( const entry_view_s& i_entry )
+    {
+        auto refs{ entry_refs_s{
+            intern( i_entry.name ), intern( i_entry.user ), intern( i_entry.url ), intern( i_entry.notes ) } };
+
+        if( ( m_entries.size() + 1 ) * 2 > m_names.size() )
+        {
+            grow_names();
+        }
+
+        auto slot{ name_slot( refs.name ) };
+
+        if( m_names[slot] != no_entry )
+        {
+            m_entries[m_names[slot]] = refs;
+            return m_names[slot];
+        }
+
+        auto id{ static_cast<uint32_t>( m_entries.size() ) };
+
+        m_entries.push_back( refs );
+        m_names[slot] = id;
+
+        return id;
+    }
+
+
+    /**
+     * @brief Id of the entry with a name
+     *
+     * @return id, nothing if no entry has the name
+     */
+    std::optional<uint32_t> find( std::string_view i_name ) const
+    {
+        auto ref{ lookup( i_name ) };
+
+        if( !ref || m_names.empty() )
+        {
+            return std::nullopt;
+        }
+
+        auto id{ m_names[name_slot( *ref )] };
+
+        return id == no_entry ? std::nullopt : std::optional{ id };
+    }
+
+
+    /**
+     * @brief Fields of an entry
+     *
+     */
+    entry_view_s operator[]( uint32_t i_id ) const noexcept
+    {
+        auto& refs{ m_entries[i_id] };
+
+        return { field( refs.name ), field( refs.user ), field( refs.url ), field( refs.notes ) };
+    }
+
+
+    /**
+     * @brief Name of an entry, without touching its other fields
+     *
+     */
+    std::string_view name( uint32_t i_id ) const noexcept
+    {
+        return field( m_entries[i_id].name );
+    }
+
+
+    std::size_t size() const noexcept
+    {
+        return m_entries.size();
+    }
+
+
+    /**
+     * @brief Distinct field values stored
+     *
+     */
+    std::size_t distinct_fields() const noexcept
+    {
+        return m_field_count;
+    }
+
+
+    /**
+     * @brief Bytes taken by the slabs, the index and the lookup tables
+     *
+     */
+    std::size_t memory_usage() const noexcept
+    {
+        return m_slabs.size() * slab_size + m_entries.capacity() * sizeof( entry_refs_s ) +
+               ( m_fields.capacity() + m_names.capacity() ) * sizeof( uint32_t );
+    }
+
+
+    /**
+     * @brief Wipe and drop every entry
+     *
+     */
+    void clear()
+    {
+        release_slabs();
+
+        m_entries.clear();
+        m_fields.clear();
+        m_names.clear();
+        m_field_count = 0;
+    }
+
+private:
+    using field_ref_t = uint32_t;  // slab number in the high bits, position within the slab in the low slab_bits
+
+    static constexpr auto no_field = ~0_ui32;
+
+    static constexpr auto no_entry = ~0_ui32;
+
+    static constexpr auto length_size = sizeof( uint16_t );
+
+
+    /**
+     * @brief Index record of one entry
+     *
+     */
+    struct entry_refs_s
+    {
+        field_ref_t name{ no_field };
+        field_ref_t user{ no_field };
+        field_ref_t url{ no_field };
+        field_ref_t notes{ no_field };
+    };
+
+    static_assert( sizeof( entry_refs_s ) == 16, "Entry index records must stay 16 bytes!" );
+
+
+    struct slab_s
+    {
+        char* data{ nullptr };
+        bool locked{ false };
+    };
+
+    std::vector<slab_s> m_slabs{};
+
+    std::size_t m_used{ slab_size };  // bytes used in the last slab; a full slab when there is none yet
+
+    std::vector<entry_refs_s> m_entries{};
+
+    std::vector<field_ref_t> m_fields{};  // open-addressed set of every distinct field, keyed by its contents
+
+    std::size_t m_field_count{ 0_sz };
+
+    std::vector<uint32_t> m_names{};  // open-addressed entry ids, keyed by their interned name
+
+
+    /**
+     * @brief Table slot for a hash: the high bits of a Fibonacci multiplication, for a power of two table size
+     *
+     */
+    static std::size_t home_slot( uint64_t i_hash, std::size_t i_table_size ) noexcept
+    {
+        return static_cast<std::size_t>( ( i_hash * 0x9E3779B97F4A7C15_ui64 ) >> 32 ) & ( i_table_size - 1 );
+    }
+
+
+    static uint64_t content_hash( std::string_view i_value ) noexcept
+    {
+        return std::hash<std::string_view>{}( i_value );
+    }
+
+
+    std::string_view field( field_ref_t i_ref ) const noexcept
+    {
+        auto data{ m_slabs[i_ref >> slab_bits].data + ( i_ref & ( slab_size - 1 ) ) };
+
+        auto length{ uint16_t{} };
+        std::memcpy( &length, data, length_size );
+
+        return { data + length_size, length };
+    }
+
+
+    /**
+     * @brief Slot of a field value in the intern table: where it is stored, else the empty slot it would take
+     *
+     */
+    std::size_t field_slot( std::string_view i_value ) const noexcept
+    {
+        auto mask{ m_fields.size() - 1 };
+
+        for( auto slot{ home_slot( content_hash( i_value ), m_fields.size() ) };; slot = ( slot + 1 ) & mask )
+        {
+            if( m_fields[slot] == no_field || field( m_fields[slot] ) == i_value )
+            {
+                return slot;
+            }
+        }
+    }
+
+
+    std::optional<field_ref_t> lookup( std::string_view i_value ) const noexcept
+    {
+        if( m_fields.empty() )
+        {
+            return std::nullopt;
+        }
+
+        auto ref{ m_fields[field_slot( i_value )] };
+
+        return ref == no_field ? std::nullopt : std::optional{ ref };
+    }
+
+
+    /**
+     * @brief Reference to a field value, appending it to the arena the first time it is seen
+     *
+     */
+    field_ref_t intern( std::string_view i_value )
+    {
+        if( i_value.size() > max_field_size )
+        {
+            throw vault_error{ "Field too long for the entry store" };
+        }
+
+        if( ( m_field_count + 1 ) * 2 > m_fields.size() )
+        {
+            grow_fields();
+        }
+
+        auto slot{ field_slot( i_value ) };
+
+        if( m_fields[slot] != no_field )
+        {
+            return m_fields[slot];
+        }
+
+        auto ref{ append( i_value ) };
+
+        m_fields[slot] = ref;
+        ++m_field_count;
+
+        return ref;
+    }
+
+
+    field_ref_t append( std::string_view i_value )
+    {
+        if( m_used + length_size + i_value.size() > slab_size )
+        {
+            add_slab();
+        }
+
+        auto length{ static_cast<uint16_t>( i_value.size() ) };
+        auto data{ m_slabs.back().data + m_used };
+
+        std::memcpy( data, &length, length_size );
+        std::memcpy( data + length_size, i_value.data(), i_value.size() );
+
+        auto ref{ static_cast<field_ref_t>( ( ( m_slabs.size() - 1 ) << slab_bits ) | m_used ) };
+        m_used += length_size + i_value.size();
+
+        return ref;
+    }
+
+
+    void add_slab()
+    {
+        if( m_slabs.size() == max_slabs )
+        {
+            throw vault_error{ "Entry store is full" };
+        }
+
+        auto region{ ::mmap( nullptr, slab_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 ) };
+
+        if( region == MAP_FAILED )
+        {
+            throw std::bad_alloc{};
+        }
+
+        auto slab{ slab_s{ static_cast<char*>( region ) } };
+
+        // as for the plaintext cache, a slab that cannot be locked still works, only without the swap guarantee
+        slab.locked = ::mlock( slab.data, slab_size ) == 0;
+
+#ifdef MADV_DONTDUMP
+        ::madvise( slab.data, slab_size, MADV_DONTDUMP );
+#endif
+
+        m_slabs.push_back( slab );
+        m_used = 0;
+    }
+
+
+    void release_slabs() noexcept
+    {
+        for( auto&& slab : m_slabs )
+        {
+            wipe_bytes( slab.data, slab_size );
+
+            if( slab.locked )
+            {
+                ::munlock( slab.data, slab_size );
+            }
+
+            ::munmap( slab.data, slab_size );
+        }
+
+        m_slabs.clear();
+        m_used = slab_size;
+    }
+
+
+    void grow_fields()
+    {
+        auto old{ std::vector<field_ref_t>( std::max( 16_sz, m_fields.size() * 2 ), no_field ) };
+        std::swap( old, m_fields );
+
+        for( auto ref : old )
+        {
+            if( ref != no_field )
+            {
+                m_fields[field_slot( field( ref ) )] = ref;
+            }
+        }
+    }
+
+
+    /**
+     * @brief Slot of a name in the name table; interned names compare by reference alone
+     *
+     */
+    std::size_t name_slot( field_ref_t i_name ) const noexcept
+    {
+        auto mask{ m_names.size() - 1 };
+
+        for( auto slot{ home_slot( i_name, m_names.size() ) };; slot = ( slot + 1 ) & mask )
+        {
+            if( m_names[slot] == no_entry || m_entries[m_names[slot]].name == i_name )
+            {
+                return slot;
+            }
+        }
+    }
+
+
+    void grow_names()
+    {
+        m_names.assign( std::max( 16_sz, m_names.size() * 2 ), no_entry );
+
+        for( auto id{ 0_ui32 }; id < m_entries.size(); ++id )
+        {
+            m_names[name_slot( m_entries[id].name )] = id;
+        }
+    }
+};
+
+}
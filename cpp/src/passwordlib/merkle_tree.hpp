@@ -0,0 +1,317 @@
+/**
+ * @file merkle_tree.hpp
+ * @author ashwinn76
+ * @brief Fixed-shape Merkle tree over the records of a vault, for finding where two replicas differ
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "sha256.hpp"
+#include "vault_crypto.hpp"
+#include "vault_io.hpp"
+
+namespace vault
+{
+constexpr auto merkle_digest_size = 16_sz;
+
+
+/**
+ * @brief Truncated SHA-256, of a record frame for the leaves and of child hashes for the nodes above them
+ *
+ */
+using merkle_digest_t = std::array<uint8_t, merkle_digest_size>;
+
+
+/**
+ * @brief Digest of a record as stored; frames carry a random nonce, so equal digests mean the very same frame
+ *
+ */
+inline merkle_digest_t record_digest( std::string_view i_frame ) noexcept
+{
+    auto hash{ encryption::sha256::hash( i_frame.data(), i_frame.size() ) };
+
+    auto digest{ merkle_digest_t{} };
+    std::copy_n( hash.begin(), merkle_digest_size, digest.begin() );
+
+    return digest;
+}
+
+
+/**
+ * @brief Merkle tree whose shape depends only on the blind indexes, so two replicas of a vault can compare it level by
+ *        level
+ *
+ * Each level splits on the next four bits of the blind index and the leaves hold the (index, record digest) pairs of
+ * their bucket in index order. A leaf hashes its pairs and a node its sixteen children; an empty subtree hashes to
+ * zero. Hashes are recomputed lazily, so a write only dirties one path and a comparison rehashes what changed since
+ * the last one. Writes must be serialised by the caller; reading hashes is safe from many threads.
+ */
+class merkle_tree
+{
+public:
+    static constexpr auto fanout = 16_ui32;
+
+    static constexpr auto depth = 4_ui32;  // leaf level; 65536 buckets keep a million records at ~15 per bucket
+
+    using bucket_t = std::vector<std::pair<blind_index_t, merkle_digest_t>>;
+
+
+    merkle_tree()
+    {
+        for( auto level{ 0_ui32 }, width{ 1_ui32 }; level <= depth; ++level, width *= fanout )
+        {
+            m_hashes.emplace_back( width );
+            m_dirty.emplace_back( width, false );
+        }
+
+        m_buckets.resize( m_hashes.back().size() );
+    }
+
+
+    /**
+     * @brief Insert or replace the digest of a record
+     *
+     */
+    void set( const blind_index_t& i_index, const merkle_digest_t& i_digest )
+    {
+        auto position{ bucket_of( i_index ) };
+        auto& bucket{ m_buckets[position] };
+
+        auto iter{ lower_bound_in( bucket, i_index ) };
+
+        if( iter != bucket.end() && iter->first == i_index )
+        {
+            if( iter->second == i_digest )
+            {
+                return;
+            }
+
+            iter->second = i_digest;
+        }
+        else
+        {
+            bucket.emplace( iter, i_index, i_digest );
+            ++m_size;
+        }
+
+        touch( position );
+    }
+
+
+    /**
+     * @brief Remove a record, if present
+     *
+     */
+    void erase( const blind_index_t& i_index )
+    {
+        auto position{ bucket_of( i_index ) };
+        auto& bucket{ m_buckets[position] };
+
+        auto iter{ find_in( bucket, i_index ) };
+
+        if( iter != bucket.end() )
+        {
+            bucket.erase( iter );
+            --m_size;
+
+            touch( position );
+        }
+    }
+
+
+    /**
+     * @brief Digest of a record
+     *
+     * @return digest, nothing if the record is not in the tree
+     */
+    std::optional<merkle_digest_t> find( const blind_index_t& i_index ) const
+    {
+        auto& bucket{ m_buckets[bucket_of( i_index )] };
+
+        auto iter{ find_in( bucket, i_index ) };
+
+        if( iter == bucket.end() )
+        {
+            return std::nullopt;
+        }
+
+        return iter->second;
+    }
+
+
+    void clear()
+    {
+        for( auto position{ 0_sz }; position < m_buckets.size(); ++position )
+        {
+            if( !m_buckets[position].empty() )
+            {
+                m_buckets[position].clear();
+                touch( static_cast<uint32_t>( position ) );
+            }
+        }
+
+        m_size = 0;
+    }
+
+
+    std::size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+
+    /**
+     * @brief Hash of a node, rehashing the dirty part of its subtree first
+     *
+     * @param i_level level of the node, 0 for the root and depth for the leaves
+     * @param i_position position of the node within its level
+     */
+    merkle_digest_t hash( uint32_t i_level, uint32_t i_position ) const
+    {
+        if( i_level > depth || i_position >= m_hashes[i_level].size() )
+        {
+            throw vault_error{ "Merkle tree node out of range" };
+        }
+
+        auto lock{ std::lock_guard{ m_mutex } };
+        return rehash( i_level, i_position );
+    }
+
+
+    /**
+     * @brief Records of one leaf bucket in index order
+     *
+     */
+    const bucket_t& bucket( uint32_t i_position ) const
+    {
+        if( i_position >= m_buckets.size() )
+        {
+            throw vault_error{ "Merkle tree bucket out of range" };
+        }
+
+        return m_buckets[i_position];
+    }
+
+
+    /**
+     * @brief Leaf bucket a blind index falls into: its leading 4 * depth bits
+     *
+     */
+    static uint32_t bucket_of( const blind_index_t& i_index ) noexcept
+    {
+        auto prefix{ 0_ui32 };
+
+        for( auto i{ 0_sz }; i < sizeof( prefix ); ++i )
+        {
+            prefix = ( prefix << 8 ) | i_index[i];
+        }
+
+        return prefix >> ( 32 - 4 * depth );
+    }
+
+private:
+    std::vector<bucket_t> m_buckets{};
+
+    std::size_t m_size{ 0_sz };
+
+    mutable std::mutex m_mutex{};  // guards the lazily computed hashes
+
+    mutable std::vector<std::vector<merkle_digest_t>> m_hashes{};  // per level, valid where not dirty
+
+    mutable std::vector<std::vector<bool>> m_dirty{};
+
+
+    static bool before( const bucket_t::value_type& i_pair, const blind_index_t& i_index ) noexcept
+    {
+        return i_pair.first < i_index;
+    }
+
+
+    static bucket_t::iterator lower_bound_in( bucket_t& i_bucket, const blind_index_t& i_index )
+    {
+        return std::lower_bound( i_bucket.begin(), i_bucket.end(), i_index, before );
+    }
+
+
+    static bucket_t::const_iterator find_in( const bucket_t& i_bucket, const blind_index_t& i_index )
+    {
+        auto iter{ std::lower_bound( i_bucket.begin(), i_bucket.end(), i_index, before ) };
+
+        return iter != i_bucket.end() && iter->first == i_index ? iter : i_bucket.end();
+    }
+
+
+    /**
+     * @brief Mark a leaf and its ancestors for rehashing
+     *
+     */
+    void touch( uint32_t i_position )
+    {
+        auto lock{ std::lock_guard{ m_mutex } };
+
+        for( auto level{ depth + 1 }; level-- > 0; i_position /= fanout )
+        {
+            m_dirty[level][i_position] = true;
+        }
+    }
+
+
+    merkle_digest_t rehash( uint32_t i_level, uint32_t i_position ) const
+    {
+        auto& digest{ m_hashes[i_level][i_position] };
+
+        if( !m_dirty[i_level][i_position] )
+        {
+            return digest;
+        }
+
+        auto hasher{ encryption::sha256{} };
+        auto empty{ true };
+
+        if( i_level == depth )
+        {
+            for( auto&& [index, record] : m_buckets[i_position] )
+            {
+                hasher.update( index.data(), index.size() ).update( record.data(), record.size() );
+                empty = false;
+            }
+        }
+        else
+        {
+            for( auto child{ 0_ui32 }; child < fanout; ++child )
+            {
+                auto child_digest{ rehash( i_level + 1, i_position * fanout + child ) };
+
+                hasher.update( child_digest.data(), child_digest.size() );
+                empty = empty && child_digest == merkle_digest_t{};
+            }
+        }
+
+        digest = merkle_digest_t{};
+
+        if( !empty )
+        {
+            auto hash{ hasher.finish() };
+            std::copy_n( hash.begin(), merkle_digest_size, digest.begin() );
+        }
+
+        m_dirty[i_level][i_position] = false;
+
+        return digest;
+    }
+};
+
+}
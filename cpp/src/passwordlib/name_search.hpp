@@ -0,0 +1,444 @@
+/**
+ * @file name_search.hpp
+ * @author ashwinn76
+ * @brief Prefix and typo-tolerant search over decrypted entry names with a compact radix trie
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * The names sit in an entry_store; the trie nodes only refer to ranges of those names, so a node is 20 bytes and holds
+ * no name bytes of its own. A search runs a Levenshtein automaton over the trie: the automaton state after reading a
+ * path is the last row of the edit distance table between the query and that path, computed once per trie edge
+ * character and shared by every name below it. A row whose smallest value exceeds the allowed distance is a dead
+ * state, so its subtree is skipped. Children are kept in byte order, so the walk meets names in name order and stops
+ * descending once k better matches are certain. Distances count bytes, not UTF-8 characters.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "btree_vault.hpp"
+#include "bulk_transfer.hpp"
+#include "entry_store.hpp"
+#include "vault.hpp"
+
+namespace vault
+{
+/**
+ * @brief What a name search matches
+ *
+ */
+struct name_search_options_s
+{
+    uint32_t max_distance{ 0_ui32 };  // insertions, deletions and substitutions allowed
+    bool prefix{ true };  // match the query against the start of names rather than whole names
+    std::size_t limit{ 10_sz };  // matches returned, the closest first
+};
+
+
+/**
+ * @brief One search result
+ *
+ */
+struct name_match_s
+{
+    std::string name{};
+    uint32_t distance{ 0_ui32 };  // edit distance to the name, or to its closest prefix in prefix mode
+
+    bool operator==( const name_match_s& i_other ) const noexcept
+    {
+        return name == i_other.name && distance == i_other.distance;
+    }
+};
+
+
+/**
+ * @brief Entry names in an entry_store, indexed by a radix trie for search
+ *
+ * Not thread-safe; like the store, the index wipes its names when it is cleared or destroyed.
+ */
+class name_index
+{
+public:
+    name_index()
+    {
+        m_nodes.emplace_back();
+    }
+
+
+    name_index( const name_index& ) = delete;
+    name_index& operator=( const name_index& ) = delete;
+
+
+    /**
+     * @brief Add an entry, or replace the fields of the one with the same name
+     *
+     * @return id of the entry in the store
+     */
+    uint32_t insert( const entry_view_s& i_entry )
+    {
+        auto id{ m_store.put( i_entry ) };
+        auto name{ i_entry.name };
+
+        auto node{ 0_ui32 };
+        auto position{ 0_sz };
+
+        while( position < name.size() )
+        {
+            auto first{ static_cast<uint8_t>( name[position] ) };
+            auto previous{ no_node };
+            auto child{ m_nodes[node].first_child };
+
+            while( child != no_node && static_cast<uint8_t>( label( child ).front() ) < first )
+            {
+                previous = child;
+                child = m_nodes[child].next_sibling;
+            }
+
+            if( child == no_node || static_cast<uint8_t>( label( child ).front() ) != first )
+            {
+                auto leaf{ node_s{ id, static_cast<uint16_t>( position ) } };
+                leaf.label_length = static_cast<uint16_t>( name.size() - position );
+                leaf.next_sibling = child;
+                leaf.entry = id;
+
+                link( node, previous, add_node( leaf ) );
+                return id;
+            }
+
+            auto edge{ label( child ) };
+            auto common{ static_cast<std::size_t>(
+                std::mismatch( edge.begin(), edge.end(), name.begin() + position, name.end() ).first - edge.begin() ) };
+
+            if( common < edge.size() )
+            {
+                // split the edge where the name leaves it
+                auto middle{ m_nodes[child] };
+                middle.label_length = static_cast<uint16_t>( common );
+                middle.entry = no_entry;
+                middle.first_child = child;
+                middle.next_sibling = m_nodes[child].next_sibling;
+
+                m_nodes[child].label_start += static_cast<uint16_t>( common );
+                m_nodes[child].label_length -= static_cast<uint16_t>( common );
+                m_nodes[child].next_sibling = no_node;
+
+                child = add_node( middle );
+                link( node, previous, child );
+            }
+
+            node = child;
+            position += common;
+        }
+
+        m_nodes[node].entry = id;
+        return id;
+    }
+
+
+    uint32_t insert( std::string_view i_name )
+    {
+        return insert( entry_view_s{ i_name } );
+    }
+
+
+    /**
+     * @brief Closest names to a query, ordered by distance and then by name
+     *
+     */
+    std::vector<name_match_s> search( std::string_view i_query, const name_search_options_s& i_options ) const
+    {
+        auto state{ search_state_s{ i_query, i_options } };
+
+        if( i_options.limit == 0 )
+        {
+            return {};
+        }
+
+        state.rows.resize( i_query.size() + 1 );
+
+        for( auto j{ 0_sz }; j <= i_query.size(); ++j )
+        {
+            state.rows[j] = static_cast<uint32_t>( j );
+        }
+
+        visit( 0, 0, static_cast<uint32_t>( i_query.size() ), state );
+
+        std::sort_heap( state.best.begin(), state.best.end(), [this]( auto i_left, auto i_right ) {
+            return better( i_left, i_right );
+        } );
+
+        auto matches{ std::vector<name_match_s>{} };
+
+        for( auto&& [distance, id] : state.best )
+        {
+            matches.push_back( { std::string{ m_store.name( id ) }, distance } );
+        }
+
+        return matches;
+    }
+
+
+    std::size_t size() const noexcept
+    {
+        return m_store.size();
+    }
+
+
+    /**
+     * @brief Entries behind the names, with their other fields
+     *
+     */
+    const entry_store& entries() const noexcept
+    {
+        return m_store;
+    }
+
+
+    /**
+     * @brief Bytes taken by the names, the trie and the store's tables
+     *
+     */
+    std::size_t memory_usage() const noexcept
+    {
+        return m_store.memory_usage() + m_nodes.capacity() * sizeof( node_s );
+    }
+
+
+    void clear()
+    {
+        m_store.clear();
+        m_nodes.assign( 1, node_s{} );
+    }
+
+private:
+    static constexpr auto no_node = ~0_ui32;
+
+    static constexpr auto no_entry = ~0_ui32;
+
+
+    /**
+     * @brief Trie node: the edge label leading to it, as a range of one stored name, and its links
+     *
+     */
+    struct node_s
+    {
+        uint32_t label_entry{ no_entry };
+        uint16_t label_start{ 0 };
+        uint16_t label_length{ 0 };
+        uint32_t first_child{ no_node };  // children in the byte order of their labels
+        uint32_t next_sibling{ no_node };
+        uint32_t entry{ no_entry };  // entry whose name ends here
+    };
+
+    static_assert( sizeof( node_s ) == 20, "Trie nodes must stay 20 bytes!" );
+
+
+    /**
+     * @brief Automaton rows along the current path and the best matches so far, a max-heap on (distance, name)
+     *
+     */
+    struct search_state_s
+    {
+        std::string_view query{};
+        name_search_options_s options{};
+        std::vector<uint32_t> rows{};  // one row of query size + 1 per character of the path
+        std::vector<std::pair<uint32_t, uint32_t>> best{};  // (distance, entry id)
+    };
+
+    entry_store m_store{};
+
+    std::vector<node_s> m_nodes{};  // the root first
+
+
+    std::string_view label( uint32_t i_node ) const noexcept
+    {
+        auto& node{ m_nodes[i_node] };
+        return m_store.name( node.label_entry ).substr( node.label_start, node.label_length );
+    }
+
+
+    uint32_t add_node( const node_s& i_node )
+    {
+        m_nodes.push_back( i_node );
+        return static_cast<uint32_t>( m_nodes.size() - 1 );
+    }
+
+
+    /**
+     * @brief Put a node into a parent's child list after a sibling, or first when there is none
+     *
+     */
+    void link( uint32_t i_parent, uint32_t i_previous, uint32_t i_node )
+    {
+        if( i_previous == no_node )
+        {
+            m_nodes[i_parent].first_child = i_node;
+        }
+        else
+        {
+            m_nodes[i_previous].next_sibling = i_node;
+        }
+    }
+
+
+    bool better( const std::pair<uint32_t, uint32_t>& i_left, const std::pair<uint32_t, uint32_t>& i_right ) const
+    {
+        return i_left.first != i_right.first ? i_left.first < i_right.first
+                                             : m_store.name( i_left.second ) < m_store.name( i_right.second );
+    }
+
+
+    /**
+     * @brief Keep a match if it is among the best so far
+     *
+     */
+    void offer( uint32_t i_distance, uint32_t i_entry, search_state_s& io_state ) const
+    {
+        auto worse{ [this]( auto i_left, auto i_right ) { return better( i_left, i_right ); } };
+        auto& best{ io_state.best };
+
+        if( best.size() == io_state.options.limit )
+        {
+            // the walk meets names in order, so a later name only wins on a smaller distance
+            if( i_distance >= best.front().first )
+            {
+                return;
+            }
+
+            std::pop_heap( best.begin(), best.end(), worse );
+            best.pop_back();
+        }
+
+        best.emplace_back( i_distance, i_entry );
+        std::push_heap( best.begin(), best.end(), worse );
+    }
+
+
+    /**
+     * @brief Smallest distance any name below the current path can still reach
+     *
+     */
+    static uint32_t lower_bound( const uint32_t* i_row, std::size_t i_width, uint32_t i_prefix_best, bool i_prefix )
+    {
+        auto bound{ *std::min_element( i_row, i_row + i_width ) };
+        return i_prefix ? std::min( bound, i_prefix_best ) : bound;
+    }
+
+
+    /**
+     * @brief Walk the subtree of a node whose automaton row for the path so far is at a depth of the row stack
+     *
+     * @param i_prefix_best smallest distance between the query and any prefix of the path, for prefix mode
+     */
+    void visit( uint32_t i_node, std::size_t i_depth, uint32_t i_prefix_best, search_state_s& io_state ) const
+    {
+        auto width{ io_state.query.size() + 1 };
+        auto& options{ io_state.options };
+
+        if( auto entry{ m_nodes[i_node].entry }; entry != no_entry )
+        {
+            auto distance{ options.prefix ? i_prefix_best : io_state.rows[i_depth * width + width - 1] };
+
+            if( distance <= options.max_distance )
+            {
+                offer( distance, entry, io_state );
+            }
+        }
+
+        for( auto child{ m_nodes[i_node].first_child }; child != no_node; child = m_nodes[child].next_sibling )
+        {
+            auto edge{ label( child ) };
+            auto depth{ i_depth };
+            auto prefix_best{ i_prefix_best };
+            auto alive{ true };
+
+            io_state.rows.resize( std::max( io_state.rows.size(), ( i_depth + edge.size() + 1 ) * width ) );
+
+            for( auto character : edge )
+            {
+                auto previous{ io_state.rows.data() + depth * width };
+                auto row{ previous + width };
+
+                row[0] = previous[0] + 1;
+
+                for( auto j{ 1_sz }; j < width; ++j )
+                {
+                    auto substitution{ previous[j - 1] + ( io_state.query[j - 1] == character ? 0 : 1 ) };
+                    row[j] = std::min( { previous[j] + 1, row[j - 1] + 1, substitution } );
+                }
+
+                ++depth;
+                prefix_best = std::min( prefix_best, row[width - 1] );
+
+                auto bound{ lower_bound( row, width, prefix_best, options.prefix ) };
+                auto full{ io_state.best.size() == options.limit };
+
+                if( bound > options.max_distance || ( full && bound >= io_state.best.front().first ) )
+                {
+                    alive = false;
+                    break;
+                }
+            }
+
+            if( alive )
+            {
+                visit( child, depth, prefix_best, io_state );
+            }
+        }
+    }
+};
+
+
+/**
+ * @brief Index the names of every entry of a log vault, decrypting on a worker pool
+ *
+ */
+inline void load_names( const vault& i_store, name_index& io_index, const bulk_options_s& i_options = {} )
+{
+    auto locations{ i_store.entry_locations() };
+    auto next{ 0_sz };
+
+    ordered_pipeline<record_location_s, std::string>(
+        [&]() -> std::optional<record_location_s> {
+            if( next == locations.size() )
+            {
+                return std::nullopt;
+            }
+
+            return locations[next++];
+        },
+        [&]( const record_location_s& i_location ) {
+            auto entry{ i_store.open_entry( i_location ) };
+            wipe_bytes( entry.secret.data(), entry.secret.size() );
+
+            return std::move( entry.name );
+        },
+        [&io_index]( std::string i_name ) {
+            io_index.insert( i_name );
+            wipe_bytes( i_name.data(), i_name.size() );
+        },
+        i_options.workers,
+        i_options.queue_capacity );
+}
+
+
+/**
+ * @brief Index the names of every entry of a B+tree vault, in one pass along its leaves
+ *
+ */
+inline void load_names( const btree_vault& i_store, name_index& io_index, const bulk_options_s& = {} )
+{
+    i_store.scan( {}, [&io_index]( std::string_view i_name, std::string_view ) {
+        io_index.insert( i_name );
+        return true;
+    } );
+}
+
+}
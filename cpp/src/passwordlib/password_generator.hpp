@@ -18,6 +18,7 @@
 
 #include "bound_value.hpp"
 #include "algo_utils.hpp"
+#include "password_strength.hpp"
 
 using namespace std::string_literals;
 using namespace std::string_view_literals;
@@ -55,6 +56,8 @@ struct char_valid_info_s
 constexpr auto all_special_characters = char_valid_info_s{};
 constexpr auto no_special_characters = char_valid_info_s{ true };
 
+constexpr auto max_generation_attempts = 256;
+
 
 /**
  * @brief Get a randomly generated string
@@ -63,7 +66,7 @@ constexpr auto no_special_characters = char_valid_info_s{ true };
  * @param i_character_info valid/invalid special characters
  * @return random string
  */
-auto get_random_string( int i_length, char_valid_info_s i_character_info ) noexcept
+inline auto get_random_string( int i_length, char_valid_info_s i_character_info ) noexcept
 {
     constexpr auto first_grid = std::array<char, 36>{
         'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P', 'Q', 'R',
@@ -140,4 +143,34 @@ auto get_random_string( int i_length, char_valid_info_s i_character_info ) noexc
     return random_str;
 }
 
-}
\ No newline at end of file
+
+
+/**
+ * @brief Get a randomly generated string whose estimated strength is above an entropy floor
+ *
+ * @param i_length required length of string
+ * @param i_character_info valid/invalid special characters
+ * @param i_min_entropy minimum log2 guesses the string must need
+ * @param i_estimator estimator used to verify the string
+ * @return random string
+ */
+inline auto get_random_string( int i_length,
+                               char_valid_info_s i_character_info,
+                               double i_min_entropy,
+                               const password_strength::strength_estimator& i_estimator =
+                                   password_strength::default_estimator() )
+{
+    for( auto attempt{ 0 }; attempt < max_generation_attempts; ++attempt )
+    {
+        auto random_str{ get_random_string( i_length, i_character_info ) };
+
+        if( i_estimator.meets_floor( random_str, i_min_entropy ) )
+        {
+            return random_str;
+        }
+    }
+
+    throw std::runtime_error{ "Unable to generate a password above the entropy floor!" };
+}
+
+}
@@ -0,0 +1,993 @@
+/**
+ * @file password_strength.hpp
+ * @author ashwinn76
+ * @brief zxcvbn-style password strength estimation over dictionaries, keyboard walks and dates
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Dictionary matches are only as good as the frequency list behind them, and none ships with the library: an
+ * estimator is always given its dictionaries. The useful ones are built offline from a real list of common passwords
+ * and words, most frequent first, with read_frequency_list and dawg::save, and mapped with dawg::map_file. The shared
+ * default_estimator maps the file named by PASSWORDS_DICTIONARY; without one it falls back to a seed list of the 140
+ * most common passwords, which catches the worst choices but rates rarer dictionary words far too highly.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "macro_utils.hpp"
+#include "dawg.hpp"
+
+namespace password_strength
+{
+constexpr auto dictionary_variable = "PASSWORDS_DICTIONARY";  // DAWG file written by dawg::save
+
+
+/**
+ * @brief Kind of pattern a part of the password was explained by
+ *
+ */
+enum class match_type
+{
+    bruteforce,
+    dictionary,
+    keyboard,
+    date,
+    repeat,
+    sequence,
+};
+
+
+/**
+ * @brief Pattern found in a password, covering the characters [begin, end)
+ *
+ */
+struct match_s
+{
+    match_type type{ match_type::bruteforce };
+    uint64_t begin{ 0_ui64 };
+    uint64_t end{ 0_ui64 };
+    double guesses_log2{ 0.0 };
+};
+
+
+/**
+ * @brief Strength of a password
+ *
+ */
+struct strength_s
+{
+    double entropy{ 0.0 };  // log2 of the number of guesses needed by an attacker following the matched patterns
+    int score{ 0 };  // 0 (too guessable) to 4 (very unguessable)
+    std::vector<match_s> sequence{};  // cheapest explanation of the password
+};
+
+
+namespace
+{
+/**
+ * @brief Most common passwords and words, most frequent first; a fallback, not a frequency list
+ *
+ */
+constexpr auto seed_words = std::array<std::string_view, 140>{
+    "123456",    "password", "12345678", "qwerty",   "123456789", "12345",      "1234",     "111111",   "1234567",
+    "dragon",    "123123",   "baseball", "abc123",   "football",  "monkey",     "letmein",  "696969",   "shadow",
+    "master",    "666666",   "qwertyuiop", "123321", "mustang",   "1234567890", "michael",  "654321",   "superman",
+    "1qaz2wsx",  "7777777",  "121212",   "000000",   "qazwsx",    "123qwe",     "killer",   "trustno1", "jordan",
+    "jennifer",  "zxcvbnm",  "asdfgh",   "hunter",   "buster",    "soccer",     "harley",   "batman",   "andrew",
+    "tigger",    "sunshine", "iloveyou", "charlie",  "robert",    "thomas",     "hockey",   "ranger",   "daniel",
+    "starwars",  "klaster",  "112233",   "george",   "computer",  "michelle",   "jessica",  "pepper",   "1111",
+    "zxcvbn",    "555555",   "11111111", "131313",   "freedom",   "777777",     "pass",     "maggie",   "159753",
+    "aaaaaa",    "ginger",   "princess", "joshua",   "cheese",    "amanda",     "summer",   "love",     "ashley",
+    "nicole",    "chelsea",  "biteme",   "matthew",  "access",    "yankees",    "987654321", "dallas",  "austin",
+    "thunder",   "taylor",   "matrix",   "admin",    "welcome",   "secret",     "login",    "hello",    "orange",
+    "purple",    "banana",   "apple",    "flower",   "winter",    "spring",     "autumn",   "money",    "google",
+    "internet",  "samsung",  "mother",   "father",   "family",    "friend",     "house",    "change",   "guest",
+    "root",      "test",     "server",   "backup",   "vault",     "crypto",     "secure",   "the",      "and",
+    "you",       "that",     "was",      "for",      "are",       "with",       "his",      "they",     "this",
+    "have",      "from",     "word",     "what",     "some",
+};
+
+
+/**
+ * @brief Rows of a US qwerty keyboard, unshifted then shifted; a leading space models the row stagger
+ *
+ */
+constexpr auto keyboard_rows = std::array<std::string_view, 4>{
+    "`1234567890-=",
+    " qwertyuiop[]\\",
+    " asdfghjkl;'",
+    " zxcvbnm,./",
+};
+
+constexpr auto shifted_keyboard_rows = std::array<std::string_view, 4>{
+    "~!@#$%^&*()_+",
+    " QWERTYUIOP{}|",
+    " ASDFGHJKL:\"",
+    " ZXCVBNM<>?",
+};
+
+constexpr auto keyboard_starting_positions = 47.0;
+
+constexpr auto keyboard_average_degree = 4.6;
+
+constexpr auto min_year_space = 20;
+
+constexpr auto bruteforce_cardinality_lower = 26;
+constexpr auto bruteforce_cardinality_upper = 26;
+constexpr auto bruteforce_cardinality_digits = 10;
+constexpr auto bruteforce_cardinality_symbols = 33;
+
+constexpr auto date_separators = std::string_view{ " -/\\_." };
+
+
+/**
+ * @brief Lowercase letters a l33t character may stand for
+ *
+ * @param i_char possibly substituted character
+ * @return candidate letters, empty when the character is not a substitution
+ */
+constexpr std::string_view l33t_candidates( char i_char ) noexcept
+{
+    switch( i_char )
+    {
+    case '4':
+    case '@':
+        return "a";
+    case '8':
+        return "b";
+    case '(':
+    case '{':
+    case '[':
+    case '<':
+        return "c";
+    case '3':
+        return "e";
+    case '6':
+    case '9':
+        return "g";
+    case '1':
+    case '|':
+        return "il";
+    case '!':
+        return "i";
+    case '7':
+        return "lt";
+    case '0':
+        return "o";
+    case '$':
+    case '5':
+        return "s";
+    case '+':
+        return "t";
+    case '%':
+        return "x";
+    case '2':
+        return "z";
+    default:
+        return "";
+    }
+}
+
+
+/**
+ * @brief log2 of the binomial coefficient n choose k
+ *
+ */
+inline double log2_choose( uint64_t i_n, uint64_t i_k ) noexcept
+{
+    if( i_k > i_n )
+    {
+        return -INFINITY;
+    }
+
+    return ( std::lgamma( i_n + 1.0 ) - std::lgamma( i_k + 1.0 ) - std::lgamma( i_n - i_k + 1.0 ) ) / std::log( 2.0 );
+}
+
+
+/**
+ * @brief log2 of the sum of n choose i for i in [1, min(n1, n2)], the number of ways to mix two character variants
+ *
+ */
+inline double log2_variations( uint64_t i_first, uint64_t i_second ) noexcept
+{
+    if( i_first == 0_ui64 || i_second == 0_ui64 )
+    {
+        return 1.0;
+    }
+
+    auto sum{ 0.0 };
+
+    for( auto i{ 1_ui64 }; i <= std::min( i_first, i_second ); ++i )
+    {
+        sum += std::exp2( log2_choose( i_first + i_second, i ) );
+    }
+
+    return std::log2( sum );
+}
+
+
+/**
+ * @brief Year used as the reference point for date guesses
+ *
+ */
+inline int reference_year() noexcept
+{
+    static const auto year{ [] {
+        auto now{ std::time( nullptr ) };
+        auto parts{ std::tm{} };
+        gmtime_r( &now, &parts );
+
+        return parts.tm_year + 1900;
+    }() };
+
+    return year;
+}
+
+}
+
+
+/**
+ * @brief Password strength estimator
+ *
+ */
+class strength_estimator
+{
+public:
+    /**
+     * @brief Construct an estimator over dictionaries, typically mapped with dawg::map_file
+     *
+     * @param i_dictionaries ranked dictionaries; without any, only keyboard walks, dates, repeats and sequences count
+     */
+    explicit strength_estimator( std::vector<dawg> i_dictionaries ) : m_dictionaries{ std::move( i_dictionaries ) }
+    {
+        for( auto row{ 0_sz }; row < keyboard_rows.size(); ++row )
+        {
+            for( auto col{ 0_sz }; col < keyboard_rows[row].size(); ++col )
+            {
+                if( keyboard_rows[row][col] != ' ' )
+                {
+                    set_key( keyboard_rows[row][col], row, col, false );
+                    set_key( shifted_keyboard_rows[row][col], row, col, true );
+                }
+            }
+        }
+    }
+
+
+    /**
+     * @brief Estimate the strength of one password
+     *
+     * @param i_password password to score
+     * @return strength with its cheapest explanation
+     */
+    strength_s estimate( std::string_view i_password ) const
+    {
+        auto matches{ std::vector<match_s>{} };
+
+        dictionary_matches( i_password, matches );
+        keyboard_matches( i_password, matches );
+        date_matches( i_password, matches );
+        repeat_and_sequence_matches( i_password, matches );
+
+        return most_guessable_sequence( i_password, matches );
+    }
+
+
+    /**
+     * @brief Estimate the strength of many passwords on several threads
+     *
+     * @param i_passwords passwords to score
+     * @param i_threads number of worker threads, 0 for the hardware concurrency
+     * @return strengths in input order
+     */
+    template<typename _Container>
+    std::vector<strength_s> estimate_batch( const _Container& i_passwords, unsigned i_threads = 0 ) const
+    {
+        constexpr auto chunk_size = 1024_sz;
+
+        auto results{ std::vector<strength_s>( std::size( i_passwords ) ) };
+
+        auto next{ std::atomic<std::size_t>{ 0_sz } };
+
+        auto worker = [&] {
+            for( auto begin{ next.fetch_add( chunk_size ) }; begin < results.size();
+                 begin = next.fetch_add( chunk_size ) )
+            {
+                auto end{ std::min( begin + chunk_size, results.size() ) };
+
+                for( auto i{ begin }; i < end; ++i )
+                {
+                    results[i] = estimate( std::data( i_passwords )[i] );
+                }
+            }
+        };
+
+        if( i_threads == 0 )
+        {
+            i_threads = std::max( 1u, std::thread::hardware_concurrency() );
+        }
+
+        i_threads = static_cast<unsigned>( std::min<std::size_t>( i_threads, results.size() / chunk_size + 1 ) );
+
+        auto threads{ std::vector<std::thread>{} };
+
+        for( auto i{ 1u }; i < i_threads; ++i )
+        {
+            threads.emplace_back( worker );
+        }
+
+        worker();
+
+        for( auto&& thread : threads )
+        {
+            thread.join();
+        }
+
+        return results;
+    }
+
+
+    /**
+     * @brief Check whether a password reaches an entropy floor
+     *
+     * @param i_password password to check
+     * @param i_min_entropy minimum log2 guesses
+     * @return true if the password is strong enough
+     */
+    bool meets_floor( std::string_view i_password, double i_min_entropy ) const
+    {
+        return estimate( i_password ).entropy >= i_min_entropy;
+    }
+
+private:
+    struct key_position_s
+    {
+        int row{ -1 };
+        int col{ -1 };
+        bool shifted{ false };
+    };
+
+    std::vector<dawg> m_dictionaries{};
+
+    std::array<key_position_s, 128> m_keys{};
+
+
+    void set_key( char i_char, std::size_t i_row, std::size_t i_col, bool i_shifted ) noexcept
+    {
+        m_keys[static_cast<unsigned char>( i_char )] =
+            key_position_s{ static_cast<int>( i_row ), static_cast<int>( i_col ), i_shifted };
+    }
+
+
+    const key_position_s* key( char i_char ) const noexcept
+    {
+        auto idx{ static_cast<unsigned char>( i_char ) };
+
+        return idx < m_keys.size() && m_keys[idx].row >= 0 ? &m_keys[idx] : nullptr;
+    }
+
+
+    /**
+     * @brief Find dictionary words, case-insensitively and through l33t substitutions
+     *
+     */
+    void dictionary_matches( std::string_view i_password, std::vector<match_s>& o_matches ) const
+    {
+        struct state_s
+        {
+            uint32_t node;
+            uint32_t index;
+            uint64_t end;
+            uint64_t substitutions;
+        };
+
+        for( auto&& dictionary : m_dictionaries )
+        {
+            for( auto begin{ 0_ui64 }; begin < i_password.size(); ++begin )
+            {
+                auto stack{ std::vector<state_s>{ { dawg::root, 0_ui32, begin, 0_ui64 } } };
+
+                while( !stack.empty() )
+                {
+                    auto state{ stack.back() };
+                    stack.pop_back();
+
+                    if( state.end >= i_password.size() )
+                    {
+                        continue;
+                    }
+
+                    auto original{ i_password[state.end] };
+                    auto lower{ static_cast<char>( std::tolower( static_cast<unsigned char>( original ) ) ) };
+
+                    auto follow = [&]( char i_label, uint64_t i_substitutions ) {
+                        auto next{ dictionary.step( state.node, i_label ) };
+
+                        if( !next )
+                        {
+                            return;
+                        }
+
+                        auto index{ state.index + next->index_offset };
+
+                        if( next->end_of_word )
+                        {
+                            o_matches.push_back( dictionary_match( i_password,
+                                                                   begin,
+                                                                   state.end + 1,
+                                                                   dictionary.rank_at( index ),
+                                                                   i_substitutions ) );
+                            ++index;
+                        }
+
+                        if( next->child != 0_ui32 )
+                        {
+                            stack.push_back( state_s{ next->child, index, state.end + 1, i_substitutions } );
+                        }
+                    };
+
+                    follow( lower, state.substitutions );
+
+                    for( auto&& candidate : l33t_candidates( original ) )
+                    {
+                        follow( candidate, state.substitutions + 1 );
+                    }
+                }
+            }
+        }
+    }
+
+
+    static match_s dictionary_match( std::string_view i_password,
+                                     uint64_t i_begin,
+                                     uint64_t i_end,
+                                     uint32_t i_rank,
+                                     uint64_t i_substitutions ) noexcept
+    {
+        auto upper{ 0_ui64 };
+        auto lower{ 0_ui64 };
+
+        for( auto i{ i_begin }; i < i_end; ++i )
+        {
+            auto ch{ static_cast<unsigned char>( i_password[i] ) };
+            upper += std::isupper( ch ) ? 1 : 0;
+            lower += std::islower( ch ) ? 1 : 0;
+        }
+
+        auto uppercase_log2{ 0.0 };
+
+        if( upper != 0_ui64 )
+        {
+            auto first_only{ upper == 1_ui64 && std::isupper( static_cast<unsigned char>( i_password[i_begin] ) ) };
+            auto last_only{ upper == 1_ui64 && std::isupper( static_cast<unsigned char>( i_password[i_end - 1] ) ) };
+
+            uppercase_log2 = ( lower == 0_ui64 || first_only || last_only ) ? 1.0 : log2_variations( upper, lower );
+        }
+
+        auto l33t_log2{ i_substitutions == 0_ui64 ? 0.0 : static_cast<double>( i_substitutions ) };
+
+        return match_s{ match_type::dictionary,
+                        i_begin,
+                        i_end,
+                        std::log2( static_cast<double>( i_rank ) ) + uppercase_log2 + l33t_log2 };
+    }
+
+
+    /**
+     * @brief Find runs of three or more adjacent keys
+     *
+     */
+    void keyboard_matches( std::string_view i_password, std::vector<match_s>& o_matches ) const
+    {
+        auto begin{ 0_ui64 };
+
+        while( begin + 2 < i_password.size() )
+        {
+            auto end{ begin + 1 };
+            auto turns{ 0_ui64 };
+            auto last_direction{ -1 };
+            auto shifted{ 0_ui64 };
+
+            if( auto first{ key( i_password[begin] ) }; first && first->shifted )
+            {
+                ++shifted;
+            }
+
+            for( ; end < i_password.size(); ++end )
+            {
+                auto direction{ adjacency( i_password[end - 1], i_password[end] ) };
+
+                if( direction < 0 )
+                {
+                    break;
+                }
+
+                if( direction != last_direction )
+                {
+                    ++turns;
+                    last_direction = direction;
+                }
+
+                shifted += key( i_password[end] )->shifted ? 1 : 0;
+            }
+
+            auto length{ end - begin };
+
+            if( length >= 3 )
+            {
+                auto guesses{ 0.0 };
+
+                for( auto i{ 2_ui64 }; i <= length; ++i )
+                {
+                    for( auto j{ 1_ui64 }; j <= std::min( turns, i - 1 ); ++j )
+                    {
+                        guesses += std::exp2( log2_choose( i - 1, j - 1 ) ) * keyboard_starting_positions *
+                                   std::pow( keyboard_average_degree, static_cast<double>( j ) );
+                    }
+                }
+
+                auto shift_log2{ shifted == 0_ui64 ? 0.0 : log2_variations( shifted, length - shifted ) };
+
+                o_matches.push_back( match_s{ match_type::keyboard, begin, end, std::log2( guesses ) + shift_log2 } );
+
+                begin = end - 1;
+            }
+            else
+            {
+                ++begin;
+            }
+        }
+    }
+
+
+    /**
+     * @brief Direction from one key to a neighbouring key
+     *
+     * @return 0-5 for the six neighbours of a staggered keyboard, -1 when the keys are not adjacent
+     */
+    int adjacency( char i_from, char i_to ) const noexcept
+    {
+        auto from{ key( i_from ) };
+        auto to{ key( i_to ) };
+
+        if( !from || !to )
+        {
+            return -1;
+        }
+
+        constexpr auto neighbours = std::array<std::pair<int, int>, 6>{
+            std::pair{ 0, -1 }, std::pair{ 0, 1 }, std::pair{ -1, 0 },
+            std::pair{ -1, 1 }, std::pair{ 1, -1 }, std::pair{ 1, 0 },
+        };
+
+        for( auto i{ 0 }; i < static_cast<int>( neighbours.size() ); ++i )
+        {
+            if( from->row + neighbours[i].first == to->row && from->col + neighbours[i].second == to->col )
+            {
+                return i;
+            }
+        }
+
+        return -1;
+    }
+
+
+    /**
+     * @brief Find dates such as 1987, 12/05/1990 or 19900512
+     *
+     */
+    void date_matches( std::string_view i_password, std::vector<match_s>& o_matches ) const
+    {
+        auto is_digit = []( char c ) { return c >= '0' && c <= '9'; };
+
+        auto to_int = []( std::string_view i_digits ) {
+            auto value{ 0 };
+
+            for( auto&& c : i_digits )
+            {
+                value = value * 10 + ( c - '0' );
+            }
+
+            return value;
+        };
+
+        auto year_guesses = []( int i_year ) {
+            return static_cast<double>( std::max( std::abs( reference_year() - i_year ), min_year_space ) );
+        };
+
+        auto normalize_year = []( int i_year, std::size_t i_digits ) {
+            if( i_digits == 2 )
+            {
+                return i_year > 50 ? 1900 + i_year : 2000 + i_year;
+            }
+
+            return i_year;
+        };
+
+        auto valid_date = [&]( int i_day, int i_month, int i_year, std::size_t i_year_digits ) {
+            auto year{ normalize_year( i_year, i_year_digits ) };
+
+            return i_day >= 1 && i_day <= 31 && i_month >= 1 && i_month <= 12 && year >= 1000 && year <= 2050;
+        };
+
+        for( auto begin{ 0_ui64 }; begin < i_password.size(); ++begin )
+        {
+            for( auto end{ begin + 4 }; end <= std::min<uint64_t>( i_password.size(), begin + 10 ); ++end )
+            {
+                auto token{ i_password.substr( begin, end - begin ) };
+
+                if( std::all_of( token.begin(), token.end(), is_digit ) )
+                {
+                    if( token.size() == 4 )
+                    {
+                        auto year{ to_int( token ) };
+
+                        if( year >= 1900 && year <= 2049 )
+                        {
+                            o_matches.push_back(
+                                match_s{ match_type::date, begin, end, std::log2( year_guesses( year ) ) } );
+                        }
+                    }
+
+                    if( token.size() > 8 )
+                    {
+                        continue;
+                    }
+
+                    // split into year + two one-or-two digit parts, with the year at either end
+                    auto best{ -1.0 };
+
+                    for( auto year_digits : { 2_sz, 4_sz } )
+                    {
+                        if( token.size() <= year_digits + 1 || token.size() > year_digits + 4 )
+                        {
+                            continue;
+                        }
+
+                        for( auto year_first : { true, false } )
+                        {
+                            auto year_part{ year_first ? token.substr( 0, year_digits )
+                                                       : token.substr( token.size() - year_digits ) };
+                            auto rest{ year_first ? token.substr( year_digits )
+                                                  : token.substr( 0, token.size() - year_digits ) };
+
+                            for( auto split{ 1_sz }; split < rest.size() && split <= 2; ++split )
+                            {
+                                if( rest.size() - split > 2 )
+                                {
+                                    continue;
+                                }
+
+                                auto first{ to_int( rest.substr( 0, split ) ) };
+                                auto second{ to_int( rest.substr( split ) ) };
+                                auto year{ to_int( year_part ) };
+
+                                if( valid_date( first, second, year, year_digits ) ||
+                                    valid_date( second, first, year, year_digits ) )
+                                {
+                                    auto guesses{ year_guesses( normalize_year( year, year_digits ) ) * 365.0 };
+
+                                    best = best < 0.0 ? guesses : std::min( best, guesses );
+                                }
+                            }
+                        }
+                    }
+
+                    if( best > 0.0 )
+                    {
+                        o_matches.push_back( match_s{ match_type::date, begin, end, std::log2( best ) } );
+                    }
+                }
+                else if( token.size() >= 6 )
+                {
+                    // d{1,4} sep d{1,2} sep d{1,4} with the same separator
+                    auto first_sep{ token.find_first_of( date_separators ) };
+                    auto last_sep{ token.find_last_of( date_separators ) };
+
+                    if( first_sep == std::string_view::npos || first_sep == last_sep ||
+                        token[first_sep] != token[last_sep] )
+                    {
+                        continue;
+                    }
+
+                    auto parts{ std::array{ token.substr( 0, first_sep ),
+                                            token.substr( first_sep + 1, last_sep - first_sep - 1 ),
+                                            token.substr( last_sep + 1 ) } };
+
+                    auto digits_only = [&]( auto&& part ) {
+                        return !part.empty() && std::all_of( part.begin(), part.end(), is_digit );
+                    };
+
+                    if( !std::all_of( parts.begin(), parts.end(), digits_only ) || parts[0].size() > 4 ||
+                        parts[1].size() > 2 || parts[2].size() > 4 )
+                    {
+                        continue;
+                    }
+
+                    auto year_first{ parts[0].size() > 2 };
+                    auto&& year_part{ year_first ? parts[0] : parts[2] };
+                    auto&& day_or_month{ year_first ? parts[2] : parts[0] };
+
+                    if( day_or_month.size() > 2 || ( year_part.size() != 2 && year_part.size() != 4 ) )
+                    {
+                        continue;
+                    }
+
+                    auto year{ to_int( year_part ) };
+                    auto a{ to_int( day_or_month ) };
+                    auto b{ to_int( parts[1] ) };
+
+                    if( valid_date( a, b, year, year_part.size() ) || valid_date( b, a, year, year_part.size() ) )
+                    {
+                        auto guesses{ year_guesses( normalize_year( year, year_part.size() ) ) * 365.0 * 4.0 };
+
+                        o_matches.push_back( match_s{ match_type::date, begin, end, std::log2( guesses ) } );
+                    }
+                }
+            }
+        }
+    }
+
+
+    /**
+     * @brief Find runs of one repeated character and arithmetic sequences such as abcd or 9876
+     *
+     */
+    static void repeat_and_sequence_matches( std::string_view i_password, std::vector<match_s>& o_matches )
+    {
+        auto begin{ 0_ui64 };
+
+        while( begin + 2 < i_password.size() )
+        {
+            auto end{ begin + 1 };
+
+            while( end < i_password.size() && i_password[end] == i_password[begin] )
+            {
+                ++end;
+            }
+
+            if( end - begin >= 3 )
+            {
+                auto base{ std::log2( static_cast<double>( char_cardinality( i_password[begin] ) ) ) };
+
+                o_matches.push_back(
+                    match_s{ match_type::repeat, begin, end, base + std::log2( static_cast<double>( end - begin ) ) } );
+            }
+
+            begin = end;
+        }
+
+        begin = 0_ui64;
+
+        while( begin + 2 < i_password.size() )
+        {
+            auto delta{ i_password[begin + 1] - i_password[begin] };
+            auto end{ begin + 1 };
+
+            while( ( delta == 1 || delta == -1 ) && end < i_password.size() &&
+                   i_password[end] - i_password[end - 1] == delta &&
+                   char_cardinality( i_password[end] ) == char_cardinality( i_password[begin] ) )
+            {
+                ++end;
+            }
+
+            if( end - begin >= 3 )
+            {
+                auto first{ std::tolower( static_cast<unsigned char>( i_password[begin] ) ) };
+                auto obvious{ first == 'a' || first == 'z' || first == '0' || first == '1' || first == '9' };
+
+                auto base{ obvious ? 2.0 : std::log2( static_cast<double>( char_cardinality( i_password[begin] ) ) ) };
+
+                o_matches.push_back( match_s{ match_type::sequence,
+                                              begin,
+                                              end,
+                                              base + std::log2( static_cast<double>( end - begin ) ) +
+                                                  ( delta < 0 ? 1.0 : 0.0 ) } );
+
+                begin = end - 1;
+            }
+            else
+            {
+                ++begin;
+            }
+        }
+    }
+
+
+    static int char_cardinality( char i_char ) noexcept
+    {
+        auto ch{ static_cast<unsigned char>( i_char ) };
+
+        if( std::islower( ch ) )
+        {
+            return bruteforce_cardinality_lower;
+        }
+
+        if( std::isupper( ch ) )
+        {
+            return bruteforce_cardinality_upper;
+        }
+
+        if( std::isdigit( ch ) )
+        {
+            return bruteforce_cardinality_digits;
+        }
+
+        return bruteforce_cardinality_symbols;
+    }
+
+
+    /**
+     * @brief Pick the non-overlapping matches whose guesses multiply to the smallest total
+     *
+     */
+    static strength_s most_guessable_sequence( std::string_view i_password, const std::vector<match_s>& i_matches )
+    {
+        auto has_lower{ false }, has_upper{ false }, has_digit{ false }, has_symbol{ false };
+
+        for( auto&& c : i_password )
+        {
+            auto ch{ static_cast<unsigned char>( c ) };
+            has_lower |= std::islower( ch ) != 0;
+            has_upper |= std::isupper( ch ) != 0;
+            has_digit |= std::isdigit( ch ) != 0;
+            has_symbol |= !std::isalnum( ch );
+        }
+
+        auto cardinality{ ( has_lower ? bruteforce_cardinality_lower : 0 ) +
+                          ( has_upper ? bruteforce_cardinality_upper : 0 ) +
+                          ( has_digit ? bruteforce_cardinality_digits : 0 ) +
+                          ( has_symbol ? bruteforce_cardinality_symbols : 0 ) };
+
+        auto per_char{ cardinality > 0 ? std::log2( static_cast<double>( cardinality ) ) : 0.0 };
+
+        auto n{ i_password.size() };
+
+        auto best{ std::vector<double>( n + 1, INFINITY ) };
+        auto via{ std::vector<const match_s*>( n + 1, nullptr ) };
+
+        auto by_end{ std::vector<std::vector<const match_s*>>( n + 1 ) };
+
+        for( auto&& match : i_matches )
+        {
+            by_end[match.end].push_back( &match );
+        }
+
+        best[0] = 0.0;
+
+        for( auto end{ 1_sz }; end <= n; ++end )
+        {
+            best[end] = best[end - 1] + per_char;
+
+            for( auto&& match : by_end[end] )
+            {
+                auto candidate{ best[match->begin] + std::max( match->guesses_log2, 0.0 ) };
+
+                if( candidate < best[end] )
+                {
+                    best[end] = candidate;
+                    via[end] = match;
+                }
+            }
+        }
+
+        auto result{ strength_s{} };
+        result.entropy = best[n];
+
+        for( auto end{ n }; end > 0; )
+        {
+            if( via[end] )
+            {
+                result.sequence.push_back( *via[end] );
+                end = via[end]->begin;
+            }
+            else if( !result.sequence.empty() && result.sequence.back().type == match_type::bruteforce &&
+                     result.sequence.back().begin == end )
+            {
+                result.sequence.back().begin = end - 1;
+                result.sequence.back().guesses_log2 += per_char;
+                --end;
+            }
+            else
+            {
+                result.sequence.push_back( match_s{ match_type::bruteforce, end - 1, end, per_char } );
+                --end;
+            }
+        }
+
+        std::reverse( result.sequence.begin(), result.sequence.end() );
+
+        constexpr auto score_thresholds = std::array{ 10.0, 20.0, 26.6, 33.2 };  // 1e3, 1e6, 1e8, 1e10 guesses
+
+        result.score = static_cast<int>(
+            std::upper_bound( score_thresholds.begin(), score_thresholds.end(), result.entropy ) -
+            score_thresholds.begin() );
+
+        return result;
+    }
+};
+
+
+/**
+ * @brief Read a frequency list, one word per line and most frequent first, into a dictionary
+ *
+ * Words are lowercased, since matching is case-insensitive; a repeated word keeps its first rank. Blank lines are
+ * skipped and take no rank.
+ *
+ * @param io_stream list to read
+ * @return dictionary, ready to be saved and mapped later
+ */
+inline dawg read_frequency_list( std::istream& io_stream )
+{
+    auto words{ std::vector<std::string>{} };
+    auto line{ std::string{} };
+
+    while( std::getline( io_stream, line ) )
+    {
+        if( !line.empty() && line.back() == '\r' )
+        {
+            line.pop_back();
+        }
+
+        if( std::all_of( line.begin(), line.end(), []( unsigned char i_char ) { return std::isspace( i_char ); } ) )
+        {
+            continue;
+        }
+
+        std::transform( line.begin(), line.end(), line.begin(), []( unsigned char i_char ) {
+            return static_cast<char>( std::tolower( i_char ) );
+        } );
+
+        words.push_back( line );
+    }
+
+    return dawg::build( words );
+}
+
+
+/**
+ * @brief Dictionary of the shared estimator: the file named by PASSWORDS_DICTIONARY, else the seed list
+ *
+ * @return mapped or built dictionary
+ * @throw std::runtime_error if the named file cannot be mapped
+ */
+inline dawg default_dictionary()
+{
+    if( auto path{ std::getenv( dictionary_variable ) } )
+    {
+        return dawg::map_file( path );
+    }
+
+    return dawg::build( std::vector<std::string>{ seed_words.begin(), seed_words.end() } );
+}
+
+
+/**
+ * @brief Shared estimator over default_dictionary, loaded on first use
+ *
+ * @return estimator instance
+ */
+inline const strength_estimator& default_estimator()
+{
+    static const auto estimator{ strength_estimator{ std::vector<dawg>{ default_dictionary() } } };
+
+    return estimator;
+}
+
+}
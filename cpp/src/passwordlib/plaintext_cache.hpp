@@ -0,0 +1,356 @@
+/**
+ * @file plaintext_cache.hpp
+ * @author ashwinn76
+ * @brief Size-bounded LRU cache for decrypted secrets, kept in locked memory and wiped on eviction
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <cstring>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/mman.h>
+
+#include "macro_utils.hpp"
+
+namespace vault
+{
+namespace
+{
+constexpr auto cache_slot_size = 256_sz;  // secrets longer than a slot minus its length prefix are not cached
+
+constexpr auto no_slot = ~0_ui32;
+
+
+inline void wipe_bytes( void* io_data, std::size_t i_size ) noexcept
+{
+    auto volatile_data{ static_cast<volatile char*>( io_data ) };
+
+    for( auto i{ 0_sz }; i < i_size; ++i )
+    {
+        volatile_data[i] = 0;
+    }
+}
+
+}
+
+
+/**
+ * @brief LRU cache of plaintexts in one fixed, mlocked, non-dumpable region
+ *
+ * The region is split into fixed-size slots so eviction never moves or reallocates plaintext; an evicted slot is
+ * wiped before it is reused. Thread-safe.
+ */
+template<typename _Key, typename _Hash = std::hash<_Key>>
+class plaintext_cache
+{
+public:
+    /**
+     * @brief Reserve the cache region
+     *
+     * @param i_capacity bytes of plaintext storage, rounded down to whole slots; zero disables caching
+     */
+    explicit plaintext_cache( std::size_t i_capacity )
+    {
+        auto slots{ i_capacity / cache_slot_size };
+
+        if( slots == 0 )
+        {
+            return;
+        }
+
+        m_size = slots * cache_slot_size;
+
+        auto region{ ::mmap( nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 ) };
+
+        if( region == MAP_FAILED )
+        {
+            m_size = 0;
+            return;
+        }
+
+        m_region = static_cast<char*>( region );
+
+        // a cache that cannot be locked (RLIMIT_MEMLOCK) still works, it only loses the swap guarantee
+        m_locked = ::mlock( m_region, m_size ) == 0;
+
+#ifdef MADV_DONTDUMP
+        ::madvise( m_region, m_size, MADV_DONTDUMP );
+#endif
+
+        m_slots.resize( slots );
+
+        for( auto i{ 0_sz }; i < slots; ++i )
+        {
+            m_slots[i].next = i + 1 < slots ? static_cast<uint32_t>( i + 1 ) : no_slot;
+        }
+
+        m_free = 0;
+    }
+
+
+    plaintext_cache( const plaintext_cache& ) = delete;
+    plaintext_cache& operator=( const plaintext_cache& ) = delete;
+
+
+    ~plaintext_cache()
+    {
+        if( m_region )
+        {
+            wipe_bytes( m_region, m_size );
+
+            if( m_locked )
+            {
+                ::munlock( m_region, m_size );
+            }
+
+            ::munmap( m_region, m_size );
+        }
+    }
+
+
+    /**
+     * @brief Look up a plaintext and mark it most recently used
+     *
+     */
+    std::optional<std::string> get( const _Key& i_key )
+    {
+        auto lock{ std::lock_guard{ m_mutex } };
+
+        auto iter{ m_lookup.find( i_key ) };
+
+        if( iter == m_lookup.end() )
+        {
+            ++m_misses;
+            return std::nullopt;
+        }
+
+        ++m_hits;
+
+        unlink( iter->second );
+        push_front( iter->second );
+
+        auto data{ slot_data( iter->second ) };
+        return std::string{ data + sizeof( uint32_t ), slot_length( iter->second ) };
+    }
+
+
+    /**
+     * @brief Insert or replace a plaintext, evicting the least recently used one when full
+     *
+     */
+    void put( const _Key& i_key, std::string_view i_plain )
+    {
+        auto lock{ std::lock_guard{ m_mutex } };
+
+        if( auto iter{ m_lookup.find( i_key ) }; iter != m_lookup.end() )
+        {
+            release( iter );
+        }
+
+        if( m_slots.empty() || i_plain.size() > cache_slot_size - sizeof( uint32_t ) )
+        {
+            return;
+        }
+
+        if( m_free == no_slot )
+        {
+            release( m_lookup.find( m_slots[m_tail].key ) );
+        }
+
+        auto slot{ m_free };
+        m_free = m_slots[slot].next;
+
+        auto length{ static_cast<uint32_t>( i_plain.size() ) };
+        auto data{ slot_data( slot ) };
+        std::memcpy( data, &length, sizeof( length ) );
+        std::memcpy( data + sizeof( length ), i_plain.data(), i_plain.size() );
+
+        m_slots[slot].key = i_key;
+        push_front( slot );
+        m_lookup.emplace( i_key, slot );
+    }
+
+
+    /**
+     * @brief Drop and wipe one plaintext
+     *
+     */
+    void erase( const _Key& i_key )
+    {
+        auto lock{ std::lock_guard{ m_mutex } };
+
+        if( auto iter{ m_lookup.find( i_key ) }; iter != m_lookup.end() )
+        {
+            release( iter );
+        }
+    }
+
+
+    /**
+     * @brief Drop and wipe every plaintext
+     *
+     */
+    void clear()
+    {
+        auto lock{ std::lock_guard{ m_mutex } };
+
+        while( !m_lookup.empty() )
+        {
+            release( m_lookup.begin() );
+        }
+    }
+
+
+    /**
+     * @brief Number of cached plaintexts
+     *
+     */
+    std::size_t size() const
+    {
+        auto lock{ std::lock_guard{ m_mutex } };
+        return m_lookup.size();
+    }
+
+
+    /**
+     * @brief Number of plaintexts the cache can hold
+     *
+     */
+    std::size_t capacity() const noexcept
+    {
+        return m_slots.size();
+    }
+
+
+    /**
+     * @brief Whether the region is locked in memory
+     *
+     */
+    bool locked() const noexcept
+    {
+        return m_locked;
+    }
+
+
+    /**
+     * @brief Lookups answered from the cache
+     *
+     */
+    uint64_t hits() const
+    {
+        auto lock{ std::lock_guard{ m_mutex } };
+        return m_hits;
+    }
+
+
+    /**
+     * @brief Lookups that had to go to the store
+     *
+     */
+    uint64_t misses() const
+    {
+        auto lock{ std::lock_guard{ m_mutex } };
+        return m_misses;
+    }
+
+private:
+    /**
+     * @brief Bookkeeping for one slot, kept outside the locked region as it holds no plaintext
+     *
+     */
+    struct slot_s
+    {
+        _Key key{};
+        uint32_t prev{ no_slot };
+        uint32_t next{ no_slot };  // next in recency order, or next free slot
+    };
+
+    mutable std::mutex m_mutex{};
+
+    char* m_region{ nullptr };
+
+    std::size_t m_size{ 0_sz };
+
+    bool m_locked{ false };
+
+    std::vector<slot_s> m_slots{};
+
+    std::unordered_map<_Key, uint32_t, _Hash> m_lookup{};
+
+    uint32_t m_head{ no_slot };  // most recently used
+
+    uint32_t m_tail{ no_slot };  // least recently used
+
+    uint32_t m_free{ no_slot };
+
+    uint64_t m_hits{ 0_ui64 };
+
+    uint64_t m_misses{ 0_ui64 };
+
+
+    char* slot_data( uint32_t i_slot ) const noexcept
+    {
+        return m_region + i_slot * cache_slot_size;
+    }
+
+
+    std::size_t slot_length( uint32_t i_slot ) const noexcept
+    {
+        auto length{ uint32_t{} };
+        std::memcpy( &length, slot_data( i_slot ), sizeof( length ) );
+
+        return length;
+    }
+
+
+    void unlink( uint32_t i_slot ) noexcept
+    {
+        auto& slot{ m_slots[i_slot] };
+
+        ( slot.prev == no_slot ? m_head : m_slots[slot.prev].next ) = slot.next;
+        ( slot.next == no_slot ? m_tail : m_slots[slot.next].prev ) = slot.prev;
+
+        slot.prev = slot.next = no_slot;
+    }
+
+
+    void push_front( uint32_t i_slot ) noexcept
+    {
+        auto& slot{ m_slots[i_slot] };
+
+        slot.prev = no_slot;
+        slot.next = m_head;
+
+        ( m_head == no_slot ? m_tail : m_slots[m_head].prev ) = i_slot;
+        m_head = i_slot;
+    }
+
+
+    template<typename _Iter>
+    void release( _Iter i_iter )
+    {
+        auto slot{ i_iter->second };
+
+        unlink( slot );
+        wipe_bytes( slot_data( slot ), cache_slot_size );
+
+        m_slots[slot].key = _Key{};
+        m_slots[slot].next = m_free;
+        m_free = slot;
+
+        m_lookup.erase( i_iter );
+    }
+};
+
+}
@@ -0,0 +1,300 @@
+/**
+ * @file sha256.hpp
+ * @author ashwinn76
+ * @brief SHA-256, HMAC-SHA-256 and PBKDF2-HMAC-SHA-256
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#include "macro_utils.hpp"
+
+namespace encryption
+{
+using digest_t = std::array<uint8_t, 32>;
+
+namespace
+{
+constexpr auto sha256_round_constants = std::array<uint32_t, 64>{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+constexpr uint32_t rotr( uint32_t x, int n ) noexcept
+{
+    return ( x >> n ) | ( x << ( 32 - n ) );
+}
+
+}
+
+
+/**
+ * @brief Incremental SHA-256 hasher
+ *
+ */
+class sha256
+{
+public:
+    /**
+     * @brief Feed more data into the hash
+     *
+     * @param i_data pointer to the data
+     * @param i_size number of bytes
+     * @return the hasher for chaining
+     */
+    sha256& update( const void* i_data, std::size_t i_size ) noexcept
+    {
+        auto bytes{ static_cast<const uint8_t*>( i_data ) };
+
+        m_length += i_size;
+
+        while( i_size > 0 )
+        {
+            auto take{ std::min( i_size, m_block.size() - m_filled ) };
+            std::memcpy( m_block.data() + m_filled, bytes, take );
+
+            m_filled += take;
+            bytes += take;
+            i_size -= take;
+
+            if( m_filled == m_block.size() )
+            {
+                compress();
+                m_filled = 0;
+            }
+        }
+
+        return *this;
+    }
+
+
+    sha256& update( std::string_view i_data ) noexcept
+    {
+        return update( i_data.data(), i_data.size() );
+    }
+
+
+    /**
+     * @brief Finish hashing and get the digest
+     *
+     * @return 32 byte digest
+     */
+    digest_t finish() noexcept
+    {
+        auto bit_length{ m_length * 8 };
+
+        auto pad{ std::array<uint8_t, 72>{ 0x80 } };
+        auto pad_size{ ( m_filled < 56 ? 56 : 120 ) - m_filled };
+
+        for( auto i{ 0 }; i < 8; ++i )
+        {
+            pad[pad_size + i] = static_cast<uint8_t>( bit_length >> ( 56 - 8 * i ) );
+        }
+
+        update( pad.data(), pad_size + 8 );
+
+        auto digest{ digest_t{} };
+
+        for( auto i{ 0_sz }; i < m_state.size(); ++i )
+        {
+            for( auto b{ 0_sz }; b < 4; ++b )
+            {
+                digest[i * 4 + b] = static_cast<uint8_t>( m_state[i] >> ( 24 - 8 * b ) );
+            }
+        }
+
+        return digest;
+    }
+
+
+    /**
+     * @brief One-shot hash
+     *
+     */
+    static digest_t hash( const void* i_data, std::size_t i_size ) noexcept
+    {
+        return sha256{}.update( i_data, i_size ).finish();
+    }
+
+private:
+    std::array<uint32_t, 8> m_state{
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+
+    std::array<uint8_t, 64> m_block{};
+
+    std::size_t m_filled{ 0_sz };
+
+    uint64_t m_length{ 0_ui64 };
+
+
+    void compress() noexcept
+    {
+        auto w{ std::array<uint32_t, 64>{} };
+
+        for( auto i{ 0_sz }; i < 16; ++i )
+        {
+            w[i] = ( uint32_t{ m_block[i * 4] } << 24 ) | ( uint32_t{ m_block[i * 4 + 1] } << 16 ) |
+                   ( uint32_t{ m_block[i * 4 + 2] } << 8 ) | uint32_t{ m_block[i * 4 + 3] };
+        }
+
+        for( auto i{ 16_sz }; i < 64; ++i )
+        {
+            auto s0{ rotr( w[i - 15], 7 ) ^ rotr( w[i - 15], 18 ) ^ ( w[i - 15] >> 3 ) };
+            auto s1{ rotr( w[i - 2], 17 ) ^ rotr( w[i - 2], 19 ) ^ ( w[i - 2] >> 10 ) };
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        auto [a, b, c, d, e, f, g, h] = m_state;
+
+        for( auto i{ 0_sz }; i < 64; ++i )
+        {
+            auto s1{ rotr( e, 6 ) ^ rotr( e, 11 ) ^ rotr( e, 25 ) };
+            auto ch{ ( e & f ) ^ ( ~e & g ) };
+            auto t1{ h + s1 + ch + sha256_round_constants[i] + w[i] };
+            auto s0{ rotr( a, 2 ) ^ rotr( a, 13 ) ^ rotr( a, 22 ) };
+            auto maj{ ( a & b ) ^ ( a & c ) ^ ( b & c ) };
+            auto t2{ s0 + maj };
+
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+
+        m_state[0] += a;
+        m_state[1] += b;
+        m_state[2] += c;
+        m_state[3] += d;
+        m_state[4] += e;
+        m_state[5] += f;
+        m_state[6] += g;
+        m_state[7] += h;
+    }
+};
+
+
+/**
+ * @brief Incremental HMAC-SHA-256
+ *
+ */
+class hmac_sha256
+{
+public:
+    hmac_sha256( const void* i_key, std::size_t i_key_size ) noexcept
+    {
+        auto block{ std::array<uint8_t, 64>{} };
+
+        if( i_key_size > block.size() )
+        {
+            auto digest{ sha256::hash( i_key, i_key_size ) };
+            std::memcpy( block.data(), digest.data(), digest.size() );
+        }
+        else if( i_key_size > 0 )
+        {
+            std::memcpy( block.data(), i_key, i_key_size );
+        }
+
+        auto inner{ block };
+        auto outer{ block };
+
+        for( auto i{ 0_sz }; i < block.size(); ++i )
+        {
+            inner[i] ^= 0x36;
+            outer[i] ^= 0x5c;
+        }
+
+        m_inner.update( inner.data(), inner.size() );
+        m_outer.update( outer.data(), outer.size() );
+    }
+
+
+    hmac_sha256& update( const void* i_data, std::size_t i_size ) noexcept
+    {
+        m_inner.update( i_data, i_size );
+        return *this;
+    }
+
+
+    hmac_sha256& update( std::string_view i_data ) noexcept
+    {
+        return update( i_data.data(), i_data.size() );
+    }
+
+
+    digest_t finish() noexcept
+    {
+        auto inner{ m_inner.finish() };
+        return m_outer.update( inner.data(), inner.size() ).finish();
+    }
+
+
+    /**
+     * @brief One-shot MAC
+     *
+     */
+    static digest_t mac( const void* i_key, std::size_t i_key_size, const void* i_data, std::size_t i_size ) noexcept
+    {
+        return hmac_sha256{ i_key, i_key_size }.update( i_data, i_size ).finish();
+    }
+
+private:
+    sha256 m_inner{};
+
+    sha256 m_outer{};
+};
+
+
+/**
+ * @brief Derive a 32 byte key from a password with PBKDF2-HMAC-SHA-256
+ *
+ * @param i_password password
+ * @param i_salt salt bytes
+ * @param i_iterations iteration count
+ * @return derived key
+ */
+inline digest_t pbkdf2_sha256( std::string_view i_password,
+                               const std::vector<uint8_t>& i_salt,
+                               uint32_t i_iterations ) noexcept
+{
+    auto prf{ hmac_sha256{ i_password.data(), i_password.size() } };
+
+    auto block_index{ std::array<uint8_t, 4>{ 0, 0, 0, 1 } };
+
+    auto u{ hmac_sha256{ prf }.update( i_salt.data(), i_salt.size() ).update( block_index.data(), 4 ).finish() };
+    auto result{ u };
+
+    for( auto i{ 1_ui32 }; i < i_iterations; ++i )
+    {
+        u = hmac_sha256{ prf }.update( u.data(), u.size() ).finish();
+
+        for( auto b{ 0_sz }; b < result.size(); ++b )
+        {
+            result[b] ^= u[b];
+        }
+    }
+
+    return result;
+}
+
+}
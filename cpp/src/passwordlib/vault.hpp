@@ -0,0 +1,2722 @@
+/**
+ * @file vault.hpp
+ * @author ashwinn76
+ * @brief Append-only encrypted vault storage engine behind the passwords tool
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Layout: a fixed header followed by frames. Every frame is an 8 byte frame header (body length, type, key id) and a
+ * body. Entry bodies are the blind index of the entry name (a keyed HMAC) followed by a ChaCha20-Poly1305 box that is
+ * authenticated together with the frame header and that index. Names therefore never reach the disk in the clear, and
+ * a lookup hashes the name, probes the in-memory index and decrypts exactly one record. A checkpoint appends an
+ * encrypted footer holding the blind index -> offset map, so opening reads one footer and the log written after it.
+ * Records stay sealed until a get asks for them, and decrypted secrets are kept in a bounded, locked LRU cache.
+ *
+ * The entry frames double as the write-ahead log: put and update append a sealed entry and commit it with fdatasync
+ * before returning, while the footer is only a checkpoint that bounds how much of that log an open has to replay.
+ * Commits are grouped: the threads of a handle wait for one leader's sync, and the leaders of different handles and
+ * processes take turns, each skipping its sync when a root published meanwhile already covers its writes.
+ *
+ * Concurrency is multi-version: frames are never modified once written, so every prefix of the log that ends on a
+ * commit is an immutable snapshot. The header holds two MAC-protected root slots {version, end of log, checkpoint}.
+ * The single writer (serialised by flock) publishes each new root into the older slot once the frames below its end are
+ * synced; readers take no locks, pin the newest valid root when they open and only ever read frames below its end.
+ *
+ * Keys rotate online. Every frame header names the key its frame is sealed under, and the header has two key slots,
+ * the new one wrapping the key it replaces. While live entries are re-encrypted in parallel batches a handle holds both
+ * keys and reads each record under its own. The records still sealed under the old key are the remaining work, so a
+ * rotation interrupted by a crash resumes where it stopped.
+ *
+ * Updates leave dead frames behind. Compaction copies the live frames, which do not depend on where they are written,
+ * into a new file and renames it over the vault; other handles follow on their next write or refresh.
+ *
+ * Copies of a vault made with clone are replicas: each stamps a version vector into the entries it writes, and a
+ * Merkle tree over the digests of the live frames, kept current with the index, lets two replicas find the records
+ * they disagree on (see vault_sync.hpp).
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "merkle_tree.hpp"
+#include "plaintext_cache.hpp"
+#include "vault_crypto.hpp"
+#include "vault_io.hpp"
+
+namespace vault
+{
+/**
+ * @brief Kind of frame stored in the vault file
+ *
+ */
+enum class frame_type : uint8_t
+{
+    entry = 1,
+    footer = 2,
+};
+
+
+/**
+ * @brief Location of a frame in the vault file
+ *
+ */
+struct record_location_s
+{
+    uint64_t offset{ 0_ui64 };  // start of the frame header
+    uint32_t size{ 0_ui32 };  // frame header plus body
+    uint8_t key{ 0_ui8 };  // id of the key the frame is sealed under
+};
+
+
+/**
+ * @brief When a put or update becomes durable
+ *
+ */
+enum class durability_mode : uint8_t
+{
+    per_write,  // every write syncs on its own before returning
+    grouped,  // concurrent writers share one sync, every write is durable before returning
+    async,  // writes are synced on flush or close only
+};
+
+
+/**
+ * @brief Update counters of an entry, one per replica that wrote it, sorted by replica id
+ *
+ */
+using version_vector_t = std::vector<std::pair<uint64_t, uint64_t>>;
+
+
+/**
+ * @brief Whether a version has seen every update another one has, i.e. none of the other's counters is ahead
+ *
+ */
+inline bool descends( const version_vector_t& i_version, const version_vector_t& i_other ) noexcept
+{
+    auto iter{ i_version.begin() };
+
+    for( auto&& [replica, counter] : i_other )
+    {
+        while( iter != i_version.end() && iter->first < replica )
+        {
+            ++iter;
+        }
+
+        if( iter == i_version.end() || iter->first != replica || iter->second < counter )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Smallest version that descends from both, for merging two concurrent updates
+ *
+ */
+inline version_vector_t merge_versions( const version_vector_t& i_left, const version_vector_t& i_right )
+{
+    auto merged{ version_vector_t{} };
+    auto left{ i_left.begin() };
+    auto right{ i_right.begin() };
+
+    while( left != i_left.end() || right != i_right.end() )
+    {
+        if( right == i_right.end() || ( left != i_left.end() && left->first < right->first ) )
+        {
+            merged.push_back( *left++ );
+        }
+        else if( left == i_left.end() || right->first < left->first )
+        {
+            merged.push_back( *right++ );
+        }
+        else
+        {
+            merged.emplace_back( left->first, std::max( left->second, right->second ) );
+            ++left;
+            ++right;
+        }
+    }
+
+    return merged;
+}
+
+
+/**
+ * @brief Count one more update by a replica
+ *
+ */
+inline version_vector_t bump_version( version_vector_t i_version, uint64_t i_replica )
+{
+    auto iter{ std::lower_bound( i_version.begin(), i_version.end(), std::make_pair( i_replica, 0_ui64 ) ) };
+
+    if( iter == i_version.end() || iter->first != i_replica )
+    {
+        iter = i_version.emplace( iter, i_replica, 0_ui64 );
+    }
+
+    ++iter->second;
+
+    return i_version;
+}
+
+
+/**
+ * @brief Decrypted entry
+ *
+ */
+struct entry_s
+{
+    blind_index_t index{};  // keyed hash of the name, stored in the clear in front of the sealed body
+    std::string name{};
+    std::string secret{};
+    version_vector_t versions{};  // sealed with the entry, compared when replicas sync
+};
+
+
+/**
+ * @brief Entry encrypted into a complete frame but not yet written
+ *
+ */
+struct sealed_entry_s
+{
+    blind_index_t index{};
+    std::string frame{};  // frame header, blind index and sealed body
+    uint8_t key{ 0_ui8 };  // id of the key the frame is sealed under
+    std::optional<blind_index_t> retired{};  // index of the same name under a key being rotated out
+};
+
+
+/**
+ * @brief Options for opening or creating a vault
+ *
+ */
+struct vault_options_s
+{
+    uint32_t kdf_iterations{ 200000_ui32 };  // PBKDF2 iterations used when creating a vault
+    bool read_only{ false };  // open without write access
+    durability_mode durability{ durability_mode::grouped };  // commit policy for put and update
+    uint32_t checkpoint_records{ 1024_ui32 };  // log records replayed on open before close writes a checkpoint
+    std::size_t cache_bytes{ 64_sz * 1024 };  // locked memory for decrypted secrets, zero to decrypt on every get
+};
+
+
+/**
+ * @brief Tuning for a compaction
+ *
+ */
+struct compaction_options_s
+{
+    uint64_t bytes_per_second{ 0_ui64 };  // I/O budget for copying records, zero for no limit
+    std::size_t chunk_bytes{ 1_sz << 20 };  // largest single copy; a backlog below this is copied under the lock
+};
+
+
+/**
+ * @brief How much of the log is still live, for scheduling compactions
+ *
+ */
+struct space_usage_s
+{
+    uint64_t log_bytes{ 0_ui64 };  // frames after the header
+    uint64_t live_bytes{ 0_ui64 };  // frames of live entries and of the latest checkpoint
+
+    /**
+     * @brief Share of the log a compaction would reclaim
+     *
+     */
+    double fragmentation() const noexcept
+    {
+        return log_bytes == 0 ? 0.0 : 1.0 - static_cast<double>( live_bytes ) / static_cast<double>( log_bytes );
+    }
+};
+
+
+/**
+ * @brief Committed state of a vault file pinned for copying it while the vault stays in use
+ *
+ */
+struct committed_file_s
+{
+    std::string header{};  // file header holding only the pinned root
+    uint64_t end{ 0_ui64 };  // end of the committed log, the size of the copy
+    uint64_t log_id{ 0_ui64 };  // replaced whenever the log is rewritten; equal ids mean equal frames below both ends
+    std::shared_ptr<const unique_fd> file{};  // file the log is read from, kept open across a compaction
+
+    /**
+     * @brief Read part of the copy; bytes past the header come straight from the file, which never changes below end
+     *
+     */
+    void read( uint64_t i_offset, char* o_data, std::size_t i_size ) const
+    {
+        if( i_offset + i_size > end )
+        {
+            throw vault_error{ "Read past the committed end of the vault" };
+        }
+
+        auto from_header{ 0_sz };
+
+        if( i_offset < header.size() )
+        {
+            from_header = std::min<uint64_t>( header.size() - i_offset, i_size );
+            std::copy_n( header.data() + i_offset, from_header, o_data );
+        }
+
+        if( from_header < i_size )
+        {
+            read_exact( file->get(), o_data + from_header, i_size - from_header, i_offset + from_header );
+        }
+    }
+};
+
+
+/**
+ * @brief Tuning for a key rotation
+ *
+ */
+struct rotation_options_s
+{
+    std::size_t workers{ std::max( 1u, std::thread::hardware_concurrency() ) };  // re-encryption threads
+    std::size_t batch_size{ 256_sz };  // re-encrypted records per write and commit
+};
+
+
+namespace
+{
+constexpr auto vault_magic = std::string_view{ "PWVAULT1" };
+
+constexpr auto vault_format_version = 5_ui32;
+
+constexpr auto replica_id_offset = 16_ui64;
+
+constexpr auto log_id_offset = 24_ui64;
+
+constexpr auto file_header_size = 384_ui64;
+
+constexpr auto root_slots_offset = 64_ui64;
+
+constexpr auto root_slot_size = 32_ui64;
+
+constexpr auto root_mac_size = 8_sz;
+
+constexpr auto key_slots_offset = 128_ui64;
+
+constexpr auto key_slot_size = 104_ui64;
+
+constexpr auto wrapped_key_size = std::tuple_size_v<encryption::aead_key_t> + encryption::aead_overhead;
+
+constexpr auto frame_header_size = 8_ui64;
+
+constexpr auto max_frame_body = 1_ui32 << 28;
+
+
+/**
+ * @brief Published state of the log: everything a reader needs to pin a snapshot
+ *
+ */
+struct root_s
+{
+    uint64_t version{ 0_ui64 };
+    uint64_t end{ file_header_size };  // end of the last committed frame
+    uint64_t checkpoint{ 0_ui64 };  // latest checkpoint footer, zero when none
+};
+
+
+/**
+ * @brief Header slot describing how to derive one vault key from a master key
+ *
+ */
+struct key_slot_s
+{
+    uint8_t id{ 0_ui8 };  // zero marks an empty slot
+    uint8_t previous{ 0_ui8 };  // key this one replaced, zero for the first key of a vault
+    uint32_t iterations{ 0_ui32 };
+    std::vector<uint8_t> salt{};
+    std::string check{};
+    std::string wrapped{};  // previous vault key sealed under this one, empty for the first key
+
+    std::string bytes() const
+    {
+        auto writer{ byte_writer{} };
+        writer.put( id ).put( previous ).put( 0_ui16 ).put( iterations );
+        writer.put_bytes( salt.data(), salt.size() ).put_bytes( check.data(), check.size() );
+        writer.put_bytes( wrapped.data(), wrapped.size() );
+
+        writer.bytes().resize( key_slot_size, '\0' );
+
+        return writer.bytes();
+    }
+
+    static key_slot_s parse( std::string_view i_bytes )
+    {
+        auto reader{ byte_reader{ i_bytes } };
+
+        auto slot{ key_slot_s{} };
+        slot.id = reader.get<uint8_t>();
+        slot.previous = reader.get<uint8_t>();
+        reader.get<uint16_t>();
+        slot.iterations = reader.get<uint32_t>();
+
+        auto salt{ reader.get_bytes( salt_size ) };
+        slot.salt.assign( salt.begin(), salt.end() );
+        slot.check = reader.get_bytes( key_check_size );
+
+        if( slot.previous != 0 )
+        {
+            slot.wrapped = reader.get_bytes( wrapped_key_size );
+        }
+
+        return slot;
+    }
+};
+
+
+/**
+ * @brief Frame header as written in front of every frame body
+ *
+ */
+struct frame_header_s
+{
+    uint32_t length{ 0_ui32 };
+    frame_type type{ frame_type::entry };
+    uint8_t key{ 0_ui8 };  // id of the key the body is sealed under
+
+    std::string bytes() const
+    {
+        auto writer{ byte_writer{} };
+        writer.put( length ).put( static_cast<uint8_t>( type ) ).put( key ).put( 0_ui16 );
+
+        return writer.bytes();
+    }
+
+    static frame_header_s parse( std::string_view i_bytes )
+    {
+        auto reader{ byte_reader{ i_bytes } };
+
+        auto header{ frame_header_s{} };
+        header.length = reader.get<uint32_t>();
+        header.type = static_cast<frame_type>( reader.get<uint8_t>() );
+        header.key = reader.get<uint8_t>();
+
+        return header;
+    }
+};
+
+}
+
+
+/**
+ * @brief Append-only encrypted vault
+ *
+ */
+class vault
+{
+public:
+    /**
+     * @brief Open a vault, creating it when it does not exist yet
+     *
+     * @param i_path vault file
+     * @param i_key master key
+     * @param i_options open options
+     */
+    vault( std::string i_path, const encryption::encryption_key& i_key, vault_options_s i_options = {} ) :
+        m_path{ std::move( i_path ) },
+        m_options{ i_options },
+        m_cache{ i_options.cache_bytes }
+    {
+        m_file->fd = unique_fd::open( m_path, m_options.read_only ? O_RDONLY : O_RDWR | O_CREAT );
+
+        // writers may truncate a torn tail while loading, so they exclude each other from the start
+        auto lock{ std::optional<file_lock>{} };
+
+        if( !m_options.read_only )
+        {
+            lock.emplace( m_file->fd.get() );
+
+            // a compaction may have renamed a new file over the one just opened
+            while( !names_file( m_path, m_file->fd.get() ) )
+            {
+                lock.reset();
+
+                m_file = std::make_shared<log_file_s>();
+                m_file->fd = unique_fd::open( m_path, O_RDWR );
+
+                lock.emplace( m_file->fd.get() );
+            }
+        }
+
+        if( file_size( m_file->fd.get() ) == 0_ui64 )
+        {
+            if( m_options.read_only )
+            {
+                throw vault_error{ "Vault " + m_path + " does not exist" };
+            }
+
+            create_header( i_key );
+        }
+        else
+        {
+            read_header( i_key );
+        }
+
+        load_index();
+    }
+
+
+    vault( const vault& ) = delete;
+    vault& operator=( const vault& ) = delete;
+
+
+    ~vault()
+    {
+        try
+        {
+            if( !m_options.read_only && m_tail_records >= m_options.checkpoint_records )
+            {
+                checkpoint();
+            }
+
+            flush();
+        }
+        catch( ... )
+        {
+        }
+    }
+
+
+    /**
+     * @brief Get the secret stored under a name from the plaintext cache, or with one read and one decryption
+     *
+     * @param i_name entry name
+     * @return secret, nothing if the entry does not exist
+     */
+    std::optional<std::string> get( std::string_view i_name ) const
+    {
+        auto lock{ std::shared_lock{ m_lock } };
+
+        auto iter{ find_entry( i_name ) };
+
+        if( iter == m_index.end() )
+        {
+            return std::nullopt;
+        }
+
+        auto index{ iter->first };
+
+        if( auto secret{ m_cache.get( index ) } )
+        {
+            return secret;
+        }
+
+        auto entry{ read_entry( iter->second ) };
+
+        if( entry.name != i_name )
+        {
+            throw vault_error{ "Vault index points at the wrong entry" };
+        }
+
+        m_cache.put( index, entry.secret );
+
+        return std::move( entry.secret );
+    }
+
+
+    /**
+     * @brief Add a new entry, durable on return unless the vault is in async mode
+     *
+     * @param i_name entry name, must not exist yet
+     * @param i_secret secret to store
+     */
+    void put( std::string_view i_name, std::string_view i_secret )
+    {
+        store( i_name, i_secret, false );
+    }
+
+
+    /**
+     * @brief Replace the secret of an existing entry, durable on return unless the vault is in async mode
+     *
+     * @param i_name entry name, must exist
+     * @param i_secret new secret
+     */
+    void update( std::string_view i_name, std::string_view i_secret )
+    {
+        store( i_name, i_secret, true );
+    }
+
+
+    /**
+     * @brief Check whether an entry exists
+     *
+     */
+    bool contains( std::string_view i_name ) const
+    {
+        auto lock{ std::shared_lock{ m_lock } };
+        return find_entry( i_name ) != m_index.end();
+    }
+
+
+    /**
+     * @brief Number of live entries
+     *
+     */
+    std::size_t size() const
+    {
+        auto lock{ std::shared_lock{ m_lock } };
+        return m_index.size();
+    }
+
+
+    /**
+     * @brief Make every record written so far durable
+     *
+     */
+    void flush()
+    {
+        if( m_options.read_only )
+        {
+            return;
+        }
+
+        auto end{ uint64_t{} };
+        auto file{ std::shared_ptr<log_file_s>{} };
+
+        {
+            auto lock{ std::shared_lock{ m_lock } };
+
+            end = m_end;
+            file = m_file;
+        }
+
+        file->commit.commit( end, [this, &file]( uint64_t i_target ) { return sync_log( *file, i_target ); } );
+    }
+
+
+    /**
+     * @brief Write the index as a checkpoint so later opens replay only the log written after it
+     *
+     */
+    void checkpoint()
+    {
+        if( m_options.read_only )
+        {
+            return;
+        }
+
+        auto lock{ std::unique_lock{ m_lock } };
+        auto writer_lock{ lock_writer() };
+        append_checkpoint();
+    }
+
+
+    /**
+     * @brief Re-encrypt the vault under a new master key while it stays open for reads and writes
+     *
+     * The new key goes into the free header slot first; from then on every write is sealed under it and every open
+     * must use it. The live entries still sealed under the old key are then re-encrypted in parallel batches, each
+     * appended and committed on its own so gets are only held up for one write at a time, and a checkpoint under the
+     * new key retires the old one. After a crash, resume_rotation on a handle opened with the new key finishes the job.
+     *
+     * @param i_new_key new master key
+     * @param i_options re-encryption threads and batch size
+     */
+    void rotate_key( const encryption::encryption_key& i_new_key, rotation_options_s i_options = {} )
+    {
+        if( m_options.read_only )
+        {
+            throw vault_error{ "Vault " + m_path + " is open read-only" };
+        }
+
+        // the key derivation is the slow part and needs no locks
+        auto slot{ key_slot_s{} };
+        auto key{ derive_new_key( i_new_key, slot ) };
+
+        {
+            auto lock{ std::unique_lock{ m_lock } };
+            auto writer_lock{ lock_writer() };
+
+            if( m_keys.size() > 1 )
+            {
+                throw vault_error{ "A key rotation of vault " + m_path + " is unfinished; resume it first" };
+            }
+
+            auto& current{ m_keys.front() };
+
+            slot.id = static_cast<uint8_t>( current.id % 255 + 1 );
+            slot.previous = current.id;
+
+            auto wrapped{ encryption::aead_seal(
+                derive_subkey( key, "vault key wrap" ),
+                wrap_associated_data( slot ),
+                { reinterpret_cast<const char*>( current.key.data() ), current.key.size() } ) };
+
+            slot.wrapped.assign( reinterpret_cast<const char*>( wrapped.data() ), wrapped.size() );
+
+            // the active slot is left alone, so a crash before the sync leaves the vault on its old key
+            auto free_slot{ 1 - m_key_slot };
+            auto bytes{ slot.bytes() };
+
+            write_exact( m_file->fd.get(), bytes.data(), bytes.size(), key_slots_offset + free_slot * key_slot_size );
+            sync_data( m_file->fd.get() );
+
+            m_keys.insert( m_keys.begin(), make_key( slot.id, key ) );
+            m_key_slot = free_slot;
+
+            publish_root( m_end );
+        }
+
+        resume_rotation( i_options );
+    }
+
+
+    /**
+     * @brief Finish an unfinished key rotation: re-encrypt what is still sealed under the old key, then retire it
+     *
+     * @param i_options re-encryption threads and batch size
+     */
+    void resume_rotation( rotation_options_s i_options = {} )
+    {
+        if( m_options.read_only )
+        {
+            throw vault_error{ "Vault " + m_path + " is open read-only" };
+        }
+
+        // writes racing a pass can leave records to pick up in the next one
+        while( !finish_rotation() )
+        {
+            reencrypt( retiring_records(), i_options );
+        }
+    }
+
+
+    /**
+     * @brief Whether a key rotation has started and not finished yet
+     *
+     */
+    bool rotation_pending() const
+    {
+        auto lock{ std::shared_lock{ m_lock } };
+        return m_keys.size() > 1;
+    }
+
+
+    /**
+     * @brief Live and total bytes of the log; the fragmentation of the result is what a compaction would reclaim
+     *
+     */
+    space_usage_s space_usage() const
+    {
+        auto lock{ std::shared_lock{ m_lock } };
+
+        auto usage{ space_usage_s{ m_end - file_header_size } };
+
+        for( auto&& [index, location] : m_index )
+        {
+            usage.live_bytes += location.size;
+        }
+
+        if( m_checkpoint != 0 )
+        {
+            auto bytes{ std::string( frame_header_size, '\0' ) };
+            read_exact( m_file->fd.get(), bytes.data(), bytes.size(), m_checkpoint );
+
+            usage.live_bytes += frame_header_size + frame_header_s::parse( bytes ).length;
+        }
+
+        return usage;
+    }
+
+
+    /**
+     * @brief Copy the live records into a new file and switch to it atomically, leaving the dead ones behind
+     *
+     * Safe to run on a background thread while the vault serves reads and writes. The live records are copied without
+     * holding any lock and throttled to the I/O budget, and records written meanwhile follow in catch-up passes. Only
+     * the last short pass, the checkpoint and the rename over the vault hold off writers. Handles on the old file keep
+     * reading their snapshot and move to the new file on their next write or refresh.
+     *
+     * @param i_options I/O budget
+     * @return bytes reclaimed
+     */
+    uint64_t compact( compaction_options_s i_options = {} )
+    {
+        if( m_options.read_only )
+        {
+            throw vault_error{ "Vault " + m_path + " is open read-only" };
+        }
+
+        auto target_path{ m_path + ".compact" };
+
+        auto state{ compaction_s{} };
+        state.options = i_options;
+        state.options.chunk_bytes = std::max<std::size_t>( state.options.chunk_bytes, 1 );
+        state.target = std::make_shared<log_file_s>();
+        state.target->fd = unique_fd::open( target_path, O_RDWR | O_CREAT );
+
+        // the scratch file stays locked for the whole run, so two compactions never interleave
+        auto target_lock{ std::optional<file_lock>{} };
+        target_lock.emplace( state.target->fd.get(), LOCK_EX | LOCK_NB );
+
+        // a compaction that finished just before the lock was taken may have renamed this very file over the vault
+        if( !names_file( target_path, state.target->fd.get() ) )
+        {
+            throw vault_error{ "Another compaction of vault " + m_path + " is running" };
+        }
+
+        if( ::ftruncate( state.target->fd.get(), 0 ) != 0 )
+        {
+            throw vault_error{ "Unable to truncate " + target_path };
+        }
+
+        auto records{ std::vector<std::pair<blind_index_t, record_location_s>>{} };
+        auto from{ uint64_t{} };
+
+        {
+            auto lock{ std::shared_lock{ m_lock } };
+
+            state.source = m_file;
+            records.assign( m_index.begin(), m_index.end() );
+            from = m_end;
+        }
+
+        std::sort( records.begin(), records.end(), []( const auto& i_left, const auto& i_right ) {
+            return i_left.second.offset < i_right.second.offset;
+        } );
+
+        copy_records( state, records );
+
+        // follow the writes made meanwhile without locks while they are more than one chunk behind
+        while( true )
+        {
+            auto until{ uint64_t{} };
+
+            {
+                auto lock{ std::shared_lock{ m_lock } };
+                until = read_root().end;
+            }
+
+            if( until < from + state.options.chunk_bytes )
+            {
+                break;
+            }
+
+            from = copy_log( state, from, until, true );
+        }
+
+        auto lock{ std::unique_lock{ m_lock } };
+        auto writer_lock{ lock_writer() };
+
+        copy_log( state, from, m_end, false );
+
+        // a copied record that was since rewritten under another key lives on under another index; drop the old one
+        for( auto iter{ state.index.begin() }; iter != state.index.end(); )
+        {
+            iter = m_index.count( iter->first ) != 0 ? std::next( iter ) : state.index.erase( iter );
+        }
+
+        // the header keeps the key slots, the root slots start over and the rewritten log gets a new id
+        auto header{ std::string( file_header_size, '\0' ) };
+        read_exact( m_file->fd.get(), header.data(), header.size(), 0_ui64 );
+        std::fill_n( header.begin() + root_slots_offset, 2 * root_slot_size, '\0' );
+
+        auto log_id{ byte_writer{} };
+        log_id.put( new_random_id() );
+        std::copy( log_id.bytes().begin(), log_id.bytes().end(), header.begin() + log_id_offset );
+        write_exact( state.target->fd.get(), header.data(), header.size(), 0_ui64 );
+
+        auto footer{ seal_frame( m_keys.front(), frame_type::footer, footer_body( state.index ) ) };
+        auto footer_offset{ state.end };
+
+        write_exact( state.target->fd.get(), footer.data(), footer.size(), footer_offset );
+        state.end += footer.size();
+
+        sync_data( state.target->fd.get() );
+
+        auto root{ root_s{ m_version + 1, state.end, footer_offset } };
+        auto slot{ root_slot( root, m_keys.front() ) };
+
+        write_exact( state.target->fd.get(),
+                     slot.data(),
+                     slot.size(),
+                     root_slots_offset + ( root.version % 2 ) * root_slot_size );
+
+        sync_data( state.target->fd.get() );
+
+        if( ::rename( target_path.c_str(), m_path.c_str() ) != 0 )
+        {
+            throw vault_error{ "Unable to replace " + m_path + ": " + std::strerror( errno ) };
+        }
+
+        sync_parent_directory( m_path );
+
+        auto reclaimed{ m_end > state.end ? m_end - state.end : 0_ui64 };
+
+        m_file = state.target;
+        m_index = std::move( state.index );
+        m_end = state.end;
+        m_checkpoint = footer_offset;
+        m_version = root.version;
+        m_tail_records = 0;
+
+        // released here, before any other thread of this handle locks the same file through lock_writer
+        target_lock.reset();
+
+        return reclaimed;
+    }
+
+
+    /**
+     * @brief Move to the newest published root; until then the handle keeps reading the snapshot it pinned
+     *
+     * @return true if a newer root was found
+     */
+    bool refresh()
+    {
+        auto lock{ std::unique_lock{ m_lock } };
+
+        if( !m_options.read_only )
+        {
+            // writers may only look past a root while holding the file lock
+            auto previous{ m_version };
+            auto writer_lock{ lock_writer() };
+
+            return m_version != previous;
+        }
+
+        if( !names_file( m_path, m_file->fd.get() ) )
+        {
+            auto file{ std::make_shared<log_file_s>() };
+            file->fd = unique_fd::open( m_path, O_RDONLY );
+
+            reload( std::move( file ) );
+
+            return true;
+        }
+
+        refresh_keys();
+
+        auto root{ read_root() };
+
+        if( root.version == m_version )
+        {
+            return false;
+        }
+
+        replay_log( m_end, root.end, root.end );
+        m_version = root.version;
+
+        return true;
+    }
+
+
+    /**
+     * @brief Version of the root this handle reads
+     *
+     */
+    uint64_t version() const
+    {
+        auto lock{ std::shared_lock{ m_lock } };
+        return m_version;
+    }
+
+
+    /**
+     * @brief Encrypt an entry without touching the file, so bulk imports can seal on many threads
+     *
+     * @param i_name entry name
+     * @param i_secret secret
+     * @return complete entry frame, ready for append_sealed
+     */
+    sealed_entry_s seal_entry( std::string_view i_name, std::string_view i_secret ) const
+    {
+        auto lock{ std::shared_lock{ m_lock } };
+
+        // replacing an entry continues its version vector, which costs one read
+        auto iter{ find_entry( i_name ) };
+        auto versions{ iter != m_index.end() ? read_versions( iter->second ) : version_vector_t{} };
+
+        return seal_entry( m_keys.front(), i_name, i_secret, bump_version( std::move( versions ), m_replica ) );
+    }
+
+
+    /**
+     * @brief Append sealed entries in order with one write and one commit, adding new entries and replacing
+     *        existing ones
+     *
+     */
+    void append_sealed( const std::vector<sealed_entry_s>& i_entries )
+    {
+        if( m_options.read_only )
+        {
+            throw vault_error{ "Vault " + m_path + " is open read-only" };
+        }
+
+        auto end{ uint64_t{} };
+        auto file{ std::shared_ptr<log_file_s>{} };
+
+        {
+            auto lock{ std::unique_lock{ m_lock } };
+            auto writer_lock{ lock_writer() };
+
+            auto bytes{ std::string{} };
+
+            for( auto&& entry : i_entries )
+            {
+                if( entry.key != m_keys.front().id )
+                {
+                    throw vault_error{ "Entry was sealed under a key that has since been rotated" };
+                }
+
+                bytes += entry.frame;
+            }
+
+            write_exact( m_file->fd.get(), bytes.data(), bytes.size(), m_end );
+
+            for( auto&& entry : i_entries )
+            {
+                index_sealed( entry );
+            }
+
+            end = m_end;
+            file = m_file;
+        }
+
+        commit( *file, end );
+    }
+
+
+    /**
+     * @brief Locations of all live entries in file order, for sequential bulk reads
+     *
+     */
+    std::vector<record_location_s> entry_locations() const
+    {
+        auto locations{ std::vector<record_location_s>{} };
+
+        {
+            auto lock{ std::shared_lock{ m_lock } };
+            locations.reserve( m_index.size() );
+
+            for( auto&& [index, location] : m_index )
+            {
+                locations.push_back( location );
+            }
+        }
+
+        std::sort( locations.begin(), locations.end(), []( const auto& i_left, const auto& i_right ) {
+            return i_left.offset < i_right.offset;
+        } );
+
+        return locations;
+    }
+
+
+    /**
+     * @brief Read and decrypt the entry at a location from entry_locations; safe to call from many threads
+     *
+     */
+    entry_s open_entry( const record_location_s& i_location ) const
+    {
+        auto lock{ std::shared_lock{ m_lock } };
+        return read_entry( i_location );
+    }
+
+
+    /**
+     * @brief Id this replica stamps into the version vectors of the entries it writes
+     *
+     */
+    uint64_t replica_id() const noexcept
+    {
+        return m_replica;
+    }
+
+
+    /**
+     * @brief Value two replicas compare before syncing, equal only when they hold the same active key
+     *
+     */
+    std::string sync_fingerprint() const
+    {
+        auto lock{ std::shared_lock{ m_lock } };
+
+        auto& key{ m_keys.front() };
+        auto mac{ derive_subkey( key.key, "vault sync" ) };
+
+        auto fingerprint{ byte_writer{} };
+        fingerprint.put( key.id ).put_bytes( mac.data(), merkle_digest_size );
+
+        return fingerprint.bytes();
+    }
+
+
+    /**
+     * @brief Hash of a node of the Merkle tree over the live records
+     *
+     * @param i_level level of the node, 0 for the root and merkle_tree::depth for the leaf buckets
+     * @param i_position position of the node within its level
+     */
+    merkle_digest_t merkle_hash( uint32_t i_level, uint32_t i_position ) const
+    {
+        auto lock{ std::shared_lock{ m_lock } };
+        return m_tree.hash( i_level, i_position );
+    }
+
+
+    /**
+     * @brief Blind indexes and record digests of one leaf bucket of the Merkle tree
+     *
+     */
+    merkle_tree::bucket_t merkle_bucket( uint32_t i_position ) const
+    {
+        auto lock{ std::shared_lock{ m_lock } };
+        return m_tree.bucket( i_position );
+    }
+
+
+    /**
+     * @brief Live record of an entry exactly as stored, for shipping to another replica
+     *
+     * @return frame, nothing if no live entry has the index
+     */
+    std::optional<std::string> read_record( const blind_index_t& i_index ) const
+    {
+        auto lock{ std::shared_lock{ m_lock } };
+
+        auto iter{ m_index.find( i_index ) };
+
+        if( iter == m_index.end() )
+        {
+            return std::nullopt;
+        }
+
+        return read_frame( iter->second, frame_type::entry );
+    }
+
+
+    /**
+     * @brief Authenticate and decrypt a record from read_record on this or another replica
+     *
+     */
+    entry_s open_record( std::string_view i_frame ) const
+    {
+        auto lock{ std::shared_lock{ m_lock } };
+        return check_record( i_frame );
+    }
+
+
+    /**
+     * @brief Encrypt an entry under its own version vector, for the merge of two concurrent updates
+     *
+     * @return complete entry frame, ready for merge_records on any replica
+     */
+    sealed_entry_s seal_record( const entry_s& i_entry ) const
+    {
+        auto lock{ std::shared_lock{ m_lock } };
+        return seal_entry( m_keys.front(), i_entry.name, i_entry.secret, i_entry.versions );
+    }
+
+
+    /**
+     * @brief Append records from another replica with one write and one commit, keeping only those that descend from
+     *        the local version of their entry
+     *
+     * A record the local entry has moved past since the caller compared them is skipped, so a sync racing with local
+     * writes never loses one. Between two different records of the same version the larger digest wins, as it does on
+     * every replica.
+     *
+     * @param i_frames records from read_record or seal_record
+     * @return number of records appended
+     */
+    std::size_t merge_records( const std::vector<std::string>& i_frames )
+    {
+        if( m_options.read_only )
+        {
+            throw vault_error{ "Vault " + m_path + " is open read-only" };
+        }
+
+        auto end{ uint64_t{} };
+        auto file{ std::shared_ptr<log_file_s>{} };
+        auto merged{ std::vector<sealed_entry_s>{} };
+
+        {
+            auto lock{ std::unique_lock{ m_lock } };
+            auto writer_lock{ lock_writer() };
+
+            auto bytes{ std::string{} };
+
+            for( auto&& frame : i_frames )
+            {
+                auto entry{ check_record( frame ) };
+                auto key{ frame_header_s::parse( frame ).key };
+
+                wipe_bytes( entry.secret.data(), entry.secret.size() );
+
+                if( key != m_keys.front().id )
+                {
+                    throw vault_error{ "Replica record is sealed under a key this vault no longer writes with" };
+                }
+
+                if( auto iter{ find_entry( entry.name ) }; iter != m_index.end() )
+                {
+                    auto digest{ record_digest( frame ) };
+                    auto current{ read_versions( iter->second ) };
+                    auto current_digest{ m_tree.find( iter->first ).value_or( merkle_digest_t{} ) };
+
+                    auto newer{ descends( entry.versions, current ) &&
+                                ( !descends( current, entry.versions ) || current_digest < digest ) };
+
+                    if( !newer )
+                    {
+                        continue;
+                    }
+                }
+
+                auto sealed{ sealed_entry_s{ entry.index, frame, key } };
+
+                if( m_keys.size() > 1 )
+                {
+                    sealed.retired = blind_index( m_keys.back().index_key, entry.name );
+                }
+
+                bytes += frame;
+                merged.push_back( std::move( sealed ) );
+            }
+
+            if( merged.empty() )
+            {
+                return 0;
+            }
+
+            write_exact( m_file->fd.get(), bytes.data(), bytes.size(), m_end );
+
+            for( auto&& entry : merged )
+            {
+                index_sealed( entry );
+            }
+
+            end = m_end;
+            file = m_file;
+        }
+
+        commit( *file, end );
+
+        return merged.size();
+    }
+
+
+    /**
+     * @brief Pin the newest committed root for copying the vault file while it stays in use
+     *
+     * Only the pinning takes the lock. The copy's header holds that root alone, and the frames below it never change,
+     * so they can be read at leisure, even after a compaction has replaced the file.
+     */
+    committed_file_s pin_committed() const
+    {
+        auto lock{ std::shared_lock{ m_lock } };
+
+        auto pinned{ committed_file_s{} };
+        auto root{ read_root() };
+
+        pinned.header.resize( file_header_size );
+        read_exact( m_file->fd.get(), pinned.header.data(), pinned.header.size(), 0_ui64 );
+
+        // another process may publish a newer root while the header is read; keep only the pinned one
+        auto slot{ root_slot( root, m_keys.front() ) };
+        auto slot_offset{ root_slots_offset + ( root.version % 2 ) * root_slot_size };
+
+        std::fill_n( pinned.header.begin() + root_slots_offset, 2 * root_slot_size, '\0' );
+        std::copy( slot.begin(), slot.end(), pinned.header.begin() + slot_offset );
+
+        pinned.end = std::max( root.end, file_header_size );
+        pinned.log_id = byte_reader{ std::string_view{ pinned.header }.substr( log_id_offset ) }.get<uint64_t>();
+        pinned.file = std::shared_ptr<const unique_fd>{ m_file, &m_file->fd };
+
+        return pinned;
+    }
+
+
+    /**
+     * @brief Write a replica of the vault to a new file: the committed log under a fresh replica id
+     *
+     * @param i_path file to create, must not exist
+     */
+    void clone( const std::string& i_path ) const
+    {
+        auto target{ unique_fd::open( i_path, O_RDWR | O_CREAT | O_EXCL ) };
+        auto pinned{ pin_committed() };
+
+        auto ids{ byte_writer{} };
+        ids.put( new_random_id() ).put( new_random_id() );
+        std::copy( ids.bytes().begin(), ids.bytes().end(), pinned.header.begin() + replica_id_offset );
+
+        auto buffer{ std::string{} };
+
+        for( auto offset{ 0_ui64 }; offset < pinned.end; offset += buffer.size() )
+        {
+            buffer.resize( std::min<uint64_t>( pinned.end - offset, 1_ui64 << 20 ) );
+
+            pinned.read( offset, buffer.data(), buffer.size() );
+            write_exact( target.get(), buffer.data(), buffer.size(), offset );
+        }
+
+        sync_data( target.get() );
+        sync_parent_directory( i_path );
+    }
+
+
+    /**
+     * @brief Decrypted secrets cache, for sizing and tests
+     *
+     */
+    const plaintext_cache<blind_index_t, blind_index_hash>& cache() const noexcept
+    {
+        return m_cache;
+    }
+
+
+    /**
+     * @brief Number of fdatasync calls issued for commits
+     *
+     */
+    uint64_t syncs() const
+    {
+        auto lock{ std::shared_lock{ m_lock } };
+        return m_file->syncs.load();
+    }
+
+
+    /**
+     * @brief Path of the vault file
+     *
+     */
+    const std::string& path() const noexcept
+    {
+        return m_path;
+    }
+
+private:
+    std::string m_path{};
+
+    vault_options_s m_options{};
+
+    /**
+     * @brief Open vault file and the commit state of its log, replaced as a whole when a compaction switches files
+     *
+     */
+    struct log_file_s
+    {
+        unique_fd fd{};
+        group_commit commit{};
+        std::atomic<uint64_t> syncs{ 0_ui64 };  // fdatasync calls issued for commits
+    };
+
+    std::shared_ptr<log_file_s> m_file{ std::make_shared<log_file_s>() };
+
+    /**
+     * @brief One vault key and the subkeys derived from it
+     *
+     */
+    struct key_s
+    {
+        uint8_t id{ 0_ui8 };
+        encryption::aead_key_t key{};
+        encryption::aead_key_t index_key{};  // keys the blind indexes standing in for entry names
+        encryption::aead_key_t root_key{};  // authenticates the root slots
+    };
+
+    std::vector<key_s> m_keys{};  // the active key, then the key being rotated out while a rotation is unfinished
+
+    uint64_t m_key_slot{ 0_ui64 };  // header slot of the active key
+
+    using index_map = std::unordered_map<blind_index_t, record_location_s, blind_index_hash>;
+
+    index_map m_index{};
+
+    merkle_tree m_tree{};  // record digests of the entries in m_index
+
+    uint64_t m_replica{ 0_ui64 };  // id of this replica in version vectors
+
+    uint64_t m_end{ file_header_size };
+
+    uint64_t m_checkpoint{ 0_ui64 };  // offset of the latest checkpoint footer
+
+    uint64_t m_version{ 0_ui64 };  // version of the root this handle has reached
+
+    uint64_t m_tail_records{ 0_ui64 };  // log records written after the latest checkpoint
+
+    mutable std::shared_mutex m_lock{};  // guards the keys, the index and the end of the log
+
+    mutable plaintext_cache<blind_index_t, blind_index_hash> m_cache;  // entries decrypted since open, bounded LRU
+
+
+    /**
+     * @brief Append an entry under the writer locks, then commit it according to the durability mode
+     *
+     */
+    void store( std::string_view i_name, std::string_view i_secret, bool i_replace )
+    {
+        if( m_options.read_only )
+        {
+            throw vault_error{ "Vault " + m_path + " is open read-only" };
+        }
+
+        auto end{ uint64_t{} };
+        auto file{ std::shared_ptr<log_file_s>{} };
+
+        {
+            auto lock{ std::unique_lock{ m_lock } };
+            auto writer_lock{ lock_writer() };
+
+            auto iter{ find_entry( i_name ) };
+            auto exists{ iter != m_index.end() };
+
+            if( exists != i_replace )
+            {
+                throw vault_error{ "Entry " + std::string{ i_name } +
+                                   ( exists ? " already exists" : " does not exist" ) };
+            }
+
+            auto versions{ exists ? read_versions( iter->second ) : version_vector_t{} };
+            append_entry( i_name, i_secret, bump_version( std::move( versions ), m_replica ) );
+            end = m_end;
+            file = m_file;
+        }
+
+        commit( *file, end );
+    }
+
+
+    /**
+     * @brief Make a write durable and publish it according to the durability mode; called without the writer locks
+     *
+     * Async writes are published by the next flush, so a root never covers frames that may not be on disk yet.
+     *
+     * @param io_file file the write went to, which a compaction may have replaced since
+     * @param i_end end of the write
+     */
+    void commit( log_file_s& io_file, uint64_t i_end )
+    {
+        switch( m_options.durability )
+        {
+        case durability_mode::per_write:
+            sync_log( io_file, i_end );
+            break;
+        case durability_mode::grouped:
+            io_file.commit.commit( i_end,
+                                   [this, &io_file]( uint64_t i_target ) { return sync_log( io_file, i_target ); } );
+            break;
+        case durability_mode::async:
+            io_file.commit.written( i_end );
+            break;
+        }
+    }
+
+
+    /**
+     * @brief Make the log durable up to at least an offset, then publish a root over what was synced
+     *
+     * Leaders of different handles and processes take turns here. Roots are only published over synced frames, so a
+     * root that already reaches the offset means another leader's sync covered it; otherwise one fdatasync covers every
+     * frame appended so far, whoever appended it.
+     *
+     * @param io_file file the writes went to, which a compaction may have replaced since
+     * @param i_offset end of the writes
+     * @return offset the log is durable up to
+     */
+    uint64_t sync_log( log_file_s& io_file, uint64_t i_offset )
+    {
+        auto turn{ turn_lock{ io_file.fd.get() } };
+        auto end{ uint64_t{} };
+
+        {
+            auto lock{ std::unique_lock{ m_lock } };
+            auto writer_lock{ lock_writer() };
+
+            // a compaction copied the writes into its file and synced it before switching to it
+            if( m_file.get() != &io_file )
+            {
+                return i_offset;
+            }
+
+            if( auto root{ read_root() }; root.end >= i_offset )
+            {
+                return root.end;
+            }
+
+            end = m_end;
+        }
+
+        sync_data( io_file.fd.get() );
+        ++io_file.syncs;
+
+        auto lock{ std::unique_lock{ m_lock } };
+        auto writer_lock{ lock_writer() };
+
+        if( m_file.get() == &io_file && read_root().end < end )
+        {
+            publish_root( end );
+        }
+
+        return end;
+    }
+
+
+    /**
+     * @brief Apply records other processes appended since this one last wrote; called with the file lock held
+     *
+     */
+    void catch_up()
+    {
+        refresh_keys();
+
+        auto root{ read_root() };
+        m_version = std::max( m_version, root.version );
+
+        if( file_size( m_file->fd.get() ) > m_end )
+        {
+            replay_log( m_end, file_size( m_file->fd.get() ), root.end );
+        }
+    }
+
+
+    static std::string root_slot( const root_s& i_root, const key_s& i_key )
+    {
+        auto slot{ byte_writer{} };
+        slot.put( i_root.version ).put( i_root.end ).put( i_root.checkpoint );
+
+        auto mac{ encryption::hmac_sha256::mac(
+            i_key.root_key.data(), i_key.root_key.size(), slot.bytes().data(), slot.bytes().size() ) };
+
+        slot.put_bytes( mac.data(), root_mac_size );
+
+        return slot.bytes();
+    }
+
+
+    /**
+     * @brief Newest root slot that is intact; a torn slot write leaves the other, older one in charge
+     *
+     * Roots are signed with the active key, so during a rotation either key held may have signed the newest one.
+     */
+    root_s read_root() const
+    {
+        auto bytes{ std::string( 2 * root_slot_size, '\0' ) };
+        read_exact( m_file->fd.get(), bytes.data(), bytes.size(), root_slots_offset );
+
+        auto newest{ root_s{} };
+
+        for( auto slot{ 0_ui64 }; slot < 2; ++slot )
+        {
+            auto stored{ std::string_view{ bytes }.substr( slot * root_slot_size, root_slot_size ) };
+
+            auto reader{ byte_reader{ stored } };
+            auto root{ root_s{ reader.get<uint64_t>(), reader.get<uint64_t>(), reader.get<uint64_t>() } };
+
+            auto signed_by{ [&]( const key_s& i_key ) { return root_slot( root, i_key ) == stored; } };
+
+            if( root.version > newest.version && std::any_of( m_keys.begin(), m_keys.end(), signed_by ) )
+            {
+                newest = root;
+            }
+        }
+
+        return newest;
+    }
+
+
+    /**
+     * @brief Publish a root over the log up to an offset; called with the file lock held once the log is synced there
+     *
+     */
+    void publish_root( uint64_t i_end )
+    {
+        // a checkpoint appended past the synced end waits for a later root
+        auto checkpoint{ m_checkpoint < i_end ? m_checkpoint : read_root().checkpoint };
+        auto root{ root_s{ m_version + 1, i_end, checkpoint } };
+        auto slot{ root_slot( root, m_keys.front() ) };
+
+        auto offset{ root_slots_offset + ( root.version % 2 ) * root_slot_size };
+        write_exact( m_file->fd.get(), slot.data(), slot.size(), offset );
+
+        m_version = root.version;
+    }
+
+
+    void create_header( const encryption::encryption_key& i_key )
+    {
+        auto slot{ key_slot_s{} };
+        slot.id = 1;
+
+        m_keys.assign( 1, make_key( slot.id, derive_new_key( i_key, slot ) ) );
+        m_key_slot = 0;
+
+        m_replica = new_random_id();
+
+        auto header{ byte_writer{} };
+        header.put_bytes( vault_magic.data(), vault_magic.size() ).put( vault_format_version );
+
+        header.bytes().resize( replica_id_offset, '\0' );
+        header.put( m_replica ).put( new_random_id() );
+
+        header.bytes().resize( key_slots_offset, '\0' );
+        header.bytes() += slot.bytes();
+        header.bytes().resize( file_header_size, '\0' );
+
+        write_exact( m_file->fd.get(), header.bytes().data(), header.bytes().size(), 0_ui64 );
+        sync_data( m_file->fd.get() );
+    }
+
+
+    void read_header( const encryption::encryption_key& i_key )
+    {
+        auto bytes{ std::string( file_header_size, '\0' ) };
+        read_exact( m_file->fd.get(), bytes.data(), bytes.size(), 0_ui64 );
+
+        auto reader{ byte_reader{ bytes } };
+
+        if( reader.get_bytes( vault_magic.size() ) != vault_magic )
+        {
+            throw vault_error{ m_path + " is not a vault" };
+        }
+
+        if( reader.get<uint32_t>() != vault_format_version )
+        {
+            throw vault_error{ "Unsupported vault format version" };
+        }
+
+        m_replica = byte_reader{ std::string_view{ bytes }.substr( replica_id_offset ) }.get<uint64_t>();
+
+        auto slots{ read_key_slots() };
+        auto active{ active_slot( slots ) };
+        auto key{ open_key_slot( slots[active], i_key ) };
+
+        if( !key )
+        {
+            // a key rotated out still matches its slot until the rotation finishes, but no longer opens the vault
+            auto& other{ slots[1 - active] };
+
+            if( other.id != 0 && open_key_slot( other, i_key ) )
+            {
+                throw vault_error{ "The key of vault " + m_path + " has been rotated; open it with the new key" };
+            }
+
+            throw vault_error{ "Wrong key for vault " + m_path };
+        }
+
+        m_keys.assign( 1, make_key( slots[active].id, *key ) );
+        m_key_slot = active;
+
+        load_retiring_key( slots );
+    }
+
+
+    /**
+     * @brief Random non-zero id, for a replica or for a log
+     *
+     */
+    static uint64_t new_random_id()
+    {
+        auto id{ 0_ui64 };
+
+        while( id == 0 )
+        {
+            encryption::random_bytes( &id, sizeof( id ) );
+        }
+
+        return id;
+    }
+
+
+    std::array<key_slot_s, 2> read_key_slots() const
+    {
+        auto bytes{ std::string( 2 * key_slot_size, '\0' ) };
+        read_exact( m_file->fd.get(), bytes.data(), bytes.size(), key_slots_offset );
+
+        return { key_slot_s::parse( std::string_view{ bytes }.substr( 0, key_slot_size ) ),
+                 key_slot_s::parse( std::string_view{ bytes }.substr( key_slot_size ) ) };
+    }
+
+
+    /**
+     * @brief Slot of the newest key: the only one, or the one that replaced the other
+     *
+     */
+    static uint64_t active_slot( const std::array<key_slot_s, 2>& i_slots ) noexcept
+    {
+        if( i_slots[0].id == 0 || i_slots[1].id == 0 )
+        {
+            return i_slots[0].id == 0 ? 1 : 0;
+        }
+
+        return i_slots[1].previous == i_slots[0].id ? 1 : 0;
+    }
+
+
+    /**
+     * @brief Derive the key of a slot from a master key
+     *
+     * @return key, nothing if the master key is not the one the slot was made with
+     */
+    static std::optional<encryption::aead_key_t> open_key_slot( const key_slot_s& i_slot,
+                                                                const encryption::encryption_key& i_key )
+    {
+        auto key{ derive_master_key( i_key, i_slot.salt, i_slot.iterations ) };
+        auto check{ master_key_check( key ) };
+
+        if( std::string_view{ reinterpret_cast<const char*>( check.data() ), key_check_size } != i_slot.check )
+        {
+            return std::nullopt;
+        }
+
+        return key;
+    }
+
+
+    /**
+     * @brief Derive a vault key from a master key under a fresh salt and describe it in a key slot
+     *
+     */
+    encryption::aead_key_t derive_new_key( const encryption::encryption_key& i_key, key_slot_s& io_slot ) const
+    {
+        io_slot.iterations = m_options.kdf_iterations;
+        io_slot.salt.resize( salt_size );
+        encryption::random_bytes( io_slot.salt.data(), io_slot.salt.size() );
+
+        auto key{ derive_master_key( i_key, io_slot.salt, io_slot.iterations ) };
+        auto check{ master_key_check( key ) };
+
+        io_slot.check.assign( reinterpret_cast<const char*>( check.data() ), key_check_size );
+
+        return key;
+    }
+
+
+    static std::string wrap_associated_data( const key_slot_s& i_slot )
+    {
+        auto writer{ byte_writer{} };
+        writer.put( i_slot.id ).put( i_slot.previous );
+
+        return writer.bytes();
+    }
+
+
+    /**
+     * @brief Unwrap the key being rotated out for as long as its slot is still in the header
+     *
+     */
+    void load_retiring_key( const std::array<key_slot_s, 2>& i_slots )
+    {
+        auto& active{ i_slots[m_key_slot] };
+        auto& other{ i_slots[1 - m_key_slot] };
+
+        m_keys.resize( 1 );
+
+        if( other.id == 0 || other.id != active.previous )
+        {
+            return;
+        }
+
+        auto plain{ std::string{} };
+
+        if( !encryption::aead_open( derive_subkey( m_keys.front().key, "vault key wrap" ),
+                                    wrap_associated_data( active ),
+                                    reinterpret_cast<const uint8_t*>( active.wrapped.data() ),
+                                    active.wrapped.size(),
+                                    plain ) ||
+            plain.size() != std::tuple_size_v<encryption::aead_key_t> )
+        {
+            throw vault_error{ "Corrupt vault key slot" };
+        }
+
+        auto key{ encryption::aead_key_t{} };
+        std::copy( plain.begin(), plain.end(), key.begin() );
+        wipe_bytes( plain.data(), plain.size() );
+
+        m_keys.push_back( make_key( other.id, key ) );
+    }
+
+
+    /**
+     * @brief Follow a rotation finished by another handle, and refuse to go on if another handle rotated the key
+     *        this one holds; called under the writer locks or by a reader moving to a newer root
+     *
+     */
+    void refresh_keys()
+    {
+        auto slots{ read_key_slots() };
+        auto id{ m_keys.front().id };
+        auto slot{ slots[0].id == id ? 0_ui64 : 1_ui64 };
+
+        if( slots[slot].id != id || ( slots[1 - slot].id != 0 && slots[1 - slot].previous == id ) )
+        {
+            throw vault_error{ "The key of vault " + m_path + " has been rotated; reopen it with the new key" };
+        }
+
+        m_key_slot = slot;
+
+        if( m_keys.size() > 1 && slots[1 - slot].id != m_keys.back().id )
+        {
+            m_keys.resize( 1 );
+        }
+    }
+
+
+    static key_s make_key( uint8_t i_id, const encryption::aead_key_t& i_key )
+    {
+        return key_s{ i_id, i_key, derive_subkey( i_key, "vault blind index" ), derive_subkey( i_key, "vault root" ) };
+    }
+
+
+    const key_s& key_for( uint8_t i_id ) const
+    {
+        for( auto&& key : m_keys )
+        {
+            if( key.id == i_id )
+            {
+                return key;
+            }
+        }
+
+        throw vault_error{ "Vault record is sealed under a key this handle does not hold" };
+    }
+
+
+    /**
+     * @brief Find an entry by name under each key it may be indexed by, the active key first
+     *
+     */
+    index_map::const_iterator find_entry( std::string_view i_name ) const
+    {
+        for( auto&& key : m_keys )
+        {
+            if( auto iter{ m_index.find( blind_index( key.index_key, i_name ) ) }; iter != m_index.end() )
+            {
+                return iter;
+            }
+        }
+
+        return m_index.end();
+    }
+
+
+    /**
+     * @brief Forget the index entries of a name under keys other than the one it was just written under
+     *
+     */
+    void drop_aliases( std::string_view i_name, uint8_t i_key )
+    {
+        for( auto&& key : m_keys )
+        {
+            if( key.id != i_key )
+            {
+                auto index{ blind_index( key.index_key, i_name ) };
+
+                m_index.erase( index );
+                m_tree.erase( index );
+                m_cache.erase( index );
+            }
+        }
+    }
+
+
+    /**
+     * @brief Write the index as a checkpoint footer and publish it; called with the writer locks held
+     *
+     */
+    void append_checkpoint()
+    {
+        auto footer_offset{ m_end };
+        append_frame( frame_type::footer, footer_body( m_index ) );
+
+        // the footer must be durable before a root points at it
+        sync_data( m_file->fd.get() );
+        ++m_file->syncs;
+
+        m_checkpoint = footer_offset;
+        m_tail_records = 0;
+
+        publish_root( m_end );
+    }
+
+
+    /**
+     * @brief Checkpoint of an index over the live entries, each with its record digest from the Merkle tree
+     *
+     */
+    std::string footer_body( const index_map& i_index ) const
+    {
+        auto footer{ byte_writer{} };
+        footer.put( static_cast<uint32_t>( i_index.size() ) );
+
+        for( auto&& [index, location] : i_index )
+        {
+            auto digest{ m_tree.find( index ).value_or( merkle_digest_t{} ) };
+
+            footer.put_bytes( index.data(), index.size() ).put( location.offset ).put( location.size );
+            footer.put( location.key ).put_bytes( digest.data(), digest.size() );
+        }
+
+        return footer.bytes();
+    }
+
+
+    /**
+     * @brief Take the writer file lock and catch up with the log, first following the vault to its new file if a
+     *        compaction renamed one over the file this handle has open
+     *
+     */
+    file_lock lock_writer()
+    {
+        auto file{ m_file };
+        auto lock{ file_lock{ file->fd.get() } };
+
+        while( !names_file( m_path, file->fd.get() ) )
+        {
+            file = std::make_shared<log_file_s>();
+            file->fd = unique_fd::open( m_path, O_RDWR );
+
+            // the old file stays open through m_file until the lock on it is released
+            lock = file_lock{ file->fd.get() };
+            reload( file );
+        }
+
+        catch_up();
+
+        return lock;
+    }
+
+
+    /**
+     * @brief Start over on another vault file: pin its newest root and rebuild the index from it
+     *
+     */
+    void reload( std::shared_ptr<log_file_s> i_file )
+    {
+        m_file = std::move( i_file );
+
+        m_index.clear();
+        m_tree.clear();
+        m_cache.clear();
+        m_tail_records = 0;
+
+        refresh_keys();
+        load_index();
+    }
+
+
+    /**
+     * @brief Progress of a compaction: the new file, the index of what has been copied to it and the I/O budget
+     *
+     */
+    struct compaction_s
+    {
+        std::shared_ptr<log_file_s> source{};
+        std::shared_ptr<log_file_s> target{};
+        index_map index{};  // live entries at their offsets in the new file
+        uint64_t end{ file_header_size };  // end of the copied log
+        compaction_options_s options{};
+        std::chrono::steady_clock::time_point start{ std::chrono::steady_clock::now() };
+        uint64_t copied{ 0_ui64 };  // bytes charged to the I/O budget
+    };
+
+
+    /**
+     * @brief Copy a byte range of frames from the old file to the end of the new one
+     *
+     * @param i_throttle whether the copy is charged to the I/O budget; the final pass under the lock is not
+     */
+    static void copy_bytes( compaction_s& io_state, uint64_t i_offset, uint64_t i_size, bool i_throttle )
+    {
+        auto bytes{ std::string( i_size, '\0' ) };
+
+        read_exact( io_state.source->fd.get(), bytes.data(), bytes.size(), i_offset );
+        write_exact( io_state.target->fd.get(), bytes.data(), bytes.size(), io_state.end );
+
+        io_state.end += i_size;
+
+        if( i_throttle && io_state.options.bytes_per_second != 0 )
+        {
+            io_state.copied += i_size;
+
+            auto due{ std::chrono::duration<double>{ static_cast<double>( io_state.copied ) /
+                                                     static_cast<double>( io_state.options.bytes_per_second ) } };
+
+            std::this_thread::sleep_until(
+                io_state.start + std::chrono::duration_cast<std::chrono::steady_clock::duration>( due ) );
+        }
+    }
+
+
+    /**
+     * @brief Copy live records, sorted by offset, reading runs of adjacent records with one read each
+     *
+     */
+    static void copy_records( compaction_s& io_state,
+                              const std::vector<std::pair<blind_index_t, record_location_s>>& i_records )
+    {
+        for( auto first{ 0_sz }; first < i_records.size(); )
+        {
+            auto start{ i_records[first].second.offset };
+            auto run_end{ start };
+            auto last{ first };
+
+            while( last < i_records.size() && i_records[last].second.offset == run_end &&
+                   run_end - start < io_state.options.chunk_bytes )
+            {
+                auto&& [index, location] = i_records[last];
+
+                auto offset{ io_state.end + ( run_end - start ) };
+                io_state.index[index] = record_location_s{ offset, location.size, location.key };
+                run_end += location.size;
+                ++last;
+            }
+
+            copy_bytes( io_state, start, run_end - start, true );
+            first = last;
+        }
+    }
+
+
+    /**
+     * @brief Copy the entry frames of a committed stretch of the old log; its footers refer to old offsets and are
+     *        left behind
+     *
+     * @return end of the last frame copied
+     */
+    static uint64_t copy_log( compaction_s& io_state, uint64_t i_from, uint64_t i_until, bool i_throttle )
+    {
+        auto offset{ i_from };
+
+        while( offset + frame_header_size <= i_until )
+        {
+            auto bytes{ std::string( frame_header_size + blind_index_size, '\0' ) };
+            read_exact( io_state.source->fd.get(), bytes.data(), frame_header_size, offset );
+
+            auto header{ frame_header_s::parse( bytes ) };
+            auto size{ frame_header_size + header.length };
+
+            if( offset + size > i_until )
+            {
+                break;
+            }
+
+            if( header.type == frame_type::entry )
+            {
+                read_exact( io_state.source->fd.get(), bytes.data(), bytes.size(), offset );
+
+                auto index{ blind_index_t{} };
+                std::copy_n( bytes.data() + frame_header_size, blind_index_size, index.begin() );
+
+                io_state.index[index] = record_location_s{ io_state.end, static_cast<uint32_t>( size ), header.key };
+                copy_bytes( io_state, offset, size, i_throttle );
+            }
+
+            offset += size;
+        }
+
+        return offset;
+    }
+
+
+    /**
+     * @brief Live entries still sealed under the key being rotated out, in file order
+     *
+     */
+    std::vector<std::pair<blind_index_t, record_location_s>> retiring_records() const
+    {
+        auto records{ std::vector<std::pair<blind_index_t, record_location_s>>{} };
+
+        auto lock{ std::shared_lock{ m_lock } };
+
+        if( m_keys.size() < 2 )
+        {
+            return records;
+        }
+
+        for( auto&& [index, location] : m_index )
+        {
+            if( location.key == m_keys.back().id )
+            {
+                records.emplace_back( index, location );
+            }
+        }
+
+        std::sort( records.begin(), records.end(), []( const auto& i_left, const auto& i_right ) {
+            return i_left.second.offset < i_right.second.offset;
+        } );
+
+        return records;
+    }
+
+
+    /**
+     * @brief Re-encrypt records under the active key on a pool of threads, one append and commit per batch
+     *
+     */
+    void reencrypt( const std::vector<std::pair<blind_index_t, record_location_s>>& i_records,
+                    const rotation_options_s& i_options )
+    {
+        auto batch_size{ std::max<std::size_t>( i_options.batch_size, 1 ) };
+        auto batches{ ( i_records.size() + batch_size - 1 ) / batch_size };
+
+        auto next{ std::atomic<std::size_t>{ 0 } };
+        auto error{ std::exception_ptr{} };
+        auto error_mutex{ std::mutex{} };
+
+        auto work = [&] {
+            try
+            {
+                for( auto batch{ next++ }; batch < batches; batch = next++ )
+                {
+                    auto first{ batch * batch_size };
+                    auto last{ std::min( first + batch_size, i_records.size() ) };
+
+                    auto sealed{ std::vector<std::pair<uint64_t, sealed_entry_s>>{} };
+                    sealed.reserve( last - first );
+
+                    for( auto i{ first }; i < last; ++i )
+                    {
+                        auto&& [index, location] = i_records[i];
+
+                        // readers share the lock with the decryption, only the append below excludes them
+                        auto lock{ std::shared_lock{ m_lock } };
+
+                        auto entry{ read_entry( location ) };
+                        auto entry_sealed{ seal_entry( m_keys.front(), entry.name, entry.secret, entry.versions ) };
+                        entry_sealed.retired = index;
+
+                        wipe_bytes( entry.secret.data(), entry.secret.size() );
+
+                        sealed.emplace_back( location.offset, std::move( entry_sealed ) );
+                    }
+
+                    append_reencrypted( sealed );
+                }
+            }
+            catch( ... )
+            {
+                auto lock{ std::lock_guard{ error_mutex } };
+
+                if( !error )
+                {
+                    error = std::current_exception();
+                }
+
+                next = batches;
+            }
+        };
+
+        auto workers{ std::vector<std::thread>{} };
+
+        for( auto i{ 1_sz }; i < std::min( std::max<std::size_t>( i_options.workers, 1 ), batches ); ++i )
+        {
+            workers.emplace_back( work );
+        }
+
+        work();
+
+        for( auto&& worker : workers )
+        {
+            worker.join();
+        }
+
+        if( error )
+        {
+            std::rethrow_exception( error );
+        }
+    }
+
+
+    /**
+     * @brief Append re-encrypted entries whose old record is still the live one, with one write and one commit
+     *
+     * @param i_entries offset of the record each entry was read from, and the entry sealed under the active key
+     */
+    void append_reencrypted( const std::vector<std::pair<uint64_t, sealed_entry_s>>& i_entries )
+    {
+        auto end{ uint64_t{} };
+        auto file{ std::shared_ptr<log_file_s>{} };
+
+        {
+            auto lock{ std::unique_lock{ m_lock } };
+            auto writer_lock{ lock_writer() };
+
+            auto bytes{ std::string{} };
+            auto current{ std::vector<const sealed_entry_s*>{} };
+
+            for( auto&& [offset, entry] : i_entries )
+            {
+                // an update since the record was read has already replaced it under the active key
+                auto iter{ m_index.find( *entry.retired ) };
+
+                if( entry.key == m_keys.front().id && iter != m_index.end() && iter->second.offset == offset )
+                {
+                    bytes += entry.frame;
+                    current.push_back( &entry );
+                }
+            }
+
+            if( current.empty() )
+            {
+                return;
+            }
+
+            write_exact( m_file->fd.get(), bytes.data(), bytes.size(), m_end );
+
+            for( auto&& entry : current )
+            {
+                index_sealed( *entry );
+            }
+
+            end = m_end;
+            file = m_file;
+        }
+
+        commit( *file, end );
+    }
+
+
+    /**
+     * @brief Retire the old key once no live entry is sealed under it
+     *
+     * A checkpoint under the new key goes first, so no later open replays frames sealed under the old one; only then is
+     * the old key slot cleared.
+     *
+     * @return false if entries sealed under the old key are left to re-encrypt
+     */
+    bool finish_rotation()
+    {
+        auto lock{ std::unique_lock{ m_lock } };
+        auto writer_lock{ lock_writer() };
+
+        if( m_keys.size() < 2 )
+        {
+            return true;
+        }
+
+        auto retiring{ m_keys.back().id };
+
+        if( std::any_of( m_index.begin(), m_index.end(), [retiring]( const auto& i_entry ) {
+                return i_entry.second.key == retiring;
+            } ) )
+        {
+            return false;
+        }
+
+        append_checkpoint();
+        sync_data( m_file->fd.get() );
+
+        auto empty{ std::string( key_slot_size, '\0' ) };
+        auto offset{ key_slots_offset + ( 1 - m_key_slot ) * key_slot_size };
+        write_exact( m_file->fd.get(), empty.data(), empty.size(), offset );
+        sync_data( m_file->fd.get() );
+
+        m_keys.resize( 1 );
+
+        return true;
+    }
+
+
+    /**
+     * @brief Pin the newest root and build its index from the checkpoint footer and the log written after it
+     *
+     * Readers stop at the root's end and ignore frames a concurrent writer is still appending. A writer holds the file
+     * lock here, so anything past the root is an unpublished record from a crashed writer: it is replayed if intact,
+     * cut off if torn, and the result is published as a new root. Nothing below the root is ever cut off.
+     */
+    void load_index()
+    {
+        auto size{ file_size( m_file->fd.get() ) };
+        auto root{ read_root() };
+
+        m_version = root.version;
+        m_checkpoint = root.checkpoint;
+        m_end = file_header_size;
+
+        auto from{ is_footer( root.checkpoint, size ) ? root.checkpoint : file_header_size };
+
+        replay_log( from, m_options.read_only ? root.end : size, root.end );
+
+        // the replayed tail may only have reached the page cache of a writer that crashed
+        if( !m_options.read_only && ( m_end != root.end || m_checkpoint != root.checkpoint ) )
+        {
+            sync_data( m_file->fd.get() );
+            publish_root( m_end );
+        }
+    }
+
+
+    bool is_footer( uint64_t i_offset, uint64_t i_size ) const
+    {
+        if( i_offset < file_header_size || i_offset + frame_header_size > i_size )
+        {
+            return false;
+        }
+
+        auto bytes{ std::string( frame_header_size, '\0' ) };
+        read_exact( m_file->fd.get(), bytes.data(), bytes.size(), i_offset );
+
+        return frame_header_s::parse( bytes ).type == frame_type::footer;
+    }
+
+
+    void load_footer( uint64_t i_offset )
+    {
+        auto header_bytes{ std::string( frame_header_size, '\0' ) };
+        read_exact( m_file->fd.get(), header_bytes.data(), header_bytes.size(), i_offset );
+
+        auto header{ frame_header_s::parse( header_bytes ) };
+
+        if( header.type != frame_type::footer || header.length > max_frame_body )
+        {
+            throw vault_error{ "Corrupt vault footer" };
+        }
+
+        auto location{ record_location_s{ i_offset, static_cast<uint32_t>( frame_header_size + header.length ) } };
+        auto plain{ open_frame( location, frame_type::footer ) };
+
+        auto reader{ byte_reader{ plain } };
+        auto count{ reader.get<uint32_t>() };
+
+        m_index.clear();
+        m_index.reserve( count );
+        m_tree.clear();
+        m_cache.clear();
+
+        for( auto i{ 0_ui32 }; i < count; ++i )
+        {
+            auto index{ blind_index_t{} };
+            auto index_bytes{ reader.get_bytes( blind_index_size ) };
+            std::copy( index_bytes.begin(), index_bytes.end(), index.begin() );
+
+            auto offset{ reader.get<uint64_t>() };
+            auto frame_size{ reader.get<uint32_t>() };
+            auto key{ reader.get<uint8_t>() };
+
+            auto digest{ merkle_digest_t{} };
+            auto digest_bytes{ reader.get_bytes( merkle_digest_size ) };
+            std::copy( digest_bytes.begin(), digest_bytes.end(), digest.begin() );
+
+            m_index.emplace( index, record_location_s{ offset, frame_size, key } );
+            m_tree.set( index, digest );
+        }
+    }
+
+
+    /**
+     * @brief Replay part of the log: load the last footer found, apply entries written after it and, for writers, cut
+     *        off a torn tail
+     *
+     * Only frames past the published root can be torn, since a root is published once the frames below it are synced.
+     * A frame below it that does not check out is corruption, and cutting the log there would drop every committed
+     * record after it, so the replay stops with an error instead.
+     *
+     * @param i_from frame to start at, the latest checkpoint on open or the known end when catching up
+     * @param i_until end of the log to replay, the pinned root for readers
+     * @param i_committed end of the published root
+     */
+    void replay_log( uint64_t i_from, uint64_t i_until, uint64_t i_committed )
+    {
+        auto file_end{ file_size( m_file->fd.get() ) };
+        auto size{ std::min( i_until, file_end ) };
+
+        auto offset{ i_from };
+        auto last_footer{ std::optional<uint64_t>{} };
+        auto tail{ std::vector<record_location_s>{} };
+
+        while( offset + frame_header_size <= size )
+        {
+            auto header_bytes{ std::string( frame_header_size, '\0' ) };
+            read_exact( m_file->fd.get(), header_bytes.data(), header_bytes.size(), offset );
+
+            auto header{ frame_header_s::parse( header_bytes ) };
+
+            if( header.length > max_frame_body || offset + frame_header_size + header.length > size )
+            {
+                if( offset < i_committed )
+                {
+                    throw vault_error{ "Corrupt vault record at offset " + std::to_string( offset ) };
+                }
+
+                break;
+            }
+
+            auto location{
+                record_location_s{ offset, static_cast<uint32_t>( frame_header_size + header.length ), header.key } };
+
+            if( header.type == frame_type::footer )
+            {
+                last_footer = offset;
+                tail.clear();
+            }
+            else if( header.type == frame_type::entry )
+            {
+                tail.push_back( location );
+            }
+            else if( offset < i_committed )
+            {
+                throw vault_error{ "Corrupt vault record at offset " + std::to_string( offset ) };
+            }
+            else
+            {
+                break;
+            }
+
+            offset += location.size;
+        }
+
+        if( offset < std::min( i_committed, i_until ) )
+        {
+            throw vault_error{ "Vault " + m_path + " ends before its last committed record" };
+        }
+
+        auto valid_end{ offset };
+
+        if( last_footer )
+        {
+            load_footer( *last_footer );
+            m_checkpoint = *last_footer;
+            m_tail_records = 0;
+        }
+
+        // tail records are authenticated before they are indexed, so a torn write is cut off rather than indexed
+        for( auto&& location : tail )
+        {
+            // a frame under a key this handle lacks is intact but unreadable, and must not be cut off as torn
+            key_for( location.key );
+
+            auto bytes{ std::string{} };
+            auto entry{ std::optional<entry_s>{} };
+
+            try
+            {
+                bytes = read_frame( location, frame_type::entry );
+                entry = parse_entry( bytes );
+            }
+            catch( const vault_error& )
+            {
+                if( location.offset < i_committed )
+                {
+                    throw vault_error{ "Corrupt vault record at offset " + std::to_string( location.offset ) };
+                }
+
+                valid_end = location.offset;
+                break;
+            }
+
+            m_index[entry->index] = location;
+            m_tree.set( entry->index, record_digest( bytes ) );
+            m_cache.erase( entry->index );
+            drop_aliases( entry->name, location.key );
+            ++m_tail_records;
+        }
+
+        m_end = valid_end;
+
+        if( !m_options.read_only && valid_end != file_end &&
+            ::ftruncate( m_file->fd.get(), static_cast<off_t>( valid_end ) ) != 0 )
+        {
+            throw vault_error{ "Unable to truncate torn vault tail" };
+        }
+    }
+
+
+    /**
+     * @brief Encrypt a body into a complete frame; frames do not depend on where they are written
+     *
+     * @param i_key key to seal under
+     * @param i_type frame type
+     * @param i_plain body to encrypt
+     * @param i_clear authenticated but unencrypted prefix of the body, the blind index of entry frames
+     * @return frame header, clear prefix and sealed body
+     */
+    static std::string seal_frame( const key_s& i_key,
+                                   frame_type i_type,
+                                   std::string_view i_plain,
+                                   std::string_view i_clear = {} )
+    {
+        auto length{ i_clear.size() + i_plain.size() + encryption::aead_overhead };
+
+        if( length > max_frame_body )
+        {
+            throw vault_error{ "Vault record too large" };
+        }
+
+        auto frame{ frame_header_s{ static_cast<uint32_t>( length ), i_type, i_key.id }.bytes() };
+        frame.append( i_clear.data(), i_clear.size() );
+
+        auto sealed{ encryption::aead_seal( i_key.key, frame, i_plain ) };
+        frame.append( reinterpret_cast<const char*>( sealed.data() ), sealed.size() );
+
+        return frame;
+    }
+
+
+    /**
+     * @brief Encrypt a body and append it as a frame
+     *
+     * @return location of the new frame
+     */
+    record_location_s append_frame( frame_type i_type, std::string_view i_plain, std::string_view i_clear = {} )
+    {
+        if( m_options.read_only )
+        {
+            throw vault_error{ "Vault " + m_path + " is open read-only" };
+        }
+
+        auto frame{ seal_frame( m_keys.front(), i_type, i_plain, i_clear ) };
+
+        write_exact( m_file->fd.get(), frame.data(), frame.size(), m_end );
+
+        auto location{ record_location_s{ m_end, static_cast<uint32_t>( frame.size() ), m_keys.front().id } };
+        m_end += location.size;
+
+        return location;
+    }
+
+
+    /**
+     * @brief Encrypt an entry under a key into a complete frame
+     *
+     */
+    sealed_entry_s seal_entry( const key_s& i_key,
+                               std::string_view i_name,
+                               std::string_view i_secret,
+                               const version_vector_t& i_versions ) const
+    {
+        auto plain{ byte_writer{} };
+        plain.put_string( i_name ).put( static_cast<uint16_t>( i_versions.size() ) );
+
+        for( auto&& [replica, counter] : i_versions )
+        {
+            plain.put( replica ).put( counter );
+        }
+
+        plain.put_bytes( i_secret.data(), i_secret.size() );
+
+        auto sealed{ sealed_entry_s{ blind_index( i_key.index_key, i_name ) } };
+        auto clear{ std::string_view{ reinterpret_cast<const char*>( sealed.index.data() ), blind_index_size } };
+
+        sealed.frame = seal_frame( i_key, frame_type::entry, plain.bytes(), clear );
+        sealed.key = i_key.id;
+
+        if( m_keys.size() > 1 && i_key.id == m_keys.front().id )
+        {
+            sealed.retired = blind_index( m_keys.back().index_key, i_name );
+        }
+
+        wipe_bytes( plain.bytes().data(), plain.bytes().size() );
+
+        return sealed;
+    }
+
+
+    void append_entry( std::string_view i_name, std::string_view i_secret, const version_vector_t& i_versions )
+    {
+        auto sealed{ seal_entry( m_keys.front(), i_name, i_secret, i_versions ) };
+        auto index{ sealed.index };
+
+        write_exact( m_file->fd.get(), sealed.frame.data(), sealed.frame.size(), m_end );
+
+        index_sealed( sealed );
+        m_cache.put( index, i_secret );
+    }
+
+
+    /**
+     * @brief Index an entry just written at the end of the log, replacing the record of its name under a retiring key
+     *
+     */
+    void index_sealed( const sealed_entry_s& i_entry )
+    {
+        if( i_entry.retired )
+        {
+            m_index.erase( *i_entry.retired );
+            m_tree.erase( *i_entry.retired );
+            m_cache.erase( *i_entry.retired );
+        }
+
+        m_index[i_entry.index] = record_location_s{ m_end, static_cast<uint32_t>( i_entry.frame.size() ), i_entry.key };
+        m_tree.set( i_entry.index, record_digest( i_entry.frame ) );
+        m_cache.erase( i_entry.index );
+
+        m_end += i_entry.frame.size();
+        ++m_tail_records;
+    }
+
+
+    /**
+     * @brief Read a whole frame with one pread and check its header
+     *
+     */
+    std::string read_frame( const record_location_s& i_location, frame_type i_type ) const
+    {
+        if( i_location.size < frame_header_size + clear_prefix_size( i_type ) + encryption::aead_overhead )
+        {
+            throw vault_error{ "Corrupt vault record" };
+        }
+
+        auto bytes{ std::string( i_location.size, '\0' ) };
+        read_exact( m_file->fd.get(), bytes.data(), bytes.size(), i_location.offset );
+
+        auto header{ frame_header_s::parse( bytes ) };
+
+        if( header.type != i_type || frame_header_size + header.length != i_location.size )
+        {
+            throw vault_error{ "Corrupt vault record" };
+        }
+
+        return bytes;
+    }
+
+
+    /**
+     * @brief Decrypt a frame read by read_frame; the header and clear prefix are the associated data
+     *
+     */
+    std::string open_sealed( std::string_view i_bytes, frame_type i_type ) const
+    {
+        auto associated_size{ frame_header_size + clear_prefix_size( i_type ) };
+        auto& key{ key_for( frame_header_s::parse( i_bytes ).key ) };
+
+        auto plain{ std::string{} };
+
+        if( !encryption::aead_open( key.key,
+                                    i_bytes.substr( 0, associated_size ),
+                                    reinterpret_cast<const uint8_t*>( i_bytes.data() + associated_size ),
+                                    i_bytes.size() - associated_size,
+                                    plain ) )
+        {
+            throw vault_error{ "Vault record failed authentication" };
+        }
+
+        return plain;
+    }
+
+
+    std::string open_frame( const record_location_s& i_location, frame_type i_type ) const
+    {
+        return open_sealed( read_frame( i_location, i_type ), i_type );
+    }
+
+
+    static uint64_t clear_prefix_size( frame_type i_type ) noexcept
+    {
+        return i_type == frame_type::entry ? blind_index_size : 0_ui64;
+    }
+
+
+    /**
+     * @brief Read and decrypt one entry
+     *
+     */
+    entry_s read_entry( const record_location_s& i_location ) const
+    {
+        return parse_entry( read_frame( i_location, frame_type::entry ) );
+    }
+
+
+    /**
+     * @brief Decrypt an entry frame read by read_frame
+     *
+     */
+    entry_s parse_entry( std::string_view i_bytes ) const
+    {
+        auto plain{ open_sealed( i_bytes, frame_type::entry ) };
+
+        auto entry{ entry_s{} };
+        std::copy_n( i_bytes.data() + frame_header_size, blind_index_size, entry.index.begin() );
+
+        auto reader{ byte_reader{ plain } };
+        entry.name = reader.get_string();
+        entry.versions.resize( reader.get<uint16_t>() );
+
+        for( auto&& [replica, counter] : entry.versions )
+        {
+            replica = reader.get<uint64_t>();
+            counter = reader.get<uint64_t>();
+        }
+
+        entry.secret = reader.rest();
+        wipe_bytes( plain.data(), plain.size() );
+
+        return entry;
+    }
+
+
+    /**
+     * @brief Version vector of the entry at a location, without keeping its secret
+     *
+     * A damaged record counts as never updated, so whatever replaces it descends from it.
+     */
+    version_vector_t read_versions( const record_location_s& i_location ) const
+    {
+        auto entry{ entry_s{} };
+
+        try
+        {
+            entry = read_entry( i_location );
+        }
+        catch( const vault_error& )
+        {
+            return {};
+        }
+
+        wipe_bytes( entry.secret.data(), entry.secret.size() );
+
+        return std::move( entry.versions );
+    }
+
+
+    /**
+     * @brief Decrypt an entry frame that came from outside this handle, checking it is whole and that its blind
+     *        index is the one of its name
+     *
+     */
+    entry_s check_record( std::string_view i_frame ) const
+    {
+        if( i_frame.size() < frame_header_size + blind_index_size + encryption::aead_overhead )
+        {
+            throw vault_error{ "Corrupt replica record" };
+        }
+
+        auto header{ frame_header_s::parse( i_frame ) };
+
+        if( header.type != frame_type::entry || frame_header_size + header.length != i_frame.size() )
+        {
+            throw vault_error{ "Corrupt replica record" };
+        }
+
+        auto entry{ parse_entry( i_frame ) };
+
+        if( entry.index != blind_index( key_for( header.key ).index_key, entry.name ) )
+        {
+            throw vault_error{ "Replica record is filed under the wrong blind index" };
+        }
+
+        return entry;
+    }
+};
+
+}
@@ -0,0 +1,819 @@
+/**
+ * @file vault_agent.hpp
+ * @author ashwinn76
+ * @brief Resident agent holding an unlocked vault and answering requests over a Unix-domain socket
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Protocol: every message is a u32 body length followed by the body. A request body is the operation (a mode value,
+ * agent_lock_op or agent_check_op), the u64 device and u64 inode of the vault the client means, the u16-prefixed entry
+ * name and the secret for put and update. A search sends the query in
+ * place of the name, then a u8 distance, a u8 prefix flag and a u16 limit. A response body is an agent_status
+ * followed by the secret, the matches (u16 count, then each u16-prefixed name and its u8 distance) or an error
+ * message.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "name_search.hpp"
+#include "plaintext_cache.hpp"
+#include "vault_io.hpp"
+
+namespace vault
+{
+/**
+ * @brief Operation requested from a vault
+ *
+ */
+enum class mode : uint8_t
+{
+    get,
+    put,
+    update,
+    bulk_import,
+    bulk_export,
+    rotate_key,
+    compact,
+    stats,
+    sync,
+    backup,
+    restore,
+    search,
+};
+
+
+/**
+ * @brief Outcome of an agent request
+ *
+ */
+enum class agent_status : uint8_t
+{
+    ok = 0,
+    not_found = 1,
+    error = 2,
+    wrong_vault = 3,
+};
+
+
+namespace
+{
+constexpr auto agent_lock_op = uint8_t{ 0xFF };
+
+constexpr auto agent_check_op = uint8_t{ 0xFE };
+
+constexpr auto agent_request_timeout = std::chrono::milliseconds{ 5000 };
+
+constexpr auto max_agent_message = 1_ui32 << 20;
+
+constexpr auto agent_cache_bytes = 256_sz * 1024;
+
+constexpr auto agent_backlog = 16;
+
+
+/**
+ * @brief Overwrite a string holding key material or a secret before releasing it
+ *
+ */
+inline void wipe( std::string& io_data ) noexcept
+{
+    wipe_bytes( io_data.data(), io_data.size() );
+    io_data.clear();
+}
+
+
+inline void send_all( int i_fd, std::string_view i_data )
+{
+    while( !i_data.empty() )
+    {
+        auto sent{ ::send( i_fd, i_data.data(), i_data.size(), MSG_NOSIGNAL ) };
+
+        if( sent < 0 )
+        {
+            if( errno == EINTR )
+            {
+                continue;
+            }
+
+            throw vault_error{ std::string{ "Unable to write to agent socket: " } + std::strerror( errno ) };
+        }
+
+        i_data.remove_prefix( static_cast<std::size_t>( sent ) );
+    }
+}
+
+
+/**
+ * @brief Receive exactly a number of bytes
+ *
+ * @return false on a clean end of stream before the first byte
+ */
+inline bool receive_exact( int i_fd, char* o_data, std::size_t i_size )
+{
+    auto done{ 0_sz };
+
+    while( done < i_size )
+    {
+        auto received{ ::recv( i_fd, o_data + done, i_size - done, 0 ) };
+
+        if( received == 0 && done == 0 )
+        {
+            return false;
+        }
+
+        if( received <= 0 )
+        {
+            if( received < 0 && errno == EINTR )
+            {
+                continue;
+            }
+
+            throw vault_error{ "Agent connection closed unexpectedly" };
+        }
+
+        done += static_cast<std::size_t>( received );
+    }
+
+    return true;
+}
+
+
+inline void send_message( int i_fd, std::string_view i_body )
+{
+    auto writer{ byte_writer{} };
+    writer.put( static_cast<uint32_t>( i_body.size() ) ).put_bytes( i_body.data(), i_body.size() );
+
+    send_all( i_fd, writer.bytes() );
+}
+
+
+inline std::optional<std::string> receive_message( int i_fd )
+{
+    auto length_bytes{ std::string( sizeof( uint32_t ), '\0' ) };
+
+    if( !receive_exact( i_fd, length_bytes.data(), length_bytes.size() ) )
+    {
+        return std::nullopt;
+    }
+
+    auto length{ byte_reader{ length_bytes }.get<uint32_t>() };
+
+    if( length > max_agent_message )
+    {
+        throw vault_error{ "Agent message too large" };
+    }
+
+    auto body{ std::string( length, '\0' ) };
+
+    if( length != 0 && !receive_exact( i_fd, body.data(), body.size() ) )
+    {
+        throw vault_error{ "Agent connection closed unexpectedly" };
+    }
+
+    return body;
+}
+
+
+/**
+ * @brief Device and inode of a vault file, the same however the path to it is spelled
+ *
+ */
+inline std::pair<uint64_t, uint64_t> vault_identity( const std::string& i_path )
+{
+    struct stat status{};
+
+    if( ::stat( i_path.c_str(), &status ) != 0 )
+    {
+        throw vault_error{ "Unable to read " + i_path + ": " + std::strerror( errno ) };
+    }
+
+    return { static_cast<uint64_t>( status.st_dev ), static_cast<uint64_t>( status.st_ino ) };
+}
+
+
+inline sockaddr_un socket_address( const std::string& i_path )
+{
+    auto address{ sockaddr_un{} };
+    address.sun_family = AF_UNIX;
+
+    if( i_path.size() >= sizeof( address.sun_path ) )
+    {
+        throw vault_error{ "Agent socket path too long: " + i_path };
+    }
+
+    std::copy( i_path.begin(), i_path.end(), address.sun_path );
+
+    return address;
+}
+
+}
+
+
+/**
+ * @brief Agent serving one open vault until it is locked explicitly or stays idle too long
+ *
+ * Works with any store offering get, put, update, flush and refresh, and load_names for search. Connections are only
+ * accepted from processes running as the same user, and each has to finish a request within agent_request_timeout so
+ * a stalled client cannot hold up the others. Every request first picks up what other handles published, so the
+ * cached secrets and the name index for search never outlive a change made without the agent.
+ */
+template<typename _Vault>
+class agent_server
+{
+public:
+    /**
+     * @brief Listen on a socket for an unlocked vault
+     *
+     * @param i_socket_path socket to create, replaced if it exists
+     * @param i_vault_path file of the vault, which requests for any other vault are refused against
+     * @param io_store unlocked vault, must outlive the server
+     * @param i_idle_timeout lock after this long without a request
+     */
+    agent_server( std::string i_socket_path,
+                  std::string i_vault_path,
+                  _Vault& io_store,
+                  std::chrono::milliseconds i_idle_timeout ) :
+        m_socket_path{ std::move( i_socket_path ) },
+        m_vault_path{ std::move( i_vault_path ) },
+        m_store{ io_store },
+        m_idle_timeout{ i_idle_timeout },
+        m_cache{ agent_cache_bytes }
+    {
+        m_listener = unique_fd{ ::socket( AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0 ) };
+
+        if( !m_listener )
+        {
+            throw vault_error{ std::string{ "Unable to create agent socket: " } + std::strerror( errno ) };
+        }
+
+        auto address{ socket_address( m_socket_path ) };
+
+        ::unlink( m_socket_path.c_str() );
+
+        // create the socket owner-only so other users cannot connect at all
+        auto previous_mask{ ::umask( 0177 ) };
+        auto bound{ ::bind( m_listener.get(), reinterpret_cast<const sockaddr*>( &address ), sizeof( address ) ) };
+        ::umask( previous_mask );
+
+        if( bound != 0 || ::listen( m_listener.get(), agent_backlog ) != 0 )
+        {
+            throw vault_error{ std::string{ "Unable to listen on " } + m_socket_path + ": " + std::strerror( errno ) };
+        }
+    }
+
+
+    agent_server( const agent_server& ) = delete;
+    agent_server& operator=( const agent_server& ) = delete;
+
+
+    ~agent_server()
+    {
+        lock();
+    }
+
+
+    /**
+     * @brief Serve requests until locked
+     *
+     */
+    void run()
+    {
+        using clock = std::chrono::steady_clock;
+
+        auto idle_deadline{ clock::now() + m_idle_timeout };
+
+        while( m_listener )
+        {
+            auto now{ clock::now() };
+
+            if( now >= idle_deadline )
+            {
+                lock();
+                break;
+            }
+
+            auto wake{ idle_deadline };
+            auto waiting{ std::vector<pollfd>{ pollfd{ m_listener.get(), POLLIN, 0 } } };
+
+            for( auto&& connection : m_connections )
+            {
+                waiting.push_back( pollfd{ connection.fd.get(), POLLIN, 0 } );
+                wake = std::min( wake, connection.deadline );
+            }
+
+            // round up so a wake-up never comes just before the deadline it waits for
+            auto wait{ std::min( std::chrono::ceil<std::chrono::milliseconds>( wake - now ).count(),
+                                 static_cast<std::chrono::milliseconds::rep>( std::numeric_limits<int>::max() ) ) };
+            auto ready{ ::poll( waiting.data(), waiting.size(), static_cast<int>( wait ) ) };
+
+            if( ready < 0 )
+            {
+                if( errno == EINTR )
+                {
+                    continue;
+                }
+
+                throw vault_error{ std::string{ "Unable to wait for agent requests: " } + std::strerror( errno ) };
+            }
+
+            now = clock::now();
+
+            for( auto i{ 0_sz }; i < m_connections.size() && m_listener; ++i )
+            {
+                auto& connection{ m_connections[i] };
+
+                if( waiting[i + 1].revents != 0 && receive( connection ) )
+                {
+                    idle_deadline = clock::now() + m_idle_timeout;
+                }
+                else if( connection.deadline <= now )
+                {
+                    connection.fd.reset();
+                }
+            }
+
+            m_connections.erase( std::remove_if( m_connections.begin(),
+                                                 m_connections.end(),
+                                                 []( const connection_s& i_connection ) { return !i_connection.fd; } ),
+                                 m_connections.end() );
+
+            if( m_listener && ( waiting[0].revents & POLLIN ) != 0 )
+            {
+                accept( now );
+            }
+        }
+
+        m_connections.clear();
+    }
+
+
+    /**
+     * @brief Stop listening and wipe cached secrets
+     *
+     */
+    void lock() noexcept
+    {
+        m_cache.clear();
+        m_names.clear();
+        m_names_loaded = false;
+
+        if( m_listener )
+        {
+            m_listener.reset();
+            ::unlink( m_socket_path.c_str() );
+        }
+    }
+
+
+    /**
+     * @brief Whether the agent still accepts requests
+     *
+     */
+    bool unlocked() const noexcept
+    {
+        return static_cast<bool>( m_listener );
+    }
+
+private:
+    struct connection_s
+    {
+        unique_fd fd{};
+
+        std::string pending{};  // bytes of a request not received in full yet
+
+        std::chrono::steady_clock::time_point deadline{};  // dropped unless the next request is in by then
+
+        connection_s() = default;
+        connection_s( connection_s&& ) = default;
+        connection_s& operator=( connection_s&& ) = default;
+
+        ~connection_s()
+        {
+            wipe( pending );
+        }
+    };
+
+
+    std::string m_socket_path{};
+
+    std::string m_vault_path{};
+
+    _Vault& m_store;
+
+    std::chrono::milliseconds m_idle_timeout{};
+
+    unique_fd m_listener{};
+
+    std::vector<connection_s> m_connections{};
+
+    plaintext_cache<std::string> m_cache;  // hot records, written through on put and update
+
+    name_index m_names{};  // every entry name, for search
+
+    bool m_names_loaded{ false };
+
+
+    static bool same_user( int i_fd ) noexcept
+    {
+        auto credentials{ ucred{} };
+        auto size{ socklen_t{ sizeof( credentials ) } };
+
+        return ::getsockopt( i_fd, SOL_SOCKET, SO_PEERCRED, &credentials, &size ) == 0 && credentials.uid == ::getuid();
+    }
+
+
+    void accept( std::chrono::steady_clock::time_point i_now )
+    {
+        auto fd{ unique_fd{ ::accept4( m_listener.get(), nullptr, nullptr, SOCK_CLOEXEC ) } };
+
+        if( !fd || !same_user( fd.get() ) )
+        {
+            return;
+        }
+
+        // a client that stops reading its answers only stalls the agent this long
+        auto timeout{ timeval{} };
+        timeout.tv_sec = static_cast<time_t>( agent_request_timeout.count() / 1000 );
+        timeout.tv_usec = static_cast<suseconds_t>( ( agent_request_timeout.count() % 1000 ) * 1000 );
+        ::setsockopt( fd.get(), SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof( timeout ) );
+
+        auto connection{ connection_s{} };
+        connection.fd = std::move( fd );
+        connection.deadline = i_now + agent_request_timeout;
+
+        m_connections.push_back( std::move( connection ) );
+    }
+
+
+    /**
+     * @brief Take what a client sent without waiting for more, and answer every request received in full
+     *
+     * @return true if a request was answered
+     */
+    bool receive( connection_s& io_connection )
+    {
+        auto chunk{ std::array<char, 4096>{} };
+        auto received{ ::recv( io_connection.fd.get(), chunk.data(), chunk.size(), MSG_DONTWAIT ) };
+
+        if( received < 0 && ( errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK ) )
+        {
+            return false;
+        }
+
+        if( received <= 0 )
+        {
+            io_connection.fd.reset();
+            return false;
+        }
+
+        io_connection.pending.append( chunk.data(), static_cast<std::size_t>( received ) );
+        wipe_bytes( chunk.data(), chunk.size() );
+
+        auto answered{ false };
+
+        while( m_listener && io_connection.pending.size() >= sizeof( uint32_t ) )
+        {
+            auto length{ byte_reader{ io_connection.pending }.get<uint32_t>() };
+
+            if( length > max_agent_message )
+            {
+                io_connection.fd.reset();
+                break;
+            }
+
+            if( io_connection.pending.size() < sizeof( uint32_t ) + length )
+            {
+                break;
+            }
+
+            auto request{ io_connection.pending.substr( sizeof( uint32_t ), length ) };
+            auto rest{ io_connection.pending.substr( sizeof( uint32_t ) + length ) };
+
+            wipe( io_connection.pending );
+            io_connection.pending = std::move( rest );
+
+            try
+            {
+                send_message( io_connection.fd.get(), answer( request ) );
+            }
+            catch( const vault_error& )
+            {
+                // a broken client only loses its own connection
+                io_connection.fd.reset();
+            }
+
+            wipe( request );
+            answered = true;
+
+            if( !io_connection.fd )
+            {
+                break;
+            }
+
+            io_connection.deadline = std::chrono::steady_clock::now() + agent_request_timeout;
+        }
+
+        return answered;
+    }
+
+
+    std::string answer( std::string_view i_request )
+    {
+        auto response{ byte_writer{} };
+
+        try
+        {
+            auto reader{ byte_reader{ i_request } };
+            auto op{ reader.get<uint8_t>() };
+            auto device{ reader.get<uint64_t>() };
+            auto inode{ reader.get<uint64_t>() };
+
+            // the path is looked up again each time, as compaction and restore put a new file in its place
+            if( vault_identity( m_vault_path ) != std::pair{ device, inode } )
+            {
+                response.put( static_cast<uint8_t>( agent_status::wrong_vault ) );
+                return response.bytes();
+            }
+
+            if( op == agent_lock_op )
+            {
+                lock();
+                response.put( static_cast<uint8_t>( agent_status::ok ) );
+                return response.bytes();
+            }
+
+            if( op == agent_check_op )
+            {
+                response.put( static_cast<uint8_t>( agent_status::ok ) );
+                return response.bytes();
+            }
+
+            // pick up imports, rotations and other changes made without the agent before answering from the cache
+            if( m_store.refresh() )
+            {
+                m_cache.clear();
+                m_names.clear();
+                m_names_loaded = false;
+            }
+
+            auto name{ std::string{ reader.get_string() } };
+
+            switch( static_cast<mode>( op ) )
+            {
+            case mode::get:
+            {
+                auto secret{ cached_get( name ) };
+
+                if( !secret )
+                {
+                    response.put( static_cast<uint8_t>( agent_status::not_found ) );
+                    break;
+                }
+
+                response.put( static_cast<uint8_t>( agent_status::ok ) ).put_bytes( secret->data(), secret->size() );
+                break;
+            }
+            case mode::put:
+            case mode::update:
+            {
+                auto secret{ reader.rest() };
+
+                if( static_cast<mode>( op ) == mode::put )
+                {
+                    m_store.put( name, secret );
+                }
+                else
+                {
+                    m_store.update( name, secret );
+                }
+
+                m_store.flush();
+                m_cache.put( name, secret );
+
+                if( m_names_loaded )
+                {
+                    m_names.insert( name );
+                }
+
+                response.put( static_cast<uint8_t>( agent_status::ok ) );
+                break;
+            }
+            case mode::search:
+            {
+                auto options{ name_search_options_s{} };
+                options.max_distance = reader.get<uint8_t>();
+                options.prefix = reader.get<uint8_t>() != 0;
+                options.limit = reader.get<uint16_t>();
+
+                if( !m_names_loaded )
+                {
+                    load_names( m_store, m_names );
+                    m_names_loaded = true;
+                }
+
+                auto matches{ m_names.search( name, options ) };
+
+                response.put( static_cast<uint8_t>( agent_status::ok ) ).put( static_cast<uint16_t>( matches.size() ) );
+
+                for( auto&& match : matches )
+                {
+                    response.put_string( match.name ).put( static_cast<uint8_t>( match.distance ) );
+                }
+
+                break;
+            }
+            default:
+                throw vault_error{ "Unknown agent operation" };
+            }
+        }
+        catch( const std::exception& e )
+        {
+            auto message{ std::string_view{ e.what() } };
+
+            response = byte_writer{};
+            response.put( static_cast<uint8_t>( agent_status::error ) ).put_bytes( message.data(), message.size() );
+        }
+
+        return response.bytes();
+    }
+
+
+    std::optional<std::string> cached_get( const std::string& i_name )
+    {
+        if( auto secret{ m_cache.get( i_name ) } )
+        {
+            return secret;
+        }
+
+        auto secret{ m_store.get( i_name ) };
+
+        if( secret )
+        {
+            m_cache.put( i_name, *secret );
+        }
+
+        return secret;
+    }
+};
+
+
+/**
+ * @brief Client side of the agent protocol
+ *
+ */
+class agent_client
+{
+public:
+    /**
+     * @brief Connect to a running agent holding a vault
+     *
+     * @param i_socket_path agent socket
+     * @param i_vault_path vault the requests are meant for
+     * @throw vault_error if no agent listens on the socket or it holds another vault
+     */
+    agent_client( const std::string& i_socket_path, const std::string& i_vault_path ) :
+        m_vault{ vault_identity( i_vault_path ) }
+    {
+        m_fd = unique_fd{ ::socket( AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0 ) };
+
+        auto address{ socket_address( i_socket_path ) };
+
+        if( !m_fd || ::connect( m_fd.get(), reinterpret_cast<const sockaddr*>( &address ), sizeof( address ) ) != 0 )
+        {
+            throw vault_error{ "No agent listening on " + i_socket_path };
+        }
+
+        request( agent_check_op, {}, {} );
+    }
+
+
+    /**
+     * @brief Get a secret through the agent
+     *
+     * @return secret, nothing if the entry does not exist
+     */
+    std::optional<std::string> get( std::string_view i_name )
+    {
+        auto [status, payload] = request( static_cast<uint8_t>( mode::get ), i_name, {} );
+
+        if( status == agent_status::not_found )
+        {
+            return std::nullopt;
+        }
+
+        return payload;
+    }
+
+
+    void put( std::string_view i_name, std::string_view i_secret )
+    {
+        request( static_cast<uint8_t>( mode::put ), i_name, i_secret );
+    }
+
+
+    void update( std::string_view i_name, std::string_view i_secret )
+    {
+        request( static_cast<uint8_t>( mode::update ), i_name, i_secret );
+    }
+
+
+    /**
+     * @brief Search the entry names held by the agent
+     *
+     */
+    std::vector<name_match_s> search( std::string_view i_query, const name_search_options_s& i_options )
+    {
+        auto parameters{ byte_writer{} };
+        parameters.put( static_cast<uint8_t>( std::min( i_options.max_distance, 0xFF_ui32 ) ) )
+            .put( static_cast<uint8_t>( i_options.prefix ) )
+            .put( static_cast<uint16_t>( std::min( i_options.limit, 0xFFFF_sz ) ) );
+
+        auto [status, payload] = request( static_cast<uint8_t>( mode::search ), i_query, parameters.bytes() );
+
+        auto reader{ byte_reader{ payload } };
+        auto matches{ std::vector<name_match_s>( reader.get<uint16_t>() ) };
+
+        for( auto&& match : matches )
+        {
+            match.name = reader.get_string();
+            match.distance = reader.get<uint8_t>();
+        }
+
+        return matches;
+    }
+
+
+    /**
+     * @brief Nothing to do, the agent commits every write before answering
+     *
+     */
+    void flush() noexcept
+    {
+    }
+
+
+    /**
+     * @brief Ask the agent to wipe its state and exit
+     *
+     */
+    void lock()
+    {
+        request( agent_lock_op, {}, {} );
+    }
+
+private:
+    unique_fd m_fd{};
+
+    std::pair<uint64_t, uint64_t> m_vault{};  // device and inode of the vault file
+
+
+    std::pair<agent_status, std::string> request( uint8_t i_op, std::string_view i_name, std::string_view i_secret )
+    {
+        auto writer{ byte_writer{} };
+        writer.put( i_op ).put( m_vault.first ).put( m_vault.second ).put_string( i_name );
+        writer.put_bytes( i_secret.data(), i_secret.size() );
+
+        send_message( m_fd.get(), writer.bytes() );
+
+        auto response{ receive_message( m_fd.get() ) };
+
+        if( !response )
+        {
+            throw vault_error{ "Agent closed the connection" };
+        }
+
+        auto reader{ byte_reader{ *response } };
+        auto status{ static_cast<agent_status>( reader.get<uint8_t>() ) };
+        auto payload{ std::string{ reader.rest() } };
+
+        if( status == agent_status::error )
+        {
+            throw vault_error{ payload };
+        }
+
+        if( status == agent_status::wrong_vault )
+        {
+            throw vault_error{ "The agent holds another vault" };
+        }
+
+        return { status, std::move( payload ) };
+    }
+};
+
+}
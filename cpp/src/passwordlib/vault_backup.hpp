@@ -0,0 +1,666 @@
+/**
+ * @file vault_backup.hpp
+ * @author ashwinn76
+ * @brief Incremental, deduplicated and encrypted backups of a vault file split into content-defined chunks
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * A backup directory holds a config file, a chunks/ tree and a snapshots/ directory. The config salts the backup key,
+ * which is derived from the master key and keeps working after the vault is lost. Each snapshot is a sealed manifest
+ * listing the chunks of one committed copy of the vault file. Chunks are named by a keyed hash of their contents and
+ * sealed on their own, so a chunk already in the directory is never written again.
+ *
+ * The header of the vault file is a chunk of its own and the log behind it is cut by FastCDC: a gear rolling hash,
+ * with a gear table derived from the backup key so chunk boundaries reveal nothing about the contents, and normalised
+ * chunking around the average size. A boundary depends only on the bytes just before it, so edits and compactions
+ * only disturb the chunks they touch. The log is append-only, so when the previous snapshot came from the same log
+ * its chunks are reused as they are and only the tail written since then is read and chunked.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <ctime>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "vault.hpp"
+
+namespace vault
+{
+/**
+ * @brief Options for opening or creating a backup directory
+ *
+ */
+struct backup_options_s
+{
+    uint32_t kdf_iterations{ 200000_ui32 };  // PBKDF2 iterations used when creating a backup directory
+};
+
+
+/**
+ * @brief What one backup stored
+ *
+ */
+struct backup_stats_s
+{
+    std::string snapshot{};  // name of the new snapshot
+    uint64_t bytes{ 0_ui64 };  // size of the vault copy
+    std::size_t chunks{ 0_sz };  // chunks the copy is made of
+    std::size_t new_chunks{ 0_sz };  // chunks that were not in the directory yet
+    uint64_t new_bytes{ 0_ui64 };  // plaintext bytes of the new chunks
+    uint64_t reused_bytes{ 0_ui64 };  // log bytes taken over from the previous snapshot without reading them
+};
+
+
+namespace
+{
+constexpr auto backup_magic = std::string_view{ "PWBACKUP" };
+
+constexpr auto backup_format_version = 1_ui32;
+
+constexpr auto chunk_id_size = 16_sz;
+
+constexpr auto min_chunk_size = 2_sz * 1024;
+
+constexpr auto average_chunk_size = 8_sz * 1024;
+
+constexpr auto max_chunk_size = 64_sz * 1024;
+
+// normalised chunking: a harder cut condition before the average size and an easier one after it
+constexpr auto small_chunk_mask = ~0_ui64 << ( 64 - 15 );
+
+constexpr auto large_chunk_mask = ~0_ui64 << ( 64 - 11 );
+
+
+using chunk_id_t = std::array<uint8_t, chunk_id_size>;
+
+using gear_table_t = std::array<uint64_t, 256>;
+
+
+inline std::string to_hex( const uint8_t* i_data, std::size_t i_size )
+{
+    constexpr auto digits = std::string_view{ "0123456789abcdef" };
+
+    auto hex{ std::string{} };
+
+    for( auto i{ 0_sz }; i < i_size; ++i )
+    {
+        hex += digits[i_data[i] >> 4];
+        hex += digits[i_data[i] & 0xF];
+    }
+
+    return hex;
+}
+
+
+inline void make_directory( const std::string& i_path )
+{
+    if( ::mkdir( i_path.c_str(), 0700 ) != 0 && errno != EEXIST )
+    {
+        throw vault_error{ "Unable to create " + i_path + ": " + std::strerror( errno ) };
+    }
+}
+
+
+inline bool path_exists( const std::string& i_path ) noexcept
+{
+    struct stat status{};
+    return ::stat( i_path.c_str(), &status ) == 0;
+}
+
+
+inline std::string read_file( const std::string& i_path )
+{
+    auto fd{ unique_fd::open( i_path, O_RDONLY ) };
+
+    auto bytes{ std::string( file_size( fd.get() ), '\0' ) };
+    read_exact( fd.get(), bytes.data(), bytes.size(), 0_ui64 );
+
+    return bytes;
+}
+
+
+/**
+ * @brief Write a file under a temporary name, sync it and rename it into place, so it appears whole or not at all
+ *
+ */
+inline void write_file_atomically( const std::string& i_path, std::string_view i_bytes )
+{
+    auto temporary{ i_path + ".tmp" };
+
+    {
+        auto fd{ unique_fd::open( temporary, O_WRONLY | O_CREAT | O_TRUNC ) };
+        write_exact( fd.get(), i_bytes.data(), i_bytes.size(), 0_ui64 );
+        sync_data( fd.get() );
+    }
+
+    if( ::rename( temporary.c_str(), i_path.c_str() ) != 0 )
+    {
+        throw vault_error{ "Unable to write " + i_path + ": " + std::strerror( errno ) };
+    }
+}
+
+}
+
+
+/**
+ * @brief FastCDC chunk boundaries under a keyed gear table
+ *
+ */
+class content_chunker
+{
+public:
+    explicit content_chunker( const gear_table_t& i_gear ) noexcept : m_gear{ i_gear }
+    {
+    }
+
+
+    /**
+     * @brief Length of the first chunk of some data
+     *
+     * @param i_data data starting at a chunk boundary
+     * @param i_final whether the data runs to the end of the stream; otherwise it must hold at least a maximum chunk
+     * @return chunk length
+     */
+    std::size_t cut( std::string_view i_data, bool i_final ) const noexcept
+    {
+        if( i_final && i_data.size() <= min_chunk_size )
+        {
+            return i_data.size();
+        }
+
+        auto normal{ std::min( average_chunk_size, i_data.size() ) };
+        auto end{ std::min( max_chunk_size, i_data.size() ) };
+        auto hash{ 0_ui64 };
+        auto i{ min_chunk_size };
+
+        for( ; i < normal; ++i )
+        {
+            hash = ( hash << 1 ) + m_gear[static_cast<uint8_t>( i_data[i] )];
+
+            if( ( hash & small_chunk_mask ) == 0 )
+            {
+                return i + 1;
+            }
+        }
+
+        for( ; i < end; ++i )
+        {
+            hash = ( hash << 1 ) + m_gear[static_cast<uint8_t>( i_data[i] )];
+
+            if( ( hash & large_chunk_mask ) == 0 )
+            {
+                return i + 1;
+            }
+        }
+
+        return end;
+    }
+
+private:
+    gear_table_t m_gear{};
+};
+
+
+/**
+ * @brief Directory of encrypted, deduplicated chunks and the snapshot manifests built from them
+ *
+ */
+class backup_store
+{
+public:
+    /**
+     * @brief Open a backup directory, creating it when it does not exist yet
+     *
+     * @param i_directory backup directory
+     * @param i_key master key
+     * @param i_options open options
+     */
+    backup_store( std::string i_directory, const encryption::encryption_key& i_key, backup_options_s i_options = {} ) :
+        m_directory{ std::move( i_directory ) }
+    {
+        make_directory( m_directory );
+        make_directory( m_directory + "/chunks" );
+        make_directory( m_directory + "/snapshots" );
+
+        auto config_path{ m_directory + "/config" };
+
+        if( !path_exists( config_path ) )
+        {
+            create_config( config_path, i_key, i_options );
+        }
+
+        auto config{ read_file( config_path ) };
+        auto reader{ byte_reader{ config } };
+
+        if( reader.get_bytes( backup_magic.size() ) != backup_magic )
+        {
+            throw vault_error{ m_directory + " is not a backup directory" };
+        }
+
+        if( reader.get<uint32_t>() != backup_format_version )
+        {
+            throw vault_error{ "Unsupported backup format version" };
+        }
+
+        auto iterations{ reader.get<uint32_t>() };
+        auto salt_bytes{ reader.get_bytes( salt_size ) };
+        auto check{ reader.get_bytes( key_check_size ) };
+
+        auto key{ derive_master_key( i_key, { salt_bytes.begin(), salt_bytes.end() }, iterations ) };
+        auto expected{ master_key_check( key ) };
+
+        if( check != std::string_view{ reinterpret_cast<const char*>( expected.data() ), key_check_size } )
+        {
+            throw vault_error{ "Wrong key for backup directory " + m_directory };
+        }
+
+        m_chunk_key = derive_subkey( key, "backup chunk" );
+        m_id_key = derive_subkey( key, "backup chunk id" );
+
+        auto gear_key{ derive_subkey( key, "backup gear" ) };
+
+        for( auto i{ 0_sz }; i < m_gear.size(); ++i )
+        {
+            auto byte{ static_cast<uint8_t>( i ) };
+            auto mac{ encryption::hmac_sha256::mac( gear_key.data(), gear_key.size(), &byte, 1 ) };
+
+            auto bytes{ std::string_view{ reinterpret_cast<const char*>( mac.data() ), sizeof( uint64_t ) } };
+
+            m_gear[i] = byte_reader{ bytes }.get<uint64_t>();
+        }
+    }
+
+
+    /**
+     * @brief Store a snapshot of the committed vault, writing only the chunks the directory does not hold yet
+     *
+     */
+    backup_stats_s backup( const vault& i_vault )
+    {
+        auto pinned{ i_vault.pin_committed() };
+        auto previous{ latest_manifest() };
+
+        auto stats{ backup_stats_s{} };
+        auto manifest{ manifest_s{ pinned.log_id, pinned.end } };
+
+        // the header changes with every commit, so it is a chunk of its own and the log chunks stay put
+        store_chunk( pinned.header, manifest, stats );
+
+        auto offset{ file_header_size };
+
+        if( previous && previous->log_id != 0 && previous->log_id == pinned.log_id && previous->end <= pinned.end &&
+            previous->chunks.size() > 1 )
+        {
+            // the same append-only log: its frames below the old end are unchanged. The last old chunk may have been
+            // cut by the end of the log rather than by its contents, so chunking resumes at its start
+            for( auto iter{ previous->chunks.begin() + 1 }; iter != previous->chunks.end() - 1; ++iter )
+            {
+                manifest.chunks.push_back( *iter );
+                offset += iter->second;
+            }
+
+            stats.reused_bytes = offset - file_header_size;
+        }
+
+        chunk_log( pinned, offset, manifest, stats );
+
+        for( auto&& directory : m_touched )
+        {
+            sync_parent_directory( directory + "/chunk" );
+        }
+
+        m_touched.clear();
+
+        stats.bytes = pinned.end;
+        stats.chunks = manifest.chunks.size();
+        stats.snapshot = write_manifest( manifest );
+
+        return stats;
+    }
+
+
+    /**
+     * @brief Rebuild the vault file of a snapshot, checking every chunk against its keyed hash
+     *
+     * @param i_snapshot snapshot name from snapshots
+     * @param i_target file to create, must not exist
+     */
+    void restore( const std::string& i_snapshot, const std::string& i_target ) const
+    {
+        auto manifest{ read_manifest( i_snapshot ) };
+        auto target{ unique_fd::open( i_target, O_WRONLY | O_CREAT | O_EXCL ) };
+
+        auto offset{ 0_ui64 };
+
+        for( auto&& [id, length] : manifest.chunks )
+        {
+            auto chunk{ load_chunk( id ) };
+
+            if( chunk.size() != length )
+            {
+                throw vault_error{ "Backup chunk " + to_hex( id.data(), id.size() ) + " has the wrong length" };
+            }
+
+            write_exact( target.get(), chunk.data(), chunk.size(), offset );
+            offset += chunk.size();
+        }
+
+        if( offset != manifest.end )
+        {
+            throw vault_error{ "Backup snapshot " + i_snapshot + " is incomplete" };
+        }
+
+        sync_data( target.get() );
+        sync_parent_directory( i_target );
+    }
+
+
+    /**
+     * @brief Names of the snapshots in the directory, oldest first
+     *
+     */
+    std::vector<std::string> snapshots() const
+    {
+        auto names{ std::vector<std::string>{} };
+        auto path{ m_directory + "/snapshots" };
+
+        auto directory{ ::opendir( path.c_str() ) };
+
+        if( !directory )
+        {
+            throw vault_error{ "Unable to list " + path + ": " + std::strerror( errno ) };
+        }
+
+        while( auto entry{ ::readdir( directory ) } )
+        {
+            auto name{ std::string{ entry->d_name } };
+
+            if( name.front() != '.' && name.find( ".tmp" ) == std::string::npos )
+            {
+                names.push_back( std::move( name ) );
+            }
+        }
+
+        ::closedir( directory );
+
+        std::sort( names.begin(), names.end() );
+
+        return names;
+    }
+
+
+    /**
+     * @brief Chunk boundaries this directory cuts at
+     *
+     */
+    content_chunker chunker() const noexcept
+    {
+        return content_chunker{ m_gear };
+    }
+
+private:
+    /**
+     * @brief Chunk list of one snapshot
+     *
+     */
+    struct manifest_s
+    {
+        uint64_t log_id{ 0_ui64 };
+        uint64_t end{ 0_ui64 };
+        std::vector<std::pair<chunk_id_t, uint32_t>> chunks{};  // id and length, in file order
+    };
+
+    std::string m_directory{};
+
+    encryption::aead_key_t m_chunk_key{};  // seals chunks and manifests
+
+    encryption::aead_key_t m_id_key{};  // keys the chunk ids, so they reveal nothing about the contents
+
+    gear_table_t m_gear{};
+
+    std::set<std::string> m_touched{};  // chunk directories written to since the last sync
+
+
+    void create_config( const std::string& i_path,
+                        const encryption::encryption_key& i_key,
+                        const backup_options_s& i_options ) const
+    {
+        auto salt{ std::vector<uint8_t>( salt_size ) };
+        encryption::random_bytes( salt.data(), salt.size() );
+
+        auto check{ master_key_check( derive_master_key( i_key, salt, i_options.kdf_iterations ) ) };
+
+        auto config{ byte_writer{} };
+        config.put_bytes( backup_magic.data(), backup_magic.size() ).put( backup_format_version );
+        config.put( i_options.kdf_iterations ).put_bytes( salt.data(), salt.size() );
+        config.put_bytes( check.data(), key_check_size );
+
+        write_file_atomically( i_path, config.bytes() );
+        sync_parent_directory( i_path );
+    }
+
+
+    chunk_id_t chunk_id( std::string_view i_chunk ) const
+    {
+        auto mac{ encryption::hmac_sha256::mac( m_id_key.data(), m_id_key.size(), i_chunk.data(), i_chunk.size() ) };
+
+        auto id{ chunk_id_t{} };
+        std::copy_n( mac.begin(), chunk_id_size, id.begin() );
+
+        return id;
+    }
+
+
+    std::string chunk_path( const chunk_id_t& i_id ) const
+    {
+        auto hex{ to_hex( i_id.data(), i_id.size() ) };
+        return m_directory + "/chunks/" + hex.substr( 0, 2 ) + "/" + hex;
+    }
+
+
+    /**
+     * @brief Add a chunk to a manifest, sealing it into the directory unless an identical one is there already
+     *
+     */
+    void store_chunk( std::string_view i_chunk, manifest_s& io_manifest, backup_stats_s& io_stats )
+    {
+        auto id{ chunk_id( i_chunk ) };
+        auto path{ chunk_path( id ) };
+
+        io_manifest.chunks.emplace_back( id, static_cast<uint32_t>( i_chunk.size() ) );
+
+        if( path_exists( path ) )
+        {
+            return;
+        }
+
+        auto directory{ path.substr( 0, path.rfind( '/' ) ) };
+        make_directory( directory );
+
+        auto sealed{ encryption::aead_seal(
+            m_chunk_key, { reinterpret_cast<const char*>( id.data() ), id.size() }, i_chunk ) };
+
+        write_file_atomically( path, { reinterpret_cast<const char*>( sealed.data() ), sealed.size() } );
+        m_touched.insert( directory );
+
+        ++io_stats.new_chunks;
+        io_stats.new_bytes += i_chunk.size();
+    }
+
+
+    std::string load_chunk( const chunk_id_t& i_id ) const
+    {
+        auto sealed{ read_file( chunk_path( i_id ) ) };
+        auto chunk{ std::string{} };
+
+        if( !encryption::aead_open( m_chunk_key,
+                                    { reinterpret_cast<const char*>( i_id.data() ), i_id.size() },
+                                    reinterpret_cast<const uint8_t*>( sealed.data() ),
+                                    sealed.size(),
+                                    chunk ) ||
+            chunk_id( chunk ) != i_id )
+        {
+            throw vault_error{ "Backup chunk " + to_hex( i_id.data(), i_id.size() ) + " failed authentication" };
+        }
+
+        return chunk;
+    }
+
+
+    /**
+     * @brief Cut the log from an offset into chunks and store them, reading it in large sequential pieces
+     *
+     */
+    void chunk_log( const committed_file_s& i_pinned,
+                    uint64_t i_offset,
+                    manifest_s& io_manifest,
+                    backup_stats_s& io_stats )
+    {
+        auto chunker{ content_chunker{ m_gear } };
+        auto buffer{ std::string{} };
+        auto start{ 0_sz };  // first byte of the buffer not yet chunked
+
+        for( auto offset{ i_offset }; offset < i_pinned.end || start < buffer.size(); )
+        {
+            // keep at least a maximum chunk buffered until the end of the log
+            if( offset < i_pinned.end && buffer.size() - start < max_chunk_size )
+            {
+                buffer.erase( 0, start );
+                start = 0;
+
+                auto piece{ std::min<uint64_t>( i_pinned.end - offset, 16 * max_chunk_size ) };
+                auto filled{ buffer.size() };
+
+                buffer.resize( filled + piece );
+                i_pinned.read( offset, buffer.data() + filled, piece );
+                offset += piece;
+
+                continue;
+            }
+
+            auto remaining{ std::string_view{ buffer }.substr( start ) };
+            auto length{ chunker.cut( remaining, offset == i_pinned.end ) };
+
+            store_chunk( remaining.substr( 0, length ), io_manifest, io_stats );
+            start += length;
+        }
+    }
+
+
+    std::optional<manifest_s> latest_manifest() const
+    {
+        auto names{ snapshots() };
+
+        if( names.empty() )
+        {
+            return std::nullopt;
+        }
+
+        return read_manifest( names.back() );
+    }
+
+
+    static std::string manifest_associated_data( const std::string& i_name )
+    {
+        return "backup manifest " + i_name;
+    }
+
+
+    /**
+     * @brief Seal a manifest under a new snapshot name, the time of the backup in UTC
+     *
+     * @return snapshot name
+     */
+    std::string write_manifest( const manifest_s& i_manifest ) const
+    {
+        auto plain{ byte_writer{} };
+        plain.put( i_manifest.log_id ).put( i_manifest.end ).put( static_cast<uint32_t>( i_manifest.chunks.size() ) );
+
+        for( auto&& [id, length] : i_manifest.chunks )
+        {
+            plain.put_bytes( id.data(), id.size() ).put( length );
+        }
+
+        auto now{ std::chrono::system_clock::now() };
+        auto name{ std::string{} };
+
+        // names sort in time order; a second backup within the same millisecond takes the next one
+        for( auto tick{ 0 }; name.empty() || path_exists( snapshot_path( name ) ); ++tick )
+        {
+            auto time{ now + std::chrono::milliseconds{ tick } };
+            auto seconds{ std::chrono::system_clock::to_time_t( time ) };
+            auto millis{ std::chrono::duration_cast<std::chrono::milliseconds>( time.time_since_epoch() ).count() };
+
+            auto calendar{ std::tm{} };
+            ::gmtime_r( &seconds, &calendar );
+
+            auto text{ std::array<char, 32>{} };
+            auto length{ std::strftime( text.data(), text.size(), "%Y%m%dT%H%M%S", &calendar ) };
+
+            auto fraction{ std::to_string( 1000 + millis % 1000 ).substr( 1 ) };
+            name = std::string{ text.data(), length } + "." + fraction + "Z";
+        }
+
+        auto sealed{ encryption::aead_seal( m_chunk_key, manifest_associated_data( name ), plain.bytes() ) };
+
+        auto path{ snapshot_path( name ) };
+
+        write_file_atomically( path, { reinterpret_cast<const char*>( sealed.data() ), sealed.size() } );
+        sync_parent_directory( path );
+
+        return name;
+    }
+
+
+    manifest_s read_manifest( const std::string& i_name ) const
+    {
+        auto sealed{ read_file( snapshot_path( i_name ) ) };
+        auto plain{ std::string{} };
+
+        if( !encryption::aead_open( m_chunk_key,
+                                    manifest_associated_data( i_name ),
+                                    reinterpret_cast<const uint8_t*>( sealed.data() ),
+                                    sealed.size(),
+                                    plain ) )
+        {
+            throw vault_error{ "Backup snapshot " + i_name + " failed authentication" };
+        }
+
+        auto reader{ byte_reader{ plain } };
+
+        auto manifest{ manifest_s{} };
+        manifest.log_id = reader.get<uint64_t>();
+        manifest.end = reader.get<uint64_t>();
+        manifest.chunks.resize( reader.get<uint32_t>() );
+
+        for( auto&& [id, length] : manifest.chunks )
+        {
+            auto id_bytes{ reader.get_bytes( chunk_id_size ) };
+            std::copy( id_bytes.begin(), id_bytes.end(), id.begin() );
+
+            length = reader.get<uint32_t>();
+        }
+
+        return manifest;
+    }
+
+
+    std::string snapshot_path( const std::string& i_name ) const
+    {
+        return m_directory + "/snapshots/" + i_name;
+    }
+};
+
+}
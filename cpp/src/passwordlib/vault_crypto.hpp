@@ -0,0 +1,114 @@
+/**
+ * @file vault_crypto.hpp
+ * @author ashwinn76
+ * @brief Key derivation and verification shared by the vault formats
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#include "chacha20_poly1305.hpp"
+#include "encryption_key.hpp"
+#include "sha256.hpp"
+
+namespace vault
+{
+constexpr auto salt_size = 16_sz;
+
+constexpr auto key_check_size = 16_sz;
+
+constexpr auto blind_index_size = 16_sz;
+
+
+/**
+ * @brief Keyed hash standing in for an entry name wherever the vault needs to find an entry without decrypting it
+ *
+ */
+using blind_index_t = std::array<uint8_t, blind_index_size>;
+
+
+/**
+ * @brief Hash for blind indexes; they are already uniformly distributed, so any eight bytes will do
+ *
+ */
+struct blind_index_hash
+{
+    std::size_t operator()( const blind_index_t& i_index ) const noexcept
+    {
+        auto value{ uint64_t{} };
+        std::memcpy( &value, i_index.data(), sizeof( value ) );
+
+        return static_cast<std::size_t>( value );
+    }
+};
+
+
+/**
+ * @brief Derive the vault key from the master key
+ *
+ * @param i_key master key
+ * @param i_salt per-vault salt
+ * @param i_iterations PBKDF2 iterations
+ * @return vault key
+ */
+inline encryption::aead_key_t derive_master_key( const encryption::encryption_key& i_key,
+                                                 const std::vector<uint8_t>& i_salt,
+                                                 uint32_t i_iterations )
+{
+    return encryption::pbkdf2_sha256( i_key.string(), i_salt, i_iterations );
+}
+
+
+/**
+ * @brief Derive a purpose-specific subkey so one vault key never serves two roles
+ *
+ * @param i_key vault key
+ * @param i_label purpose of the subkey
+ * @return subkey
+ */
+inline encryption::aead_key_t derive_subkey( const encryption::aead_key_t& i_key, std::string_view i_label )
+{
+    return encryption::hmac_sha256::mac( i_key.data(), i_key.size(), i_label.data(), i_label.size() );
+}
+
+
+/**
+ * @brief Value stored in a vault header to tell a wrong master key from a corrupt vault
+ *
+ * @param i_key vault key
+ * @return check bytes, of which the first key_check_size are stored
+ */
+inline encryption::digest_t master_key_check( const encryption::aead_key_t& i_key )
+{
+    return derive_subkey( i_key, "vault key check" );
+}
+
+
+/**
+ * @brief Blind index of an entry name
+ *
+ * @param i_index_key subkey reserved for blind indexes
+ * @param i_name entry name
+ * @return truncated HMAC of the name
+ */
+inline blind_index_t blind_index( const encryption::aead_key_t& i_index_key, std::string_view i_name )
+{
+    auto mac{ encryption::hmac_sha256::mac( i_index_key.data(), i_index_key.size(), i_name.data(), i_name.size() ) };
+
+    auto index{ blind_index_t{} };
+    std::copy( mac.begin(), mac.begin() + blind_index_size, index.begin() );
+
+    return index;
+}
+
+}
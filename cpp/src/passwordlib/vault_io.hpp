@@ -0,0 +1,608 @@
+/**
+ * @file vault_io.hpp
+ * @author ashwinn76
+ * @brief File and byte-level helpers shared by the vault formats
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "macro_utils.hpp"
+
+namespace vault
+{
+/**
+ * @brief Error raised for unreadable, corrupt or inaccessible vaults
+ *
+ */
+class vault_error : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
+
+/**
+ * @brief Owning file descriptor
+ *
+ */
+class unique_fd
+{
+public:
+    unique_fd() noexcept = default;
+
+    explicit unique_fd( int i_fd ) noexcept : m_fd{ i_fd }
+    {
+    }
+
+    unique_fd( unique_fd&& i_other ) noexcept : m_fd{ std::exchange( i_other.m_fd, -1 ) }
+    {
+    }
+
+    unique_fd& operator=( unique_fd&& i_other ) noexcept
+    {
+        if( this != &i_other )
+        {
+            reset( std::exchange( i_other.m_fd, -1 ) );
+        }
+
+        return *this;
+    }
+
+    unique_fd( const unique_fd& ) = delete;
+    unique_fd& operator=( const unique_fd& ) = delete;
+
+    ~unique_fd()
+    {
+        reset();
+    }
+
+
+    /**
+     * @brief Open a file, throwing on failure
+     *
+     */
+    static unique_fd open( const std::string& i_path, int i_flags, mode_t i_mode = 0600 )
+    {
+        auto fd{ ::open( i_path.c_str(), i_flags | O_CLOEXEC, i_mode ) };
+
+        if( fd < 0 )
+        {
+            throw vault_error{ "Unable to open " + i_path + ": " + std::strerror( errno ) };
+        }
+
+        return unique_fd{ fd };
+    }
+
+
+    void reset( int i_fd = -1 ) noexcept
+    {
+        if( m_fd >= 0 )
+        {
+            ::close( m_fd );
+        }
+
+        m_fd = i_fd;
+    }
+
+    int get() const noexcept
+    {
+        return m_fd;
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return m_fd >= 0;
+    }
+
+private:
+    int m_fd{ -1 };
+};
+
+
+/**
+ * @brief Read exactly i_size bytes at an offset
+ *
+ */
+inline void read_exact( int i_fd, void* o_data, std::size_t i_size, uint64_t i_offset )
+{
+    auto bytes{ static_cast<char*>( o_data ) };
+
+    while( i_size > 0 )
+    {
+        auto got{ ::pread( i_fd, bytes, i_size, static_cast<off_t>( i_offset ) ) };
+
+        if( got < 0 && errno == EINTR )
+        {
+            continue;
+        }
+
+        if( got <= 0 )
+        {
+            throw vault_error{ "Unexpected end of vault file" };
+        }
+
+        bytes += got;
+        i_size -= static_cast<std::size_t>( got );
+        i_offset += static_cast<uint64_t>( got );
+    }
+}
+
+
+/**
+ * @brief Write exactly i_size bytes at an offset
+ *
+ */
+inline void write_exact( int i_fd, const void* i_data, std::size_t i_size, uint64_t i_offset )
+{
+    auto bytes{ static_cast<const char*>( i_data ) };
+
+    while( i_size > 0 )
+    {
+        auto put{ ::pwrite( i_fd, bytes, i_size, static_cast<off_t>( i_offset ) ) };
+
+        if( put < 0 && errno == EINTR )
+        {
+            continue;
+        }
+
+        if( put <= 0 )
+        {
+            throw vault_error{ std::string{ "Unable to write vault file: " } + std::strerror( errno ) };
+        }
+
+        bytes += put;
+        i_size -= static_cast<std::size_t>( put );
+        i_offset += static_cast<uint64_t>( put );
+    }
+}
+
+
+/**
+ * @brief Flush file data to stable storage
+ *
+ */
+inline void sync_data( int i_fd )
+{
+    if( ::fdatasync( i_fd ) != 0 )
+    {
+        throw vault_error{ std::string{ "Unable to sync vault file: " } + std::strerror( errno ) };
+    }
+}
+
+
+/**
+ * @brief Holds an advisory lock on a whole file, serialising writers across processes
+ *
+ */
+class file_lock
+{
+public:
+    explicit file_lock( int i_fd, int i_operation = LOCK_EX ) : m_fd{ i_fd }
+    {
+        while( ::flock( m_fd, i_operation ) != 0 )
+        {
+            if( errno != EINTR )
+            {
+                throw vault_error{ std::string{ "Unable to lock vault file: " } + std::strerror( errno ) };
+            }
+        }
+    }
+
+
+    file_lock( file_lock&& i_other ) noexcept : m_fd{ std::exchange( i_other.m_fd, -1 ) }
+    {
+    }
+
+    file_lock& operator=( file_lock&& i_other ) noexcept
+    {
+        if( this != &i_other )
+        {
+            unlock();
+            m_fd = std::exchange( i_other.m_fd, -1 );
+        }
+
+        return *this;
+    }
+
+    file_lock( const file_lock& ) = delete;
+    file_lock& operator=( const file_lock& ) = delete;
+
+
+    ~file_lock()
+    {
+        unlock();
+    }
+
+
+    void unlock() noexcept
+    {
+        if( m_fd >= 0 )
+        {
+            ::flock( std::exchange( m_fd, -1 ), LOCK_UN );
+        }
+    }
+
+private:
+    int m_fd{ -1 };
+};
+
+
+/**
+ * @brief Holds an advisory lock on the first byte of a file, independent of the whole-file lock
+ *
+ * Open file description locks conflict between separate opens of a file, in one process or in several, but neither
+ * between the threads sharing one open nor with flock, so they order the commit leaders of different handles without
+ * getting in the way of writers.
+ */
+class turn_lock
+{
+public:
+    explicit turn_lock( int i_fd ) : m_fd{ i_fd }
+    {
+        auto range{ first_byte( F_WRLCK ) };
+
+        while( ::fcntl( m_fd, F_OFD_SETLKW, &range ) != 0 )
+        {
+            if( errno != EINTR )
+            {
+                throw vault_error{ std::string{ "Unable to lock vault file: " } + std::strerror( errno ) };
+            }
+        }
+    }
+
+    turn_lock( const turn_lock& ) = delete;
+    turn_lock& operator=( const turn_lock& ) = delete;
+
+
+    ~turn_lock()
+    {
+        auto range{ first_byte( F_UNLCK ) };
+        ::fcntl( m_fd, F_OFD_SETLK, &range );
+    }
+
+private:
+    int m_fd{ -1 };
+
+
+    static struct flock first_byte( short i_type ) noexcept
+    {
+        struct flock range
+        {
+        };
+
+        range.l_type = i_type;
+        range.l_whence = SEEK_SET;
+        range.l_start = 0;
+        range.l_len = 1;
+
+        return range;
+    }
+};
+
+
+/**
+ * @brief Batches the commits of concurrent threads into one sync
+ *
+ * Writers append their record, then call commit with the file offset just past it. The first writer to arrive
+ * becomes the leader and makes everything written so far durable; writers arriving meanwhile wait for that sync or
+ * lead the next one. Records must be written in increasing offset order for an offset to cover everything before it.
+ * Batching across processes is up to the sync function, which may find its work already done by another one.
+ */
+class group_commit
+{
+public:
+    /**
+     * @brief Wait until everything up to an offset is durable, syncing as leader when nobody else is
+     *
+     * @param i_offset end of the caller's record
+     * @param i_sync called by the leader with the end of everything written so far; makes at least that much durable
+     *               and returns the offset the file is durable up to
+     */
+    template<typename _Sync>
+    void commit( uint64_t i_offset, _Sync&& i_sync )
+    {
+        auto lock{ std::unique_lock{ m_mutex } };
+
+        m_written = std::max( m_written, i_offset );
+
+        while( m_synced < i_offset )
+        {
+            if( m_syncing )
+            {
+                m_done.wait( lock );
+                continue;
+            }
+
+            m_syncing = true;
+            auto target{ m_written };
+
+            lock.unlock();
+
+            auto durable{ uint64_t{} };
+            auto failed{ std::exception_ptr{} };
+
+            try
+            {
+                durable = i_sync( target );
+            }
+            catch( ... )
+            {
+                failed = std::current_exception();
+            }
+
+            lock.lock();
+
+            m_syncing = false;
+            m_done.notify_all();
+
+            if( failed )
+            {
+                std::rethrow_exception( failed );
+            }
+
+            m_synced = std::max( m_synced, durable );
+        }
+    }
+
+
+    /**
+     * @brief Note a record written without waiting for it to be durable
+     *
+     */
+    void written( uint64_t i_offset )
+    {
+        auto lock{ std::lock_guard{ m_mutex } };
+        m_written = std::max( m_written, i_offset );
+    }
+
+
+    /**
+     * @brief Whether every noted record is durable
+     *
+     */
+    bool synced() const
+    {
+        auto lock{ std::lock_guard{ m_mutex } };
+        return m_synced >= m_written;
+    }
+
+private:
+    mutable std::mutex m_mutex{};
+
+    std::condition_variable m_done{};
+
+    uint64_t m_written{ 0_ui64 };
+
+    uint64_t m_synced{ 0_ui64 };
+
+    bool m_syncing{ false };
+};
+
+
+/**
+ * @brief Size of an open file
+ *
+ */
+inline uint64_t file_size( int i_fd )
+{
+    struct stat st
+    {
+    };
+
+    if( ::fstat( i_fd, &st ) != 0 )
+    {
+        throw vault_error{ std::string{ "Unable to stat vault file: " } + std::strerror( errno ) };
+    }
+
+    return static_cast<uint64_t>( st.st_size );
+}
+
+
+/**
+ * @brief Whether a path still names the file open on a descriptor, or has been renamed over
+ *
+ */
+inline bool names_file( const std::string& i_path, int i_fd )
+{
+    struct stat open_st
+    {
+    };
+
+    struct stat path_st
+    {
+    };
+
+    if( ::fstat( i_fd, &open_st ) != 0 )
+    {
+        throw vault_error{ std::string{ "Unable to stat vault file: " } + std::strerror( errno ) };
+    }
+
+    // a path that cannot be looked up is treated as unchanged; only a rename over it moves the vault
+    if( ::stat( i_path.c_str(), &path_st ) != 0 )
+    {
+        return true;
+    }
+
+    return open_st.st_dev == path_st.st_dev && open_st.st_ino == path_st.st_ino;
+}
+
+
+/**
+ * @brief Make a rename into the directory holding a path durable
+ *
+ */
+inline void sync_parent_directory( const std::string& i_path )
+{
+    auto slash{ i_path.find_last_of( '/' ) };
+    auto directory{ slash == std::string::npos ? std::string{ "." }
+                                               : i_path.substr( 0, std::max<std::size_t>( slash, 1 ) ) };
+
+    auto fd{ unique_fd::open( directory, O_RDONLY | O_DIRECTORY ) };
+
+    if( ::fsync( fd.get() ) != 0 )
+    {
+        throw vault_error{ "Unable to sync directory " + directory + ": " + std::strerror( errno ) };
+    }
+}
+
+
+/**
+ * @brief Appends little-endian fields to a byte string
+ *
+ */
+class byte_writer
+{
+public:
+    template<typename _T>
+    byte_writer& put( _T i_value )
+    {
+        static_assert( std::is_integral_v<_T>, "Only integral fields are supported!" );
+
+        for( auto i{ 0_sz }; i < sizeof( _T ); ++i )
+        {
+            m_bytes.push_back( static_cast<char>( static_cast<uint64_t>( i_value ) >> ( 8 * i ) ) );
+        }
+
+        return *this;
+    }
+
+
+    byte_writer& put_bytes( const void* i_data, std::size_t i_size )
+    {
+        m_bytes.append( static_cast<const char*>( i_data ), i_size );
+        return *this;
+    }
+
+
+    /**
+     * @brief Write a string prefixed with its 16 bit length
+     *
+     */
+    byte_writer& put_string( std::string_view i_value )
+    {
+        if( i_value.size() > 0xFFFF )
+        {
+            throw vault_error{ "Field too long for the vault format" };
+        }
+
+        put( static_cast<uint16_t>( i_value.size() ) );
+        return put_bytes( i_value.data(), i_value.size() );
+    }
+
+
+    const std::string& bytes() const noexcept
+    {
+        return m_bytes;
+    }
+
+    std::string& bytes() noexcept
+    {
+        return m_bytes;
+    }
+
+private:
+    std::string m_bytes{};
+};
+
+
+/**
+ * @brief Reads little-endian fields with bounds checking
+ *
+ */
+class byte_reader
+{
+public:
+    explicit byte_reader( std::string_view i_bytes ) noexcept : m_bytes{ i_bytes }
+    {
+    }
+
+
+    template<typename _T>
+    _T get()
+    {
+        static_assert( std::is_integral_v<_T>, "Only integral fields are supported!" );
+
+        require( sizeof( _T ) );
+
+        auto value{ 0_ui64 };
+
+        for( auto i{ 0_sz }; i < sizeof( _T ); ++i )
+        {
+            value |= static_cast<uint64_t>( static_cast<uint8_t>( m_bytes[m_position + i] ) ) << ( 8 * i );
+        }
+
+        m_position += sizeof( _T );
+
+        return static_cast<_T>( value );
+    }
+
+
+    std::string_view get_bytes( std::size_t i_size )
+    {
+        require( i_size );
+
+        auto bytes{ m_bytes.substr( m_position, i_size ) };
+        m_position += i_size;
+
+        return bytes;
+    }
+
+
+    std::string_view get_string()
+    {
+        return get_bytes( get<uint16_t>() );
+    }
+
+
+    std::string_view rest() noexcept
+    {
+        auto bytes{ m_bytes.substr( m_position ) };
+        m_position = m_bytes.size();
+
+        return bytes;
+    }
+
+
+    bool empty() const noexcept
+    {
+        return m_position == m_bytes.size();
+    }
+
+private:
+    std::string_view m_bytes{};
+
+    std::size_t m_position{ 0_sz };
+
+
+    void require( std::size_t i_size ) const
+    {
+        if( m_bytes.size() - m_position < i_size )
+        {
+            throw vault_error{ "Truncated vault record" };
+        }
+    }
+};
+
+}
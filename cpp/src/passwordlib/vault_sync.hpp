@@ -0,0 +1,743 @@
+/**
+ * @file vault_sync.hpp
+ * @author ashwinn76
+ * @brief Two-way synchronisation of vault replicas over a pair of file descriptors
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Replicas are copies made with vault::clone, so they share the vault key and file each entry under the same blind
+ * index. The initiator compares Merkle trees top-down, asking only for the children of nodes whose hashes differ, then
+ * for the leaf buckets that differ and finally for the records in them. Comparing two large replicas therefore moves
+ * O(changes * log n) data. A record only on one side is copied to the other; when both sides changed an entry, the
+ * version vectors decide which one is newer, and two concurrent updates are merged into a record whose version
+ * descends from both, carrying the secret of the replica with more updates.
+ *
+ * Protocol: every message is a u32 body length followed by the body, whose first byte is the sync_op. The responder
+ * answers each request with the same op, or with sync_op::error and a message.
+ *   hello    fingerprint                      -> fingerprint
+ *   nodes    u32 level, u32 count, positions  -> digest per node
+ *   buckets  u32 count, positions             -> per bucket a u32 count and (blind index, digest) pairs
+ *   fetch    u32 count, blind indexes         -> per index a u32 length and the record, empty when gone
+ *   push     u32 count, length-prefixed records -> u32 records merged
+ *   done                                      -> (end of session)
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <exception>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "vault.hpp"
+
+namespace vault
+{
+/**
+ * @brief Request and response types of the sync protocol
+ *
+ */
+enum class sync_op : uint8_t
+{
+    hello = 1,
+    nodes = 2,
+    buckets = 3,
+    fetch = 4,
+    push = 5,
+    done = 6,
+    error = 0xFF,
+};
+
+
+/**
+ * @brief What one sync exchanged
+ *
+ */
+struct sync_stats_s
+{
+    std::size_t nodes_compared{ 0_sz };  // Merkle tree nodes whose hashes were exchanged
+    std::size_t records_pulled{ 0_sz };  // replica records merged into the local vault
+    std::size_t records_pushed{ 0_sz };  // local records merged into the replica
+    std::size_t conflicts{ 0_sz };  // concurrent updates of one entry merged into a new record
+};
+
+
+namespace
+{
+constexpr auto max_sync_message = 1_ui32 << 30;
+
+constexpr auto sync_batch = 256_sz;  // tree nodes, buckets or records per request
+
+
+inline void write_stream( int i_fd, std::string_view i_data )
+{
+    while( !i_data.empty() )
+    {
+        auto written{ ::write( i_fd, i_data.data(), i_data.size() ) };
+
+        if( written < 0 )
+        {
+            if( errno == EINTR )
+            {
+                continue;
+            }
+
+            throw vault_error{ std::string{ "Unable to write to sync stream: " } + std::strerror( errno ) };
+        }
+
+        i_data.remove_prefix( static_cast<std::size_t>( written ) );
+    }
+}
+
+
+/**
+ * @brief Read exactly a number of bytes
+ *
+ * @return false on a clean end of stream before the first byte
+ */
+inline bool read_stream( int i_fd, char* o_data, std::size_t i_size )
+{
+    auto done{ 0_sz };
+
+    while( done < i_size )
+    {
+        auto received{ ::read( i_fd, o_data + done, i_size - done ) };
+
+        if( received == 0 && done == 0 )
+        {
+            return false;
+        }
+
+        if( received <= 0 )
+        {
+            if( received < 0 && errno == EINTR )
+            {
+                continue;
+            }
+
+            throw vault_error{ "Sync stream closed unexpectedly" };
+        }
+
+        done += static_cast<std::size_t>( received );
+    }
+
+    return true;
+}
+
+
+inline void send_sync_message( int i_fd, sync_op i_op, std::string_view i_body = {} )
+{
+    auto writer{ byte_writer{} };
+    writer.put( static_cast<uint32_t>( i_body.size() + 1 ) ).put( static_cast<uint8_t>( i_op ) );
+    writer.put_bytes( i_body.data(), i_body.size() );
+
+    write_stream( i_fd, writer.bytes() );
+}
+
+
+/**
+ * @brief Receive one message, its op byte first
+ *
+ * @return body, nothing on a clean end of stream
+ */
+inline std::optional<std::string> receive_sync_message( int i_fd )
+{
+    auto length_bytes{ std::string( sizeof( uint32_t ), '\0' ) };
+
+    if( !read_stream( i_fd, length_bytes.data(), length_bytes.size() ) )
+    {
+        return std::nullopt;
+    }
+
+    auto length{ byte_reader{ length_bytes }.get<uint32_t>() };
+
+    if( length == 0 || length > max_sync_message )
+    {
+        throw vault_error{ "Malformed sync message" };
+    }
+
+    auto body{ std::string( length, '\0' ) };
+
+    if( !read_stream( i_fd, body.data(), body.size() ) )
+    {
+        throw vault_error{ "Sync stream closed unexpectedly" };
+    }
+
+    return body;
+}
+
+
+template<typename _Array>
+_Array get_array( byte_reader& io_reader )
+{
+    auto bytes{ io_reader.get_bytes( std::tuple_size_v<_Array> ) };
+
+    auto value{ _Array{} };
+    std::copy( bytes.begin(), bytes.end(), value.begin() );
+
+    return value;
+}
+
+
+inline uint64_t update_count( const version_vector_t& i_versions ) noexcept
+{
+    auto count{ 0_ui64 };
+
+    for( auto&& [replica, counter] : i_versions )
+    {
+        count += counter;
+    }
+
+    return count;
+}
+
+}
+
+
+/**
+ * @brief Answer the sync requests of one initiator until it is done or closes the stream
+ *
+ * @param io_local vault this side holds
+ * @param i_in stream the requests arrive on
+ * @param i_out stream the responses go to
+ */
+inline void serve_sync( vault& io_local, int i_in, int i_out )
+{
+    while( auto message{ receive_sync_message( i_in ) } )
+    {
+        auto reader{ byte_reader{ *message } };
+        auto op{ static_cast<sync_op>( reader.get<uint8_t>() ) };
+
+        if( op == sync_op::done )
+        {
+            return;
+        }
+
+        auto response{ byte_writer{} };
+
+        try
+        {
+            switch( op )
+            {
+            case sync_op::hello:
+                response.bytes() = io_local.sync_fingerprint();
+                break;
+            case sync_op::nodes:
+            {
+                auto level{ reader.get<uint32_t>() };
+                auto count{ reader.get<uint32_t>() };
+
+                for( auto i{ 0_ui32 }; i < count; ++i )
+                {
+                    auto digest{ io_local.merkle_hash( level, reader.get<uint32_t>() ) };
+                    response.put_bytes( digest.data(), digest.size() );
+                }
+
+                break;
+            }
+            case sync_op::buckets:
+            {
+                auto count{ reader.get<uint32_t>() };
+
+                for( auto i{ 0_ui32 }; i < count; ++i )
+                {
+                    auto bucket{ io_local.merkle_bucket( reader.get<uint32_t>() ) };
+                    response.put( static_cast<uint32_t>( bucket.size() ) );
+
+                    for( auto&& [index, digest] : bucket )
+                    {
+                        response.put_bytes( index.data(), index.size() ).put_bytes( digest.data(), digest.size() );
+                    }
+                }
+
+                break;
+            }
+            case sync_op::fetch:
+            {
+                auto count{ reader.get<uint32_t>() };
+
+                for( auto i{ 0_ui32 }; i < count; ++i )
+                {
+                    auto record{ io_local.read_record( get_array<blind_index_t>( reader ) ).value_or( std::string{} ) };
+                    response.put( static_cast<uint32_t>( record.size() ) ).put_bytes( record.data(), record.size() );
+                }
+
+                break;
+            }
+            case sync_op::push:
+            {
+                auto count{ reader.get<uint32_t>() };
+                auto records{ std::vector<std::string>{} };
+
+                for( auto i{ 0_ui32 }; i < count; ++i )
+                {
+                    records.emplace_back( reader.get_bytes( reader.get<uint32_t>() ) );
+                }
+
+                response.put( static_cast<uint32_t>( io_local.merge_records( records ) ) );
+                break;
+            }
+            default:
+                throw vault_error{ "Unknown sync request" };
+            }
+        }
+        catch( const std::exception& e )
+        {
+            send_sync_message( i_out, sync_op::error, e.what() );
+            continue;
+        }
+
+        send_sync_message( i_out, op, response.bytes() );
+    }
+}
+
+
+/**
+ * @brief Bring a vault and a replica served by serve_sync on the other end of a stream pair to the same state
+ *
+ */
+class sync_session
+{
+public:
+    /**
+     * @brief Start a session by checking both sides hold the same vault key
+     *
+     * @param io_local vault this side holds
+     * @param i_in stream the responses arrive on
+     * @param i_out stream the requests go to
+     */
+    sync_session( vault& io_local, int i_in, int i_out ) : m_local{ io_local }, m_in{ i_in }, m_out{ i_out }
+    {
+        if( request( sync_op::hello, {} ) != m_local.sync_fingerprint() )
+        {
+            throw vault_error{ "The replica is not a copy of vault " + m_local.path() + " under the same key" };
+        }
+    }
+
+
+    sync_session( const sync_session& ) = delete;
+    sync_session& operator=( const sync_session& ) = delete;
+
+
+    ~sync_session()
+    {
+        try
+        {
+            send_sync_message( m_out, sync_op::done );
+        }
+        catch( ... )
+        {
+        }
+    }
+
+
+    /**
+     * @brief Exchange the records the two sides disagree on
+     *
+     */
+    sync_stats_s run()
+    {
+        auto stats{ sync_stats_s{} };
+
+        auto pull{ std::vector<blind_index_t>{} };
+        auto push{ std::vector<std::string>{} };
+
+        for( auto&& bucket : differing_buckets( stats ) )
+        {
+            compare_buckets( bucket.first, bucket.second, pull, push );
+        }
+
+        for( auto first{ 0_sz }; first < pull.size(); first += sync_batch )
+        {
+            auto last{ std::min( first + sync_batch, pull.size() ) };
+            resolve( fetch( pull, first, last ), push, stats );
+        }
+
+        for( auto first{ 0_sz }; first < push.size(); first += sync_batch )
+        {
+            auto body{ byte_writer{} };
+            auto last{ std::min( first + sync_batch, push.size() ) };
+
+            body.put( static_cast<uint32_t>( last - first ) );
+
+            for( auto i{ first }; i < last; ++i )
+            {
+                body.put( static_cast<uint32_t>( push[i].size() ) ).put_bytes( push[i].data(), push[i].size() );
+            }
+
+            auto response{ request( sync_op::push, body.bytes() ) };
+            stats.records_pushed += byte_reader{ response }.get<uint32_t>();
+        }
+
+        return stats;
+    }
+
+private:
+    vault& m_local;
+
+    int m_in{ -1 };
+
+    int m_out{ -1 };
+
+
+    /**
+     * @brief Send a request and wait for its response
+     *
+     * @return response body after the op byte
+     */
+    std::string request( sync_op i_op, std::string_view i_body )
+    {
+        send_sync_message( m_out, i_op, i_body );
+
+        auto response{ receive_sync_message( m_in ) };
+
+        if( !response )
+        {
+            throw vault_error{ "Replica closed the sync stream" };
+        }
+
+        auto op{ static_cast<sync_op>( ( *response )[0] ) };
+
+        if( op == sync_op::error )
+        {
+            throw vault_error{ "Replica failed to sync: " + response->substr( 1 ) };
+        }
+
+        if( op != i_op )
+        {
+            throw vault_error{ "Unexpected sync response" };
+        }
+
+        return response->substr( 1 );
+    }
+
+
+    /**
+     * @brief Walk both Merkle trees from the root, descending only into nodes whose hashes differ
+     *
+     * @return position and replica contents of every leaf bucket that differs
+     */
+    std::vector<std::pair<uint32_t, merkle_tree::bucket_t>> differing_buckets( sync_stats_s& io_stats )
+    {
+        auto level_nodes{ std::vector<uint32_t>{ 0 } };
+
+        for( auto level{ 0_ui32 }; !level_nodes.empty(); ++level )
+        {
+            auto differing{ std::vector<uint32_t>{} };
+
+            for( auto first{ 0_sz }; first < level_nodes.size(); first += sync_batch )
+            {
+                auto last{ std::min( first + sync_batch, level_nodes.size() ) };
+
+                auto body{ byte_writer{} };
+                body.put( level ).put( static_cast<uint32_t>( last - first ) );
+
+                for( auto i{ first }; i < last; ++i )
+                {
+                    body.put( level_nodes[i] );
+                }
+
+                auto response{ request( sync_op::nodes, body.bytes() ) };
+                auto reader{ byte_reader{ response } };
+
+                for( auto i{ first }; i < last; ++i )
+                {
+                    if( get_array<merkle_digest_t>( reader ) != m_local.merkle_hash( level, level_nodes[i] ) )
+                    {
+                        differing.push_back( level_nodes[i] );
+                    }
+                }
+            }
+
+            io_stats.nodes_compared += level_nodes.size();
+
+            if( level == merkle_tree::depth )
+            {
+                return fetch_buckets( differing );
+            }
+
+            level_nodes.clear();
+
+            for( auto node : differing )
+            {
+                for( auto child{ 0_ui32 }; child < merkle_tree::fanout; ++child )
+                {
+                    level_nodes.push_back( node * merkle_tree::fanout + child );
+                }
+            }
+        }
+
+        return {};
+    }
+
+
+    std::vector<std::pair<uint32_t, merkle_tree::bucket_t>> fetch_buckets( const std::vector<uint32_t>& i_positions )
+    {
+        auto buckets{ std::vector<std::pair<uint32_t, merkle_tree::bucket_t>>{} };
+
+        for( auto first{ 0_sz }; first < i_positions.size(); first += sync_batch )
+        {
+            auto last{ std::min( first + sync_batch, i_positions.size() ) };
+
+            auto body{ byte_writer{} };
+            body.put( static_cast<uint32_t>( last - first ) );
+
+            for( auto i{ first }; i < last; ++i )
+            {
+                body.put( i_positions[i] );
+            }
+
+            auto response{ request( sync_op::buckets, body.bytes() ) };
+            auto reader{ byte_reader{ response } };
+
+            for( auto i{ first }; i < last; ++i )
+            {
+                auto& bucket{ buckets.emplace_back( i_positions[i], merkle_tree::bucket_t{} ).second };
+                bucket.resize( reader.get<uint32_t>() );
+
+                for( auto&& [index, digest] : bucket )
+                {
+                    index = get_array<blind_index_t>( reader );
+                    digest = get_array<merkle_digest_t>( reader );
+                }
+            }
+        }
+
+        return buckets;
+    }
+
+
+    /**
+     * @brief Sort the records of a differing bucket into those to fetch from the replica and those only held here
+     *
+     */
+    void compare_buckets( uint32_t i_position,
+                          const merkle_tree::bucket_t& i_remote,
+                          std::vector<blind_index_t>& io_pull,
+                          std::vector<std::string>& io_push )
+    {
+        auto local{ m_local.merkle_bucket( i_position ) };
+
+        auto left{ local.begin() };
+        auto right{ i_remote.begin() };
+
+        while( left != local.end() || right != i_remote.end() )
+        {
+            if( right == i_remote.end() || ( left != local.end() && left->first < right->first ) )
+            {
+                if( auto record{ m_local.read_record( left->first ) } )
+                {
+                    io_push.push_back( std::move( *record ) );
+                }
+
+                ++left;
+            }
+            else if( left == local.end() || right->first < left->first )
+            {
+                io_pull.push_back( right++->first );
+            }
+            else
+            {
+                // both sides hold the entry; which record wins needs their version vectors
+                if( left->second != right->second )
+                {
+                    io_pull.push_back( right->first );
+                }
+
+                ++left;
+                ++right;
+            }
+        }
+    }
+
+
+    /**
+     * @brief Fetch the current replica records of a range of blind indexes
+     *
+     */
+    std::vector<std::string> fetch( const std::vector<blind_index_t>& i_indexes,
+                                    std::size_t i_first,
+                                    std::size_t i_last )
+    {
+        auto body{ byte_writer{} };
+        body.put( static_cast<uint32_t>( i_last - i_first ) );
+
+        for( auto i{ i_first }; i < i_last; ++i )
+        {
+            body.put_bytes( i_indexes[i].data(), i_indexes[i].size() );
+        }
+
+        auto response{ request( sync_op::fetch, body.bytes() ) };
+        auto reader{ byte_reader{ response } };
+
+        auto records{ std::vector<std::string>{} };
+
+        for( auto i{ i_first }; i < i_last; ++i )
+        {
+            if( auto record{ reader.get_bytes( reader.get<uint32_t>() ) }; !record.empty() )
+            {
+                records.emplace_back( record );
+            }
+        }
+
+        return records;
+    }
+
+
+    /**
+     * @brief Decide between fetched replica records and the local ones: merge the newer replica records here, queue
+     *        the newer local ones for the replica, and merge concurrent updates for both
+     *
+     */
+    void resolve( const std::vector<std::string>& i_records,
+                  std::vector<std::string>& io_push,
+                  sync_stats_s& io_stats )
+    {
+        auto merge{ std::vector<std::string>{} };
+
+        for( auto&& record : i_records )
+        {
+            auto remote{ m_local.open_record( record ) };
+            auto local_record{ m_local.read_record( remote.index ) };
+
+            if( !local_record )
+            {
+                merge.push_back( record );
+                continue;
+            }
+
+            auto local{ m_local.open_record( *local_record ) };
+
+            auto remote_newer{ descends( remote.versions, local.versions ) };
+            auto local_newer{ descends( local.versions, remote.versions ) };
+
+            if( remote_newer && local_newer )
+            {
+                // two records of one version; the larger digest wins everywhere
+                remote_newer = record_digest( *local_record ) < record_digest( record );
+                local_newer = !remote_newer;
+            }
+
+            if( remote_newer && !local_newer )
+            {
+                merge.push_back( record );
+            }
+            else if( local_newer && !remote_newer )
+            {
+                io_push.push_back( std::move( *local_record ) );
+            }
+            else
+            {
+                auto remote_wins{ update_count( remote.versions ) != update_count( local.versions )
+                                      ? update_count( remote.versions ) > update_count( local.versions )
+                                      : record_digest( *local_record ) < record_digest( record ) };
+
+                auto merged{ remote_wins ? remote : local };
+                merged.versions = merge_versions( remote.versions, local.versions );
+
+                auto sealed{ m_local.seal_record( merged ) };
+                wipe_bytes( merged.secret.data(), merged.secret.size() );
+
+                merge.push_back( sealed.frame );
+                io_push.push_back( std::move( sealed.frame ) );
+
+                ++io_stats.conflicts;
+            }
+
+            wipe_bytes( remote.secret.data(), remote.secret.size() );
+            wipe_bytes( local.secret.data(), local.secret.size() );
+        }
+
+        io_stats.records_pulled += m_local.merge_records( merge );
+    }
+};
+
+
+/**
+ * @brief Sync a vault with a replica served on the other end of a stream pair
+ *
+ * @param io_local vault this side holds
+ * @param i_in stream the responses arrive on
+ * @param i_out stream the requests go to
+ */
+inline sync_stats_s sync_replicas( vault& io_local, int i_in, int i_out )
+{
+    return sync_session{ io_local, i_in, i_out }.run();
+}
+
+
+/**
+ * @brief Sync two vaults open in this process through a pair of pipes, the replica served on a second thread
+ *
+ */
+inline sync_stats_s sync_vaults( vault& io_local, vault& io_replica )
+{
+    auto requests{ std::array<int, 2>{} };
+    auto responses{ std::array<int, 2>{} };
+
+    if( ::pipe( requests.data() ) != 0 )
+    {
+        throw vault_error{ std::string{ "Unable to create sync pipe: " } + std::strerror( errno ) };
+    }
+
+    auto request_read{ unique_fd{ requests[0] } };
+    auto request_write{ unique_fd{ requests[1] } };
+
+    if( ::pipe( responses.data() ) != 0 )
+    {
+        throw vault_error{ std::string{ "Unable to create sync pipe: " } + std::strerror( errno ) };
+    }
+
+    auto response_read{ unique_fd{ responses[0] } };
+    auto response_write{ unique_fd{ responses[1] } };
+
+    auto server_error{ std::exception_ptr{} };
+
+    auto server{ std::thread{ [&] {
+        try
+        {
+            serve_sync( io_replica, request_read.get(), response_write.get() );
+        }
+        catch( ... )
+        {
+            server_error = std::current_exception();
+        }
+
+        // wakes the initiator if the server stopped early
+        response_write.reset();
+    } } };
+
+    auto stats{ sync_stats_s{} };
+    auto error{ std::exception_ptr{} };
+
+    try
+    {
+        stats = sync_replicas( io_local, response_read.get(), request_write.get() );
+    }
+    catch( ... )
+    {
+        error = std::current_exception();
+    }
+
+    request_write.reset();
+    server.join();
+
+    if( error || server_error )
+    {
+        std::rethrow_exception( error ? error : server_error );
+    }
+
+    return stats;
+}
+
+}
@@ -9,15 +9,798 @@
  *
  */
 
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
 
-enum class mode
+#include "passwordlib/btree_vault.hpp"
+#include "passwordlib/bulk_transfer.hpp"
+#include "passwordlib/password_generator.hpp"
+#include "passwordlib/password_strength.hpp"
+#include "passwordlib/vault.hpp"
+#include "passwordlib/vault_agent.hpp"
+#include "passwordlib/vault_backup.hpp"
+#include "passwordlib/vault_sync.hpp"
+
+using vault::mode;
+
+namespace
+{
+constexpr auto generated_length = 20;
+
+constexpr auto generated_min_entropy = 80.0;
+
+constexpr auto search_limit = 20_sz;
+
+constexpr auto master_key_variable = "PASSWORDS_MASTER_KEY";
+
+constexpr auto new_master_key_variable = "PASSWORDS_NEW_MASTER_KEY";
+
+constexpr auto agent_socket_variable = "PASSWORDS_AGENT_SOCKET";
+
+constexpr auto default_agent_idle_seconds = 900_ui32;
+
+constexpr auto btree_flag = std::string_view{ "--btree" };
+
+constexpr auto durability_flag = std::string_view{ "--durability=" };
+
+constexpr auto format_flag = std::string_view{ "--format=" };
+
+constexpr auto jobs_flag = std::string_view{ "--jobs=" };
+
+
+/**
+ * @brief Parse the mode argument
+ *
+ * @param i_arg command line argument
+ * @return mode, nothing if the argument is not a mode
+ */
+std::optional<mode> parse_mode( std::string_view i_arg ) noexcept
+{
+    if( i_arg == "get" )
+    {
+        return mode::get;
+    }
+
+    if( i_arg == "put" )
+    {
+        return mode::put;
+    }
+
+    if( i_arg == "update" )
+    {
+        return mode::update;
+    }
+
+    if( i_arg == "import" )
+    {
+        return mode::bulk_import;
+    }
+
+    if( i_arg == "export" )
+    {
+        return mode::bulk_export;
+    }
+
+    if( i_arg == "rotate" )
+    {
+        return mode::rotate_key;
+    }
+
+    if( i_arg == "compact" )
+    {
+        return mode::compact;
+    }
+
+    if( i_arg == "stats" )
+    {
+        return mode::stats;
+    }
+
+    if( i_arg == "sync" )
+    {
+        return mode::sync;
+    }
+
+    if( i_arg == "backup" )
+    {
+        return mode::backup;
+    }
+
+    if( i_arg == "restore" )
+    {
+        return mode::restore;
+    }
+
+    if( i_arg == "search" )
+    {
+        return mode::search;
+    }
+
+    return std::nullopt;
+}
+
+
+/**
+ * @brief Parse the value of the durability option
+ *
+ * @param i_arg option value
+ * @return durability mode, nothing if the value is not a mode
+ */
+std::optional<vault::durability_mode> parse_durability( std::string_view i_arg ) noexcept
+{
+    if( i_arg == "per-write" )
+    {
+        return vault::durability_mode::per_write;
+    }
+
+    if( i_arg == "grouped" )
+    {
+        return vault::durability_mode::grouped;
+    }
+
+    if( i_arg == "async" )
+    {
+        return vault::durability_mode::async;
+    }
+
+    return std::nullopt;
+}
+
+
+/**
+ * @brief Parse a decimal command line number
+ *
+ * @param i_arg argument
+ * @return value, nothing if the argument is not all digits, such as "-1", or does not fit the type
+ */
+template<typename _T>
+std::optional<_T> parse_number( std::string_view i_arg ) noexcept
+{
+    auto value{ _T{} };
+    auto [end, error]{ std::from_chars( i_arg.data(), i_arg.data() + i_arg.size(), value ) };
+
+    if( error != std::errc{} || end != i_arg.data() + i_arg.size() )
+    {
+        return std::nullopt;
+    }
+
+    return value;
+}
+
+
+/**
+ * @brief Parse the value of the jobs option
+ *
+ * @param i_arg option value
+ * @return number of threads, nothing if the value is not a positive number
+ */
+std::optional<std::size_t> parse_jobs( std::string_view i_arg ) noexcept
 {
-    get,
-    put,
-    update,
-};
+    auto jobs{ parse_number<std::size_t>( i_arg ) };
+
+    if( jobs == std::size_t{ 0 } )
+    {
+        return std::nullopt;
+    }
+
+    return jobs;
+}
+
+
+/**
+ * @brief Read a master key from the environment or the next line of stdin
+ *
+ * @param i_variable environment variable holding the key
+ */
+std::string read_master_key( const char* i_variable = master_key_variable )
+{
+    if( auto env{ std::getenv( i_variable ) } )
+    {
+        return env;
+    }
+
+    auto key{ std::string{} };
+    std::getline( std::cin, key );
+
+    return key;
+}
+
+
+/**
+ * @brief Search the entry names of a vault; without an agent the index lives only as long as this process
+ *
+ */
+template<typename _Vault>
+std::vector<vault::name_match_s> find_names( _Vault& io_store,
+                                             std::string_view i_query,
+                                             const vault::name_search_options_s& i_options )
+{
+    auto index{ vault::name_index{} };
+    vault::load_names( io_store, index );
+
+    return index.search( i_query, i_options );
+}
+
+
+std::vector<vault::name_match_s> find_names( vault::agent_client& io_client,
+                                             std::string_view i_query,
+                                             const vault::name_search_options_s& i_options )
+{
+    return io_client.search( i_query, i_options );
+}
+
+
+/**
+ * @brief Run one mode against an open vault of either format
+ *
+ * @return process exit code
+ */
+template<typename _Vault>
+int run( _Vault& io_store, mode i_mode, std::string_view i_name, const char* i_secret )
+{
+    switch( i_mode )
+    {
+    case mode::get:
+    {
+        auto secret{ io_store.get( i_name ) };
+
+        if( !secret )
+        {
+            std::cerr << "No entry named " << i_name << "\n";
+            return 1;
+        }
+
+        std::cout << *secret << "\n";
+        break;
+    }
+    case mode::put:
+    case mode::update:
+    {
+        auto secret{ i_secret ? std::string{ i_secret }
+                              : password_generator::get_random_string( generated_length,
+                                                                       password_generator::all_special_characters,
+                                                                       generated_min_entropy ) };
+
+        if( i_mode == mode::put )
+        {
+            io_store.put( i_name, secret );
+        }
+        else
+        {
+            io_store.update( i_name, secret );
+        }
+
+        io_store.flush();
+
+        if( !i_secret )
+        {
+            std::cout << secret << "\n";
+        }
+
+        break;
+    }
+    case mode::search:
+    {
+        auto options{ vault::name_search_options_s{} };
+        // main has rejected anything but a number
+        options.max_distance = i_secret ? parse_number<uint32_t>( i_secret ).value_or( 0_ui32 ) : 0_ui32;
+        options.limit = search_limit;
+
+        auto matches{ find_names( io_store, i_name, options ) };
+
+        if( matches.empty() )
+        {
+            std::cerr << "No entry name matches " << i_name << "\n";
+            return 1;
+        }
+
+        for( auto&& match : matches )
+        {
+            std::cout << match.name << "\n";
+        }
+
+        break;
+    }
+    case mode::bulk_import:
+    case mode::bulk_export:
+    case mode::rotate_key:
+    case mode::compact:
+    case mode::stats:
+    case mode::sync:
+    case mode::backup:
+    case mode::restore:
+        throw vault::vault_error{ "import, export, rotate, compact, stats, sync and backup need a local log-format "
+                                  "vault" };
+    }
+
+    return 0;
+}
+
+
+/**
+ * @brief Stream records between a vault and a CSV or JSON-lines file, or stdin / stdout
+ *
+ * @return process exit code
+ */
+int run_bulk( vault::vault& io_store, mode i_mode, const char* i_file, const vault::bulk_options_s& i_options )
+{
+    if( i_mode == mode::bulk_import )
+    {
+        auto file{ std::ifstream{} };
+
+        if( i_file && ( file.open( i_file ), !file ) )
+        {
+            throw vault::vault_error{ std::string{ "Unable to open " } + i_file };
+        }
+
+        auto count{ vault::import_records( io_store, i_file ? file : std::cin, i_options ) };
+        io_store.flush();
+
+        std::cerr << "Imported " << count << " entries\n";
+    }
+    else
+    {
+        auto count{ i_file ? vault::export_file( io_store, i_file, i_options )
+                           : vault::export_records( io_store, std::cout, i_options ) };
+
+        std::cerr << "Exported " << count << " entries\n";
+    }
+
+    return 0;
+}
+
+
+/**
+ * @brief Re-encrypt a vault under a new master key, or finish a rotation that was interrupted
+ *
+ * @return process exit code
+ */
+int run_rotate( vault::vault& io_store, const vault::bulk_options_s& i_options )
+{
+    auto options{ vault::rotation_options_s{} };
+    options.workers = i_options.workers;
+
+    if( io_store.rotation_pending() )
+    {
+        io_store.resume_rotation( options );
+
+        std::cerr << "Finished the interrupted key rotation\n";
+        return 0;
+    }
+
+    auto new_key{ encryption::encryption_key{ read_master_key( new_master_key_variable ), false } };
+    io_store.rotate_key( new_key, options );
+
+    std::cerr << "Rotated the vault to the new master key\n";
+    return 0;
+}
+
+
+/**
+ * @brief Print how much of a vault is live, or compact it
+ *
+ * @param i_budget compaction I/O budget in KiB per second, null for no limit
+ * @return process exit code
+ */
+int run_maintenance( vault::vault& io_store, mode i_mode, const char* i_budget )
+{
+    auto usage{ io_store.space_usage() };
+
+    std::cout << "entries        " << io_store.size() << "\n"
+              << "log bytes      " << usage.log_bytes << "\n"
+              << "live bytes     " << usage.live_bytes << "\n"
+              << "fragmentation  " << static_cast<int>( usage.fragmentation() * 100 + 0.5 ) << "%\n";
+
+    if( i_mode == mode::compact )
+    {
+        auto options{ vault::compaction_options_s{} };
+        // main has rejected anything but a number of KiB that fits in bytes
+        options.bytes_per_second = i_budget ? parse_number<uint64_t>( i_budget ).value_or( 0_ui64 ) * 1024 : 0_ui64;
+
+        std::cout << "reclaimed      " << io_store.compact( options ) << " bytes\n";
+    }
+
+    return 0;
+}
+
+
+/**
+ * @brief Exchange changes with a replica of a vault, or create the replica when it does not exist yet
+ *
+ * @return process exit code
+ */
+int run_sync( vault::vault& io_store,
+              const std::string& i_replica,
+              const encryption::encryption_key& i_key,
+              const vault::vault_options_s& i_options )
+{
+    if( std::ifstream{ i_replica }.fail() )
+    {
+        io_store.clone( i_replica );
+
+        std::cerr << "Created replica " << i_replica << "\n";
+        return 0;
+    }
+
+    auto replica{ vault::vault{ i_replica, i_key, i_options } };
+    auto stats{ vault::sync_vaults( io_store, replica ) };
+
+    std::cout << "nodes compared " << stats.nodes_compared << "\n"
+              << "pulled         " << stats.records_pulled << "\n"
+              << "pushed         " << stats.records_pushed << "\n"
+              << "conflicts      " << stats.conflicts << "\n";
+
+    return 0;
+}
+
+
+/**
+ * @brief Store a snapshot of a vault in a backup directory, writing only the chunks that changed since the last one
+ *
+ * @return process exit code
+ */
+int run_backup( const vault::vault& i_store, const std::string& i_directory, const encryption::encryption_key& i_key )
+{
+    auto backups{ vault::backup_store{ i_directory, i_key } };
+    auto stats{ backups.backup( i_store ) };
+
+    std::cout << "snapshot       " << stats.snapshot << "\n"
+              << "bytes          " << stats.bytes << "\n"
+              << "chunks         " << stats.chunks << "\n"
+              << "new chunks     " << stats.new_chunks << "\n"
+              << "new bytes      " << stats.new_bytes << "\n";
+
+    return 0;
+}
+
+
+/**
+ * @brief Rebuild a vault from a snapshot in a backup directory, the latest one when none is named
+ *
+ * @return process exit code
+ */
+int run_restore( const std::string& i_target,
+                 const std::string& i_directory,
+                 const char* i_snapshot,
+                 const encryption::encryption_key& i_key )
+{
+    auto backups{ vault::backup_store{ i_directory, i_key } };
+    auto snapshots{ backups.snapshots() };
+
+    if( snapshots.empty() )
+    {
+        throw vault::vault_error{ "No snapshots in " + i_directory };
+    }
+
+    auto snapshot{ i_snapshot ? std::string{ i_snapshot } : snapshots.back() };
+    backups.restore( snapshot, i_target );
+
+    // the restored file must open under the same key
+    auto options{ vault::vault_options_s{} };
+    options.read_only = true;
+
+    auto restored{ vault::vault{ i_target, i_key, options } };
+
+    std::cerr << "Restored " << restored.size() << " entries from snapshot " << snapshot << "\n";
+    return 0;
+}
+
+
+/**
+ * @brief Build the password strength dictionary from a frequency list, for PASSWORDS_DICTIONARY to map
+ *
+ * @return process exit code
+ */
+int run_dictionary( const std::string& i_list, const std::string& i_output )
+{
+    auto stream{ std::ifstream{ i_list } };
+
+    if( !stream )
+    {
+        throw std::runtime_error{ "Unable to read " + i_list };
+    }
+
+    auto dictionary{ password_strength::read_frequency_list( stream ) };
+    dictionary.save( i_output );
+
+    std::cerr << "Wrote " << dictionary.size() << " words to " << i_output << "\n";
+    return 0;
+}
+
+
+/**
+ * @brief Unlock a vault and serve it over the agent socket until it locks
+ *
+ * @return process exit code
+ */
+template<typename _Vault>
+int serve_agent( _Vault& io_store, const std::string& i_path, std::chrono::seconds i_idle_timeout )
+{
+    auto socket{ std::getenv( agent_socket_variable ) };
+
+    if( !socket )
+    {
+        std::cerr << agent_socket_variable << " must name the socket to listen on\n";
+        return 2;
+    }
+
+    auto server{ vault::agent_server<_Vault>{ socket, i_path, io_store, i_idle_timeout } };
+    server.run();
+
+    return 0;
+}
+
+
+int usage( const char* i_program )
+{
+    std::cerr << "usage: " << i_program << " [options] get <vault> <name>\n"
+              << "       " << i_program << " [options] put <vault> <name> [secret]\n"
+              << "       " << i_program << " [options] update <vault> <name> [secret]\n"
+              << "       " << i_program << " [options] search <vault> <prefix> [max-typos]\n"
+              << "       " << i_program << " [options] import <vault> [file]\n"
+              << "       " << i_program << " [options] export <vault> [file]\n"
+              << "       " << i_program << " [options] rotate <vault>\n"
+              << "       " << i_program << " [options] stats <vault>\n"
+              << "       " << i_program << " [options] compact <vault> [KiB-per-second]\n"
+              << "       " << i_program << " [options] sync <vault> <replica>\n"
+              << "       " << i_program << " [options] backup <vault> <directory>\n"
+              << "       " << i_program << " [options] restore <vault> <directory> [snapshot]\n"
+              << "       " << i_program << " [options] agent <vault> [idle-seconds]\n"
+              << "       " << i_program << " dictionary <frequency-list> <output>\n"
+              << "The master key is read from " << master_key_variable << " or the first line of stdin.\n"
+              << "put and update generate a secret when none is given.\n"
+              << "search lists the closest entry names starting with prefix, allowing up to max-typos edits\n"
+              << "(default 0).\n"
+              << "agent keeps the vault unlocked on the socket named by " << agent_socket_variable
+              << " until idle for idle-seconds (default " << default_agent_idle_seconds << ");\n"
+              << "get, put, update and search go through that agent whenever it holds the same vault.\n"
+              << "import and export stream stdin / stdout when no file is given; an export file is readable by\n"
+              << "its owner only. An import that fails partway keeps the records before the failure, and running\n"
+              << "it again replaces them.\n"
+              << "rotate re-encrypts the vault under a new master key read from " << new_master_key_variable
+              << " or the next line of stdin,\n"
+              << "or finishes an interrupted rotation when opened with the new key.\n"
+              << "stats prints how much of the log is dead; compact rewrites the live records into a new file,\n"
+              << "optionally limited to KiB-per-second of I/O, while the vault stays in use.\n"
+              << "sync exchanges the changes made to a vault and its replica since they last met, merging\n"
+              << "concurrent updates; it creates the replica as a copy of the vault when it does not exist.\n"
+              << "backup stores an encrypted snapshot of the vault in a directory, writing only what changed since\n"
+              << "the previous one; restore creates the vault from the latest snapshot, or the one named.\n"
+              << "dictionary builds the password strength dictionary from a list of common passwords and words,\n"
+              << "one per line and most frequent first; generated secrets are rated against the file named by\n"
+              << password_strength::dictionary_variable << ", or a short built-in list without one.\n"
+              << "options:\n"
+              << "  --btree            create new vaults in the paged B+tree format; existing vaults are detected\n"
+              << "  --durability=MODE  per-write, grouped (default) or async commits for the log format\n"
+              << "  --format=FORMAT    csv or jsonl for import and export (default from the file name, else jsonl)\n"
+              << "  --jobs=N           encrypt / decrypt threads for import, export and rotate\n";
+
+    return 2;
+}
+
+}
 
 int main( int argc, char** argv )
 {
-}
\ No newline at end of file
+    auto program{ argv[0] };
+    auto btree{ false };
+    auto durability{ std::optional{ vault::durability_mode::grouped } };
+    auto format{ std::optional<vault::bulk_format>{} };
+    auto bulk_options{ vault::bulk_options_s{} };
+
+    for( ; argc > 1 && std::string_view{ argv[1] }.substr( 0, 2 ) == "--"; --argc, ++argv )
+    {
+        auto option{ std::string_view{ argv[1] } };
+
+        if( option == btree_flag )
+        {
+            btree = true;
+        }
+        else if( option.substr( 0, durability_flag.size() ) == durability_flag )
+        {
+            durability = parse_durability( option.substr( durability_flag.size() ) );
+        }
+        else if( option == "--format=csv" || option == "--format=jsonl" )
+        {
+            format = option.substr( format_flag.size() ) == "csv" ? vault::bulk_format::csv
+                                                                  : vault::bulk_format::json_lines;
+        }
+        else if( option.substr( 0, jobs_flag.size() ) == jobs_flag )
+        {
+            auto jobs{ parse_jobs( option.substr( jobs_flag.size() ) ) };
+
+            if( !jobs )
+            {
+                return usage( program );
+            }
+
+            bulk_options.workers = *jobs;
+        }
+        else
+        {
+            return usage( program );
+        }
+    }
+
+    if( !durability )
+    {
+        return usage( program );
+    }
+
+    auto agent{ argc > 1 && argv[1] == std::string_view{ "agent" } };
+    auto dictionary{ argc > 1 && argv[1] == std::string_view{ "dictionary" } };
+    // nothing for agent and dictionary, which are not operations on a vault
+    const auto selected{ argc > 1 ? parse_mode( argv[1] ) : std::nullopt };
+
+    if( dictionary )
+    {
+        if( argc != 4 )
+        {
+            return usage( program );
+        }
+
+        try
+        {
+            return run_dictionary( argv[2], argv[3] );
+        }
+        catch( const std::exception& e )
+        {
+            std::cerr << e.what() << "\n";
+            return 1;
+        }
+    }
+
+    if( !agent && !selected )
+    {
+        return usage( program );
+    }
+
+    auto bulk{ selected == mode::bulk_import || selected == mode::bulk_export };
+    auto rotate{ selected == mode::rotate_key };
+    auto maintenance{ selected == mode::compact || selected == mode::stats };
+    auto sync{ selected == mode::sync };
+    auto backup{ selected == mode::backup };
+    auto restore{ selected == mode::restore };
+    auto log_only{ bulk || rotate || maintenance || sync || backup || restore };
+
+    // rotate and stats take <vault>, agent, bulk and compact <vault> [argument], get <vault> <name>, sync and backup
+    // <vault> <other>, put, update and restore an optional third argument as well
+    auto single{ selected == mode::get || sync || backup };
+    auto valid{ rotate || selected == mode::stats
+                    ? argc == 3
+                    : agent || bulk || maintenance ? argc == 3 || argc == 4
+                                                   : argc == 4 || ( argc == 5 && !single ) };
+
+    if( !valid )
+    {
+        return usage( program );
+    }
+
+    if( selected == mode::search && argc == 5 && !parse_number<uint32_t>( argv[4] ) )
+    {
+        return usage( program );
+    }
+
+    if( selected == mode::compact && argc == 4 )
+    {
+        // the budget is given in KiB and has to fit in bytes
+        auto budget{ parse_number<uint64_t>( argv[3] ) };
+
+        if( !budget || *budget > std::numeric_limits<uint64_t>::max() / 1024 )
+        {
+            return usage( program );
+        }
+    }
+
+    auto idle_seconds{ agent && argc == 4 ? parse_number<uint32_t>( argv[3] ) : default_agent_idle_seconds };
+
+    if( !idle_seconds || *idle_seconds == 0 )
+    {
+        return usage( program );
+    }
+
+    try
+    {
+        auto secret{ !bulk && argc == 5 ? argv[4] : nullptr };
+
+        if( auto socket{ std::getenv( agent_socket_variable ) }; socket && !agent && !log_only )
+        {
+            // skip the key derivation entirely when an agent already holds this vault open, and open it directly when
+            // no agent answers or the one that does holds another vault
+            auto client{ std::optional<vault::agent_client>{} };
+
+            try
+            {
+                client.emplace( socket, argv[2] );
+            }
+            catch( const vault::vault_error& )
+            {
+            }
+
+            if( client )
+            {
+                return run( *client, *selected, argv[3], secret );
+            }
+        }
+
+        auto key{ encryption::encryption_key{ read_master_key(), false } };
+
+        if( restore )
+        {
+            return run_restore( argv[2], argv[3], argc == 5 ? argv[4] : nullptr, key );
+        }
+
+        auto read_only{ selected == mode::get || selected == mode::search || selected == mode::bulk_export ||
+                        selected == mode::stats || backup };
+        auto idle_timeout{ std::chrono::seconds{ *idle_seconds } };
+
+        if( btree || vault::is_btree_vault( argv[2] ) )
+        {
+            auto options{ vault::btree_options_s{} };
+            options.read_only = read_only;
+
+            if( log_only )
+            {
+                throw vault::vault_error{ "import, export, rotate, compact, stats, sync and backup need a "
+                                          "log-format vault" };
+            }
+
+            auto store{ vault::btree_vault{ argv[2], key, options } };
+            return agent ? serve_agent( store, argv[2], idle_timeout ) : run( store, *selected, argv[3], secret );
+        }
+
+        auto options{ vault::vault_options_s{} };
+        options.read_only = read_only;
+        options.durability = *durability;
+
+        auto store{ vault::vault{ argv[2], key, options } };
+
+        if( rotate )
+        {
+            return run_rotate( store, bulk_options );
+        }
+
+        if( maintenance )
+        {
+            return run_maintenance( store, *selected, argc == 4 ? argv[3] : nullptr );
+        }
+
+        if( sync )
+        {
+            return run_sync( store, argv[3], key, options );
+        }
+
+        if( backup )
+        {
+            return run_backup( store, argv[3], key );
+        }
+
+        if( bulk )
+        {
+            auto file{ argc == 4 ? argv[3] : nullptr };
+            auto csv_file{ file && std::string_view{ file }.size() > 4 &&
+                           std::string_view{ file }.substr( std::string_view{ file }.size() - 4 ) == ".csv" };
+
+            auto default_format{ csv_file ? vault::bulk_format::csv : vault::bulk_format::json_lines };
+
+            bulk_options.format = format.value_or( default_format );
+
+            return run_bulk( store, *selected, file, bulk_options );
+        }
+
+        return agent ? serve_agent( store, argv[2], idle_timeout ) : run( store, *selected, argv[3], secret );
+    }
+    catch( const std::exception& e )
+    {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+}
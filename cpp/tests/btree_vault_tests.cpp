@@ -0,0 +1,290 @@
+/**
+ * @file btree_vault_tests.cpp
+ * @author ashwinn76
+ * @brief Tests for the paged B+tree vault format
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include "passwordlib/btree_vault.hpp"
+#include "vault_test_utils.hpp"
+
+
+namespace
+{
+constexpr auto btree_test_options = vault::btree_options_s{ 16_ui32 };
+
+
+std::string entry_name( int i_index )
+{
+    auto name{ std::to_string( i_index ) };
+    return "site/" + std::string( 5 - name.size(), '0' ) + name;
+}
+
+}
+
+
+TEST( BtreeVaultTests, PutGetUpdateTests )
+{
+    auto file{ temp_vault_path{ "btree_put_get.vault" } };
+
+    auto store{ vault::btree_vault{ file.path, master_key, btree_test_options } };
+
+    store.put( "mail", "hunter2" );
+    store.put( "bank", "correct horse battery staple" );
+
+    EXPECT_EQ( store.get( "mail" ), "hunter2" );
+    EXPECT_EQ( store.get( "bank" ), "correct horse battery staple" );
+    EXPECT_FALSE( store.get( "missing" ) );
+
+    EXPECT_THROW( store.put( "mail", "again" ), vault::vault_error );
+    EXPECT_THROW( store.update( "missing", "value" ), vault::vault_error );
+    EXPECT_THROW( store.put( std::string( 300, 'n' ), "value" ), vault::vault_error );
+
+    store.update( "mail", "hunter3" );
+
+    EXPECT_EQ( store.get( "mail" ), "hunter3" );
+    EXPECT_EQ( store.size(), 2_ui64 );
+    EXPECT_TRUE( vault::is_btree_vault( file.path ) );
+}
+
+
+TEST( BtreeVaultTests, SplitAndReopenTests )
+{
+    auto file{ temp_vault_path{ "btree_split.vault" } };
+
+    constexpr auto count = 2000;
+
+    {
+        auto store{ vault::btree_vault{ file.path, master_key, btree_test_options } };
+
+        // insert out of order so splits happen in the middle of pages as well as at the end
+        for( auto i{ 0 }; i < count; ++i )
+        {
+            auto index{ ( i * 7919 ) % count };
+            store.put( entry_name( index ), "secret" + std::to_string( index ) + std::string( index % 50, 'x' ) );
+        }
+
+        store.update( entry_name( 7 ), "rotated" );
+
+        EXPECT_GE( store.height(), 2_ui32 );
+    }
+
+    auto options{ btree_test_options };
+    options.read_only = true;
+
+    auto store{ vault::btree_vault{ file.path, master_key, options } };
+
+    EXPECT_EQ( store.size(), static_cast<uint64_t>( count ) );
+    EXPECT_EQ( store.get( entry_name( 7 ) ), "rotated" );
+
+    for( auto i{ 0 }; i < count; i += 37 )
+    {
+        EXPECT_EQ( store.get( entry_name( i ) ), "secret" + std::to_string( i ) + std::string( i % 50, 'x' ) );
+    }
+
+    EXPECT_FALSE( store.get( "site/99999" ) );
+    EXPECT_THROW( store.put( "other", "value" ), vault::vault_error );
+}
+
+
+TEST( BtreeVaultTests, PrefixScanTests )
+{
+    auto file{ temp_vault_path{ "btree_scan.vault" } };
+
+    auto store{ vault::btree_vault{ file.path, master_key, btree_test_options } };
+
+    for( auto i{ 0 }; i < 2000; ++i )
+    {
+        store.put( entry_name( i ), std::string( 40, 's' ) );
+    }
+
+    store.put( "other", "value" );
+
+    auto names{ std::vector<std::string>{} };
+    store.scan( "site/01", [&names]( std::string_view i_name, std::string_view ) {
+        names.emplace_back( i_name );
+        return true;
+    } );
+
+    ASSERT_EQ( names.size(), 1000_sz );
+    EXPECT_EQ( names.front(), "site/01000" );
+    EXPECT_EQ( names.back(), "site/01999" );
+    EXPECT_TRUE( std::is_sorted( names.begin(), names.end() ) );
+
+    auto visited{ 0 };
+    store.scan( "", [&visited]( std::string_view, std::string_view ) { return ++visited < 10; } );
+
+    EXPECT_EQ( visited, 10 );
+}
+
+
+TEST( BtreeVaultTests, WrongKeyTests )
+{
+    auto file{ temp_vault_path{ "btree_wrong_key.vault" } };
+
+    {
+        auto store{ vault::btree_vault{ file.path, master_key, btree_test_options } };
+        store.put( "mail", "hunter2" );
+    }
+
+    auto other_key{ encryption::encryption_key{ "another_random_encryption_key___", false } };
+
+    EXPECT_THROW( ( vault::btree_vault{ file.path, other_key, btree_test_options } ), vault::vault_error );
+}
+
+
+TEST( BtreeVaultTests, CrashBeforeFlushTests )
+{
+    auto file{ temp_vault_path{ "btree_crash.vault" } };
+    auto crashed{ temp_vault_path{ "btree_crash_copy.vault" } };
+
+    {
+        auto store{ vault::btree_vault{ file.path, master_key, btree_test_options } };
+
+        for( auto i{ 0 }; i < 500; ++i )
+        {
+            store.put( entry_name( i ), std::string( 40, 's' ) );
+        }
+
+        store.flush();
+
+        // enough to split pages the published tree still points at
+        for( auto i{ 500 }; i < 1500; ++i )
+        {
+            store.put( entry_name( i ), std::string( 40, 't' ) );
+        }
+
+        store.update( entry_name( 3 ), "rotated" );
+
+        // the file as a crash would leave it: pages written, header not yet published
+        std::filesystem::copy_file( file.path, crashed.path );
+    }
+
+    auto options{ btree_test_options };
+    options.read_only = true;
+
+    auto store{ vault::btree_vault{ crashed.path, master_key, options } };
+
+    EXPECT_EQ( store.size(), 500_ui64 );
+    EXPECT_EQ( store.get( entry_name( 3 ) ), std::string( 40, 's' ) );
+    EXPECT_FALSE( store.get( entry_name( 500 ) ) );
+
+    auto visited{ 0 };
+    store.scan( "", [&visited]( std::string_view, std::string_view ) { return ++visited > 0; } );
+
+    EXPECT_EQ( visited, 500 );
+
+    auto flushed{ vault::btree_vault{ file.path, master_key, options } };
+
+    EXPECT_EQ( flushed.size(), 1500_ui64 );
+    EXPECT_EQ( flushed.get( entry_name( 3 ) ), "rotated" );
+}
+
+
+TEST( BtreeVaultTests, TornHeaderTests )
+{
+    auto file{ temp_vault_path{ "btree_torn_header.vault" } };
+
+    {
+        auto store{ vault::btree_vault{ file.path, master_key, btree_test_options } };
+        store.put( "mail", "hunter2" );
+        store.flush();
+        store.put( "bank", "1234" );
+    }
+
+    // the last flush went to the second header slot; damage it as a torn write would
+    {
+        auto stream{ std::fstream{ file.path, std::ios::in | std::ios::out | std::ios::binary } };
+        stream.seekg( 2048 + 40 );
+
+        auto byte{ static_cast<char>( stream.get() ) };
+
+        stream.seekp( 2048 + 40 );
+        stream.put( static_cast<char>( ~byte ) );
+    }
+
+    auto store{ vault::btree_vault{ file.path, master_key, btree_test_options } };
+
+    EXPECT_EQ( store.get( "mail" ), "hunter2" );
+    EXPECT_FALSE( store.get( "bank" ) );
+    EXPECT_EQ( store.size(), 1_ui64 );
+
+    store.put( "bank", "5678" );
+    store.flush();
+
+    EXPECT_EQ( store.get( "bank" ), "5678" );
+}
+
+
+TEST( BtreeVaultTests, ConcurrentWriterTests )
+{
+    auto file{ temp_vault_path{ "btree_writers.vault" } };
+
+    auto first{ vault::btree_vault{ file.path, master_key, btree_test_options } };
+    auto second{ vault::btree_vault{ file.path, master_key, btree_test_options } };
+
+    first.put( "mail", "hunter2" );
+
+    auto done{ std::atomic<bool>{ false } };
+    auto writer{ std::thread{ [&second, &done]() {
+        second.put( "bank", "1234" );
+        second.flush();
+        done = true;
+    } } };
+
+    // the second writer waits for the first to publish, then builds on its root
+    std::this_thread::sleep_for( std::chrono::milliseconds{ 50 } );
+    EXPECT_FALSE( done );
+
+    first.flush();
+    writer.join();
+
+    auto options{ btree_test_options };
+    options.read_only = true;
+
+    auto store{ vault::btree_vault{ file.path, master_key, options } };
+
+    EXPECT_EQ( store.size(), 2_ui64 );
+    EXPECT_EQ( store.get( "mail" ), "hunter2" );
+    EXPECT_EQ( store.get( "bank" ), "1234" );
+}
+
+
+TEST( BtreeVaultTests, RefreshTests )
+{
+    auto file{ temp_vault_path{ "btree_refresh.vault" } };
+
+    auto writer{ vault::btree_vault{ file.path, master_key, btree_test_options } };
+    writer.put( "mail", "hunter2" );
+    writer.flush();
+
+    auto options{ btree_test_options };
+    options.read_only = true;
+
+    auto reader{ vault::btree_vault{ file.path, master_key, options } };
+
+    writer.update( "mail", "hunter3" );
+
+    // nothing is published until the flush, and the reader keeps its root until it refreshes
+    EXPECT_FALSE( reader.refresh() );
+    EXPECT_FALSE( writer.refresh() );
+
+    writer.flush();
+
+    EXPECT_EQ( reader.get( "mail" ), "hunter2" );
+    EXPECT_TRUE( reader.refresh() );
+    EXPECT_EQ( reader.get( "mail" ), "hunter3" );
+    EXPECT_FALSE( reader.refresh() );
+}
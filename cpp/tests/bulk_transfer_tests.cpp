@@ -0,0 +1,204 @@
+/**
+ * @file bulk_transfer_tests.cpp
+ * @author ashwinn76
+ * @brief Tests for the parallel import / export pipelines
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "gtest/gtest.h"
+
+#include <fstream>
+#include <sstream>
+
+#include <sys/stat.h>
+
+#include "passwordlib/bulk_transfer.hpp"
+#include "vault_test_utils.hpp"
+
+
+namespace
+{
+vault::bulk_options_s small_pipeline( vault::bulk_format i_format )
+{
+    auto options{ vault::bulk_options_s{} };
+    options.format = i_format;
+    options.workers = 3;
+    options.queue_capacity = 4;
+    options.batch_size = 7;
+
+    return options;
+}
+
+}
+
+
+TEST( BulkTransferTests, OrderedPipelineTests )
+{
+    auto next{ 0 };
+    auto results{ std::vector<int>{} };
+
+    vault::ordered_pipeline<int, int>(
+        [&next]() -> std::optional<int> {
+            return next < 500 ? std::optional{ next++ } : std::nullopt;
+        },
+        []( int i_value ) { return i_value * 2; },
+        [&results]( int i_value ) { results.push_back( i_value ); },
+        4,
+        8 );
+
+    ASSERT_EQ( results.size(), 500_sz );
+
+    for( auto i{ 0 }; i < 500; ++i )
+    {
+        EXPECT_EQ( results[static_cast<std::size_t>( i )], i * 2 );
+    }
+
+    EXPECT_THROW( ( vault::ordered_pipeline<int, int>(
+                      [&next]() -> std::optional<int> { return next++; },
+                      []( int i_value ) {
+                          if( i_value == 600 )
+                          {
+                              throw std::runtime_error{ "stop" };
+                          }
+
+                          return i_value;
+                      },
+                      []( int ) {},
+                      2,
+                      4 ) ),
+                  std::runtime_error );
+}
+
+
+TEST( BulkTransferTests, RecordFormatTests )
+{
+    auto input{ std::istringstream{ "name,secret\n"
+                                    "plain,value\n"
+                                    "\"with,comma\",\"quote\"\"d\"\n"
+                                    "multi,\"line\none\"\n" } };
+
+    auto csv{ vault::bulk_reader{ input, vault::bulk_format::csv } };
+
+    auto first{ csv.next() };
+    ASSERT_TRUE( first );
+    EXPECT_EQ( first->name, "plain" );
+    EXPECT_EQ( first->secret, "value" );
+
+    auto second{ csv.next() };
+    ASSERT_TRUE( second );
+    EXPECT_EQ( second->name, "with,comma" );
+    EXPECT_EQ( second->secret, "quote\"d" );
+
+    auto third{ csv.next() };
+    ASSERT_TRUE( third );
+    EXPECT_EQ( third->secret, "line\none" );
+    EXPECT_FALSE( csv.next() );
+
+    EXPECT_EQ( vault::format_record( "a,b", "x\"y", vault::bulk_format::csv ), "\"a,b\",\"x\"\"y\"\n" );
+
+    // an entry that looks like the header is quoted, and read back as an entry even as the first row
+    auto lookalike{ vault::format_record( "name", "secret", vault::bulk_format::csv ) };
+    EXPECT_EQ( lookalike, "\"name\",\"secret\"\n" );
+
+    auto lookalike_input{ std::istringstream{ lookalike } };
+    auto lookalike_record{ vault::bulk_reader{ lookalike_input, vault::bulk_format::csv }.next() };
+
+    ASSERT_TRUE( lookalike_record );
+    EXPECT_EQ( lookalike_record->name, "name" );
+
+    auto line{ vault::format_record( "tab\tname", "quote\" \\ \x01", vault::bulk_format::json_lines ) };
+    EXPECT_EQ( line, "{\"name\":\"tab\\tname\",\"secret\":\"quote\\\" \\\\ \\u0001\"}\n" );
+
+    auto json_input{ std::istringstream{ line + "\n{ \"secret\" : \"\\u00e9\\ud83d\\ude00\", \"name\" : \"u\" }\n" } };
+    auto json{ vault::bulk_reader{ json_input, vault::bulk_format::json_lines } };
+
+    auto round_trip{ json.next() };
+    ASSERT_TRUE( round_trip );
+    EXPECT_EQ( round_trip->name, "tab\tname" );
+    EXPECT_EQ( round_trip->secret, "quote\" \\ \x01" );
+
+    auto unicode{ json.next() };
+    ASSERT_TRUE( unicode );
+    EXPECT_EQ( unicode->secret, "\xC3\xA9\xF0\x9F\x98\x80" );
+    EXPECT_FALSE( json.next() );
+
+    auto broken{ std::istringstream{ "{\"name\":\"x\"}\n" } };
+    EXPECT_THROW( vault::bulk_reader( broken, vault::bulk_format::json_lines ).next(), vault::vault_error );
+}
+
+
+TEST( BulkTransferTests, ImportExportTests )
+{
+    constexpr auto count = 300;
+
+    for( auto format : { vault::bulk_format::csv, vault::bulk_format::json_lines } )
+    {
+        auto source_file{ temp_vault_path{ "bulk_source.vault" } };
+        auto target_file{ temp_vault_path{ "bulk_target.vault" } };
+
+        auto input{ std::stringstream{} };
+
+        for( auto i{ 0 }; i < count; ++i )
+        {
+            input << vault::format_record( "entry" + std::to_string( i ), "secret,\"" + std::to_string( i ), format );
+        }
+
+        auto exported{ std::stringstream{} };
+
+        {
+            auto source{ vault::vault{ source_file.path, master_key, test_options } };
+
+            auto imported{ vault::import_records( source, input, small_pipeline( format ) ) };
+
+            EXPECT_EQ( imported, static_cast<uint64_t>( count ) );
+            EXPECT_EQ( source.size(), static_cast<std::size_t>( count ) );
+            EXPECT_EQ( source.get( "entry42" ), "secret,\"42" );
+
+            auto written{ vault::export_records( source, exported, small_pipeline( format ) ) };
+
+            EXPECT_EQ( written, static_cast<uint64_t>( count ) );
+        }
+
+        auto target{ vault::vault{ target_file.path, master_key, test_options } };
+        target.put( "entry7", "stale" );
+
+        vault::import_records( target, exported, small_pipeline( format ) );
+
+        EXPECT_EQ( target.size(), static_cast<std::size_t>( count ) );
+        EXPECT_EQ( target.get( "entry7" ), "secret,\"7" );
+        EXPECT_EQ( target.get( "entry299" ), "secret,\"299" );
+    }
+}
+
+
+TEST( BulkTransferTests, ExportFileTests )
+{
+    auto store_file{ temp_vault_path{ "bulk_export_store.vault" } };
+    auto export_path{ temp_vault_path{ "bulk_export.csv" } };
+
+    // a file left readable by everyone is narrowed before any secret goes into it
+    std::ofstream{ export_path.path } << "stale\n";
+    ::chmod( export_path.path.c_str(), 0644 );
+
+    auto store{ vault::vault{ store_file.path, master_key, test_options } };
+    store.put( "mail", "hunter2" );
+    store.put( "name", "secret" );
+
+    EXPECT_EQ( vault::export_file( store, export_path.path, small_pipeline( vault::bulk_format::csv ) ), 2_ui64 );
+
+    struct stat status
+    {
+    };
+
+    ASSERT_EQ( ::stat( export_path.path.c_str(), &status ), 0 );
+    EXPECT_EQ( status.st_mode & 0777, 0600u );
+
+    auto contents{ std::stringstream{} };
+    contents << std::ifstream{ export_path.path }.rdbuf();
+
+    EXPECT_EQ( contents.str(), "name,secret\nmail,hunter2\n\"name\",\"secret\"\n" );
+}
@@ -0,0 +1,138 @@
+/**
+ * @file crypto_tests.cpp
+ * @author ashwinn76
+ * @brief Known-answer tests for the hash, MAC, KDF and AEAD primitives
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "gtest/gtest.h"
+
+#include "passwordlib/chacha20_poly1305.hpp"
+#include "passwordlib/sha256.hpp"
+
+
+namespace
+{
+std::string to_hex( const uint8_t* i_data, std::size_t i_size )
+{
+    constexpr auto digits = std::string_view{ "0123456789abcdef" };
+
+    auto hex{ std::string{} };
+
+    for( auto i{ 0_sz }; i < i_size; ++i )
+    {
+        hex.push_back( digits[i_data[i] >> 4] );
+        hex.push_back( digits[i_data[i] & 0xF] );
+    }
+
+    return hex;
+}
+
+template<typename _Container>
+std::string to_hex( const _Container& i_data )
+{
+    return to_hex( reinterpret_cast<const uint8_t*>( std::data( i_data ) ), std::size( i_data ) );
+}
+
+std::vector<uint8_t> from_hex( std::string_view i_hex )
+{
+    auto bytes{ std::vector<uint8_t>{} };
+
+    for( auto i{ 0_sz }; i + 1 < i_hex.size(); i += 2 )
+    {
+        bytes.push_back( static_cast<uint8_t>( std::stoi( std::string{ i_hex.substr( i, 2 ) }, nullptr, 16 ) ) );
+    }
+
+    return bytes;
+}
+
+}
+
+
+TEST( CryptoTests, Sha256Tests )
+{
+    EXPECT_EQ( to_hex( encryption::sha256{}.update( "abc" ).finish() ),
+               "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" );
+
+    EXPECT_EQ( to_hex( encryption::sha256{}.finish() ),
+               "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" );
+
+    auto million_a{ std::string( 1000000, 'a' ) };
+
+    EXPECT_EQ( to_hex( encryption::sha256{}.update( million_a ).finish() ),
+               "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0" );
+}
+
+
+TEST( CryptoTests, HmacTests )
+{
+    // RFC 4231 test case 2
+    auto key{ std::string_view{ "Jefe" } };
+
+    EXPECT_EQ( to_hex( encryption::hmac_sha256{ key.data(), key.size() }
+                           .update( "what do ya want for nothing?" )
+                           .finish() ),
+               "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843" );
+}
+
+
+TEST( CryptoTests, Pbkdf2Tests )
+{
+    auto salt{ std::vector<uint8_t>{ 's', 'a', 'l', 't' } };
+
+    EXPECT_EQ( to_hex( encryption::pbkdf2_sha256( "password", salt, 1 ) ),
+               "120fb6cffcf8b32c43e7225256c4f837a86548c92ccc35480805987cb70be17b" );
+
+    EXPECT_EQ( to_hex( encryption::pbkdf2_sha256( "password", salt, 4096 ) ),
+               "c5e478d59288c841aa530db6845c4c8d962893a001ce4e11a4963873aa98134a" );
+}
+
+
+TEST( CryptoTests, AeadTests )
+{
+    // RFC 8439 section 2.8.2
+    auto key{ encryption::aead_key_t{} };
+    auto key_bytes{ from_hex( "808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f" ) };
+    std::copy( key_bytes.begin(), key_bytes.end(), key.begin() );
+
+    auto nonce{ encryption::aead_nonce_t{ 0x07, 0x00, 0x00, 0x00, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47 } };
+
+    auto ad_bytes{ from_hex( "50515253c0c1c2c3c4c5c6c7" ) };
+    auto ad{ std::string_view{ reinterpret_cast<const char*>( ad_bytes.data() ), ad_bytes.size() } };
+
+    auto plain{ std::string{ "Ladies and Gentlemen of the class of '99: If I could offer you only one tip for the "
+                             "future, sunscreen would be it." } };
+
+    auto data{ std::vector<uint8_t>( plain.begin(), plain.end() ) };
+
+    auto tag{ encryption::aead_encrypt( key, nonce, ad, data.data(), data.size() ) };
+
+    EXPECT_EQ( to_hex( data ).substr( 0, 32 ), "d31a8d34648e60db7b86afbc53ef7ec2" );
+    EXPECT_EQ( to_hex( tag ), "1ae10b594f09e26a7e902ecbd0600691" );
+
+    EXPECT_TRUE( encryption::aead_decrypt( key, nonce, ad, data.data(), data.size(), tag ) );
+    EXPECT_EQ( std::string( data.begin(), data.end() ), plain );
+}
+
+
+TEST( CryptoTests, SealOpenTests )
+{
+    auto key{ encryption::aead_key_t{} };
+    encryption::random_bytes( key.data(), key.size() );
+
+    auto sealed{ encryption::aead_seal( key, "header", "secret value" ) };
+
+    auto plain{ std::string{} };
+
+    EXPECT_TRUE( encryption::aead_open( key, "header", sealed.data(), sealed.size(), plain ) );
+    EXPECT_EQ( plain, "secret value" );
+
+    EXPECT_FALSE( encryption::aead_open( key, "other header", sealed.data(), sealed.size(), plain ) );
+
+    sealed[15] ^= 1;
+    EXPECT_FALSE( encryption::aead_open( key, "header", sealed.data(), sealed.size(), plain ) );
+}
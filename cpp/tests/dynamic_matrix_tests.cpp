@@ -0,0 +1,268 @@
+/**
+ * @file dynamic_matrix_tests.cpp
+ * @author ashwinn76
+ * @brief Tests for the runtime-sized matrix and its interplay with the fixed one
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <cstdint>
+
+#include "dynamic_matrix.hpp"
+
+
+TEST(DynamicMatrixTests, StorageTests)
+{
+    auto mat = dynamic_matrix<>{ 3, 5 };
+
+    EXPECT_EQ(mat.Rows(), 3_ui64);
+    EXPECT_EQ(mat.Columns(), 5_ui64);
+    EXPECT_FALSE(mat.IsSquare());
+
+    // rows start on cache lines, padded to a whole number of them
+    EXPECT_EQ(mat.stride(), 8_ui64);
+    EXPECT_EQ(dynamic_matrix<float>(2, 17).stride(), 32_ui64);
+
+    for (auto row{ 0_ui64 }; row < mat.Rows(); ++row)
+    {
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(mat[row]) % dynamic_matrix<>::alignment, 0_sz);
+
+        for (auto col{ 0_ui64 }; col < mat.Columns(); ++col)
+        {
+            EXPECT_EQ(mat[row][col], row == col ? 1.0 : 0.0);
+        }
+    }
+
+    EXPECT_THROW(dynamic_matrix<>(0, 4), std::invalid_argument);
+
+    auto copy = mat;
+    copy[2][4] = 7;
+
+    EXPECT_TRUE(copy != mat);
+    EXPECT_EQ(mat[2][4], 0.0);
+
+    auto moved = std::move(copy);
+
+    EXPECT_EQ(moved(2, 4), 7.0);
+    EXPECT_EQ(copy.Rows(), 0_ui64);
+
+    // a moved-from matrix is an empty one, which copies and compares like any other
+    auto empty = copy;
+
+    EXPECT_EQ(empty.Columns(), 0_ui64);
+    EXPECT_TRUE(empty == copy);
+    EXPECT_TRUE(empty != moved);
+
+    empty = moved;
+
+    EXPECT_TRUE(empty == moved);
+
+    moved = copy;
+
+    EXPECT_EQ(moved.Rows(), 0_ui64);
+}
+
+
+TEST(DynamicMatrixTests, ArithmeticTests)
+{
+    auto first = dynamic_matrix<>{ 2, 3, { 1, 2, 3, 4, 5, 6 } };
+    auto second = dynamic_matrix<>{ 2, 3, { 6, 5, 4, 3, 2, 1 } };
+
+    EXPECT_TRUE(first + second == (dynamic_matrix<>{ 2, 3, { 7, 7, 7, 7, 7, 7 } }));
+    EXPECT_TRUE(first - first == (dynamic_matrix<>{ 2, 3, false }));
+
+    first += second;
+    first -= second;
+
+    EXPECT_TRUE(first == (dynamic_matrix<>{ 2, 3, { 1, 2, 3, 4, 5, 6 } }));
+
+    EXPECT_THROW(first + ~second, std::invalid_argument);
+    EXPECT_THROW(first * second, std::invalid_argument);
+
+    auto product = first * ~second;
+
+    EXPECT_TRUE(product == (dynamic_matrix<>{ 2, 2, { 28, 10, 73, 28 } }));
+    EXPECT_TRUE(~~first == first);
+}
+
+
+TEST(DynamicMatrixTests, FixedInteropTests)
+{
+    constexpr auto fixed = matrix<4, 3>
+    {
+         1,  2,  3,
+        53,  6, 45,
+         3, 43,  3,
+         2, 32,  3,
+    };
+
+    constexpr auto other = matrix<3, 6>
+    {
+        23, 3, 4, 54, 236,  8,
+        56, 4, 3, 78, 711,  8,
+        6,  6, 6,  6,  41, 64,
+    };
+
+    auto dynamic = dynamic_matrix<>{ fixed };
+
+    // fixed and dynamic matrices mix in every operator and give the fixed results
+    EXPECT_TRUE(dynamic * other == fixed * other);
+    EXPECT_TRUE(fixed + dynamic == dynamic_matrix<>{ fixed + fixed });
+    EXPECT_TRUE(dynamic - fixed == dynamic_matrix<>(4, 3, false));
+    EXPECT_TRUE(((dynamic * other).fixed<4, 6>() == fixed * other));
+    EXPECT_TRUE(((~dynamic).fixed<3, 4>() == ~fixed));
+
+    EXPECT_THROW((dynamic.fixed<3, 4>()), std::invalid_argument);
+}
+
+
+TEST(DynamicMatrixTests, LargeProductTests)
+{
+    // a size no fixed matrix on the stack would take, with rows that are not a multiple of the stride
+    constexpr auto order = 301_ui64;
+
+    auto lhs = dynamic_matrix<>{ order, order + 2, false };
+    auto rhs = dynamic_matrix<>{ order + 2, order - 1, false };
+
+    for (auto row{ 0_ui64 }; row < lhs.Rows(); ++row)
+    {
+        for (auto col{ 0_ui64 }; col < lhs.Columns(); ++col)
+        {
+            lhs[row][col] = static_cast<double>((row * 7 + col * 3) % 9) - 4;
+        }
+    }
+
+    for (auto row{ 0_ui64 }; row < rhs.Rows(); ++row)
+    {
+        for (auto col{ 0_ui64 }; col < rhs.Columns(); ++col)
+        {
+            rhs[row][col] = static_cast<double>((row * 5 + col * 11) % 7) - 3;
+        }
+    }
+
+    auto product = lhs * rhs;
+
+    for (auto row : { 0_ui64, 150_ui64, order - 1 })
+    {
+        for (auto col : { 0_ui64, 77_ui64, order - 2 })
+        {
+            auto expected = 0.0;
+
+            for (auto k{ 0_ui64 }; k < lhs.Columns(); ++k)
+            {
+                expected += lhs[row][k] * rhs[k][col];
+            }
+
+            EXPECT_EQ(product[row][col], expected);
+        }
+    }
+}
+
+
+TEST(DynamicMatrixTests, DeterminantAndInverseTests)
+{
+    constexpr auto fixed = Matrix4x4{ 5, -2,  2, 7,
+                                      1,  0,  0, 3,
+                                     -3,  1,  5, 0,
+                                      3, -1, -9, 4, };
+
+    auto mat = dynamic_matrix<>{ fixed };
+
+    EXPECT_NEAR(mat.determinant(), 88.0, 1e-12);
+
+    auto inverse = mat.inverse();
+    auto identity = mat * inverse;
+
+    for (auto row{ 0_ui64 }; row < 4; ++row)
+    {
+        for (auto col{ 0_ui64 }; col < 4; ++col)
+        {
+            EXPECT_NEAR(identity[row][col], row == col ? 1.0 : 0.0, 1e-12);
+            EXPECT_NEAR(inverse[row][col], fixed.inverse()[row][col], 1e-12);
+        }
+    }
+
+    // a larger system, solved for several right-hand sides at once
+    constexpr auto order = 64_ui64;
+
+    auto system = dynamic_matrix<>{ order, order, false };
+    auto expected = dynamic_matrix<>{ order, 3, false };
+
+    for (auto row{ 0_ui64 }; row < order; ++row)
+    {
+        for (auto col{ 0_ui64 }; col < order; ++col)
+        {
+            system[row][col] = std::cos(static_cast<double>(row * 3 + col * col)) + (row == col ? 4.0 : 0.0);
+        }
+
+        for (auto col{ 0_ui64 }; col < 3; ++col)
+        {
+            expected[row][col] = static_cast<double>(row) - static_cast<double>(col * 10);
+        }
+    }
+
+    auto solution = system.solve(system * expected);
+
+    for (auto row{ 0_ui64 }; row < order; ++row)
+    {
+        for (auto col{ 0_ui64 }; col < 3; ++col)
+        {
+            EXPECT_NEAR(solution[row][col], expected[row][col], 1e-9);
+        }
+    }
+
+    auto singular = dynamic_matrix<>{ 3, 3, { 1, 2, 3, 2, 4, 6, 0, 1, 0 } };
+
+    EXPECT_EQ(singular.determinant(), 0.0);
+    EXPECT_THROW(singular.inverse(), std::domain_error);
+    EXPECT_THROW((dynamic_matrix<>{ 2, 3 }.determinant()), std::invalid_argument);
+}
+
+
+TEST(DynamicMatrixTests, RingElementTests)
+{
+    auto integers = dynamic_matrix<int64_t>{ 4, 4, { 0, 1, 2, 3, 1, 0, 4, 5, 2, 4, 0, 6, 3, 5, 6, 0 } };
+
+    EXPECT_EQ(integers.determinant(), -224);
+
+    // products of elements the blocked kernel does not take run the plain loop
+    EXPECT_TRUE(((integers * integers).fixed<4, 4>() == integers.fixed<4, 4>() * integers.fixed<4, 4>()));
+
+    // determinant -1, so the inverse is integral too
+    auto triangular = dynamic_matrix<int64_t>{ 4, 4, { 1, 2, 3, 4, 0, 1, 5, 6, 0, 0, -1, 7, 0, 0, 0, 1 } };
+
+    EXPECT_TRUE(triangular * triangular.inverse() == (dynamic_matrix<int64_t>{ 4, 4 }));
+    EXPECT_THROW((dynamic_matrix<int64_t>{ 2, 2, { 2, 0, 0, 1 } }.inverse()), std::domain_error);
+
+    // a Hill cipher key modulo 26, as in the fixed matrix tests
+    using z26 = modular<26>;
+
+    auto key = dynamic_matrix<z26>{ 3, 3, { 6, 24, 1, 13, 16, 10, 20, 17, 15 } };
+
+    EXPECT_EQ(key.determinant(), z26{ 441 });
+    EXPECT_TRUE(key.inverse() == (dynamic_matrix<z26>{ 3, 3, { 8, 5, 10, 21, 8, 21, 21, 12, 8 } }));
+
+    // AES MixColumns over GF(2^8) goes through the LU decomposition, pivoting on the first non-zero element
+    auto mix = dynamic_matrix<gf256>{ 4, 4, { 2, 3, 1, 1, 1, 2, 3, 1, 1, 1, 2, 3, 3, 1, 1, 2 } };
+
+    auto inverse_mix = dynamic_matrix<gf256>
+    {
+        4, 4,
+        {
+            14, 11, 13,  9,
+             9, 14, 11, 13,
+            13,  9, 14, 11,
+            11, 13,  9, 14
+        }
+    };
+
+    EXPECT_TRUE(mix.inverse() == inverse_mix);
+    EXPECT_TRUE(mix * mix.inverse() == (dynamic_matrix<gf256>{ 4, 4 }));
+}
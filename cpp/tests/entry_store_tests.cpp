@@ -0,0 +1,97 @@
+/**
+ * @file entry_store_tests.cpp
+ * @author ashwinn76
+ * @brief Tests for the arena-backed entry store
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "gtest/gtest.h"
+
+#include <string>
+
+#include "passwordlib/entry_store.hpp"
+
+
+TEST( EntryStoreTests, PutAndFindTests )
+{
+    auto store{ vault::entry_store{} };
+
+    EXPECT_FALSE( store.find( "mail" ) );
+
+    auto mail{ store.put( { "mail", "ashwin", "https://mail.example.com", "" } ) };
+    auto bank{ store.put( { "bank", "ashwin", "https://bank.example.com", "pin in the safe" } ) };
+
+    EXPECT_NE( mail, bank );
+    EXPECT_EQ( store.size(), 2_sz );
+    EXPECT_EQ( store.find( "mail" ), mail );
+    EXPECT_EQ( store.find( "bank" ), bank );
+    EXPECT_FALSE( store.find( "ashwin" ) );
+
+    auto entry{ store[bank] };
+
+    EXPECT_EQ( entry.name, "bank" );
+    EXPECT_EQ( entry.user, "ashwin" );
+    EXPECT_EQ( entry.url, "https://bank.example.com" );
+    EXPECT_EQ( entry.notes, "pin in the safe" );
+
+    // the shared user name is stored once
+    EXPECT_EQ( store[mail].user.data(), entry.user.data() );
+    EXPECT_EQ( store.distinct_fields(), 7_sz );
+
+    // replacing keeps the id
+    EXPECT_EQ( store.put( { "mail", "someone else", "https://mail.example.com", "moved" } ), mail );
+    EXPECT_EQ( store.size(), 2_sz );
+    EXPECT_EQ( store[mail].user, "someone else" );
+    EXPECT_EQ( store[mail].notes, "moved" );
+
+    EXPECT_THROW( store.put( { "long", std::string( 70000, 'x' ), "", "" } ), vault::vault_error );
+    EXPECT_FALSE( store.find( "long" ) );
+
+    store.clear();
+
+    EXPECT_EQ( store.size(), 0_sz );
+    EXPECT_FALSE( store.find( "mail" ) );
+}
+
+
+TEST( EntryStoreTests, ManyEntriesTests )
+{
+    auto store{ vault::entry_store{} };
+    constexpr auto count = 200000_ui32;
+
+    for( auto i{ 0_ui32 }; i < count; ++i )
+    {
+        auto name{ "entry" + std::to_string( i ) };
+        auto user{ "user" + std::to_string( i % 100 ) };
+        auto url{ "https://site" + std::to_string( i % 1000 ) + ".example.com/login" };
+
+        EXPECT_EQ( store.put( { name, user, url, std::string( 40, static_cast<char>( 'a' + i % 26 ) ) } ), i );
+    }
+
+    auto first{ store[0] };
+
+    // the fields span several slabs, and views taken early stay valid as the store grows
+    EXPECT_GT( store.memory_usage(), 2 * vault::entry_store::slab_size );
+    EXPECT_EQ( first.name, "entry0" );
+    EXPECT_EQ( first.url, "https://site0.example.com/login" );
+
+    for( auto i : { 1_ui32, 12345_ui32, count - 1 } )
+    {
+        auto id{ store.find( "entry" + std::to_string( i ) ) };
+
+        ASSERT_TRUE( id );
+        EXPECT_EQ( *id, i );
+        EXPECT_EQ( store[i].user, "user" + std::to_string( i % 100 ) );
+        EXPECT_EQ( store.name( i ), "entry" + std::to_string( i ) );
+    }
+
+    // names, 100 users, 1000 sites and 26 distinct notes
+    EXPECT_EQ( store.distinct_fields(), count + 100 + 1000 + 26 );
+
+    // a fraction of what four std::string fields per entry would take
+    EXPECT_LT( store.memory_usage(), count * 4 * sizeof( std::string ) );
+}
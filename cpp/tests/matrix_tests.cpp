@@ -12,9 +12,12 @@
 
 #include "gtest/gtest.h"
 
+#include <cmath>
+
 #include "type_trait_utils.hpp"
 #include "bound_value.hpp"
 
+#include "dynamic_matrix.hpp"
 #include "macro_utils.hpp"
 #include "matrix.hpp"
 
@@ -93,6 +96,76 @@ TEST(MatrixTests, MatrixArithmeticTests)
 }
 
 
+TEST(MatrixTests, ExpressionTemplateTests)
+{
+    constexpr auto a = Matrix2x2{ 1, 2, 3, 4 };
+    constexpr auto b = Matrix2x2{ 10, 20, 30, 40 };
+    constexpr auto c = Matrix2x2{ 5, 5, 5, 5 };
+
+    // sums and differences stay lazy until they are assigned to a matrix
+    static_assert(!std::is_same_v<decltype(a + b - c), Matrix2x2>);
+    static_assert(std::is_same_v<decltype(a + b - c)::value_type, double>);
+
+    constexpr Matrix2x2 chained = a + b - c;
+
+    static_assert(chained == Matrix2x2{ 6, 17, 28, 39 });
+
+    constexpr Matrix2x2 grouped = a - (b - c) + (c + c);
+
+    static_assert(grouped == Matrix2x2{ 6, -3, -12, -21 });
+
+    constexpr Matrix2x2 products = basic_binary_operator(a, b, [](auto l_ele, auto r_ele) { return l_ele * r_ele; });
+
+    static_assert(products == Matrix2x2{ 10, 40, 90, 160 });
+
+
+    auto mat = a;
+
+    // the destination may appear in its own expression
+    mat = b - mat - mat;
+
+    EXPECT_TRUE(mat == (Matrix2x2{ 8, 16, 24, 32 }));
+
+    mat += a + c;
+    mat -= b;
+
+    EXPECT_TRUE(mat == (Matrix2x2{ 4, 3, 2, 1 }));
+
+    (mat += a) -= a;
+
+    EXPECT_TRUE(mat == (Matrix2x2{ 4, 3, 2, 1 }));
+
+    // an expression converts wherever a matrix is expected
+    auto product = Matrix2x2{ a + c } * b;
+
+    EXPECT_TRUE(product == (Matrix2x2{ 270, 400, 350, 520 }));
+
+    // and products, transposes and comparisons take it as they took the eager matrix
+    static_assert((a + c) * b == Matrix2x2{ 270, 400, 350, 520 });
+    static_assert(b * (a + c) == Matrix2x2{ 220, 250, 500, 570 });
+    static_assert((a + c) * (b - c) == Matrix2x2{ 205, 335, 265, 435 });
+    static_assert(~(a + b) == Matrix2x2{ 11, 33, 22, 44 });
+    static_assert((a + b) == Matrix2x2{ 11, 22, 33, 44 });
+    static_assert(Matrix2x2{ 11, 22, 33, 44 } == a + b);
+    static_assert((a + b) != c);
+
+    // a stored expression owns its temporary operands, here a product, and copies small matrices
+    constexpr auto stored = a * b + c;
+
+    static_assert(stored == Matrix2x2{ 75, 105, 155, 225 });
+
+    constexpr auto large = Matrix4x4{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+
+    auto later{ large * large - large };
+    auto evaluated = Matrix4x4{ later };
+
+    EXPECT_TRUE(evaluated == (Matrix4x4{  89,  98, 107, 116,
+                                         197, 222, 247, 272,
+                                         305, 346, 387, 428,
+                                         413, 470, 527, 584 }));
+}
+
+
 TEST(MatrixTests, MatrixMultiplicationTests)
 {
     constexpr auto matrix1 = matrix<4, 3>
@@ -147,6 +220,77 @@ TEST(MatrixTests, MatrixMultiplicationTests)
 }
 
 
+namespace
+{
+/**
+ * @brief Compare a product through the blocked kernel with a plain triple loop
+ *
+ * Small integer elements keep every sum exact, so the blocking and the vector width cannot change the result.
+ */
+template<uint64_t _Rows, uint64_t _Inner, uint64_t _Columns, typename _T>
+void ExpectBlockedProduct()
+{
+    auto lhs = matrix<_Rows, _Inner, _T>{ false };
+    auto rhs = matrix<_Inner, _Columns, _T>{ false };
+
+    for (auto row{ 0_ui64 }; row < _Rows; ++row)
+    {
+        for (auto col{ 0_ui64 }; col < _Inner; ++col)
+        {
+            lhs[row][col] = static_cast<_T>((row * 7 + col * 3) % 9) - 4;
+        }
+    }
+
+    for (auto row{ 0_ui64 }; row < _Inner; ++row)
+    {
+        for (auto col{ 0_ui64 }; col < _Columns; ++col)
+        {
+            rhs[row][col] = static_cast<_T>((row * 5 + col * 11) % 7) - 3;
+        }
+    }
+
+    auto product = lhs * rhs;
+
+    for (auto row{ 0_ui64 }; row < _Rows; ++row)
+    {
+        for (auto col{ 0_ui64 }; col < _Columns; ++col)
+        {
+            auto expected = _T{};
+
+            for (auto k{ 0_ui64 }; k < _Inner; ++k)
+            {
+                expected += lhs[row][k] * rhs[k][col];
+            }
+
+            ASSERT_EQ(product[row][col], expected) << row << ", " << col;
+        }
+    }
+}
+}
+
+
+TEST(MatrixTests, BlockedMultiplicationTests)
+{
+    ExpectBlockedProduct<64, 64, 64, double>();
+    ExpectBlockedProduct<64, 64, 64, float>();
+
+    // edges in every direction, and an inner dimension longer than one cache block
+    ExpectBlockedProduct<37, 130, 53, double>();
+    ExpectBlockedProduct<37, 700, 53, float>();
+    ExpectBlockedProduct<1, 300, 129, double>();
+    ExpectBlockedProduct<129, 3, 1, float>();
+
+    // the same product whether it is evaluated by the compiler or at run time
+    constexpr auto matrix1 = matrix<9, 9>{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20 };
+    constexpr auto square = matrix1 * ~matrix1;
+
+    auto runtime = matrix1;
+    runtime = runtime * ~matrix1;
+
+    EXPECT_TRUE(square == runtime);
+}
+
+
 TEST(MatrixTests, MatrixTransposeTests)
 {
     constexpr auto matrix1 = matrix<3, 2>{ -1.0, 3.0, 12.9, -12.78, -0.9, 900.8 };
@@ -175,6 +319,183 @@ TEST(MatrixTests, MatrixLeftoverElementsTests)
 }
 
 
+TEST(MatrixTests, MatrixViewTests)
+{
+    constexpr auto matrix1 = Matrix3x3{ 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+
+    static_assert(matrix1.row(1) == matrix<1, 3>{ 4, 5, 6 });
+    static_assert(matrix1.column(2) == matrix<3, 1>{ 3, 6, 9 });
+    static_assert(matrix1.transpose() == ~matrix1);
+    static_assert(matrix1.leftover(1, 1) == Matrix2x2{ 1, 3, 7, 9 });
+    static_assert(matrix1.select(std::array{ 2_ui64, 0_ui64 }, std::array{ 1_ui64 }) == matrix<2, 1>{ 8, 2 });
+
+    // views of views stay on the same elements
+    static_assert(matrix1.block<2, 2>(1, 1).transpose().row(1) == matrix<1, 2>{ 6, 9 });
+    static_assert(matrix1.transpose().block<2, 2>(1, 0).column(1) == matrix<2, 1>{ 5, 6 });
+
+    // operators take views as they take matrices
+    static_assert(matrix1.row(0) * matrix1.column(0) == matrix<1, 1>{ 30 });
+    static_assert(Matrix2x2{ matrix1.leftover(0, 0) + matrix1.block<2, 2>(0, 0) } == Matrix2x2{ 6, 8, 12, 14 });
+    static_assert(matrix1.transpose() * matrix1 == ~matrix1 * matrix1);
+
+    // writing through views changes the matrix
+    auto matrix2 = matrix1;
+    matrix2.block<2, 2>(0, 0) += matrix1.block<2, 2>(1, 1);
+    matrix2.row(2) = matrix2.row(0);
+    matrix2.column(2) -= matrix1.column(2);
+
+    EXPECT_TRUE(matrix2 == (Matrix3x3{ 6, 8, 0, 12, 14, 0, 6, 8, -6 }));
+
+    // a transpose of the matrix itself is copied out before it is assigned
+    matrix2 = matrix1;
+    matrix2 = matrix2.transpose();
+
+    EXPECT_TRUE(matrix2 == ~matrix1);
+    EXPECT_TRUE((dynamic_matrix<>{ matrix1.block<2, 3>(1, 0) } == (dynamic_matrix<>{ 2, 3, { 4, 5, 6, 7, 8, 9 } })));
+}
+
+
+TEST(MatrixTests, AliasedViewTests)
+{
+    constexpr auto matrix1 = Matrix3x3{ 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    constexpr auto matrix2 = Matrix3x3{ 1, 0, 0, 0, 2, 0, 0, 0, 3 };
+
+    // a transpose of the matrix reads elements that are written earlier in the loop
+    auto sum = matrix1;
+    sum += sum.transpose();
+    EXPECT_TRUE(sum == (Matrix3x3{ 2, 6, 10, 6, 10, 14, 10, 14, 18 }));
+
+    sum -= sum.transpose();
+    EXPECT_TRUE(sum == (Matrix3x3{ false }));
+
+    auto expression = matrix1;
+    expression = expression.transpose() + matrix2;
+    EXPECT_TRUE(expression == (Matrix3x3{ 2, 4, 7, 2, 7, 8, 3, 6, 12 }));
+
+    // a row of the matrix written into one of its columns
+    auto crossed = matrix1;
+    crossed.column(2) = crossed.row(0).transpose();
+    EXPECT_TRUE(crossed == (Matrix3x3{ 1, 2, 1, 4, 5, 2, 7, 8, 3 }));
+
+    // a block overlapping the block it is copied to
+    auto shifted = matrix1;
+    shifted.block<2, 2>(1, 1) = shifted.block<2, 2>(0, 0);
+    EXPECT_TRUE(shifted == (Matrix3x3{ 1, 2, 3, 4, 1, 2, 7, 4, 5 }));
+
+    shifted = matrix1;
+    shifted.block<2, 2>(1, 1) += shifted.block<2, 2>(0, 0);
+    EXPECT_TRUE(shifted == (Matrix3x3{ 1, 2, 3, 4, 6, 8, 7, 12, 14 }));
+
+    // large enough to be split across threads
+    auto large = matrix<128, 128>{ false };
+
+    for (auto row{ 0_ui64 }; row < 128; ++row)
+    {
+        for (auto col{ 0_ui64 }; col < 128; ++col)
+        {
+            large[row][col] = static_cast<double>(row * 128 + col);
+        }
+    }
+
+    large += large.transpose();
+
+    for (auto row{ 0_ui64 }; row < 128; ++row)
+    {
+        for (auto col{ 0_ui64 }; col < 128; ++col)
+        {
+            ASSERT_EQ(large[row][col], static_cast<double>((row + col) * 129)) << row << ", " << col;
+        }
+    }
+}
+
+
+TEST(MatrixTests, BlockedViewProductTests)
+{
+    // blocks keep the stride of their matrix through the blocked kernel
+    auto lhs = matrix<70, 90>{ false };
+    auto rhs = matrix<90, 70>{ false };
+
+    for (auto row{ 0_ui64 }; row < 70; ++row)
+    {
+        for (auto col{ 0_ui64 }; col < 90; ++col)
+        {
+            lhs[row][col] = static_cast<double>((row * 7 + col * 3) % 9) - 4;
+            rhs[col][row] = static_cast<double>((row * 5 + col * 11) % 7) - 3;
+        }
+    }
+
+    auto left = matrix<40, 50>{ lhs.block<40, 50>(3, 20) };
+    auto right = matrix<50, 30>{ rhs.block<50, 30>(11, 5) };
+
+    EXPECT_TRUE((lhs.block<40, 50>(3, 20) * rhs.block<50, 30>(11, 5) == left * right));
+    EXPECT_TRUE((lhs.block<40, 50>(3, 20) * right == left * right));
+    EXPECT_TRUE((rhs.block<50, 30>(11, 5).transpose() * left.transpose() == ~(left * right)));
+}
+
+
+
+TEST(MatrixTests, ViewBoundsTests)
+{
+    auto matrix1 = Matrix3x3{ 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+
+    EXPECT_THROW(matrix1.row(3), std::out_of_range);
+    EXPECT_THROW(matrix1.column(3), std::out_of_range);
+    EXPECT_THROW((matrix1.block<2, 2>(2, 0)), std::out_of_range);
+    EXPECT_THROW((matrix1.block<2, 2>(0, 2)), std::out_of_range);
+    EXPECT_THROW((matrix1.select(std::array{ 0_ui64, 3_ui64 }, std::array{ 1_ui64 })), std::out_of_range);
+    EXPECT_THROW(matrix1.leftover(0, 3), std::out_of_range);
+
+    // within the matrix, but past the view they are taken from
+    EXPECT_THROW((matrix1.block<2, 2>(1, 1).row(2)), std::out_of_range);
+    EXPECT_THROW((matrix1.block<2, 3>(0, 0).transpose().block<2, 2>(2, 0)), std::out_of_range);
+    EXPECT_NO_THROW((matrix1.block<2, 3>(0, 0).transpose().block<2, 2>(1, 0)));
+}
+
+
+TEST(MatrixTests, ViewAlgebraTests)
+{
+    constexpr auto matrix1 = Matrix4x4{ 5, -2,  2, 7,
+                                        1,  0,  0, 3,
+                                       -3,  1,  5, 0,
+                                        3, -1, -9, 4, };
+
+    constexpr auto inner = Matrix3x3{ matrix1.block<3, 3>(1, 1) };
+
+    // determinants and inverses of views read the viewed elements where they are
+    static_assert(matrix1.block<3, 3>(1, 1).determinant() == inner.determinant());
+    static_assert(matrix1.leftover(0, 0).determinant() == matrix1.leftover_elements(0, 0).determinant());
+    static_assert(matrix1.block<2, 2>(0, 0).inverse() == Matrix2x2{ 0, 1, -0.5, 2.5 });
+
+    EXPECT_NEAR(matrix1.transpose().determinant(), 88.0, 1e-12);
+    EXPECT_NEAR((lu_decomposition<3, double>{ matrix1.block<3, 3>(1, 1) }.determinant()), inner.determinant(), 1e-12);
+
+    // a view solved against a view of right-hand sides
+    auto solutions = matrix1.block<3, 3>(1, 1).solve(matrix1.block<3, 1>(1, 0));
+    auto check = inner * solutions;
+
+    for (auto row{ 0_ui64 }; row < 3; ++row)
+    {
+        EXPECT_NEAR(check[row][0], matrix1[row + 1][0], 1e-12);
+    }
+
+    auto inverse = matrix1.transpose().inverse();
+
+    for (auto row{ 0_ui64 }; row < 4; ++row)
+    {
+        for (auto col{ 0_ui64 }; col < 4; ++col)
+        {
+            EXPECT_NEAR(inverse[row][col], matrix1.inverse()[col][row], 1e-12);
+        }
+    }
+
+    // ring elements take the same path
+    constexpr auto integers = matrix<4, 4, int64_t>{ 0, 1, 2, 3, 1, 0, 4, 5, 2, 4, 0, 6, 3, 5, 6, 0 };
+
+    static_assert(integers.transpose().determinant() == -224);
+    static_assert(integers.select(std::array{ 0_ui64, 1_ui64 }, std::array{ 0_ui64, 1_ui64 }).inverse() ==
+                  matrix<2, 2, int64_t>{ 0, 1, 1, 0 });
+}
+
 TEST(MatrixTests, MatrixTests)
 {
     static_assert(IsMatrix<matrix<2, 3>>);
@@ -235,5 +556,179 @@ TEST(MatrixTests, InverseTests)
         }
     }
 
-    EXPECT_EQ(mat, matrix1.inverse());
+    constexpr auto inverse{ matrix1.inverse() };
+
+    for (auto row{ 0_ui64 }; row < 4; ++row)
+    {
+        for (auto col{ 0_ui64 }; col < 4; ++col)
+        {
+            EXPECT_NEAR(mat[row][col], inverse[row][col], 1e-12);
+        }
+    }
+
+    constexpr auto product{ matrix1 * inverse };
+
+    for (auto row{ 0_ui64 }; row < 4; ++row)
+    {
+        for (auto col{ 0_ui64 }; col < 4; ++col)
+        {
+            EXPECT_NEAR(product[row][col], row == col ? 1.0 : 0.0, 1e-12);
+        }
+    }
+
+    static_assert(Matrix2x2{ 4, 7, 2, 6 }.inverse() == Matrix2x2{ 0.6, -0.7, -0.2, 0.4 });
+    static_assert(matrix<1, 1>{ 4 }.inverse() == matrix<1, 1>{ 0.25 });
+
+    EXPECT_THROW(Matrix2x2(false).inverse(), std::domain_error);
+    EXPECT_THROW((Matrix4x4{ 1, 2, 3, 4, 2, 4, 6, 8, 0, 1, 0, 1, 5, 0, 2, 1 }.inverse()), std::domain_error);
+}
+
+
+/**
+ * @brief An 8x8 transform, inverted in O(n^3) rather than through 64 factorial-time minors
+ *
+ */
+TEST(MatrixTests, LargeInverseTests)
+{
+    auto mat = matrix<8, 8>{};
+
+    for (auto row{ 0_ui64 }; row < 8; ++row)
+    {
+        for (auto col{ 0_ui64 }; col < 8; ++col)
+        {
+            mat[row][col] = std::cos(static_cast<double>((2 * col + 1) * row) * 3.14159265358979323846 / 16.0) +
+                            (row == col ? 1.0 : 0.0);
+        }
+    }
+
+    auto product{ mat * mat.inverse() };
+
+    for (auto row{ 0_ui64 }; row < 8; ++row)
+    {
+        for (auto col{ 0_ui64 }; col < 8; ++col)
+        {
+            EXPECT_NEAR(product[row][col], row == col ? 1.0 : 0.0, 1e-12);
+        }
+    }
+}
+
+
+TEST(MatrixTests, LuDecompositionTests)
+{
+    constexpr auto matrix1 = Matrix4x4{ 5, -2,  2, 7,
+                                        1,  0,  0, 3,
+                                       -3,  1,  5, 0,
+                                        3, -1, -9, 4, };
+
+    constexpr auto lu = matrix1.lu();
+
+    static_assert(!lu.singular);
+
+    // the pivots keep every multiplier within [-1, 1]
+    for (auto row{ 0_ui64 }; row < 4; ++row)
+    {
+        for (auto col{ 0_ui64 }; col < row; ++col)
+        {
+            EXPECT_LE(std::abs(lu.factors[row][col]), 1.0);
+        }
+    }
+
+    auto lower = Matrix4x4{};
+    auto upper = Matrix4x4{ false };
+
+    for (auto row{ 0_ui64 }; row < 4; ++row)
+    {
+        for (auto col{ 0_ui64 }; col < 4; ++col)
+        {
+            (col < row ? lower : upper)[row][col] = lu.factors[row][col];
+        }
+    }
+
+    auto product = lower * upper;
+
+    for (auto row{ 0_ui64 }; row < 4; ++row)
+    {
+        for (auto col{ 0_ui64 }; col < 4; ++col)
+        {
+            EXPECT_NEAR(product[row][col], matrix1[lu.permutation[row]][col], 1e-12);
+        }
+    }
+
+    static_assert(matrix1.determinant() > 88.0 - 1e-9 && matrix1.determinant() < 88.0 + 1e-9);
+
+    constexpr auto singular = Matrix4x4{ 1, 2, 3, 4,
+                                         2, 4, 6, 8,
+                                         0, 1, 0, 1,
+                                         5, 0, 2, 1, };
+
+    static_assert(singular.lu().singular);
+    static_assert(singular.determinant() == 0.0);
+}
+
+
+TEST(MatrixTests, LargeDeterminantTests)
+{
+    // a 16x16 matrix, beyond the reach of cofactor expansion
+    auto mat = matrix<16, 16>{};
+    auto expected{ 1.0 };
+
+    for (auto row{ 0_ui64 }; row < 16; ++row)
+    {
+        for (auto col{ 0_ui64 }; col < 16; ++col)
+        {
+            mat[row][col] = col >= row ? static_cast<double>(row + col + 1) : 0.0;
+        }
+
+        expected *= static_cast<double>(2 * row + 1);
+    }
+
+    // mixing rows keeps the determinant, swapping two negates it
+    for (auto row{ 1_ui64 }; row < 16; ++row)
+    {
+        for (auto col{ 0_ui64 }; col < 16; ++col)
+        {
+            mat[row][col] += 0.5 * mat[row - 1][col];
+        }
+    }
+
+    std::swap(mat[3], mat[11]);
+
+    EXPECT_NEAR(mat.determinant() / -expected, 1.0, 1e-12);
+}
+
+
+TEST(MatrixTests, SolveTests)
+{
+    constexpr auto matrix1 = Matrix4x4{ 5, -2,  2, 7,
+                                        1,  0,  0, 3,
+                                       -3,  1,  5, 0,
+                                        3, -1, -9, 4, };
+
+    constexpr auto x = std::array<double, 4>{ 1, -2, 3, 0.5 };
+
+    constexpr auto b = matrix1 * matrix<4, 1>{ 1, -2, 3, 0.5 };
+
+    constexpr auto solution = matrix1.solve(std::array<double, 4>{ b[0][0], b[1][0], b[2][0], b[3][0] });
+
+    for (auto row{ 0_ui64 }; row < 4; ++row)
+    {
+        EXPECT_NEAR(solution[row], x[row], 1e-12);
+    }
+
+    // several right-hand sides at once
+    constexpr auto expected = matrix<4, 2>{ 1, 4, -2, 0, 3, -1, 0.5, 2 };
+
+    constexpr auto solutions = matrix1.solve(matrix1 * expected);
+
+    for (auto row{ 0_ui64 }; row < 4; ++row)
+    {
+        for (auto col{ 0_ui64 }; col < 2; ++col)
+        {
+            EXPECT_NEAR(solutions[row][col], expected[row][col], 1e-12);
+        }
+    }
+
+    constexpr auto singular = Matrix3x3{ 1, 2, 3, 2, 4, 6, 0, 1, 0 };
+
+    EXPECT_THROW(singular.solve(std::array<double, 3>{ 1, 2, 3 }), std::domain_error);
 }
@@ -0,0 +1,195 @@
+/**
+ * @file name_search_tests.cpp
+ * @author ashwinn76
+ * @brief Tests for the radix trie search over entry names
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+
+#include "passwordlib/name_search.hpp"
+#include "vault_test_utils.hpp"
+
+
+namespace
+{
+uint32_t edit_distance( std::string_view i_left, std::string_view i_right )
+{
+    auto row{ std::vector<uint32_t>( i_right.size() + 1 ) };
+
+    for( auto j{ 0_sz }; j < row.size(); ++j )
+    {
+        row[j] = static_cast<uint32_t>( j );
+    }
+
+    for( auto i{ 1_sz }; i <= i_left.size(); ++i )
+    {
+        auto diagonal{ row[0] };
+        row[0] = static_cast<uint32_t>( i );
+
+        for( auto j{ 1_sz }; j < row.size(); ++j )
+        {
+            auto above{ row[j] };
+            row[j] = std::min( { row[j] + 1, row[j - 1] + 1, diagonal + ( i_left[i - 1] == i_right[j - 1] ? 0 : 1 ) } );
+            diagonal = above;
+        }
+    }
+
+    return row.back();
+}
+
+
+/**
+ * @brief The search a linear scan over every name would do
+ *
+ */
+std::vector<vault::name_match_s> scan_names( const std::vector<std::string>& i_names,
+                                             std::string_view i_query,
+                                             const vault::name_search_options_s& i_options )
+{
+    auto matches{ std::vector<vault::name_match_s>{} };
+
+    for( auto&& name : i_names )
+    {
+        auto distance{ edit_distance( i_query, name ) };
+
+        for( auto length{ 0_sz }; i_options.prefix && length < name.size(); ++length )
+        {
+            distance = std::min( distance, edit_distance( i_query, std::string_view{ name }.substr( 0, length ) ) );
+        }
+
+        if( distance <= i_options.max_distance )
+        {
+            matches.push_back( { name, distance } );
+        }
+    }
+
+    std::sort( matches.begin(), matches.end(), []( auto& i_left, auto& i_right ) {
+        return std::tie( i_left.distance, i_left.name ) < std::tie( i_right.distance, i_right.name );
+    } );
+
+    matches.resize( std::min( matches.size(), i_options.limit ) );
+
+    return matches;
+}
+
+}
+
+
+TEST( NameSearchTests, PrefixAndTypoTests )
+{
+    auto index{ vault::name_index{} };
+
+    for( auto name : { "github.com", "gitlab.com", "gist.github.com", "mail.example.com", "mail", "git" } )
+    {
+        index.insert( name );
+    }
+
+    index.insert( "git" );
+    EXPECT_EQ( index.size(), 6_sz );
+
+    auto options{ vault::name_search_options_s{} };
+
+    EXPECT_EQ( index.search( "git", options ),
+               ( std::vector<vault::name_match_s>{ { "git", 0 }, { "github.com", 0 }, { "gitlab.com", 0 } } ) );
+
+    options.limit = 2;
+    EXPECT_EQ( index.search( "git", options ),
+               ( std::vector<vault::name_match_s>{ { "git", 0 }, { "github.com", 0 } } ) );
+
+    // a typo in a partial host name
+    options.limit = 10;
+    options.max_distance = 1;
+    EXPECT_EQ( index.search( "gihub", options ), ( std::vector<vault::name_match_s>{ { "github.com", 1 } } ) );
+
+    // whole names only
+    options.prefix = false;
+    options.max_distance = 2;
+    EXPECT_EQ( index.search( "gitgub.con", options ), ( std::vector<vault::name_match_s>{ { "github.com", 2 } } ) );
+    EXPECT_EQ( index.search( "mial", options ), ( std::vector<vault::name_match_s>{ { "mail", 2 } } ) );
+
+    options.max_distance = 0;
+    EXPECT_TRUE( index.search( "gi", options ).empty() );
+
+    index.clear();
+    EXPECT_TRUE( index.search( "", {} ).empty() );
+}
+
+
+TEST( NameSearchTests, MatchesLinearScanTests )
+{
+    auto random{ std::mt19937{ 41 } };
+    auto letters{ std::uniform_int_distribution<int>{ 'a', 'e' } };
+    auto lengths{ std::uniform_int_distribution<std::size_t>{ 1, 8 } };
+
+    auto index{ vault::name_index{} };
+    auto names{ std::vector<std::string>{} };
+
+    auto random_name{ [&] {
+        auto name{ std::string( lengths( random ), '\0' ) };
+        std::generate( name.begin(), name.end(), [&] { return static_cast<char>( letters( random ) ); } );
+
+        return name;
+    } };
+
+    for( auto i{ 0 }; i < 3000; ++i )
+    {
+        auto name{ random_name() };
+
+        if( std::find( names.begin(), names.end(), name ) == names.end() )
+        {
+            names.push_back( name );
+        }
+
+        index.insert( name );
+    }
+
+    EXPECT_EQ( index.size(), names.size() );
+
+    for( auto i{ 0 }; i < 200; ++i )
+    {
+        auto query{ random_name() };
+        auto options{ vault::name_search_options_s{} };
+
+        options.max_distance = static_cast<uint32_t>( i % 3 );
+        options.prefix = i % 2 == 0;
+        options.limit = 1 + i % 7;
+
+        EXPECT_EQ( index.search( query, options ), scan_names( names, query, options ) ) << query;
+    }
+}
+
+
+TEST( NameSearchTests, LoadNamesTests )
+{
+    auto file{ temp_vault_path{ "name_search.vault" } };
+
+    auto store{ vault::vault{ file.path, master_key, test_options } };
+
+    for( auto i{ 0 }; i < 500; ++i )
+    {
+        store.put( "host" + std::to_string( i ) + ".example.com", "secret" );
+    }
+
+    store.update( "host7.example.com", "changed" );
+
+    auto index{ vault::name_index{} };
+    vault::load_names( store, index );
+
+    EXPECT_EQ( index.size(), 500_sz );
+
+    auto options{ vault::name_search_options_s{} };
+    options.limit = 3;
+
+    EXPECT_EQ( index.search( "host49", options ),
+               ( std::vector<vault::name_match_s>{
+                   { "host49.example.com", 0 }, { "host490.example.com", 0 }, { "host491.example.com", 0 } } ) );
+}
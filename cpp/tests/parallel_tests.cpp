@@ -0,0 +1,194 @@
+/**
+ * @file parallel_tests.cpp
+ * @author ashwinn76
+ * @brief Tests for the tile scheduler and the multi-threaded matrix operations
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "dynamic_matrix.hpp"
+#include "parallel.hpp"
+
+
+namespace
+{
+/**
+ * @brief Spread work over several threads, whatever the machine, and restore the options afterwards
+ *
+ */
+struct forced_threads
+{
+    parallel::parallel_options_s saved{ parallel::options() };
+
+    explicit forced_threads( std::size_t i_threads )
+    {
+        auto& settings{ parallel::options() };
+
+        settings.threads = i_threads;
+        settings.product_threshold = 1;
+        settings.element_threshold = 1;
+        settings.product_tile = 48;
+        settings.element_tile = 64;
+    }
+
+    ~forced_threads()
+    {
+        parallel::options() = saved;
+    }
+};
+
+
+dynamic_matrix<> pattern_matrix( uint64_t i_rows, uint64_t i_columns, uint64_t i_seed )
+{
+    auto mat{ dynamic_matrix<>{ i_rows, i_columns, false } };
+
+    for( auto row{ 0_ui64 }; row < i_rows; ++row )
+    {
+        for( auto col{ 0_ui64 }; col < i_columns; ++col )
+        {
+            mat[row][col] = static_cast<double>( ( row * i_seed + col * 3 ) % 9 ) - 4;
+        }
+    }
+
+    return mat;
+}
+
+}
+
+
+TEST( ParallelTests, TileSchedulingTests )
+{
+    for( auto threads : { 1_sz, 2_sz, 3_sz, 8_sz } )
+    {
+        for( auto tiles : { 0_sz, 1_sz, 5_sz, 97_sz, 1000_sz } )
+        {
+            auto counts{ std::vector<std::atomic<int>>( tiles ) };
+
+            // early tiles are slow, so the threads that own them fall behind and the others steal
+            parallel::for_each_tile( tiles, threads, [&]( std::size_t i_tile ) {
+                if( i_tile < tiles / 8 )
+                {
+                    std::this_thread::sleep_for( std::chrono::microseconds{ 200 } );
+                }
+
+                counts[i_tile].fetch_add( 1 );
+            } );
+
+            for( auto tile{ 0_sz }; tile < tiles; ++tile )
+            {
+                EXPECT_EQ( counts[tile].load(), 1 ) << threads << " threads, tile " << tile << " of " << tiles;
+            }
+        }
+    }
+}
+
+
+TEST( ParallelTests, WorkerPoolTests )
+{
+    auto seen{ std::set<std::thread::id>{} };
+    auto mutex{ std::mutex{} };
+
+    // the pool keeps its threads, so repeated calls run on the same few; no test asks for more than 8
+    for( auto call{ 0 }; call < 20; ++call )
+    {
+        parallel::for_each_tile( 64, 4, [&]( std::size_t ) {
+            auto lock{ std::lock_guard{ mutex } };
+            seen.insert( std::this_thread::get_id() );
+        } );
+    }
+
+    EXPECT_LE( seen.size(), 8u );
+
+    // work that spreads itself again runs the inner tiles on the thread that took the outer one
+    auto counts{ std::vector<std::atomic<int>>( 16 * 16 ) };
+
+    parallel::for_each_tile( 16, 4, [&]( std::size_t i_outer ) {
+        parallel::for_each_tile( 16, 4, [&]( std::size_t i_inner ) { counts[i_outer * 16 + i_inner].fetch_add( 1 ); } );
+    } );
+
+    for( auto&& count : counts )
+    {
+        EXPECT_EQ( count.load(), 1 );
+    }
+}
+
+
+TEST( ParallelTests, ThrowingTileTests )
+{
+    // a tile that throws on a worker, and one that throws on the calling thread
+    for( auto failing : { 40_sz, 0_sz } )
+    {
+        auto work{ [failing]( std::size_t i_tile ) {
+            if( i_tile == failing )
+            {
+                throw std::runtime_error{ "tile failed" };
+            }
+        } };
+
+        EXPECT_THROW( parallel::for_each_tile( 64, 4, work ), std::runtime_error );
+    }
+
+    // the pool is free again afterwards
+    auto count{ std::atomic<int>{ 0 } };
+    parallel::for_each_tile( 64, 4, [&]( std::size_t ) { count.fetch_add( 1 ); } );
+
+    EXPECT_EQ( count.load(), 64 );
+}
+
+TEST( ParallelTests, ProductTests )
+{
+    auto lhs{ pattern_matrix( 203, 150, 7 ) };
+    auto rhs{ pattern_matrix( 150, 131, 5 ) };
+
+    auto expected{ lhs * rhs };
+
+    auto threads{ forced_threads{ 4 } };
+
+    // tiles of 48 leave ragged edges in both directions
+    EXPECT_TRUE( lhs * rhs == expected );
+
+    auto fixed_lhs{ lhs.fixed<203, 150>() };
+    auto fixed_rhs{ rhs.fixed<150, 131>() };
+
+    EXPECT_TRUE( fixed_lhs * fixed_rhs == expected );
+}
+
+
+TEST( ParallelTests, ElementWiseTests )
+{
+    auto first{ pattern_matrix( 300, 170, 7 ) };
+    auto second{ pattern_matrix( 300, 170, 5 ) };
+
+    auto sum{ first + second };
+    auto difference{ first - second };
+
+    auto threads{ forced_threads{ 3 } };
+
+    EXPECT_TRUE( first + second == sum );
+    EXPECT_TRUE( first - second == difference );
+
+    static auto fixed_first{ first.fixed<300, 170>() };
+    static auto fixed_second{ second.fixed<300, 170>() };
+    static auto fixed_result{ matrix<300, 170>{ false } };
+
+    fixed_result = fixed_first + fixed_second - fixed_second;
+
+    EXPECT_TRUE( fixed_result == fixed_first );
+
+    fixed_result -= fixed_first;
+
+    EXPECT_TRUE( fixed_result == ( matrix<300, 170>{ false } ) );
+}
@@ -0,0 +1,163 @@
+/**
+ * @file password_strength_tests.cpp
+ * @author ashwinn76
+ * @brief Tests for the DAWG dictionary and the password strength estimator
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+#include "passwordlib/dawg.hpp"
+#include "passwordlib/password_strength.hpp"
+#include "passwordlib/password_generator.hpp"
+
+
+TEST( PasswordStrengthTests, DawgRankTests )
+{
+    auto graph{ password_strength::dawg::build( { "password", "dragon", "passwords", "pass", "wordpass", "dragons" } ) };
+
+    EXPECT_EQ( graph.size(), 6_ui32 );
+
+    EXPECT_EQ( graph.rank( "password" ), 1_ui32 );
+    EXPECT_EQ( graph.rank( "dragon" ), 2_ui32 );
+    EXPECT_EQ( graph.rank( "passwords" ), 3_ui32 );
+    EXPECT_EQ( graph.rank( "pass" ), 4_ui32 );
+    EXPECT_EQ( graph.rank( "dragons" ), 6_ui32 );
+
+    EXPECT_FALSE( graph.rank( "passw" ) );
+    EXPECT_FALSE( graph.rank( "dragonss" ) );
+    EXPECT_FALSE( graph.rank( "" ) );
+}
+
+
+TEST( PasswordStrengthTests, DawgMinimizationTests )
+{
+    // "ing" and "s" suffixes are shared, so the graph needs far fewer edges than a trie
+    auto graph{ password_strength::dawg::build( { "walking", "talking", "balking", "walks", "talks", "balks" } ) };
+
+    EXPECT_LT( graph.edge_count(), 16_ui32 );
+
+    EXPECT_EQ( graph.rank( "talks" ), 5_ui32 );
+    EXPECT_EQ( graph.rank( "balking" ), 3_ui32 );
+}
+
+
+TEST( PasswordStrengthTests, DawgMappingTests )
+{
+    auto path{ std::string{ testing::TempDir() } + "dawg_mapping_test.dawg" };
+
+    auto words{ std::vector<std::string>{ "alpha", "beta", "gamma", "delta", "alphabet" } };
+
+    password_strength::dawg::build( words ).save( path );
+
+    auto mapped{ password_strength::dawg::map_file( path ) };
+
+    for( auto i{ 0_sz }; i < words.size(); ++i )
+    {
+        EXPECT_EQ( mapped.rank( words[i] ), static_cast<uint32_t>( i + 1 ) );
+    }
+
+    std::remove( path.c_str() );
+}
+
+
+TEST( PasswordStrengthTests, FrequencyListTests )
+{
+    auto list{ std::istringstream{ "Password\r\nqwerty\n\n \t\r\ncorrecthorse\nPASSWORD\nbatterystaple\n" } };
+
+    auto dictionary{ password_strength::read_frequency_list( list ) };
+
+    // lowercased, blank lines skipped, and a repeated word keeping its first rank
+    EXPECT_EQ( dictionary.size(), 4_ui32 );
+    EXPECT_EQ( dictionary.rank( "password" ), 1_ui32 );
+    EXPECT_EQ( dictionary.rank( "correcthorse" ), 3_ui32 );
+    EXPECT_EQ( dictionary.rank( "batterystaple" ), 5_ui32 );
+    EXPECT_FALSE( dictionary.rank( "" ) );
+
+    // a word of the list rates far lower than with the seed list alone, which does not know it
+    auto estimator{ password_strength::strength_estimator{ { dictionary } } };
+    auto seeded{ password_strength::strength_estimator{ { password_strength::default_dictionary() } } };
+
+    EXPECT_LT( estimator.estimate( "correcthorse" ).entropy, seeded.estimate( "correcthorse" ).entropy );
+
+    // the shared dictionary maps the file the environment names
+    auto path{ std::string{ testing::TempDir() } + "frequency_list_test.dawg" };
+    dictionary.save( path );
+
+    ::setenv( password_strength::dictionary_variable, path.c_str(), 1 );
+    auto mapped{ password_strength::default_dictionary() };
+    ::unsetenv( password_strength::dictionary_variable );
+
+    EXPECT_EQ( mapped.rank( "batterystaple" ), 5_ui32 );
+
+    std::remove( path.c_str() );
+}
+
+
+TEST( PasswordStrengthTests, PatternTests )
+{
+    auto&& estimator{ password_strength::default_estimator() };
+
+    auto weak{ estimator.estimate( "password" ) };
+    EXPECT_EQ( weak.score, 0 );
+    ASSERT_EQ( weak.sequence.size(), 1_sz );
+    EXPECT_EQ( weak.sequence.front().type, password_strength::match_type::dictionary );
+
+    auto l33t{ estimator.estimate( "P@ssw0rd" ) };
+    EXPECT_LT( l33t.entropy, 10.0 );
+    EXPECT_EQ( l33t.sequence.front().type, password_strength::match_type::dictionary );
+
+    auto walk{ estimator.estimate( "zxcvfdsa" ) };
+    EXPECT_EQ( walk.sequence.front().type, password_strength::match_type::keyboard );
+    EXPECT_LT( walk.entropy, estimator.estimate( "zvxcdfas" ).entropy );
+
+    auto date{ estimator.estimate( "12/05/1990" ) };
+    ASSERT_EQ( date.sequence.size(), 1_sz );
+    EXPECT_EQ( date.sequence.front().type, password_strength::match_type::date );
+
+    auto strong{ estimator.estimate( "q7#Rv!2pZ$kL9w" ) };
+    EXPECT_EQ( strong.score, 4 );
+    EXPECT_GT( strong.entropy, 60.0 );
+}
+
+
+TEST( PasswordStrengthTests, BatchTests )
+{
+    auto&& estimator{ password_strength::default_estimator() };
+
+    auto passwords{ std::vector<std::string>{} };
+
+    for( auto i{ 0 }; i < 5000; ++i )
+    {
+        passwords.push_back( "dragon" + std::to_string( i ) + "!x" );
+    }
+
+    auto results{ estimator.estimate_batch( passwords, 4 ) };
+
+    ASSERT_EQ( results.size(), passwords.size() );
+
+    for( auto i{ 0_sz }; i < passwords.size(); i += 499 )
+    {
+        EXPECT_DOUBLE_EQ( results[i].entropy, estimator.estimate( passwords[i] ).entropy );
+    }
+}
+
+
+TEST( PasswordStrengthTests, GeneratorEntropyFloorTests )
+{
+    auto random_str{ password_generator::get_random_string( 16, password_generator::all_special_characters, 60.0 ) };
+
+    EXPECT_EQ( random_str.size(), 16_sz );
+    EXPECT_TRUE( password_strength::default_estimator().meets_floor( random_str, 60.0 ) );
+
+    EXPECT_THROW( password_generator::get_random_string( 4, password_generator::all_special_characters, 80.0 ),
+                  std::runtime_error );
+}
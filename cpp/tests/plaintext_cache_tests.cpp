@@ -0,0 +1,77 @@
+/**
+ * @file plaintext_cache_tests.cpp
+ * @author ashwinn76
+ * @brief Tests for the locked plaintext LRU cache
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "gtest/gtest.h"
+
+#include "passwordlib/plaintext_cache.hpp"
+
+
+TEST( PlaintextCacheTests, LruEvictionTests )
+{
+    auto cache{ vault::plaintext_cache<std::string>{ 3 * vault::cache_slot_size } };
+
+    ASSERT_EQ( cache.capacity(), 3_sz );
+
+    cache.put( "a", "1" );
+    cache.put( "b", "2" );
+    cache.put( "c", "3" );
+
+    // touching a makes b the least recently used
+    EXPECT_EQ( cache.get( "a" ), "1" );
+
+    cache.put( "d", "4" );
+
+    EXPECT_FALSE( cache.get( "b" ) );
+    EXPECT_EQ( cache.get( "a" ), "1" );
+    EXPECT_EQ( cache.get( "c" ), "3" );
+    EXPECT_EQ( cache.get( "d" ), "4" );
+    EXPECT_EQ( cache.size(), 3_sz );
+
+    cache.put( "c", "replaced" );
+
+    EXPECT_EQ( cache.get( "c" ), "replaced" );
+    EXPECT_EQ( cache.size(), 3_sz );
+    EXPECT_EQ( cache.hits(), 5_ui64 );
+    EXPECT_EQ( cache.misses(), 1_ui64 );
+}
+
+
+TEST( PlaintextCacheTests, EraseAndBoundsTests )
+{
+    auto cache{ vault::plaintext_cache<std::string>{ 4 * vault::cache_slot_size } };
+
+    cache.put( "small", "secret" );
+    cache.put( "large", std::string( vault::cache_slot_size, 'x' ) );
+
+    EXPECT_EQ( cache.get( "small" ), "secret" );
+    EXPECT_FALSE( cache.get( "large" ) );
+
+    // replacing with a value too large for a slot drops the old value
+    cache.put( "small", std::string( vault::cache_slot_size, 'x' ) );
+    EXPECT_FALSE( cache.get( "small" ) );
+
+    cache.put( "one", "1" );
+    cache.put( "two", "2" );
+    cache.erase( "one" );
+
+    EXPECT_FALSE( cache.get( "one" ) );
+    EXPECT_EQ( cache.get( "two" ), "2" );
+
+    cache.clear();
+
+    EXPECT_EQ( cache.size(), 0_sz );
+    EXPECT_FALSE( cache.get( "two" ) );
+
+    auto disabled{ vault::plaintext_cache<std::string>{ 0 } };
+    disabled.put( "a", "1" );
+
+    EXPECT_FALSE( disabled.get( "a" ) );
+}
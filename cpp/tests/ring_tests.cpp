@@ -0,0 +1,158 @@
+/**
+ * @file ring_tests.cpp
+ * @author ashwinn76
+ * @brief Tests for matrices over integers, residues modulo n and GF(2^8)
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+
+#include "matrix.hpp"
+
+
+TEST(RingTests, ElementTests)
+{
+    // multiplication example of FIPS-197, section 4.2
+    static_assert(gf256{ 0x57 } * gf256{ 0x83 } == gf256{ 0xC1 });
+    static_assert(gf256{ 0x57 } + gf256{ 0x83 } == gf256{ 0xD4 });
+    static_assert(gf256{ 0x53 }.inverse() == gf256{ 0xCA });
+    static_assert(-gf256{ 0x53 } == gf256{ 0x53 });
+
+    for (auto value{ 1 }; value < 256; ++value)
+    {
+        auto element{ gf256{ static_cast<uint8_t>(value) } };
+        EXPECT_EQ((element * element.inverse()).value(), 1);
+    }
+
+    EXPECT_THROW(gf256{ 0 }.inverse(), std::domain_error);
+
+    static_assert(modular<26>{ -1 }.value() == 25);
+    static_assert(modular<26>{ 3 }.inverse() == modular<26>{ 9 });
+    static_assert(modular<26>{ 20 } - modular<26>{ 23 } == modular<26>{ 23 });
+    static_assert(modular<1_ui64 << 32>{ -1 } * modular<1_ui64 << 32>{ -1 } == modular<1_ui64 << 32>{ 1 });
+
+    EXPECT_THROW(modular<26>{ 13 }.inverse(), std::domain_error);
+}
+
+
+TEST(RingTests, ModularMatrixTests)
+{
+    using z26 = modular<26>;
+
+    // Hill cipher keys and their inverses modulo 26
+    constexpr auto key = matrix<2, 2, z26>{ 3, 3, 2, 5 };
+    static_assert(key.inverse() == matrix<2, 2, z26>{ 15, 17, 20, 9 });
+
+    constexpr auto large_key = matrix<3, 3, z26>{ 6, 24, 1, 13, 16, 10, 20, 17, 15 };
+    static_assert(large_key.determinant() == z26{ 441 });
+    static_assert(large_key.inverse() == matrix<3, 3, z26>{ 8, 5, 10, 21, 8, 21, 21, 12, 8 });
+
+    // determinant 18 shares a factor with 26
+    EXPECT_THROW(( matrix<2, 2, z26>{ 2, 4, 6, 8 }.inverse() ), std::domain_error);
+
+    // invertible modulo 6 although no element of the first column is a unit
+    constexpr auto no_unit_pivot = matrix<3, 3, modular<6>>{ 2, 3, 1, 3, 2, 0, 0, 0, 1 };
+    static_assert(no_unit_pivot * no_unit_pivot.inverse() == IdentityMatrix<3, modular<6>>);
+
+    auto integers = matrix<5, 5, int64_t>
+    {
+         2, -1,  0,  3,  7,
+         4,  9, -2,  1,  0,
+        -3,  5,  8,  2,  1,
+         6,  0,  1, -4,  3,
+         1,  2,  3,  4, 11
+    };
+
+    auto residues{ matrix<5, 5, modular<101>>{ false } };
+
+    for (auto row{ 0_ui64 }; row < 5; ++row)
+    {
+        for (auto col{ 0_ui64 }; col < 5; ++col)
+        {
+            residues[row][col] = integers[row][col];
+        }
+    }
+
+    EXPECT_EQ(residues.determinant(), modular<101>{ integers.determinant() });
+    EXPECT_TRUE(residues * residues.inverse() == (IdentityMatrix<5, modular<101>>));
+}
+
+
+TEST(RingTests, IntegerMatrixTests)
+{
+    auto integers = matrix<5, 5, int64_t>
+    {
+         2, -1,  0,  3,  7,
+         4,  9, -2,  1,  0,
+        -3,  5,  8,  2,  1,
+         6,  0,  1, -4,  3,
+         1,  2,  3,  4, 11
+    };
+
+    auto reals{ matrix<5, 5>{ false } };
+
+    for (auto row{ 0_ui64 }; row < 5; ++row)
+    {
+        for (auto col{ 0_ui64 }; col < 5; ++col)
+        {
+            reals[row][col] = static_cast<double>(integers[row][col]);
+        }
+    }
+
+    EXPECT_EQ(static_cast<double>(integers.determinant()), std::round(reals.determinant()));
+
+    // a zero pivot makes Bareiss' elimination swap rows
+    static_assert(matrix<4, 4, int64_t>{ 0, 1, 2, 3, 1, 0, 4, 5, 2, 4, 0, 6, 3, 5, 6, 0 }.determinant() == -224);
+    static_assert(matrix<4, 4, int64_t>{ 1, 2, 3, 4, 2, 4, 6, 8, 0, 1, 0, 1, 5, 0, 2, 1 }.determinant() == 0);
+
+    // invertible over the rationals but not over the integers
+    constexpr auto rational = matrix<4, 4, int64_t>{ 1, 2, 0, 0, 0, 1, 3, 0, 0, 0, 1, 4, 5, 0, 0, 1 };
+    static_assert(rational.determinant() == -119);
+    EXPECT_THROW(rational.inverse(), std::domain_error);
+
+    // determinant -1, so the inverse is integral too
+    constexpr auto triangular = matrix<4, 4, int64_t>{ 1, 2, 3, 4, 0, 1, 5, 6, 0, 0, -1, 7, 0, 0, 0, 1 };
+    static_assert(triangular * triangular.inverse() == IdentityMatrix<4, int64_t>);
+}
+
+
+TEST(RingTests, GaloisFieldMatrixTests)
+{
+    // AES MixColumns and InvMixColumns, FIPS-197 sections 5.1.3 and 5.3.3
+    constexpr auto mix = matrix<4, 4, gf256>
+    {
+        2, 3, 1, 1,
+        1, 2, 3, 1,
+        1, 1, 2, 3,
+        3, 1, 1, 2
+    };
+
+    constexpr auto inverse_mix = matrix<4, 4, gf256>
+    {
+        14, 11, 13,  9,
+         9, 14, 11, 13,
+        13,  9, 14, 11,
+        11, 13,  9, 14
+    };
+
+    static_assert(mix.inverse() == inverse_mix);
+    static_assert(mix * inverse_mix == IdentityMatrix<4, gf256>);
+    static_assert(mix.determinant() != gf256{ 0 });
+
+    // column of FIPS-197 appendix B, first round
+    constexpr auto column = matrix<4, 1, gf256>{ 0xD4, 0xBF, 0x5D, 0x30 };
+    static_assert(mix * column == matrix<4, 1, gf256>{ 0x04, 0x66, 0x81, 0xE5 });
+
+    auto singular = matrix<4, 4, gf256>{ mix };
+    singular[3] = singular[0];
+
+    EXPECT_EQ(singular.determinant(), gf256{ 0 });
+    EXPECT_THROW(singular.inverse(), std::domain_error);
+}
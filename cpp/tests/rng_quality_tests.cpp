@@ -0,0 +1,415 @@
+/**
+ * @file rng_quality_tests.cpp
+ * @author ashwinn76
+ * @brief Statistical quality and throughput suite for the random generators (NIST SP 800-22 subset)
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * Built as the standalone rng_tests target. The sample size defaults to a quick run and is scaled with the
+ * RNG_TEST_MEGABYTES environment variable, e.g. RNG_TEST_MEGABYTES=256 for a full run.
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "algo_utils.hpp"
+#include "passwordlib/password_generator.hpp"
+
+
+namespace
+{
+// significance level per test; strict so that a healthy generator fails the suite very rarely
+constexpr auto alpha = 1e-4;
+
+constexpr auto block_length = 128_sz;
+
+
+/**
+ * @brief Number of bytes of generator output to test
+ *
+ */
+std::size_t sample_bytes()
+{
+    auto megabytes{ 0.25 };
+
+    if( auto env{ std::getenv( "RNG_TEST_MEGABYTES" ) } )
+    {
+        megabytes = std::max( std::atof( env ), 0.01 );
+    }
+
+    return static_cast<std::size_t>( megabytes * 1024.0 * 1024.0 );
+}
+
+
+unsigned worker_count()
+{
+    return std::max( 1u, std::thread::hardware_concurrency() );
+}
+
+
+/**
+ * @brief Run i_work( begin, end, worker ) over [0, i_count) split evenly across the workers
+ *
+ */
+template<typename _Work>
+void parallel_for( std::size_t i_count, unsigned i_workers, _Work&& i_work )
+{
+    auto threads{ std::vector<std::thread>{} };
+
+    for( auto w{ 0u }; w < i_workers; ++w )
+    {
+        auto begin{ i_count * w / i_workers };
+        auto end{ i_count * ( w + 1 ) / i_workers };
+
+        threads.emplace_back( [&i_work, begin, end, w] { i_work( begin, end, w ); } );
+    }
+
+    for( auto&& thread : threads )
+    {
+        thread.join();
+    }
+}
+
+
+/**
+ * @brief Regularized upper incomplete gamma function Q(a, x)
+ *
+ */
+double igamc( double a, double x )
+{
+    if( x <= 0.0 )
+    {
+        return 1.0;
+    }
+
+    auto log_prefix{ a * std::log( x ) - x - std::lgamma( a ) };
+
+    if( x < a + 1.0 )
+    {
+        // series for P(a, x)
+        auto sum{ 1.0 / a };
+        auto term{ sum };
+
+        for( auto n{ 1 }; n < 100000; ++n )
+        {
+            term *= x / ( a + n );
+            sum += term;
+
+            if( std::abs( term ) < std::abs( sum ) * 1e-15 )
+            {
+                break;
+            }
+        }
+
+        return 1.0 - sum * std::exp( log_prefix );
+    }
+
+    // continued fraction for Q(a, x) (modified Lentz)
+    constexpr auto tiny = 1e-300;
+
+    auto b{ x + 1.0 - a };
+    auto c{ 1.0 / tiny };
+    auto d{ 1.0 / b };
+    auto h{ d };
+
+    for( auto i{ 1 }; i < 100000; ++i )
+    {
+        auto an{ -i * ( i - a ) };
+        b += 2.0;
+        d = an * d + b;
+        d = std::abs( d ) < tiny ? tiny : d;
+        c = b + an / c;
+        c = std::abs( c ) < tiny ? tiny : c;
+        d = 1.0 / d;
+
+        auto delta{ d * c };
+        h *= delta;
+
+        if( std::abs( delta - 1.0 ) < 1e-15 )
+        {
+            break;
+        }
+    }
+
+    return std::exp( log_prefix ) * h;
+}
+
+
+double chi_squared_p_value( const std::vector<uint64_t>& i_observed )
+{
+    auto total{ 0.0 };
+
+    for( auto&& count : i_observed )
+    {
+        total += static_cast<double>( count );
+    }
+
+    auto expected{ total / static_cast<double>( i_observed.size() ) };
+    auto chi2{ 0.0 };
+
+    for( auto&& count : i_observed )
+    {
+        chi2 += ( count - expected ) * ( count - expected ) / expected;
+    }
+
+    return igamc( ( i_observed.size() - 1 ) / 2.0, chi2 / 2.0 );
+}
+
+
+/**
+ * @brief Random bytes drawn from get_random_value along with per-chunk statistics, generated in parallel
+ *
+ */
+struct byte_sample_s
+{
+    std::vector<uint8_t> bytes{};
+    double seconds{ 0.0 };
+};
+
+
+const byte_sample_s& byte_sample()
+{
+    static const auto sample{ [] {
+        auto result{ byte_sample_s{} };
+        result.bytes.resize( sample_bytes() );
+
+        auto start{ std::chrono::steady_clock::now() };
+
+        parallel_for( result.bytes.size(), worker_count(), [&result]( auto begin, auto end, auto ) {
+            for( auto i{ begin }; i < end; ++i )
+            {
+                result.bytes[i] = static_cast<uint8_t>( get_random_value( 0, 255 ) );
+            }
+        } );
+
+        result.seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+
+        return result;
+    }() };
+
+    return sample;
+}
+
+
+inline bool bit_at( const std::vector<uint8_t>& i_bytes, std::size_t i_bit ) noexcept
+{
+    return ( ( i_bytes[i_bit / 8] >> ( 7 - i_bit % 8 ) ) & 1 ) != 0;
+}
+
+}
+
+
+TEST( RngQualityTests, FrequencyTest )
+{
+    auto&& bytes{ byte_sample().bytes };
+
+    auto ones{ std::vector<uint64_t>( worker_count(), 0_ui64 ) };
+
+    parallel_for( bytes.size(), worker_count(), [&]( auto begin, auto end, auto worker ) {
+        for( auto i{ begin }; i < end; ++i )
+        {
+            ones[worker] += static_cast<uint64_t>( __builtin_popcount( bytes[i] ) );
+        }
+    } );
+
+    auto n{ static_cast<double>( bytes.size() * 8 ) };
+    auto total_ones{ 0.0 };
+
+    for( auto&& count : ones )
+    {
+        total_ones += static_cast<double>( count );
+    }
+
+    auto s_obs{ std::abs( 2.0 * total_ones - n ) / std::sqrt( n ) };
+    auto p_value{ std::erfc( s_obs / std::sqrt( 2.0 ) ) };
+
+    EXPECT_GE( p_value, alpha );
+}
+
+
+TEST( RngQualityTests, BlockFrequencyTest )
+{
+    auto&& bytes{ byte_sample().bytes };
+
+    auto blocks{ bytes.size() * 8 / block_length };
+    auto partial{ std::vector<double>( worker_count(), 0.0 ) };
+
+    parallel_for( blocks, worker_count(), [&]( auto begin, auto end, auto worker ) {
+        for( auto block{ begin }; block < end; ++block )
+        {
+            auto ones{ 0 };
+
+            for( auto byte{ block * block_length / 8 }; byte < ( block + 1 ) * block_length / 8; ++byte )
+            {
+                ones += __builtin_popcount( bytes[byte] );
+            }
+
+            auto pi{ static_cast<double>( ones ) / block_length - 0.5 };
+            partial[worker] += pi * pi;
+        }
+    } );
+
+    auto chi2{ 0.0 };
+
+    for( auto&& value : partial )
+    {
+        chi2 += 4.0 * block_length * value;
+    }
+
+    EXPECT_GE( igamc( blocks / 2.0, chi2 / 2.0 ), alpha );
+}
+
+
+TEST( RngQualityTests, RunsTest )
+{
+    auto&& bytes{ byte_sample().bytes };
+
+    auto n{ bytes.size() * 8 };
+    auto workers{ worker_count() };
+
+    auto ones{ std::vector<uint64_t>( workers, 0_ui64 ) };
+    auto runs{ std::vector<uint64_t>( workers, 0_ui64 ) };
+
+    // transitions are counted inside each chunk and between a chunk and the bit before it
+    parallel_for( n, workers, [&]( auto begin, auto end, auto worker ) {
+        for( auto i{ begin }; i < end; ++i )
+        {
+            auto bit{ bit_at( bytes, i ) };
+
+            ones[worker] += bit ? 1 : 0;
+            runs[worker] += ( i > 0 && bit != bit_at( bytes, i - 1 ) ) ? 1 : 0;
+        }
+    } );
+
+    auto pi{ 0.0 };
+    auto v_obs{ 1.0 };
+
+    for( auto w{ 0u }; w < workers; ++w )
+    {
+        pi += static_cast<double>( ones[w] );
+        v_obs += static_cast<double>( runs[w] );
+    }
+
+    pi /= static_cast<double>( n );
+
+    ASSERT_LT( std::abs( pi - 0.5 ), 2.0 / std::sqrt( static_cast<double>( n ) ) ) << "frequency prerequisite failed";
+
+    auto numerator{ std::abs( v_obs - 2.0 * n * pi * ( 1.0 - pi ) ) };
+    auto denominator{ 2.0 * std::sqrt( 2.0 * n ) * pi * ( 1.0 - pi ) };
+
+    EXPECT_GE( std::erfc( numerator / denominator ), alpha );
+}
+
+
+TEST( RngQualityTests, ByteChiSquaredTest )
+{
+    auto&& bytes{ byte_sample().bytes };
+
+    auto counts{ std::vector<std::vector<uint64_t>>( worker_count(), std::vector<uint64_t>( 256, 0_ui64 ) ) };
+
+    parallel_for( bytes.size(), worker_count(), [&]( auto begin, auto end, auto worker ) {
+        for( auto i{ begin }; i < end; ++i )
+        {
+            ++counts[worker][bytes[i]];
+        }
+    } );
+
+    for( auto w{ 1_sz }; w < counts.size(); ++w )
+    {
+        for( auto value{ 0_sz }; value < 256; ++value )
+        {
+            counts[0][value] += counts[w][value];
+        }
+    }
+
+    EXPECT_GE( chi_squared_p_value( counts[0] ), alpha );
+}
+
+
+TEST( RngQualityTests, CharacterClassChiSquaredTest )
+{
+    constexpr auto string_length = 1024;
+
+    auto strings{ std::max<std::size_t>( sample_bytes() / 4 / string_length, 16 ) };
+
+    auto counts{ std::vector<std::vector<uint64_t>>( worker_count(), std::vector<uint64_t>( 256, 0_ui64 ) ) };
+
+    auto start{ std::chrono::steady_clock::now() };
+
+    parallel_for( strings, worker_count(), [&]( auto begin, auto end, auto worker ) {
+        for( auto i{ begin }; i < end; ++i )
+        {
+            for( auto&& c :
+                 password_generator::get_random_string( string_length, password_generator::all_special_characters ) )
+            {
+                ++counts[worker][static_cast<uint8_t>( c )];
+            }
+        }
+    } );
+
+    auto seconds{ std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count() };
+
+    for( auto w{ 1_sz }; w < counts.size(); ++w )
+    {
+        for( auto value{ 0_sz }; value < 256; ++value )
+        {
+            counts[0][value] += counts[w][value];
+        }
+    }
+
+    auto&& total{ counts[0] };
+
+    auto in_class = [&total]( auto&& i_predicate ) {
+        auto observed{ std::vector<uint64_t>{} };
+
+        for( auto value{ 0 }; value < 256; ++value )
+        {
+            if( i_predicate( value ) )
+            {
+                observed.push_back( total[value] );
+            }
+        }
+
+        return observed;
+    };
+
+    auto upper_and_digits{ in_class( []( int c ) { return std::isupper( c ) || std::isdigit( c ); } ) };
+    auto lower{ in_class( []( int c ) { return std::islower( c ) != 0; } ) };
+    auto symbols{ in_class( []( int c ) { return c == ' ' || std::ispunct( c ); } ) };
+
+    EXPECT_EQ( upper_and_digits.size(), 36_sz );
+    EXPECT_EQ( lower.size(), 26_sz );
+    EXPECT_EQ( symbols.size(), 33_sz );
+
+    EXPECT_GE( chi_squared_p_value( upper_and_digits ), alpha );
+    EXPECT_GE( chi_squared_p_value( lower ), alpha );
+    EXPECT_GE( chi_squared_p_value( symbols ), alpha );
+
+    // rejected grid slots are re-rolled, so every allowed character is equally likely across all classes
+    auto all_characters{ in_class( []( int c ) { return std::isgraph( c ) || c == ' '; } ) };
+
+    EXPECT_EQ( all_characters.size(), 95_sz );
+    EXPECT_GE( chi_squared_p_value( all_characters ), alpha );
+
+    RecordProperty( "string_chars_per_second", std::to_string( strings * string_length / seconds ) );
+}
+
+
+TEST( RngQualityTests, ThroughputReport )
+{
+    auto&& sample{ byte_sample() };
+
+    auto megabytes_per_second{ sample.bytes.size() / sample.seconds / ( 1024.0 * 1024.0 ) };
+
+    RecordProperty( "random_value_megabytes_per_second", std::to_string( megabytes_per_second ) );
+
+    EXPECT_GT( megabytes_per_second, 0.0 );
+}
@@ -0,0 +1,119 @@
+/**
+ * @file strassen_tests.cpp
+ * @author ashwinn76
+ * @brief Tests for the Strassen-Winograd product policy
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+
+#include "dynamic_matrix.hpp"
+
+
+namespace
+{
+/**
+ * @brief Fill a matrix with small integers, whose products and sums stay exact through every level of the recursion
+ *
+ */
+template<typename _Matrix>
+void FillPattern(_Matrix& io_matrix, uint64_t i_rows, uint64_t i_columns, uint64_t i_seed)
+{
+    for (auto row{ 0_ui64 }; row < i_rows; ++row)
+    {
+        for (auto col{ 0_ui64 }; col < i_columns; ++col)
+        {
+            io_matrix[row][col] = static_cast<double>((row * i_seed + col * 3) % 9) - 4;
+        }
+    }
+}
+}
+
+
+TEST(StrassenTests, FixedMatrixTests)
+{
+    static auto lhs = matrix<96, 96>{ false };
+    static auto rhs = matrix<96, 96>{ false };
+
+    FillPattern(lhs, 96, 96, 7);
+    FillPattern(rhs, 96, 96, 5);
+
+    // 96 -> 48 -> 24 -> 12, where the blocked kernel takes over
+    EXPECT_TRUE(multiply(lhs, rhs, strassen_policy{ 12 }) == lhs * rhs);
+    EXPECT_TRUE(multiply(lhs, rhs, classical_policy{}) == lhs * rhs);
+
+    // orders at the cutoff, and odd orders, go straight to the blocked kernel
+    EXPECT_TRUE(multiply(lhs, rhs) == lhs * rhs);
+
+    constexpr auto small = Matrix3x3{ 1, 2, 3, 4, 5, 6, 7, 8, 10 };
+
+    EXPECT_TRUE(multiply(small, small, strassen_policy{ 1 }) == small * small);
+}
+
+
+TEST(StrassenTests, DynamicMatrixTests)
+{
+    constexpr auto order = 200_ui64;
+
+    auto lhs = dynamic_matrix<>{ order, order, false };
+    auto rhs = dynamic_matrix<>{ order, order, false };
+
+    FillPattern(lhs, order, order, 7);
+    FillPattern(rhs, order, order, 5);
+
+    auto workspace = strassen::workspace<double>{};
+
+    // 200 -> 100 -> 50 -> 25, which is odd; the padded stride leaves the quadrants unaligned
+    EXPECT_TRUE(multiply(lhs, rhs, strassen_policy{ 16 }, workspace) == lhs * rhs);
+    EXPECT_EQ(workspace.capacity(), 2 * (100 * 100 + 50 * 50 + 25 * 25));
+
+    // the workspace is reused, not grown, for a smaller product
+    auto half = dynamic_matrix<>{ order / 2, order / 2, false };
+    FillPattern(half, order / 2, order / 2, 3);
+
+    EXPECT_TRUE(multiply(half, half, strassen_policy{ 16 }, workspace) == half * half);
+    EXPECT_EQ(workspace.capacity(), 2 * (100 * 100 + 50 * 50 + 25 * 25));
+
+    // non-square operands fall back to the classical product
+    auto wide = dynamic_matrix<>{ order, order + 1, false };
+    FillPattern(wide, order, order + 1, 3);
+
+    EXPECT_TRUE(multiply(lhs, wide, strassen_policy{ 16 }) == lhs * wide);
+}
+
+
+TEST(StrassenTests, AccuracyTests)
+{
+    constexpr auto order = 256_ui64;
+
+    auto lhs = dynamic_matrix<>{ order, order, false };
+    auto rhs = dynamic_matrix<>{ order, order, false };
+
+    for (auto row{ 0_ui64 }; row < order; ++row)
+    {
+        for (auto col{ 0_ui64 }; col < order; ++col)
+        {
+            lhs[row][col] = std::sin(static_cast<double>(row * 3 + col));
+            rhs[row][col] = std::cos(static_cast<double>(row + col * 5));
+        }
+    }
+
+    auto classical = lhs * rhs;
+    auto strassen = multiply(lhs, rhs, strassen_policy{ 8 });
+
+    // five levels of recursion lose a few digits, not the result
+    for (auto row{ 0_ui64 }; row < order; ++row)
+    {
+        for (auto col{ 0_ui64 }; col < order; ++col)
+        {
+            EXPECT_NEAR(strassen[row][col], classical[row][col], 1e-10);
+        }
+    }
+}
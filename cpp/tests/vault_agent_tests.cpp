@@ -0,0 +1,186 @@
+/**
+ * @file vault_agent_tests.cpp
+ * @author ashwinn76
+ * @brief Tests for the resident vault agent
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "gtest/gtest.h"
+
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "passwordlib/vault.hpp"
+#include "passwordlib/vault_agent.hpp"
+#include "vault_test_utils.hpp"
+
+
+TEST( VaultAgentTests, RequestsTests )
+{
+    auto vault_file{ temp_vault_path{ "agent_requests.vault" } };
+    auto socket_file{ temp_vault_path{ "agent_requests.sock" } };
+
+    {
+        auto store{ vault::vault{ vault_file.path, master_key, test_options } };
+        store.put( "mail", "hunter2" );
+
+        auto server{
+            vault::agent_server<vault::vault>{ socket_file.path, vault_file.path, store, std::chrono::seconds{ 10 } } };
+        auto thread{ std::thread{ [&server] { server.run(); } } };
+
+        {
+            auto client{ vault::agent_client{ socket_file.path, vault_file.path } };
+
+            EXPECT_EQ( client.get( "mail" ), "hunter2" );
+            EXPECT_FALSE( client.get( "missing" ) );
+
+            client.put( "bank", "1234" );
+            client.update( "mail", "hunter3" );
+
+            EXPECT_EQ( client.get( "mail" ), "hunter3" );
+            EXPECT_EQ( client.get( "bank" ), "1234" );
+            EXPECT_THROW( client.put( "bank", "again" ), vault::vault_error );
+
+            // the first search indexes the names; later writes join the index
+            auto matches{ client.search( "ma", {} ) };
+            EXPECT_EQ( matches, ( std::vector<vault::name_match_s>{ { "mail", 0 } } ) );
+
+            client.put( "mailbox", "5678" );
+
+            auto options{ vault::name_search_options_s{} };
+            options.max_distance = 1;
+
+            matches = client.search( "nail", options );
+            EXPECT_EQ( matches, ( std::vector<vault::name_match_s>{ { "mail", 1 }, { "mailbox", 1 } } ) );
+        }
+
+        // a second connection sees the same unlocked vault, then locks it
+        auto client{ vault::agent_client{ socket_file.path, vault_file.path } };
+
+        EXPECT_EQ( client.get( "bank" ), "1234" );
+
+        client.lock();
+        thread.join();
+
+        EXPECT_FALSE( server.unlocked() );
+        EXPECT_THROW( ( vault::agent_client{ socket_file.path, vault_file.path } ), vault::vault_error );
+    }
+
+    auto store{ vault::vault{ vault_file.path, master_key, test_options } };
+
+    EXPECT_EQ( store.get( "mail" ), "hunter3" );
+    EXPECT_EQ( store.size(), 3_sz );
+}
+
+
+TEST( VaultAgentTests, IdleTimeoutTests )
+{
+    auto vault_file{ temp_vault_path{ "agent_idle.vault" } };
+    auto socket_file{ temp_vault_path{ "agent_idle.sock" } };
+
+    auto store{ vault::vault{ vault_file.path, master_key, test_options } };
+
+    auto server{ vault::agent_server<vault::vault>{
+        socket_file.path, vault_file.path, store, std::chrono::milliseconds{ 100 } } };
+
+    // run returns by itself once no request arrives within the timeout
+    server.run();
+
+    EXPECT_FALSE( server.unlocked() );
+    EXPECT_THROW( ( vault::agent_client{ socket_file.path, vault_file.path } ), vault::vault_error );
+}
+
+
+TEST( VaultAgentTests, WrongVaultTests )
+{
+    auto vault_file{ temp_vault_path{ "agent_held.vault" } };
+    auto other_file{ temp_vault_path{ "agent_other.vault" } };
+    auto socket_file{ temp_vault_path{ "agent_wrong.sock" } };
+
+    auto store{ vault::vault{ vault_file.path, master_key, test_options } };
+    auto other{ vault::vault{ other_file.path, master_key, test_options } };
+
+    auto server{
+        vault::agent_server<vault::vault>{ socket_file.path, vault_file.path, store, std::chrono::seconds{ 10 } } };
+    auto thread{ std::thread{ [&server] { server.run(); } } };
+
+    // a client for another vault, or for one that does not exist, has to open it itself
+    EXPECT_THROW( ( vault::agent_client{ socket_file.path, other_file.path } ), vault::vault_error );
+    EXPECT_THROW( ( vault::agent_client{ socket_file.path, vault_file.path + ".missing" } ), vault::vault_error );
+
+    auto client{ vault::agent_client{ socket_file.path, vault_file.path } };
+    client.lock();
+    thread.join();
+}
+
+
+TEST( VaultAgentTests, RefreshTests )
+{
+    auto vault_file{ temp_vault_path{ "agent_refresh.vault" } };
+    auto socket_file{ temp_vault_path{ "agent_refresh.sock" } };
+
+    auto store{ vault::vault{ vault_file.path, master_key, test_options } };
+    store.put( "mail", "hunter2" );
+    store.flush();
+
+    auto server{
+        vault::agent_server<vault::vault>{ socket_file.path, vault_file.path, store, std::chrono::seconds{ 10 } } };
+    auto thread{ std::thread{ [&server] { server.run(); } } };
+
+    auto client{ vault::agent_client{ socket_file.path, vault_file.path } };
+
+    EXPECT_EQ( client.get( "mail" ), "hunter2" );
+    EXPECT_EQ( client.search( "ba", {} ).size(), 0_sz );
+
+    {
+        // a change made without the agent, as import or rotate would
+        auto direct{ vault::vault{ vault_file.path, master_key, test_options } };
+        direct.update( "mail", "hunter3" );
+        direct.put( "bank", "1234" );
+        direct.flush();
+    }
+
+    EXPECT_EQ( client.get( "mail" ), "hunter3" );
+    EXPECT_EQ( client.search( "ba", {} ), ( std::vector<vault::name_match_s>{ { "bank", 0 } } ) );
+
+    client.lock();
+    thread.join();
+}
+
+
+TEST( VaultAgentTests, StalledClientTests )
+{
+    auto vault_file{ temp_vault_path{ "agent_stalled.vault" } };
+    auto socket_file{ temp_vault_path{ "agent_stalled.sock" } };
+
+    auto store{ vault::vault{ vault_file.path, master_key, test_options } };
+    store.put( "mail", "hunter2" );
+
+    auto server{
+        vault::agent_server<vault::vault>{ socket_file.path, vault_file.path, store, std::chrono::seconds{ 10 } } };
+    auto thread{ std::thread{ [&server] { server.run(); } } };
+
+    // a client that connects and sends half a length prefix, then goes quiet
+    auto stalled{ vault::unique_fd{ ::socket( AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0 ) } };
+    auto address{ sockaddr_un{} };
+    address.sun_family = AF_UNIX;
+    std::copy( socket_file.path.begin(), socket_file.path.end(), address.sun_path );
+
+    ASSERT_EQ( ::connect( stalled.get(), reinterpret_cast<const sockaddr*>( &address ), sizeof( address ) ), 0 );
+    ASSERT_EQ( ::send( stalled.get(), "\0\0", 2, MSG_NOSIGNAL ), 2 );
+
+    auto start{ std::chrono::steady_clock::now() };
+    auto client{ vault::agent_client{ socket_file.path, vault_file.path } };
+
+    EXPECT_EQ( client.get( "mail" ), "hunter2" );
+    EXPECT_LT( std::chrono::steady_clock::now() - start, std::chrono::seconds{ 1 } );
+
+    client.lock();
+    thread.join();
+}
@@ -0,0 +1,216 @@
+/**
+ * @file vault_backup_tests.cpp
+ * @author ashwinn76
+ * @brief Tests for the content-defined chunking and the incremental backups of a vault
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+#include <random>
+#include <string>
+
+#include "passwordlib/vault_backup.hpp"
+#include "vault_test_utils.hpp"
+
+
+namespace
+{
+const auto other_key = encryption::encryption_key{ "this_is_another_encryption_key__", false };
+
+constexpr auto test_backup_options = vault::backup_options_s{ 16_ui32 };
+
+
+/**
+ * @brief Backup directory removed at the start and the end of the test
+ *
+ */
+struct temp_backup_directory
+{
+    std::string path{};
+
+    explicit temp_backup_directory( std::string_view i_name ) : path{ testing::TempDir() + std::string{ i_name } }
+    {
+        remove();
+    }
+
+    ~temp_backup_directory()
+    {
+        remove();
+    }
+
+    void remove() const
+    {
+        auto command{ "rm -rf '" + path + "'" };
+        EXPECT_EQ( std::system( command.c_str() ), 0 );
+    }
+};
+
+
+/**
+ * @brief Chunk lengths of some data, cut the way a backup cuts the log
+ *
+ */
+std::vector<std::size_t> chunk_lengths( const vault::content_chunker& i_chunker, std::string_view i_data )
+{
+    auto lengths{ std::vector<std::size_t>{} };
+
+    while( !i_data.empty() )
+    {
+        lengths.push_back( i_chunker.cut( i_data, true ) );
+        i_data.remove_prefix( lengths.back() );
+    }
+
+    return lengths;
+}
+
+}
+
+
+TEST( VaultBackupTests, ChunkerTests )
+{
+    auto directory{ temp_backup_directory{ "vault_backup_chunker" } };
+    auto chunker{ vault::backup_store{ directory.path, master_key, test_backup_options }.chunker() };
+
+    auto random{ std::mt19937_64{ 7 } };
+    auto data{ std::string( 1 << 20, '\0' ) };
+
+    for( auto& byte : data )
+    {
+        byte = static_cast<char>( random() );
+    }
+
+    auto lengths{ chunk_lengths( chunker, data ) };
+    auto total{ 0_sz };
+
+    for( auto length : lengths )
+    {
+        total += length;
+        EXPECT_LE( length, 64_sz * 1024 );
+    }
+
+    EXPECT_EQ( total, data.size() );
+
+    // around the average size of 8 KiB
+    EXPECT_GT( lengths.size(), data.size() / ( 16 * 1024 ) );
+    EXPECT_LT( lengths.size(), data.size() / ( 4 * 1024 ) );
+
+    // an insertion in the middle only moves the chunks around it
+    auto edited{ data };
+    edited.insert( data.size() / 2, "inserted bytes" );
+
+    auto edited_lengths{ chunk_lengths( chunker, edited ) };
+    auto same{ 0_sz };
+
+    for( auto front{ 0_sz }; front < lengths.size() && lengths[front] == edited_lengths[front]; ++front )
+    {
+        ++same;
+    }
+
+    for( auto back{ 1_sz }; back <= lengths.size() && lengths[lengths.size() - back] ==
+                                                          edited_lengths[edited_lengths.size() - back]; ++back )
+    {
+        ++same;
+    }
+
+    EXPECT_GE( same + 3, lengths.size() );
+}
+
+
+TEST( VaultBackupTests, IncrementalBackupTests )
+{
+    auto file{ temp_vault_path{ "vault_backup.vault" } };
+    auto restored_file{ temp_vault_path{ "vault_backup_restored.vault" } };
+    auto older_file{ temp_vault_path{ "vault_backup_older.vault" } };
+    auto directory{ temp_backup_directory{ "vault_backup_directory" } };
+
+    auto store{ vault::vault{ file.path, master_key, test_options } };
+    auto records{ std::vector<vault::sealed_entry_s>{} };
+
+    for( auto i{ 0 }; i < 5000; ++i )
+    {
+        records.push_back( store.seal_entry( "entry" + std::to_string( i ), "secret" + std::to_string( i ) ) );
+    }
+
+    store.append_sealed( records );
+
+    auto backups{ vault::backup_store{ directory.path, master_key, test_backup_options } };
+    auto first{ backups.backup( store ) };
+
+    EXPECT_EQ( first.new_chunks, first.chunks );
+    EXPECT_EQ( first.reused_bytes, 0_ui64 );
+
+    store.update( "entry10", "changed" );
+    store.put( "new entry", "new" );
+    store.flush();
+
+    auto second{ backups.backup( store ) };
+
+    // the old log is taken over; only its last chunk, the new tail and the header are chunked again
+    EXPECT_GT( second.reused_bytes, first.bytes - 64 * 1024 - 1024 );
+    EXPECT_LE( second.new_chunks, 4_sz );
+    EXPECT_LT( second.new_bytes, 80_ui64 * 1024 );
+
+    auto snapshots{ backups.snapshots() };
+
+    ASSERT_EQ( snapshots.size(), 2_sz );
+    EXPECT_EQ( snapshots.back(), second.snapshot );
+
+    // a backup of an unchanged vault stores nothing but the manifest
+    auto third{ backups.backup( store ) };
+    EXPECT_EQ( third.new_chunks, 0_sz );
+
+    backups.restore( second.snapshot, restored_file.path );
+    backups.restore( first.snapshot, older_file.path );
+
+    EXPECT_THROW( backups.restore( first.snapshot, older_file.path ), vault::vault_error );
+
+    auto restored{ vault::vault{ restored_file.path, master_key, test_options } };
+    auto older{ vault::vault{ older_file.path, master_key, test_options } };
+
+    EXPECT_EQ( restored.size(), 5001_sz );
+    EXPECT_EQ( restored.get( "entry10" ), "changed" );
+    EXPECT_EQ( restored.get( "new entry" ), "new" );
+
+    EXPECT_EQ( older.size(), 5000_sz );
+    EXPECT_EQ( older.get( "entry10" ), "secret10" );
+    EXPECT_FALSE( older.get( "new entry" ) );
+
+    // a compaction rewrites the log under a new id, so nothing is taken over without reading it
+    store.compact();
+
+    auto compacted{ backups.backup( store ) };
+    EXPECT_EQ( compacted.reused_bytes, 0_ui64 );
+
+    auto compacted_file{ temp_vault_path{ "vault_backup_compacted.vault" } };
+    backups.restore( compacted.snapshot, compacted_file.path );
+
+    EXPECT_EQ( ( vault::vault{ compacted_file.path, master_key, test_options }.get( "entry10" ) ), "changed" );
+}
+
+
+TEST( VaultBackupTests, WrongKeyTests )
+{
+    auto file{ temp_vault_path{ "vault_backup_key.vault" } };
+    auto restored_file{ temp_vault_path{ "vault_backup_key_restored.vault" } };
+    auto directory{ temp_backup_directory{ "vault_backup_key_directory" } };
+
+    auto store{ vault::vault{ file.path, master_key, test_options } };
+    store.put( "mail", "secret" );
+    store.flush();
+
+    auto snapshot{ vault::backup_store{ directory.path, master_key, test_backup_options }.backup( store ).snapshot };
+
+    EXPECT_THROW( ( vault::backup_store{ directory.path, other_key, test_backup_options } ), vault::vault_error );
+
+    auto backups{ vault::backup_store{ directory.path, master_key, test_backup_options } };
+    EXPECT_THROW( backups.restore( "20000101T000000.000Z", restored_file.path ), vault::vault_error );
+
+    backups.restore( snapshot, restored_file.path );
+    EXPECT_EQ( ( vault::vault{ restored_file.path, master_key, test_options }.get( "mail" ) ), "secret" );
+}
@@ -0,0 +1,240 @@
+/**
+ * @file vault_sync_tests.cpp
+ * @author ashwinn76
+ * @brief Tests for the Merkle tree and the synchronisation of vault replicas
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "gtest/gtest.h"
+
+#include <string>
+
+#include "passwordlib/vault_sync.hpp"
+#include "vault_test_utils.hpp"
+
+
+namespace
+{
+vault::blind_index_t test_index( uint32_t i_value )
+{
+    auto digest{ encryption::sha256::hash( &i_value, sizeof( i_value ) ) };
+
+    auto index{ vault::blind_index_t{} };
+    std::copy_n( digest.begin(), index.size(), index.begin() );
+
+    return index;
+}
+
+
+vault::merkle_digest_t test_digest( uint32_t i_value )
+{
+    return vault::record_digest( std::to_string( i_value ) );
+}
+
+}
+
+
+TEST( VaultSyncTests, MerkleTreeTests )
+{
+    auto forward{ vault::merkle_tree{} };
+    auto backward{ vault::merkle_tree{} };
+
+    EXPECT_EQ( forward.hash( 0, 0 ), vault::merkle_digest_t{} );
+
+    for( auto i{ 0_ui32 }; i < 1000; ++i )
+    {
+        forward.set( test_index( i ), test_digest( i ) );
+        backward.set( test_index( 999 - i ), test_digest( 999 - i ) );
+    }
+
+    EXPECT_EQ( forward.size(), 1000_sz );
+    EXPECT_NE( forward.hash( 0, 0 ), vault::merkle_digest_t{} );
+    EXPECT_EQ( forward.hash( 0, 0 ), backward.hash( 0, 0 ) );
+
+    auto root{ forward.hash( 0, 0 ) };
+    auto bucket{ vault::merkle_tree::bucket_of( test_index( 7 ) ) };
+    auto leaf{ forward.hash( vault::merkle_tree::depth, bucket ) };
+
+    forward.set( test_index( 7 ), test_digest( 7000 ) );
+
+    EXPECT_NE( forward.hash( 0, 0 ), root );
+    EXPECT_NE( forward.hash( vault::merkle_tree::depth, bucket ), leaf );
+    EXPECT_EQ( forward.find( test_index( 7 ) ), test_digest( 7000 ) );
+
+    // only the path to the changed leaf differs
+    auto sibling{ ( bucket >> 12 ) ^ 1 };
+    EXPECT_EQ( forward.hash( 1, sibling ), backward.hash( 1, sibling ) );
+
+    forward.set( test_index( 7 ), test_digest( 7 ) );
+    EXPECT_EQ( forward.hash( 0, 0 ), root );
+
+    forward.erase( test_index( 7 ) );
+    EXPECT_FALSE( forward.find( test_index( 7 ) ) );
+    EXPECT_EQ( forward.size(), 999_sz );
+
+    forward.clear();
+    EXPECT_EQ( forward.hash( 0, 0 ), vault::merkle_digest_t{} );
+}
+
+
+TEST( VaultSyncTests, VersionVectorTests )
+{
+    auto first{ vault::bump_version( {}, 5 ) };
+    auto second{ vault::bump_version( first, 3 ) };
+    auto other{ vault::bump_version( first, 9 ) };
+
+    EXPECT_EQ( second, ( vault::version_vector_t{ { 3, 1 }, { 5, 1 } } ) );
+
+    EXPECT_TRUE( vault::descends( second, first ) );
+    EXPECT_FALSE( vault::descends( first, second ) );
+    EXPECT_TRUE( vault::descends( second, second ) );
+
+    EXPECT_FALSE( vault::descends( second, other ) );
+    EXPECT_FALSE( vault::descends( other, second ) );
+
+    auto merged{ vault::merge_versions( second, vault::bump_version( other, 5 ) ) };
+
+    EXPECT_EQ( merged, ( vault::version_vector_t{ { 3, 1 }, { 5, 2 }, { 9, 1 } } ) );
+    EXPECT_TRUE( vault::descends( merged, second ) );
+    EXPECT_TRUE( vault::descends( merged, other ) );
+}
+
+
+TEST( VaultSyncTests, ReplicaSyncTests )
+{
+    auto file{ temp_vault_path{ "vault_sync_local.vault" } };
+    auto replica_file{ temp_vault_path{ "vault_sync_replica.vault" } };
+
+    auto local{ vault::vault{ file.path, master_key, test_options } };
+
+    local.put( "shared", "one" );
+    local.put( "contested", "base" );
+    local.checkpoint();
+    local.clone( replica_file.path );
+
+    auto replica{ vault::vault{ replica_file.path, master_key, test_options } };
+
+    EXPECT_NE( replica.replica_id(), local.replica_id() );
+    EXPECT_EQ( replica.get( "contested" ), "base" );
+    EXPECT_EQ( replica.merkle_hash( 0, 0 ), local.merkle_hash( 0, 0 ) );
+
+    local.put( "local only", "L" );
+    local.update( "shared", "two" );
+    replica.put( "replica only", "R" );
+
+    // both sides change the same entry; the replica has made more updates to it and wins
+    local.update( "contested", "from local" );
+    replica.update( "contested", "from replica 1" );
+    replica.update( "contested", "from replica 2" );
+
+    auto stats{ vault::sync_vaults( local, replica ) };
+
+    EXPECT_EQ( stats.conflicts, 1_sz );
+    EXPECT_EQ( stats.records_pulled, 2_sz );
+    EXPECT_EQ( stats.records_pushed, 3_sz );
+
+    for( auto* store : { &local, &replica } )
+    {
+        EXPECT_EQ( store->size(), 4_sz );
+        EXPECT_EQ( store->get( "shared" ), "two" );
+        EXPECT_EQ( store->get( "local only" ), "L" );
+        EXPECT_EQ( store->get( "replica only" ), "R" );
+        EXPECT_EQ( store->get( "contested" ), "from replica 2" );
+    }
+
+    EXPECT_EQ( local.merkle_hash( 0, 0 ), replica.merkle_hash( 0, 0 ) );
+
+    // the merged version descends from both sides, so a later update on either side wins outright
+    local.update( "contested", "after merge" );
+
+    stats = vault::sync_vaults( replica, local );
+
+    EXPECT_EQ( stats.conflicts, 0_sz );
+    EXPECT_EQ( stats.records_pulled, 1_sz );
+    EXPECT_EQ( replica.get( "contested" ), "after merge" );
+
+    // nothing left to exchange: only the roots are compared
+    stats = vault::sync_vaults( local, replica );
+
+    EXPECT_EQ( stats.nodes_compared, 1_sz );
+    EXPECT_EQ( stats.records_pulled + stats.records_pushed, 0_sz );
+
+    // the record digests survive a checkpoint and a reopen
+    auto root{ local.merkle_hash( 0, 0 ) };
+    local.checkpoint();
+
+    auto reopened{ vault::vault{ file.path, master_key, test_options } };
+    EXPECT_EQ( reopened.merkle_hash( 0, 0 ), root );
+}
+
+
+TEST( VaultSyncTests, DeltaSizeTests )
+{
+    auto file{ temp_vault_path{ "vault_sync_delta.vault" } };
+    auto replica_file{ temp_vault_path{ "vault_sync_delta_replica.vault" } };
+
+    auto local{ vault::vault{ file.path, master_key, test_options } };
+    auto records{ std::vector<vault::sealed_entry_s>{} };
+
+    for( auto i{ 0 }; i < 5000; ++i )
+    {
+        records.push_back( local.seal_entry( "entry" + std::to_string( i ), "secret" + std::to_string( i ) ) );
+    }
+
+    local.append_sealed( records );
+    local.clone( replica_file.path );
+
+    auto replica{ vault::vault{ replica_file.path, master_key, test_options } };
+
+    local.update( "entry10", "changed" );
+    local.update( "entry2000", "changed" );
+    replica.update( "entry4321", "changed" );
+
+    auto stats{ vault::sync_vaults( local, replica ) };
+
+    EXPECT_EQ( stats.records_pulled, 1_sz );
+    EXPECT_EQ( stats.records_pushed, 2_sz );
+    EXPECT_EQ( stats.conflicts, 0_sz );
+
+    // the root, then sixteen children per differing node on each of the levels below it
+    EXPECT_LE( stats.nodes_compared, 1 + 3 * vault::merkle_tree::fanout * vault::merkle_tree::depth );
+
+    EXPECT_EQ( replica.get( "entry10" ), "changed" );
+    EXPECT_EQ( local.get( "entry4321" ), "changed" );
+    EXPECT_EQ( local.merkle_hash( 0, 0 ), replica.merkle_hash( 0, 0 ) );
+}
+
+
+TEST( VaultSyncTests, ForeignVaultTests )
+{
+    auto file{ temp_vault_path{ "vault_sync_one.vault" } };
+    auto other_file{ temp_vault_path{ "vault_sync_other.vault" } };
+
+    auto store{ vault::vault{ file.path, master_key, test_options } };
+    auto other{ vault::vault{ other_file.path, master_key, test_options } };
+
+    store.put( "mail", "one" );
+    other.put( "mail", "two" );
+
+    // same master key but a different salt: not a replica, and its records do not authenticate here
+    EXPECT_THROW( vault::sync_vaults( store, other ), vault::vault_error );
+    auto foreign{ std::string{} };
+
+    for( auto position{ 0_ui32 }; foreign.empty(); ++position )
+    {
+        if( auto bucket{ other.merkle_bucket( position ) }; !bucket.empty() )
+        {
+            foreign = *other.read_record( bucket.front().first );
+        }
+    }
+
+    EXPECT_THROW( store.merge_records( { foreign } ), vault::vault_error );
+    EXPECT_THROW( store.merge_records( { std::string( 64, 'x' ) } ), vault::vault_error );
+
+    EXPECT_EQ( store.get( "mail" ), "one" );
+    EXPECT_THROW( store.clone( other_file.path ), vault::vault_error );
+}
@@ -0,0 +1,52 @@
+/**
+ * @file vault_test_utils.hpp
+ * @author ashwinn76
+ * @brief Master key, options and temporary files shared by the vault tests
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+#include "passwordlib/vault.hpp"
+
+namespace
+{
+const auto master_key = encryption::encryption_key{ "this_is_a_random_encryptionkey__", false };
+
+// few key derivation iterations, so opening a test vault stays cheap
+constexpr auto test_options = vault::vault_options_s{ 16_ui32 };
+
+
+/**
+ * @brief File under the test directory, removed when the test starts and again when it ends, passing or not
+ *
+ */
+struct temp_vault_path
+{
+    std::string path{};
+
+    explicit temp_vault_path( std::string_view i_name ) : path{ testing::TempDir() + std::string{ i_name } }
+    {
+        std::remove( path.c_str() );
+    }
+
+    temp_vault_path( const temp_vault_path& ) = delete;
+    temp_vault_path& operator=( const temp_vault_path& ) = delete;
+
+    ~temp_vault_path()
+    {
+        std::remove( path.c_str() );
+    }
+};
+
+}
@@ -0,0 +1,652 @@
+/**
+ * @file vault_tests.cpp
+ * @author ashwinn76
+ * @brief Tests for the append-only vault storage engine
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "passwordlib/vault.hpp"
+#include "vault_test_utils.hpp"
+
+
+TEST( VaultTests, PutGetUpdateTests )
+{
+    auto file{ temp_vault_path{ "vault_put_get.vault" } };
+
+    auto store{ vault::vault{ file.path, master_key, test_options } };
+
+    store.put( "mail", "hunter2" );
+    store.put( "bank", "correct horse battery staple" );
+
+    EXPECT_EQ( store.get( "mail" ), "hunter2" );
+    EXPECT_EQ( store.get( "bank" ), "correct horse battery staple" );
+    EXPECT_FALSE( store.get( "missing" ) );
+
+    EXPECT_THROW( store.put( "mail", "again" ), vault::vault_error );
+    EXPECT_THROW( store.update( "missing", "value" ), vault::vault_error );
+
+    store.update( "mail", "hunter3" );
+
+    EXPECT_EQ( store.get( "mail" ), "hunter3" );
+    EXPECT_EQ( store.size(), 2_sz );
+}
+
+
+TEST( VaultTests, ReopenTests )
+{
+    auto file{ temp_vault_path{ "vault_reopen.vault" } };
+
+    {
+        auto store{ vault::vault{ file.path, master_key, test_options } };
+
+        for( auto i{ 0 }; i < 100; ++i )
+        {
+            store.put( "entry" + std::to_string( i ), "secret" + std::to_string( i ) );
+        }
+
+        store.update( "entry7", "rotated" );
+    }
+
+    {
+        auto store{ vault::vault{ file.path, master_key, test_options } };
+
+        EXPECT_EQ( store.size(), 100_sz );
+        EXPECT_EQ( store.get( "entry7" ), "rotated" );
+        EXPECT_EQ( store.get( "entry99" ), "secret99" );
+
+        store.put( "late", "value" );
+    }
+
+    auto options{ test_options };
+    options.read_only = true;
+
+    auto store{ vault::vault{ file.path, master_key, options } };
+
+    EXPECT_EQ( store.get( "late" ), "value" );
+    EXPECT_EQ( store.get( "entry0" ), "secret0" );
+    EXPECT_THROW( store.put( "other", "value" ), vault::vault_error );
+}
+
+
+TEST( VaultTests, WrongKeyTests )
+{
+    auto file{ temp_vault_path{ "vault_wrong_key.vault" } };
+
+    {
+        auto store{ vault::vault{ file.path, master_key, test_options } };
+        store.put( "mail", "hunter2" );
+    }
+
+    auto other_key{ encryption::encryption_key{ "another_random_encryption_key___", false } };
+
+    EXPECT_THROW( ( vault::vault{ file.path, other_key, test_options } ), vault::vault_error );
+}
+
+
+TEST( VaultTests, RecoveryTests )
+{
+    auto file{ temp_vault_path{ "vault_recovery.vault" } };
+    auto crashed{ temp_vault_path{ "vault_recovery_crashed.vault" } };
+
+    {
+        // async writes stay past the published root until a flush, where a crash before it leaves them
+        auto options{ test_options };
+        options.durability = vault::durability_mode::async;
+
+        auto store{ vault::vault{ file.path, master_key, options } };
+        store.put( "flushed", "one" );
+        store.flush();
+
+        store.put( "unflushed", "two" );
+        store.put( "torn", "three" );
+
+        // snapshot the file as a crash would leave it: no footer and a torn last record
+        auto source{ vault::unique_fd::open( file.path, O_RDONLY ) };
+        auto bytes{ std::string( vault::file_size( source.get() ) - 3, '\0' ) };
+        vault::read_exact( source.get(), bytes.data(), bytes.size(), 0_ui64 );
+
+        auto target{ vault::unique_fd::open( crashed.path, O_WRONLY | O_CREAT | O_TRUNC ) };
+        vault::write_exact( target.get(), bytes.data(), bytes.size(), 0_ui64 );
+    }
+
+    {
+        auto store{ vault::vault{ crashed.path, master_key, test_options } };
+
+        EXPECT_EQ( store.get( "flushed" ), "one" );
+        EXPECT_EQ( store.get( "unflushed" ), "two" );
+        EXPECT_FALSE( store.get( "torn" ) );
+
+        store.put( "after", "four" );
+    }
+
+    auto store{ vault::vault{ crashed.path, master_key, test_options } };
+
+    EXPECT_EQ( store.size(), 3_sz );
+    EXPECT_EQ( store.get( "after" ), "four" );
+}
+
+
+TEST( VaultTests, CorruptRecordTests )
+{
+    auto file{ temp_vault_path{ "vault_corrupt_record.vault" } };
+
+    auto damaged{ vault::record_location_s{} };
+
+    {
+        auto store{ vault::vault{ file.path, master_key, test_options } };
+
+        for( auto name : { "a", "b", "c", "d" } )
+        {
+            store.put( name, "secret" );
+        }
+
+        damaged = store.entry_locations()[1];
+    }
+
+    // flip a byte inside a committed record in the middle of the log
+    auto size{ uint64_t{} };
+
+    {
+        auto fd{ vault::unique_fd::open( file.path, O_RDWR ) };
+        auto byte{ char{} };
+
+        vault::read_exact( fd.get(), &byte, 1, damaged.offset + damaged.size - 1 );
+        byte ^= 0x01;
+        vault::write_exact( fd.get(), &byte, 1, damaged.offset + damaged.size - 1 );
+
+        size = vault::file_size( fd.get() );
+    }
+
+    // the records committed after it must survive: a writer refuses to open rather than cut the log there
+    EXPECT_THROW( ( vault::vault{ file.path, master_key, test_options } ), vault::vault_error );
+
+    auto options{ test_options };
+    options.read_only = true;
+
+    EXPECT_THROW( ( vault::vault{ file.path, master_key, options } ), vault::vault_error );
+
+    auto fd{ vault::unique_fd::open( file.path, O_RDONLY ) };
+
+    EXPECT_EQ( vault::file_size( fd.get() ), size );
+}
+
+
+TEST( VaultTests, DurabilityModeTests )
+{
+    auto file{ temp_vault_path{ "vault_durability.vault" } };
+
+    {
+        auto options{ test_options };
+        options.durability = vault::durability_mode::per_write;
+
+        auto store{ vault::vault{ file.path, master_key, options } };
+
+        for( auto i{ 0 }; i < 10; ++i )
+        {
+            store.put( "entry" + std::to_string( i ), "secret" );
+        }
+
+        EXPECT_EQ( store.syncs(), 10_ui64 );
+    }
+
+    auto options{ test_options };
+    options.durability = vault::durability_mode::async;
+
+    auto store{ vault::vault{ file.path, master_key, options } };
+
+    for( auto i{ 0 }; i < 10; ++i )
+    {
+        store.update( "entry" + std::to_string( i ), "rotated" );
+    }
+
+    EXPECT_EQ( store.syncs(), 0_ui64 );
+
+    store.flush();
+    store.flush();
+
+    EXPECT_EQ( store.syncs(), 1_ui64 );
+}
+
+
+TEST( VaultTests, GroupCommitTests )
+{
+    auto file{ temp_vault_path{ "vault_group_commit.vault" } };
+
+    constexpr auto writers = 4;
+    constexpr auto writes = 50;
+
+    {
+        auto store{ vault::vault{ file.path, master_key, test_options } };
+
+        auto threads{ std::vector<std::thread>{} };
+
+        for( auto t{ 0 }; t < writers; ++t )
+        {
+            threads.emplace_back( [&store, t] {
+                for( auto i{ 0 }; i < writes; ++i )
+                {
+                    store.put( "job" + std::to_string( t ) + "/" + std::to_string( i ), "secret" );
+                }
+            } );
+        }
+
+        for( auto&& thread : threads )
+        {
+            thread.join();
+        }
+
+        EXPECT_EQ( store.size(), static_cast<std::size_t>( writers * writes ) );
+        EXPECT_LE( store.syncs(), static_cast<uint64_t>( writers * writes ) );
+    }
+
+    auto store{ vault::vault{ file.path, master_key, test_options } };
+
+    EXPECT_EQ( store.size(), static_cast<std::size_t>( writers * writes ) );
+    EXPECT_EQ( store.get( "job3/49" ), "secret" );
+}
+
+
+TEST( VaultTests, SharedCommitTests )
+{
+    auto file{ temp_vault_path{ "vault_shared_commit.vault" } };
+
+    auto options{ test_options };
+    options.durability = vault::durability_mode::async;
+
+    // two handles on one file stand in for two processes
+    auto lazy{ vault::vault{ file.path, master_key, options } };
+    auto eager{ vault::vault{ file.path, master_key, test_options } };
+
+    lazy.put( "async", "one" );
+
+    // a root only ever covers synced frames, so readers do not see the unsynced write yet
+    options.read_only = true;
+    EXPECT_FALSE( ( vault::vault{ file.path, master_key, options }.get( "async" ) ) );
+
+    // the other writer's sync covers every frame in the file, and the root it publishes tells the first one so
+    eager.put( "grouped", "two" );
+    lazy.flush();
+
+    EXPECT_EQ( eager.syncs(), 1_ui64 );
+    EXPECT_EQ( lazy.syncs(), 0_ui64 );
+
+    auto reader{ vault::vault{ file.path, master_key, options } };
+
+    EXPECT_EQ( reader.get( "async" ), "one" );
+    EXPECT_EQ( reader.get( "grouped" ), "two" );
+}
+
+
+TEST( VaultTests, CheckpointReplayTests )
+{
+    auto file{ temp_vault_path{ "vault_checkpoint.vault" } };
+    auto crashed{ temp_vault_path{ "vault_checkpoint_crashed.vault" } };
+
+    auto options{ test_options };
+    options.checkpoint_records = 10;
+
+    {
+        auto store{ vault::vault{ file.path, master_key, options } };
+
+        for( auto i{ 0 }; i < 25; ++i )
+        {
+            store.put( "entry" + std::to_string( i ), "secret" );
+        }
+    }
+
+    {
+        auto store{ vault::vault{ file.path, master_key, options } };
+
+        EXPECT_EQ( store.size(), 25_sz );
+
+        store.update( "entry3", "rotated" );
+        store.put( "logged", "value" );
+
+        // a crash now leaves the log written after the checkpoint and no trailer
+        auto source{ vault::unique_fd::open( file.path, O_RDONLY ) };
+        auto bytes{ std::string( vault::file_size( source.get() ), '\0' ) };
+        vault::read_exact( source.get(), bytes.data(), bytes.size(), 0_ui64 );
+
+        auto target{ vault::unique_fd::open( crashed.path, O_WRONLY | O_CREAT | O_TRUNC ) };
+        vault::write_exact( target.get(), bytes.data(), bytes.size(), 0_ui64 );
+    }
+
+    auto store{ vault::vault{ crashed.path, master_key, options } };
+
+    EXPECT_EQ( store.size(), 26_sz );
+    EXPECT_EQ( store.get( "entry3" ), "rotated" );
+    EXPECT_EQ( store.get( "logged" ), "value" );
+}
+
+
+TEST( VaultTests, SharedFileTests )
+{
+    auto file{ temp_vault_path{ "vault_shared.vault" } };
+
+    // two handles on one file behave like two processes appending to the same log
+    auto first{ vault::vault{ file.path, master_key, test_options } };
+    auto second{ vault::vault{ file.path, master_key, test_options } };
+
+    first.put( "mail", "hunter2" );
+    second.put( "bank", "1234" );
+    second.update( "mail", "hunter3" );
+
+    EXPECT_THROW( first.put( "bank", "again" ), vault::vault_error );
+    EXPECT_EQ( first.get( "mail" ), "hunter3" );
+    EXPECT_EQ( first.size(), 2_sz );
+}
+
+
+TEST( VaultTests, BlindIndexTests )
+{
+    auto file{ temp_vault_path{ "vault_blind_index.vault" } };
+
+    {
+        auto store{ vault::vault{ file.path, master_key, test_options } };
+
+        store.put( "distinctive-entry-name", "distinctive-secret-value" );
+        store.put( "another-entry-name", "value" );
+        store.checkpoint();
+    }
+
+    auto source{ vault::unique_fd::open( file.path, O_RDONLY ) };
+    auto bytes{ std::string( vault::file_size( source.get() ), '\0' ) };
+    vault::read_exact( source.get(), bytes.data(), bytes.size(), 0_ui64 );
+
+    EXPECT_EQ( bytes.find( "distinctive-entry-name" ), std::string::npos );
+    EXPECT_EQ( bytes.find( "distinctive-secret-value" ), std::string::npos );
+
+    auto store{ vault::vault{ file.path, master_key, test_options } };
+
+    EXPECT_EQ( store.get( "distinctive-entry-name" ), "distinctive-secret-value" );
+    EXPECT_TRUE( store.contains( "another-entry-name" ) );
+    EXPECT_FALSE( store.contains( "distinctive-entry" ) );
+}
+
+
+TEST( VaultTests, PlaintextCacheTests )
+{
+    auto file{ temp_vault_path{ "vault_cache.vault" } };
+
+    {
+        auto store{ vault::vault{ file.path, master_key, test_options } };
+
+        for( auto i{ 0 }; i < 100; ++i )
+        {
+            store.put( "entry" + std::to_string( i ), "secret" + std::to_string( i ) );
+        }
+    }
+
+    auto options{ test_options };
+    options.cache_bytes = 8 * vault::cache_slot_size;
+
+    auto store{ vault::vault{ file.path, master_key, options } };
+
+    // nothing is decrypted on open
+    EXPECT_EQ( store.cache().size(), 0_sz );
+
+    EXPECT_EQ( store.get( "entry1" ), "secret1" );
+    EXPECT_EQ( store.get( "entry1" ), "secret1" );
+    EXPECT_EQ( store.cache().hits(), 1_ui64 );
+
+    for( auto i{ 0 }; i < 100; ++i )
+    {
+        EXPECT_EQ( store.get( "entry" + std::to_string( i ) ), "secret" + std::to_string( i ) );
+    }
+
+    EXPECT_EQ( store.cache().size(), 8_sz );
+
+    store.update( "entry99", "rotated" );
+
+    EXPECT_EQ( store.get( "entry99" ), "rotated" );
+}
+
+
+TEST( VaultTests, SnapshotTests )
+{
+    auto file{ temp_vault_path{ "vault_snapshot.vault" } };
+
+    auto writer{ vault::vault{ file.path, master_key, test_options } };
+    writer.put( "mail", "hunter2" );
+
+    auto options{ test_options };
+    options.read_only = true;
+
+    auto reader{ vault::vault{ file.path, master_key, options } };
+    auto pinned{ reader.version() };
+
+    writer.update( "mail", "hunter3" );
+    writer.put( "bank", "1234" );
+
+    // the reader keeps its snapshot while the writer publishes new roots
+    EXPECT_EQ( reader.get( "mail" ), "hunter2" );
+    EXPECT_FALSE( reader.get( "bank" ) );
+    EXPECT_EQ( reader.version(), pinned );
+
+    EXPECT_TRUE( reader.refresh() );
+    EXPECT_FALSE( reader.refresh() );
+
+    EXPECT_EQ( reader.get( "mail" ), "hunter3" );
+    EXPECT_EQ( reader.get( "bank" ), "1234" );
+    EXPECT_EQ( reader.version(), writer.version() );
+}
+
+
+TEST( VaultTests, TornRootTests )
+{
+    auto file{ temp_vault_path{ "vault_torn_root.vault" } };
+
+    auto newest{ uint64_t{} };
+
+    {
+        auto store{ vault::vault{ file.path, master_key, test_options } };
+        store.put( "first", "one" );
+        store.put( "second", "two" );
+
+        newest = store.version();
+    }
+
+    // damage the newest root slot as a torn header write would
+    {
+        auto fd{ vault::unique_fd::open( file.path, O_RDWR ) };
+        auto garbage{ std::string( 8, '\xFF' ) };
+        vault::write_exact( fd.get(), garbage.data(), garbage.size(), 64 + ( newest % 2 ) * 32 + 8 );
+    }
+
+    auto options{ test_options };
+    options.read_only = true;
+
+    auto store{ vault::vault{ file.path, master_key, options } };
+
+    EXPECT_EQ( store.version(), newest - 1 );
+    EXPECT_EQ( store.get( "first" ), "one" );
+    EXPECT_FALSE( store.get( "second" ) );
+}
+
+
+TEST( VaultTests, KeyRotationTests )
+{
+    auto file{ temp_vault_path{ "vault_rotation.vault" } };
+
+    auto new_key{ encryption::encryption_key{ "another_random_encryption_key___", false } };
+
+    {
+        auto store{ vault::vault{ file.path, master_key, test_options } };
+
+        for( auto i{ 0 }; i < 200; ++i )
+        {
+            store.put( "entry" + std::to_string( i ), "secret" + std::to_string( i ) );
+        }
+
+        store.update( "entry7", "rotated" );
+
+        // gets keep working while the entries move to the new key underneath them
+        auto done{ std::atomic<bool>{ false } };
+        auto failures{ std::atomic<int>{ 0 } };
+
+        auto reader{ std::thread{ [&] {
+            while( !done )
+            {
+                failures += store.get( "entry150" ) != "secret150" || store.get( "entry7" ) != "rotated";
+            }
+        } } };
+
+        store.rotate_key( new_key, vault::rotation_options_s{ 2, 16 } );
+
+        done = true;
+        reader.join();
+
+        EXPECT_EQ( failures, 0 );
+        EXPECT_FALSE( store.rotation_pending() );
+        EXPECT_EQ( store.size(), 200_sz );
+
+        store.put( "after", "value" );
+    }
+
+    EXPECT_THROW( ( vault::vault{ file.path, master_key, test_options } ), vault::vault_error );
+
+    auto store{ vault::vault{ file.path, new_key, test_options } };
+
+    EXPECT_EQ( store.size(), 201_sz );
+    EXPECT_EQ( store.get( "entry7" ), "rotated" );
+    EXPECT_EQ( store.get( "entry199" ), "secret199" );
+    EXPECT_EQ( store.get( "after" ), "value" );
+}
+
+
+TEST( VaultTests, RotationResumeTests )
+{
+    auto file{ temp_vault_path{ "vault_rotation_resume.vault" } };
+
+    auto new_key{ encryption::encryption_key{ "another_random_encryption_key___", false } };
+
+    {
+        auto store{ vault::vault{ file.path, master_key, test_options } };
+
+        for( auto i{ 0 }; i < 100; ++i )
+        {
+            store.put( "entry" + std::to_string( i ), "secret" + std::to_string( i ) );
+        }
+
+        store.checkpoint();
+
+        // damage a late checkpointed record so the rotation stops part way, as a crash would
+        for( auto&& location : store.entry_locations() )
+        {
+            if( store.open_entry( location ).name == "entry80" )
+            {
+                auto fd{ vault::unique_fd::open( file.path, O_RDWR ) };
+                auto last{ location.offset + location.size - 1 };
+                auto byte{ char{} };
+
+                // flip the bits rather than write a fixed value, which the tag may already hold
+                vault::read_exact( fd.get(), &byte, 1, last );
+                byte = static_cast<char>( ~byte );
+                vault::write_exact( fd.get(), &byte, 1, last );
+            }
+        }
+
+        EXPECT_THROW( store.rotate_key( new_key, vault::rotation_options_s{ 1, 10 } ), vault::vault_error );
+        EXPECT_TRUE( store.rotation_pending() );
+
+        // both re-encrypted and not yet re-encrypted records stay readable
+        EXPECT_EQ( store.get( "entry1" ), "secret1" );
+        EXPECT_EQ( store.get( "entry99" ), "secret99" );
+    }
+
+    EXPECT_THROW( ( vault::vault{ file.path, master_key, test_options } ), vault::vault_error );
+
+    {
+        auto store{ vault::vault{ file.path, new_key, test_options } };
+
+        EXPECT_TRUE( store.rotation_pending() );
+        EXPECT_EQ( store.get( "entry99" ), "secret99" );
+
+        store.update( "entry80", "replaced" );
+        store.resume_rotation( vault::rotation_options_s{ 1, 10 } );
+
+        EXPECT_FALSE( store.rotation_pending() );
+    }
+
+    auto store{ vault::vault{ file.path, new_key, test_options } };
+
+    EXPECT_FALSE( store.rotation_pending() );
+    EXPECT_EQ( store.size(), 100_sz );
+    EXPECT_EQ( store.get( "entry80" ), "replaced" );
+
+    for( auto i{ 0 }; i < 100; i += 9 )
+    {
+        EXPECT_EQ( store.get( "entry" + std::to_string( i ) ), "secret" + std::to_string( i ) );
+    }
+}
+
+
+TEST( VaultTests, CompactionTests )
+{
+    auto file{ temp_vault_path{ "vault_compaction.vault" } };
+
+    auto store{ vault::vault{ file.path, master_key, test_options } };
+
+    for( auto round{ 0 }; round < 5; ++round )
+    {
+        for( auto i{ 0 }; i < 50; ++i )
+        {
+            store.put( "entry" + std::to_string( i ) + "-" + std::to_string( round ), "secret" );
+            store.update( "entry" + std::to_string( i ) + "-" + std::to_string( round ), "rotated" );
+        }
+    }
+
+    auto before{ store.space_usage() };
+
+    EXPECT_GT( before.fragmentation(), 0.4 );
+
+    auto options{ test_options };
+    options.read_only = true;
+
+    auto reader{ vault::vault{ file.path, master_key, options } };
+    auto other{ vault::vault{ file.path, master_key, test_options } };
+
+    // writes keep landing while a throttled compaction copies the live records
+    auto writer{ std::thread{ [&other] {
+        for( auto i{ 0 }; i < 20; ++i )
+        {
+            other.put( "during" + std::to_string( i ), "value" );
+        }
+    } } };
+
+    auto reclaimed{ store.compact( vault::compaction_options_s{ 256_ui64 * 1024, 4096 } ) };
+    writer.join();
+
+    EXPECT_GT( reclaimed, 0_ui64 );
+    EXPECT_LT( store.space_usage().fragmentation(), 0.1 );
+    EXPECT_LT( store.space_usage().log_bytes, before.log_bytes );
+
+    // the other writer moves to the new file on its next write
+    other.put( "after", "value" );
+    EXPECT_FALSE( store.get( "after" ) );
+    EXPECT_TRUE( store.refresh() );
+    EXPECT_EQ( store.get( "after" ), "value" );
+    EXPECT_EQ( store.size(), 271_sz );
+
+    // the reader keeps its snapshot of the old file until it refreshes
+    EXPECT_FALSE( reader.get( "after" ) );
+    EXPECT_TRUE( reader.refresh() );
+    EXPECT_EQ( reader.get( "during19" ), "value" );
+    EXPECT_EQ( reader.get( "entry7-3" ), "rotated" );
+    EXPECT_EQ( reader.size(), 271_sz );
+
+    auto reopened{ vault::vault{ file.path, master_key, options } };
+
+    EXPECT_EQ( reopened.size(), 271_sz );
+    EXPECT_EQ( reopened.get( "entry49-4" ), "rotated" );
+}